@@ -1,6 +1,10 @@
 #
 # a cmake macro to generate a text file with the class hierarchy
 #
+# Variables that are used:
+#         WrapVTK_HIERARCHY_JOBS: the number of worker processes
+#         WrapVTK_HIERARCHY_DB: also write the hierarchy database
+#
 MACRO(VTK_WRAP_HIERARCHY TARGET OUTPUT_DIR SOURCES)
   IF(NOT VTK_WRAP_HIERARCHY_EXE)
     MESSAGE(SEND_ERROR "VTK_WRAP_HIERARCHY_EXE not specified when calling VTK_WRAP_HIERARCHY")
@@ -184,6 +188,18 @@ MACRO(VTK_WRAP_HIERARCHY TARGET OUTPUT_DIR SOURCES)
     ENDIF(NOT "${TMP_KIT_LIB}" STREQUAL "${KIT_TARGET_NAME}")
   ENDFOREACH (TMP_KIT_LIB ${TMP_KIT_DEPENDS})
 
+  # parse the headers with worker processes
+  SET(TMP_JOBS)
+  IF(WrapVTK_HIERARCHY_JOBS GREATER 1)
+    SET(TMP_JOBS "-j" "${WrapVTK_HIERARCHY_JOBS}")
+  ENDIF(WrapVTK_HIERARCHY_JOBS GREATER 1)
+
+  # add this kit to the database for all kits
+  SET(TMP_DB)
+  IF(WrapVTK_HIERARCHY_DB)
+    SET(TMP_DB "--db" "${quote}${WrapVTK_BINARY_DIR}/WrapVTKHierarchy.db${quote}")
+  ENDIF(WrapVTK_HIERARCHY_DB)
+
   IF(NOT CMAKE_GENERATOR MATCHES "Visual Studio.*")
   # build the hierarchy file: the hierarchy file is only
   # overwritten if it will changed
@@ -195,6 +211,8 @@ MACRO(VTK_WRAP_HIERARCHY TARGET OUTPUT_DIR SOURCES)
 
       COMMAND ${VTK_WRAP_HIERARCHY_EXE}
       "${quote}@${RESPONSE_FILE}${quote}"
+      ${TMP_JOBS}
+      ${TMP_DB}
       "-o" "${quote}${OUTPUT_DIR}/${TARGET}.txt${quote}"
       "${quote}${OUTPUT_DIR}/${TARGET}.data${quote}"
       ${QUOTED_HIERARCHY_FILES}
@@ -220,6 +238,8 @@ MACRO(VTK_WRAP_HIERARCHY TARGET OUTPUT_DIR SOURCES)
 
       COMMAND ${VTK_WRAP_HIERARCHY_EXE}
       "${quote}@${RESPONSE_FILE}${quote}"
+      ${TMP_JOBS}
+      ${TMP_DB}
       "-o" "${quote}${OUTPUT_DIR}/${TARGET}.txt${quote}"
       "${quote}${OUTPUT_DIR}/${TARGET}.data${quote}"
       ${QUOTED_HIERARCHY_FILES}
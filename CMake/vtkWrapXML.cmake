@@ -12,6 +12,8 @@
 #         KIT_NAME: the name of the kit being wrapped
 #         KIT_HEADER_DIR: the directory for the input files (optional)
 #         WrapVTK_HINTS: the hints file (optional)
+#         WrapVTK_XML_BUNDLE: write one ${KIT_NAME}.xmlb for the kit
+#         WrapVTK_XML_BUNDLE_COMPRESS: compress the bundle
 MACRO(VTK_WRAP_XML TARGET XML_LIST_NAME OUTPUT_DIR SOURCES)
 
   IF(CMAKE_GENERATOR MATCHES "NMake Makefiles")
@@ -41,6 +43,10 @@ MACRO(VTK_WRAP_XML TARGET XML_LIST_NAME OUTPUT_DIR SOURCES)
   CONFIGURE_FILE(${CMAKE_ROOT}/Modules/CMakeConfigurableFile.in
                  ${RESPONSE_FILE} @ONLY)
 
+  # the inputs for the bundle, and a line of args for each input
+  SET(TMP_BUNDLE_INPUTS)
+  SET(TMP_HEADER_LIST)
+
   FOREACH(INPUT_FILE ${SOURCES})
 
     # in case we were given a path with the class name
@@ -109,6 +115,12 @@ MACRO(VTK_WRAP_XML TARGET XML_LIST_NAME OUTPUT_DIR SOURCES)
 
       SET(TMP_OUTPUT "${OUTPUT_DIR}/${TMP_CLASS}.xml")
 
+      IF(WrapVTK_XML_BUNDLE)
+        SET(TMP_BUNDLE_INPUTS ${TMP_BUNDLE_INPUTS} ${TMP_INPUT})
+        SET(TMP_HEADER_LIST
+          "${TMP_HEADER_LIST}${TMP_CONCRETE} ${TMP_SPECIAL} \"${TMP_INPUT}\"\n")
+      ELSE(WrapVTK_XML_BUNDLE)
+
       # add custom command to output
       ADD_CUSTOM_COMMAND(
         OUTPUT ${TMP_OUTPUT}
@@ -130,6 +142,8 @@ MACRO(VTK_WRAP_XML TARGET XML_LIST_NAME OUTPUT_DIR SOURCES)
       # add the output to the list
       SET(${XML_LIST_NAME} ${${XML_LIST_NAME}} ${TMP_OUTPUT})
 
+      ENDIF(WrapVTK_XML_BUNDLE)
+
     ENDIF(IGNORE_WRAP_EXCLUDE OR TMP_WRAP_SPECIAL OR NOT TMP_WRAP_EXCLUDE)
 
     ENDIF(NOT "${KIT_NAME}" STREQUAL "Filtering" OR
@@ -139,4 +153,42 @@ MACRO(VTK_WRAP_XML TARGET XML_LIST_NAME OUTPUT_DIR SOURCES)
 
   ENDFOREACH(INPUT_FILE ${SOURCES})
 
+  IF(WrapVTK_XML_BUNDLE AND TMP_BUNDLE_INPUTS)
+
+    IF(WrapVTK_XML_BUNDLE_COMPRESS)
+      SET(TMP_COMPRESS "--compress")
+    ELSE(WrapVTK_XML_BUNDLE_COMPRESS)
+      SET(TMP_COMPRESS)
+    ENDIF(WrapVTK_XML_BUNDLE_COMPRESS)
+
+    # the headers go into a file, there can be thousands of them,
+    # and the options on each line apply to the header on that line
+    STRING(STRIP "${TMP_HEADER_LIST}" CMAKE_CONFIGURABLE_FILE_CONTENT)
+    SET(HEADERS_FILE ${OUTPUT_DIR}/${TARGET}Headers.args)
+    CONFIGURE_FILE(${CMAKE_ROOT}/Modules/CMakeConfigurableFile.in
+                   ${HEADERS_FILE} @ONLY)
+
+    SET(TMP_OUTPUT "${OUTPUT_DIR}/${KIT_NAME}.xmlb")
+
+    ADD_CUSTOM_COMMAND(
+      OUTPUT ${TMP_OUTPUT}
+      DEPENDS ${VTK_WRAP_XML_EXE} ${WrapVTK_HINTS}
+      ${TMP_BUNDLE_INPUTS} ${TMP_HIERARCHY}
+      COMMAND ${VTK_WRAP_XML_EXE}
+      ARGS
+      "--bundle"
+      ${TMP_COMPRESS}
+      ${TMP_HINTS}
+      "--types" "${quote}${TMP_HIERARCHY}${quote}"
+      "${quote}@${RESPONSE_FILE}${quote}"
+      "-o" "${quote}${TMP_OUTPUT}${quote}"
+      "${quote}@${HEADERS_FILE}${quote}"
+      COMMENT "XML Wrapping - generating ${KIT_NAME}.xmlb"
+      ${verbatim}
+      )
+
+    SET(${XML_LIST_NAME} ${${XML_LIST_NAME}} ${TMP_OUTPUT})
+
+  ENDIF(WrapVTK_XML_BUNDLE AND TMP_BUNDLE_INPUTS)
+
 ENDMACRO(VTK_WRAP_XML)
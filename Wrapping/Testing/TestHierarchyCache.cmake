@@ -0,0 +1,80 @@
+#
+# TestHierarchyCache.cmake - check that the vtkWrapHierarchy cache is
+# not used when a new header would change how an include is resolved
+#
+# Usage: cmake -DHIERARCHY_EXE=<vtkWrapHierarchy> -DWORK_DIR=<dir>
+#              -P TestHierarchyCache.cmake
+#
+# vtkA.h includes "vtkABase.h", which is found in "inc2" until a header
+# with the same name is added to "inc1", which is earlier in the path.
+# vtkB.h includes "vtkBGenerated.h", which does not exist until it is
+# added to "inc2".  Each of these headers sets the superclass.
+
+IF(NOT HIERARCHY_EXE OR NOT WORK_DIR)
+  MESSAGE(FATAL_ERROR "HIERARCHY_EXE and WORK_DIR must be set")
+ENDIF(NOT HIERARCHY_EXE OR NOT WORK_DIR)
+
+FILE(REMOVE_RECURSE "${WORK_DIR}")
+FILE(MAKE_DIRECTORY "${WORK_DIR}/src" "${WORK_DIR}/inc1" "${WORK_DIR}/inc2")
+
+FILE(WRITE "${WORK_DIR}/src/vtkObjectBase.h"
+  "class vtkObjectBase\n{\n};\n")
+FILE(WRITE "${WORK_DIR}/src/vtkObject.h"
+  "#include \"vtkObjectBase.h\"\n"
+  "class vtkObject : public vtkObjectBase\n{\n};\n")
+FILE(WRITE "${WORK_DIR}/src/vtkA.h"
+  "#include \"vtkObject.h\"\n"
+  "#include \"vtkABase.h\"\n"
+  "class vtkA : public VTK_A_BASE\n{\n};\n")
+FILE(WRITE "${WORK_DIR}/src/vtkB.h"
+  "#include \"vtkObject.h\"\n"
+  "#include \"vtkBGenerated.h\"\n"
+  "#ifndef VTK_B_BASE\n"
+  "#define VTK_B_BASE vtkObject\n"
+  "#endif\n"
+  "class vtkB : public VTK_B_BASE\n{\n};\n")
+FILE(WRITE "${WORK_DIR}/inc2/vtkABase.h"
+  "#define VTK_A_BASE vtkObjectBase\n")
+FILE(WRITE "${WORK_DIR}/kit.data"
+  "${WORK_DIR}/src/vtkObjectBase.h;vtkTest\n"
+  "${WORK_DIR}/src/vtkObject.h;vtkTest\n"
+  "${WORK_DIR}/src/vtkA.h;vtkTest\n"
+  "${WORK_DIR}/src/vtkB.h;vtkTest\n")
+
+# run the tool and check the superclasses of vtkA and vtkB
+MACRO(CHECK_HIERARCHY TMP_A_BASE TMP_B_BASE)
+  EXECUTE_PROCESS(
+    COMMAND "${HIERARCHY_EXE}"
+      -I "${WORK_DIR}/inc1" -I "${WORK_DIR}/inc2"
+      -o "${WORK_DIR}/hierarchy.txt" "${WORK_DIR}/kit.data"
+    WORKING_DIRECTORY "${WORK_DIR}"
+    RESULT_VARIABLE TMP_RESULT)
+  IF(NOT TMP_RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "vtkWrapHierarchy failed: ${TMP_RESULT}")
+  ENDIF(NOT TMP_RESULT EQUAL 0)
+  FILE(READ "${WORK_DIR}/hierarchy.txt" TMP_HIERARCHY)
+  IF(NOT TMP_HIERARCHY MATCHES "(^|\n)vtkA : ${TMP_A_BASE} ;")
+    MESSAGE(FATAL_ERROR
+      "expected vtkA : ${TMP_A_BASE}, got:\n${TMP_HIERARCHY}")
+  ENDIF(NOT TMP_HIERARCHY MATCHES "(^|\n)vtkA : ${TMP_A_BASE} ;")
+  IF(NOT TMP_HIERARCHY MATCHES "(^|\n)vtkB : ${TMP_B_BASE} ;")
+    MESSAGE(FATAL_ERROR
+      "expected vtkB : ${TMP_B_BASE}, got:\n${TMP_HIERARCHY}")
+  ENDIF(NOT TMP_HIERARCHY MATCHES "(^|\n)vtkB : ${TMP_B_BASE} ;")
+ENDMACRO(CHECK_HIERARCHY)
+
+# the first run writes the cache
+CHECK_HIERARCHY(vtkObjectBase vtkObject)
+IF(NOT EXISTS "${WORK_DIR}/hierarchy.txt.cache")
+  MESSAGE(FATAL_ERROR "the cache file was not written")
+ENDIF(NOT EXISTS "${WORK_DIR}/hierarchy.txt.cache")
+
+# a header that shadows an include that was found before
+FILE(WRITE "${WORK_DIR}/inc1/vtkABase.h"
+  "#define VTK_A_BASE vtkShadow\n")
+CHECK_HIERARCHY(vtkShadow vtkObject)
+
+# a header that provides an include that was not found before
+FILE(WRITE "${WORK_DIR}/inc2/vtkBGenerated.h"
+  "#define VTK_B_BASE vtkGenerated\n")
+CHECK_HIERARCHY(vtkShadow vtkGenerated)
@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    TestMethodNames.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ TestMethodNames checks vtkParseProperties_ClassifyMethodName().  The
+ expected flags and prefix lengths in the table are the results of the
+ isSetMethod(), isGetNthMethod(), etc. checks and nameWithoutPrefix()
+ that the classifier replaced, so they must not change.
+
+ Usage: TestMethodNames
+*/
+
+#include "vtkParseProperties.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SET        VTK_METHOD_NAME_SET
+#define GET        VTK_METHOD_NAME_GET
+#define ADD        VTK_METHOD_NAME_ADD
+#define REMOVE     VTK_METHOD_NAME_REMOVE
+#define REMOVE_ALL VTK_METHOD_NAME_REMOVE_ALL
+#define NTH        VTK_METHOD_NAME_NTH
+#define NUMBER_OF  VTK_METHOD_NAME_NUMBER_OF
+#define ON         VTK_METHOD_NAME_ON
+#define OFF        VTK_METHOD_NAME_OFF
+#define VALUE_TO   VTK_METHOD_NAME_VALUE_TO
+#define AS_STRING  VTK_METHOD_NAME_AS_STRING
+#define MIN_VALUE  VTK_METHOD_NAME_MIN_VALUE
+#define MAX_VALUE  VTK_METHOD_NAME_MAX_VALUE
+
+/* a method name, its flags, and the length of its prefix */
+typedef struct _NameCase
+{
+  const char *Name;
+  unsigned int Flags;
+  size_t PrefixLength;
+} NameCase;
+
+static const NameCase name_cases[] = {
+  /* SetNthX, GetNthX */
+  { "SetNthValue", SET | NTH, 6 },
+  { "GetNthValue", GET | NTH, 6 },
+  { "SetNthvalue", SET, 3 },
+  { "SetNth", SET, 3 },
+  { "GetNth", GET, 3 },
+  { "GetNthValueAsString", GET | NTH | AS_STRING, 6 },
+  /* SetNumberOfXs, GetNumberOfXs */
+  { "SetNumberOfValues", SET | NUMBER_OF, 3 },
+  { "GetNumberOfValues", GET | NUMBER_OF, 3 },
+  { "SetNumberOfValue", SET, 3 },
+  { "GetNumberOfvalues", GET, 3 },
+  { "GetNumberOf", GET, 3 },
+  /* RemoveAllXs, RemoveX */
+  { "RemoveAllValues", REMOVE | REMOVE_ALL, 9 },
+  { "RemoveAllValue", REMOVE, 6 },
+  { "RemoveAll", REMOVE, 6 },
+  { "RemoveValue", REMOVE, 6 },
+  { "RemoveAllValuesOn", ON, 0 },
+  { "RemoveValueOn", ON, 0 },
+  { "Removevalue", 0, 0 },
+  /* AddX */
+  { "AddValue", ADD, 3 },
+  { "AddNthValue", ADD, 3 },
+  { "AddValueOn", ON, 0 },
+  { "AddValueOff", OFF, 0 },
+  { "Addvalue", 0, 0 },
+  { "Add", 0, 0 },
+  /* XOn, XOff */
+  { "ValueOn", ON, 0 },
+  { "ValueOff", OFF, 0 },
+  { "SetValueOn", SET | ON, 3 },
+  { "GetValueOff", GET | OFF, 3 },
+  { "On", 0, 0 },
+  { "Off", 0, 0 },
+  /* SetXToY */
+  { "SetValueToLinear", SET | VALUE_TO, 3 },
+  { "SetValueTo2D", SET | VALUE_TO, 3 },
+  { "SetToValue", SET | VALUE_TO, 3 },
+  { "SetValueToLinearOn", SET | VALUE_TO | ON, 3 },
+  { "SetValueTo", SET, 3 },
+  { "SetValueTox", SET, 3 },
+  { "GetValueToLinear", GET, 3 },
+  /* GetXAsString */
+  { "GetValueAsString", GET | AS_STRING, 3 },
+  { "GetXAsString", GET | AS_STRING, 3 },
+  { "GetAsString", GET, 3 },
+  { "SetValueAsString", SET, 3 },
+  /* GetXMinValue, GetXMaxValue */
+  { "GetValueMinValue", GET | MIN_VALUE, 3 },
+  { "GetValueMaxValue", GET | MAX_VALUE, 3 },
+  { "GetMinValue", GET, 3 },
+  { "GetMaxValue", GET, 3 },
+  { "SetValueMinValue", SET, 3 },
+  /* SetX, GetX */
+  { "SetValue", SET, 3 },
+  { "GetValue", GET, 3 },
+  { "SetX", SET, 3 },
+  { "Set", 0, 0 },
+  { "Get", 0, 0 },
+  { "Setvalue", 0, 0 },
+  { "Getvalue", 0, 0 },
+  /* names that are not property methods */
+  { "Update", 0, 0 },
+  { "Modified", 0, 0 },
+  { "NewInstance", 0, 0 },
+  { "Settle", 0, 0 },
+  { "Gettysburg", 0, 0 },
+  { "Removed", 0, 0 },
+  { "Addition", 0, 0 },
+  { "", 0, 0 },
+};
+
+int main(int argc, char *argv[])
+{
+  const NameCase *c;
+  unsigned int flags;
+  size_t i, l;
+  int failed = 0;
+
+  if (argc != 1)
+  {
+    fprintf(stderr, "Usage: %s\n", argv[0]);
+    return 1;
+  }
+
+  for (i = 0; i < sizeof(name_cases)/sizeof(NameCase); i++)
+  {
+    c = &name_cases[i];
+    l = 99;
+    flags = vtkParseProperties_ClassifyMethodName(c->Name, &l);
+    if (flags != c->Flags || l != c->PrefixLength)
+    {
+      fprintf(stderr, "\"%s\" gave flags 0x%04x and prefix %lu, "
+              "expected 0x%04x and %lu\n", c->Name, flags,
+              (unsigned long)l, c->Flags, (unsigned long)c->PrefixLength);
+      failed++;
+    }
+  }
+
+  /* a NULL name has no flags and no prefix */
+  l = 99;
+  if (vtkParseProperties_ClassifyMethodName(NULL, &l) != 0 || l != 0)
+  {
+    fprintf(stderr, "a NULL name was classified\n");
+    failed++;
+  }
+
+  if (failed)
+  {
+    fprintf(stderr, "%d checks failed\n", failed);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,371 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    TestParseHierarchy.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ TestParseHierarchy checks the hierarchy lookups against a handwritten
+ hierarchy file, TestParseHierarchy.txt.  The expected results are the
+ same as for the original implementations of these functions, which
+ used a binary search and walked the superclasses for every check,
+ except that vtkParseHierarchy_IsTypeOfTemplated used to skip the first
+ superclass of a class with multiple inheritance if it was reached from
+ a subclass (e.g. vtkMultiSub and vtkObject).
+
+ Usage: TestParseHierarchy TestParseHierarchy.txt
+*/
+
+#include "vtkParseHierarchy.h"
+#include "vtkParseType.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* vtkParseHierarchy_FindEntry: the name, and the entry or NULL */
+typedef struct _FindEntryCase
+{
+  const char *Name;
+  const char *EntryName;
+} FindEntryCase;
+
+static const FindEntryCase find_entry_cases[] = {
+  { "vtkObject", "vtkObject" },
+  { "vtkObject::IdType", "vtkObject::IdType" },
+  { "vtkObject::Mode", "vtkObject::Mode" },
+  { "vtkTypedArray", "vtkTypedArray" },
+  { "vtkTypedArray<int>", "vtkTypedArray" },
+  { "vtkTypedArray<vtkTypedArray<int> >", "vtkTypedArray" },
+  { "vtkPair<int, float>", "vtkPair" },
+  { "vtkOuter::Inner", "vtkOuter::Inner" },
+  { "vtkOuter<double>::Inner", "vtkOuter::Inner" },
+  { "vtkObject<int>", "vtkObject" },
+  { "vtkObj", NULL },
+  { "vtkObjectBaseX", NULL },
+  { "vtkOuter", NULL },
+  { "vtkOuter<double>::Other", NULL },
+  { "IdType", NULL },
+  { "", NULL },
+};
+
+/* vtkParseHierarchy_IsTypeOf: the class, the base class, the result */
+typedef struct _IsTypeOfCase
+{
+  const char *ClassName;
+  const char *BaseClass;
+  int Result;
+} IsTypeOfCase;
+
+static const IsTypeOfCase is_type_of_cases[] = {
+  { "vtkImageData", "vtkImageData", 1 },
+  { "vtkImageData", "vtkDataObject", 1 },
+  { "vtkImageData", "vtkObjectBase", 1 },
+  { "vtkObject", "vtkImageData", 0 },
+  { "vtkImageData", "vtkMixin", 0 },
+  { "vtkImageData", "vtkNotThere", 0 },
+  { "vtkMixin", "vtkObjectBase", 0 },
+  /* multiple inheritance */
+  { "vtkMulti", "vtkMixin", 1 },
+  { "vtkMulti", "vtkObjectBase", 1 },
+  { "vtkMulti", "vtkDataObject", 0 },
+  { "vtkMultiSub", "vtkMixin", 1 },
+  { "vtkMultiSub", "vtkObject", 1 },
+  { "vtkMultiSub", "vtkArrayBase", 0 },
+  /* templated superclasses */
+  { "vtkDenseArray", "vtkTypedArray", 1 },
+  { "vtkDenseArray", "vtkObjectBase", 1 },
+  { "vtkDoubleDenseArray", "vtkTypedArray", 1 },
+  { "vtkDoubleDenseArray", "vtkArrayBase", 1 },
+  { "vtkDoubleDenseArray", "vtkDataObject", 0 },
+  /* a superclass that is a template parameter cannot be resolved */
+  { "vtkWrapper", "vtkObject", 0 },
+  /* a superclass that is a typedef */
+  { "vtkAliasSub", "vtkObject", 1 },
+  { "vtkAliasSub", "vtkObjectBase", 1 },
+  { "vtkAliasSub", "vtkMixin", 0 },
+  { "vtkOuter::Inner", "vtkObjectBase", 1 },
+};
+
+/* vtkParseHierarchy_IsTypeOfTemplated: the class with template args,
+ * the base class, the result, and the base class with template args */
+typedef struct _IsTypeOfTemplatedCase
+{
+  const char *ClassName;
+  const char *BaseClass;
+  int Result;
+  const char *BaseClassWithArgs;
+} IsTypeOfTemplatedCase;
+
+static const IsTypeOfTemplatedCase is_type_of_templated_cases[] = {
+  { "vtkImageData", "vtkObject", 1, "vtkObject" },
+  { "vtkImageData", "vtkMixin", 0, NULL },
+  { "vtkMultiSub", "vtkMixin", 1, "vtkMixin" },
+  { "vtkDenseArray<float>", "vtkDenseArray", 1, "vtkDenseArray<float>" },
+  { "vtkDenseArray<float>", "vtkTypedArray", 1, "vtkTypedArray<float>" },
+  { "vtkDenseArray<float>", "vtkArrayBase", 1, "vtkArrayBase" },
+  { "vtkDoubleDenseArray", "vtkTypedArray", 1, "vtkTypedArray<double>" },
+  { "vtkDoubleDenseArray", "vtkDenseArray", 1, "vtkDenseArray<double>" },
+  /* the template args give the superclass */
+  { "vtkWrapper<vtkImageData>", "vtkObject", 1, "vtkObject" },
+  { "vtkWrapper<vtkImageData>", "vtkDataObject", 1, "vtkDataObject" },
+  { "vtkWrapper<vtkMixin>", "vtkObject", 0, NULL },
+  { "vtkWrapper<vtkMixin>", "vtkMixin", 1, "vtkMixin" },
+  { "vtkWrapper<vtkDenseArray<int> >", "vtkTypedArray", 1,
+    "vtkTypedArray<int>" },
+};
+
+/* vtkParseHierarchy_ExpandTypedefsInValue: the type and name, the
+ * scope, the result, and the type and name after the expansion */
+typedef struct _ExpandCase
+{
+  unsigned int Type;
+  const char *TypeName;
+  const char *Scope;
+  int Result;
+  unsigned int ExpandedType;
+  const char *ExpandedTypeName;
+} ExpandCase;
+
+static const ExpandCase expand_cases[] = {
+  { VTK_PARSE_UNKNOWN, "vtkIdType", NULL,
+    1, VTK_PARSE_LONG_LONG, "long long" },
+  { VTK_PARSE_UNKNOWN_PTR, "vtkIdType", NULL,
+    1, VTK_PARSE_LONG_LONG_PTR, "long long" },
+  /* vtkIdType is a VTK type, so it is not expanded further */
+  { VTK_PARSE_UNKNOWN, "vtkIdTypePtr", NULL,
+    1, VTK_PARSE_ID_TYPE_PTR, "vtkIdType" },
+  { VTK_PARSE_UNKNOWN, "vtkConstIdTypePtr", NULL,
+    1, VTK_PARSE_ID_TYPE_PTR | VTK_PARSE_CONST, "vtkIdType" },
+  { VTK_PARSE_UNKNOWN, "IdType", "vtkObject",
+    1, VTK_PARSE_INT, "int" },
+  /* found in the scope of a superclass */
+  { VTK_PARSE_UNKNOWN, "IdType", "vtkImageData",
+    1, VTK_PARSE_INT, "int" },
+  { VTK_PARSE_UNKNOWN, "IdType", "vtkMultiSub",
+    1, VTK_PARSE_INT, "int" },
+  /* a typedef of a scoped typedef */
+  { VTK_PARSE_UNKNOWN, "Scalar", "vtkDataObject",
+    1, VTK_PARSE_INT, "int" },
+  { VTK_PARSE_UNKNOWN, "Scalar", "vtkImageData",
+    1, VTK_PARSE_INT, "int" },
+  /* a typedef of a class */
+  { VTK_PARSE_OBJECT, "vtkObjectAlias", NULL,
+    1, VTK_PARSE_OBJECT, "vtkObject" },
+  { VTK_PARSE_OBJECT, "vtkObject", NULL,
+    1, VTK_PARSE_OBJECT, "vtkObject" },
+  /* names that are not in the hierarchy */
+  { VTK_PARSE_UNKNOWN, "IdType", NULL,
+    0, VTK_PARSE_UNKNOWN, "IdType" },
+  { VTK_PARSE_UNKNOWN, "IdType", "vtkMixin",
+    0, VTK_PARSE_UNKNOWN, "IdType" },
+  { VTK_PARSE_UNKNOWN_PTR, "vtkNotThere", NULL,
+    0, VTK_PARSE_UNKNOWN_PTR, "vtkNotThere" },
+  /* types that are not expanded */
+  { VTK_PARSE_INT, "int", NULL,
+    1, VTK_PARSE_INT, "int" },
+};
+
+/* check the FindEntry cases, return the number of failures */
+static int test_find_entry(const HierarchyInfo *info)
+{
+  const HierarchyEntry *entry;
+  const FindEntryCase *c;
+  size_t n = sizeof(find_entry_cases)/sizeof(FindEntryCase);
+  size_t i;
+  int failed = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    c = &find_entry_cases[i];
+    entry = vtkParseHierarchy_FindEntry(info, c->Name);
+    if ((entry == NULL && c->EntryName != NULL) ||
+        (entry != NULL && (c->EntryName == NULL ||
+                           strcmp(entry->Name, c->EntryName) != 0)))
+    {
+      fprintf(stderr, "FindEntry(\"%s\"): got %s, expected %s\n",
+              c->Name, (entry ? entry->Name : "NULL"),
+              (c->EntryName ? c->EntryName : "NULL"));
+      failed++;
+    }
+  }
+
+  return failed;
+}
+
+/* check the IsTypeOf cases, return the number of failures */
+static int test_is_type_of(const HierarchyInfo *info)
+{
+  const HierarchyEntry *entry;
+  const IsTypeOfCase *c;
+  size_t n = sizeof(is_type_of_cases)/sizeof(IsTypeOfCase);
+  size_t i;
+  int failed = 0;
+  int pass, result;
+
+  /* the first pass builds the tables, the second pass uses them */
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      c = &is_type_of_cases[i];
+      entry = vtkParseHierarchy_FindEntry(info, c->ClassName);
+      if (entry == NULL)
+      {
+        fprintf(stderr, "IsTypeOf: no entry for %s\n", c->ClassName);
+        failed++;
+        continue;
+      }
+      result = vtkParseHierarchy_IsTypeOf(info, entry, c->BaseClass);
+      if (result != c->Result)
+      {
+        fprintf(stderr, "IsTypeOf(%s, %s): got %d, expected %d\n",
+                c->ClassName, c->BaseClass, result, c->Result);
+        failed++;
+      }
+    }
+  }
+
+  return failed;
+}
+
+/* check the IsTypeOfTemplated cases, return the number of failures */
+static int test_is_type_of_templated(const HierarchyInfo *info)
+{
+  const HierarchyEntry *entry;
+  const IsTypeOfTemplatedCase *c;
+  const char *baseclass_with_args;
+  size_t n = sizeof(is_type_of_templated_cases)/sizeof(IsTypeOfTemplatedCase);
+  size_t i;
+  int failed = 0;
+  int pass, result;
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      c = &is_type_of_templated_cases[i];
+      entry = vtkParseHierarchy_FindEntry(info, c->ClassName);
+      if (entry == NULL)
+      {
+        fprintf(stderr, "IsTypeOfTemplated: no entry for %s\n",
+                c->ClassName);
+        failed++;
+        continue;
+      }
+      baseclass_with_args = "unset";
+      result = vtkParseHierarchy_IsTypeOfTemplated(
+        info, entry, c->ClassName, c->BaseClass, &baseclass_with_args);
+      if (result != c->Result ||
+          (baseclass_with_args == NULL) != (c->BaseClassWithArgs == NULL) ||
+          (baseclass_with_args != NULL &&
+           strcmp(baseclass_with_args, c->BaseClassWithArgs) != 0))
+      {
+        fprintf(stderr,
+                "IsTypeOfTemplated(%s, %s): got %d %s, expected %d %s\n",
+                c->ClassName, c->BaseClass, result,
+                (baseclass_with_args ? baseclass_with_args : "NULL"),
+                c->Result,
+                (c->BaseClassWithArgs ? c->BaseClassWithArgs : "NULL"));
+        failed++;
+      }
+      if (result && baseclass_with_args)
+      {
+        free((char *)baseclass_with_args);
+      }
+    }
+  }
+
+  return failed;
+}
+
+/* check the ExpandTypedefsInValue cases, return the number of failures */
+static int test_expand_typedefs(const HierarchyInfo *info)
+{
+  StringCache strings;
+  const ExpandCase *c;
+  ValueInfo val;
+  size_t n = sizeof(expand_cases)/sizeof(ExpandCase);
+  size_t i;
+  int failed = 0;
+  int pass, result;
+
+  vtkParse_InitStringCache(&strings);
+
+  /* the first pass fills the cache, the second pass replays it */
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      c = &expand_cases[i];
+      vtkParse_InitValue(&val);
+      val.Type = c->Type;
+      val.TypeName = c->TypeName;
+      result = vtkParseHierarchy_ExpandTypedefsInValue(
+        info, &val, &strings, c->Scope);
+      if (result != c->Result || val.Type != c->ExpandedType ||
+          strcmp(val.TypeName, c->ExpandedTypeName) != 0)
+      {
+        fprintf(stderr,
+                "ExpandTypedefsInValue(0x%x %s, %s) pass %d: "
+                "got %d 0x%x %s, expected %d 0x%x %s\n",
+                c->Type, c->TypeName, (c->Scope ? c->Scope : "NULL"),
+                pass, result, val.Type, val.TypeName,
+                c->Result, c->ExpandedType, c->ExpandedTypeName);
+        failed++;
+      }
+      free((char **)val.Dimensions);
+    }
+  }
+
+  vtkParse_FreeStringCache(&strings);
+
+  return failed;
+}
+
+int main(int argc, char *argv[])
+{
+  HierarchyInfo *info;
+  int failed = 0;
+
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: %s TestParseHierarchy.txt\n", argv[0]);
+    return 1;
+  }
+
+  /* each set of checks gets a new hierarchy, so that the lookups that
+   * build the tables are not always the same */
+  info = vtkParseHierarchy_ReadFile(argv[1]);
+  if (info == NULL)
+  {
+    fprintf(stderr, "Could not read %s\n", argv[1]);
+    return 1;
+  }
+  failed += test_find_entry(info);
+  failed += test_is_type_of(info);
+  failed += test_is_type_of_templated(info);
+  failed += test_expand_typedefs(info);
+  vtkParseHierarchy_Free(info);
+
+  info = vtkParseHierarchy_ReadFile(argv[1]);
+  failed += test_expand_typedefs(info);
+  failed += test_is_type_of_templated(info);
+  failed += test_is_type_of(info);
+  vtkParseHierarchy_Free(info);
+
+  if (failed)
+  {
+    fprintf(stderr, "%d checks failed\n", failed);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    TestStringReplace.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ TestStringReplace checks vtkParse_StringReplace(), which substitutes
+ template args into types and values.  Up to 32 names are found with a
+ hash table, and more names than that are searched for one by one, so
+ both are checked.  The results that are longer than 1024 chars must
+ be moved from the stack buffer to the heap.
+
+ Usage: TestStringReplace
+*/
+
+#include "vtkParseExtras.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* a replacement: the text, the names and values, and the result, which
+ * is NULL if the text is returned unchanged */
+typedef struct _ReplaceCase
+{
+  const char *Text;
+  unsigned long NumberOfNames;
+  const char *Names[3];
+  const char *Values[3];
+  const char *Result;
+} ReplaceCase;
+
+static const ReplaceCase replace_cases[] = {
+  /* nothing to replace */
+  { "", 1, { "T" }, { "int" }, NULL },
+  { "TT *T_ xT", 1, { "T" }, { "int" }, NULL },
+  { "\"T\" 'T'", 1, { "T" }, { "int" }, NULL },
+  { "vtkArray<U>", 1, { "T" }, { "int" }, NULL },
+  { "T", 0, { NULL }, { NULL }, NULL },
+  { "T", 1, { "" }, { "int" }, NULL },
+  /* at the start, the end, or both */
+  { "T", 1, { "T" }, { "int" }, "int" },
+  { "T *", 1, { "T" }, { "int" }, "int *" },
+  { "const T", 1, { "T" }, { "int" }, "const int" },
+  { "T(*)(T)", 1, { "T" }, { "double" }, "double(*)(double)" },
+  { "A<B, C>", 3, { "A", "B", "C" }, { "x", "y", "z" }, "x<y, z>" },
+  { "\"T\" T 'T'", 1, { "T" }, { "int" }, "\"T\" int 'T'" },
+  { "T::U", 2, { "T", "U" }, { "vtkObject", "Mode" }, "vtkObject::Mode" },
+  /* the values are not scanned again */
+  { "T U", 2, { "T", "U" }, { "U", "T" }, "U T" },
+  /* no ">>" is made when the value ends with ">" */
+  { "vtkArray<T>", 1, { "T" }, { "vtkVector<int>" },
+    "vtkArray<vtkVector<int> >" },
+  { "vtkArray<T> ", 1, { "T" }, { "vtkVector<int>" },
+    "vtkArray<vtkVector<int> > " },
+  { "vtkPair<T, T>", 1, { "T" }, { "vtkVector<int>" },
+    "vtkPair<vtkVector<int>, vtkVector<int> >" },
+  { "T>", 1, { "T" }, { ">" }, "> >" },
+  /* an empty value */
+  { "const T *", 1, { "T" }, { "" }, "const  *" },
+  { "T", 1, { "T" }, { "" }, "" },
+  { "vtkPair<T, U>", 2, { "T", "U" }, { "", "int" }, "vtkPair<, int>" },
+};
+
+/* check one replacement, the text is "what" in the messages */
+static int check_replace(
+  const char *what, const char *text, unsigned long n,
+  const char *names[], const char *values[], const char *expected)
+{
+  const char *result;
+  int failed = 0;
+
+  result = vtkParse_StringReplace(text, n, names, values);
+
+  if (expected == NULL)
+  {
+    if (result != text)
+    {
+      fprintf(stderr, "StringReplace(\"%s\") returned a new string \"%s\"\n",
+              what, result);
+      failed = 1;
+    }
+  }
+  else if (result == text)
+  {
+    fprintf(stderr, "StringReplace(\"%s\") returned the same string\n",
+            what);
+    failed = 1;
+  }
+  else if (strcmp(result, expected) != 0)
+  {
+    fprintf(stderr, "StringReplace(\"%s\") gave \"%s\", expected \"%s\"\n",
+            what, result, expected);
+    failed = 1;
+  }
+
+  if (result != text)
+  {
+    free((char *)result);
+  }
+
+  return failed;
+}
+
+/* the replacements that are listed in the table */
+static int test_replace_cases(void)
+{
+  const ReplaceCase *c;
+  size_t i;
+  int failed = 0;
+
+  for (i = 0; i < sizeof(replace_cases)/sizeof(ReplaceCase); i++)
+  {
+    c = &replace_cases[i];
+    failed += check_replace(c->Text, c->Text, c->NumberOfNames,
+                            (const char **)c->Names,
+                            (const char **)c->Values, c->Result);
+  }
+
+  return failed;
+}
+
+/* results that are longer than the 1024 char buffer */
+static int test_long_results(void)
+{
+  static const char *names[1] = { "T" };
+  const char *values[1];
+  char *text;
+  char *expected;
+  char *value;
+  size_t l, m, k;
+  int failed = 0;
+
+  /* "T,T,T..." where the value grows until the result is long */
+  for (m = 1; m <= 2048; m = 2*m + 1)
+  {
+    value = (char *)malloc(m + 1);
+    memset(value, 'x', m);
+    value[m] = '\0';
+    values[0] = value;
+
+    for (l = 1; l < 64; l += 7)
+    {
+      text = (char *)malloc(2*l);
+      expected = (char *)malloc(l*(m + 1));
+      for (k = 0; k < l; k++)
+      {
+        text[2*k] = 'T';
+        text[2*k + 1] = ',';
+        memcpy(&expected[k*(m + 1)], value, m);
+        expected[k*(m + 1) + m] = ',';
+      }
+      text[2*l - 1] = '\0';
+      expected[l*(m + 1) - 1] = '\0';
+
+      failed += check_replace("T,T,...", text, 1, names, values, expected);
+
+      free(text);
+      free(expected);
+    }
+
+    free(value);
+  }
+
+  /* a long text with one replacement at the very end */
+  text = (char *)malloc(3000);
+  memset(text, ' ', 2997);
+  text[2997] = 'T';
+  text[2998] = '\0';
+  expected = (char *)malloc(3001);
+  memset(expected, ' ', 2997);
+  strcpy(&expected[2997], "int");
+  values[0] = "int";
+  failed += check_replace("  ...  T", text, 1, names, values, expected);
+  free(text);
+  free(expected);
+
+  return failed;
+}
+
+/* more names than the hash table holds, so each is searched for */
+static int test_many_names(void)
+{
+  char names_store[40][8];
+  char values_store[40][8];
+  const char *names[40];
+  const char *values[40];
+  char text[512];
+  char expected[512];
+  unsigned long n, k;
+  size_t i, j;
+  int failed = 0;
+
+  for (k = 0; k < 40; k++)
+  {
+    sprintf(names_store[k], "N%lu", k);
+    sprintf(values_store[k], "V%lu", k);
+    names[k] = names_store[k];
+    values[k] = values_store[k];
+  }
+
+  /* the hash table is used for up to 32 names */
+  for (n = 30; n <= 40; n++)
+  {
+    /* "N0 N1 ... N39", where only the first n are replaced */
+    i = 0;
+    j = 0;
+    for (k = 0; k < 40; k++)
+    {
+      i += sprintf(&text[i], (k ? " %s" : "%s"), names[k]);
+      j += sprintf(&expected[j], (k ? " %s" : "%s"),
+                   (k < n ? values[k] : names[k]));
+    }
+    failed += check_replace("N0 N1 ... N39", text, n, names, values,
+                            expected);
+
+    /* a text that has none of the names */
+    failed += check_replace("N40 xN1 N1x", "N40 xN1 N1x", n, names, values,
+                            NULL);
+  }
+
+  return failed;
+}
+
+int main(int argc, char *argv[])
+{
+  int failed = 0;
+
+  if (argc != 1)
+  {
+    fprintf(stderr, "Usage: %s\n", argv[0]);
+    return 1;
+  }
+
+  failed += test_replace_cases();
+  failed += test_long_results();
+  failed += test_many_names();
+
+  if (failed)
+  {
+    fprintf(stderr, "%d checks failed\n", failed);
+    return 1;
+  }
+
+  return 0;
+}
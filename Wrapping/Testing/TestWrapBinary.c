@@ -0,0 +1,435 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    TestWrapBinary.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ TestWrapBinary reads the file that vtkWrapBinary wrote for the header
+ vtkBinaryThing.h in TestWrapBinary.cmake, and walks it with the macros
+ in vtkWrapBinary.h to check the classes, enums, typedefs, templates
+ and properties.  It also writes a truncated copy of the file, and
+ checks that vtkWrapBinary_IsValid() rejects it.
+
+ Usage: TestWrapBinary <binary file>
+*/
+
+#include "vtkWrapBinary.h"
+#include "vtkParseData.h"
+#include "vtkParseType.h"
+#include "vtkParseProperties.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* read a whole file, return NULL on failure */
+static char *read_file(const char *filename, size_t *size)
+{
+  char *text = NULL;
+  size_t n = 0;
+  size_t m = 4096;
+  size_t r;
+  FILE *fp;
+
+  fp = fopen(filename, "rb");
+  if (fp == NULL)
+  {
+    return NULL;
+  }
+
+  /* malloc gives the alignment that the records need */
+  text = (char *)malloc(m);
+  while ((r = fread(&text[n], 1, m - n, fp)) > 0)
+  {
+    n += r;
+    if (n == m)
+    {
+      m *= 2;
+      text = (char *)realloc(text, m);
+    }
+  }
+  fclose(fp);
+
+  *size = n;
+  return text;
+}
+
+/* compare a string from the file, either may be NULL */
+static int check_string(
+  const char *what, const char *value, const char *expected)
+{
+  if (value == expected ||
+      (value && expected && strcmp(value, expected) == 0))
+  {
+    return 0;
+  }
+
+  fprintf(stderr, "%s is \"%s\", expected \"%s\"\n", what,
+          (value ? value : "(null)"), (expected ? expected : "(null)"));
+  return 1;
+}
+
+/* compare a number from the file */
+static int check_value(
+  const char *what, unsigned long value, unsigned long expected)
+{
+  if (value == expected)
+  {
+    return 0;
+  }
+
+  fprintf(stderr, "%s is %lu, expected %lu\n", what, value, expected);
+  return 1;
+}
+
+/* check the name of a record, the name may be NULL */
+static int is_named(const char *value, const char *name)
+{
+  return (value != NULL && strcmp(value, name) == 0);
+}
+
+/* find a record in an array by its name, all records start with
+ * ItemType, Access, Name (except properties, which start with Name) */
+static const binary_u32_t *find_record(
+  const char *base, binary_u32_t n, binary_u32_t array, int field,
+  const char *name)
+{
+  const binary_u32_t *offsets;
+  const binary_u32_t *rec;
+  binary_u32_t i;
+
+  offsets = vtkWrapBinary_Array(base, array);
+  for (i = 0; i < n; i++)
+  {
+    rec = vtkWrapBinary_Record(base, binary_u32_t, offsets[i]);
+    if (rec && is_named(vtkWrapBinary_String(base, rec[field]), name))
+    {
+      return rec;
+    }
+  }
+
+  return NULL;
+}
+
+#define find_class(base, c, name) \
+  ((const BinaryClass *)find_record( \
+    base, (c)->NumberOfClasses, (c)->Classes, 2, name))
+#define find_enum(base, c, name) \
+  ((const BinaryClass *)find_record( \
+    base, (c)->NumberOfEnums, (c)->Enums, 2, name))
+#define find_function(base, c, name) \
+  ((const BinaryFunction *)find_record( \
+    base, (c)->NumberOfFunctions, (c)->Functions, 2, name))
+#define find_constant(base, c, name) \
+  ((const BinaryValue *)find_record( \
+    base, (c)->NumberOfConstants, (c)->Constants, 2, name))
+#define find_typedef(base, c, name) \
+  ((const BinaryValue *)find_record( \
+    base, (c)->NumberOfTypedefs, (c)->Typedefs, 2, name))
+#define find_property(base, c, name) \
+  ((const BinaryProperty *)find_record( \
+    base, (c)->NumberOfProperties, (c)->Properties, 0, name))
+
+/* check the template parameter list "<class T>" */
+static int check_template(const char *base, binary_u32_t offset)
+{
+  const BinaryTemplate *tmpl;
+  const BinaryValue *param;
+  int failed = 0;
+
+  tmpl = vtkWrapBinary_Record(base, BinaryTemplate, offset);
+  if (tmpl == NULL)
+  {
+    fprintf(stderr, "a template has no parameters\n");
+    return 1;
+  }
+
+  failed += check_value("NumberOfParameters", tmpl->NumberOfParameters, 1);
+  if (tmpl->NumberOfParameters == 1)
+  {
+    param = vtkWrapBinary_Record(base, BinaryValue,
+      vtkWrapBinary_Array(base, tmpl->Parameters)[0]);
+    failed += check_string("template parameter",
+      vtkWrapBinary_String(base, param->Name), "T");
+  }
+
+  return failed;
+}
+
+/* check the property for a method */
+static int check_method(
+  const char *base, const BinaryClass *c, const char *name,
+  binary_u32_t methodType, const BinaryProperty *property)
+{
+  const binary_u32_t *offsets;
+  const BinaryFunction *func;
+  const BinaryProperty *methodProperty;
+  binary_u32_t i, j;
+
+  offsets = vtkWrapBinary_Array(base, c->Functions);
+  for (i = 0; i < c->NumberOfFunctions; i++)
+  {
+    func = vtkWrapBinary_Record(base, BinaryFunction, offsets[i]);
+    if (is_named(vtkWrapBinary_String(base, func->Name), name))
+    {
+      j = vtkWrapBinary_Array(base, c->MethodProperties)[i];
+      if (j == VTK_BINARY_NO_PROPERTY || j >= c->NumberOfProperties)
+      {
+        fprintf(stderr, "%s has no property\n", name);
+        return 1;
+      }
+      methodProperty = vtkWrapBinary_Record(base, BinaryProperty,
+        vtkWrapBinary_Array(base, c->Properties)[j]);
+      if (methodProperty != property)
+      {
+        fprintf(stderr, "%s has the wrong property\n", name);
+        return 1;
+      }
+      return check_value(name,
+        vtkWrapBinary_Array(base, c->MethodTypes)[i], methodType);
+    }
+  }
+
+  fprintf(stderr, "%s was not found\n", name);
+  return 1;
+}
+
+/* check the file that was written for vtkBinaryThing.h */
+static int check_file(const char *base)
+{
+  static const char *modes[3] = { "Nearest", "Linear", "Cubic" };
+  const BinaryFileHeader *header;
+  const BinaryClass *contents;
+  const BinaryClass *c;
+  const BinaryClass *e;
+  const BinaryClass *t;
+  const BinaryFunction *func;
+  const BinaryValue *val;
+  const BinaryProperty *property;
+  const binary_u32_t *names;
+  int failed = 0;
+  int i;
+
+  header = vtkWrapBinary_Header(base);
+  contents = vtkWrapBinary_Record(base, BinaryClass, header->Contents);
+  c = vtkWrapBinary_Record(base, BinaryClass, header->MainClass);
+  if (contents == NULL || c == NULL)
+  {
+    fprintf(stderr, "the file has no contents or no main class\n");
+    return 1;
+  }
+
+  /* the main class */
+  failed += check_string("the main class",
+    vtkWrapBinary_String(base, c->Name), "vtkBinaryThing");
+  failed += check_value("NumberOfSuperClasses", c->NumberOfSuperClasses, 1);
+  if (c->NumberOfSuperClasses == 1)
+  {
+    failed += check_string("the superclass", vtkWrapBinary_String(base,
+      vtkWrapBinary_Array(base, c->SuperClasses)[0]), "vtkObject");
+  }
+  failed += check_value("the class flags", c->Flags, 0);
+  if (find_class(base, contents, "vtkBinaryThing") != c)
+  {
+    fprintf(stderr, "the main class is not in the file contents\n");
+    failed++;
+  }
+
+  /* a class template in the file contents */
+  t = find_class(base, contents, "vtkBinaryTemplate");
+  if (t == NULL)
+  {
+    fprintf(stderr, "vtkBinaryTemplate was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_template(base, t->Template);
+    func = find_function(base, t, "GetValue");
+    if (func == NULL || func->ReturnValue == 0)
+    {
+      fprintf(stderr, "vtkBinaryTemplate::GetValue was not found\n");
+      failed++;
+    }
+    else
+    {
+      val = vtkWrapBinary_Record(base, BinaryValue, func->ReturnValue);
+      failed += check_string("GetValue return type",
+        vtkWrapBinary_String(base, val->TypeName), "T");
+    }
+  }
+
+  /* a method template */
+  func = find_function(base, c, "Convert");
+  if (func == NULL)
+  {
+    fprintf(stderr, "vtkBinaryThing::Convert was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_template(base, func->Template);
+    failed += check_value("Convert parameters", func->NumberOfParameters, 1);
+  }
+
+  /* the enum and its constants */
+  e = find_enum(base, c, "Mode");
+  if (e == NULL)
+  {
+    fprintf(stderr, "vtkBinaryThing::Mode was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_value("Mode item type", e->ItemType, VTK_ENUM_INFO);
+  }
+  for (i = 0; i < 3; i++)
+  {
+    val = find_constant(base, c, modes[i]);
+    if (val == NULL)
+    {
+      fprintf(stderr, "the constant %s was not found\n", modes[i]);
+      failed++;
+      continue;
+    }
+    failed += check_string(modes[i],
+      vtkWrapBinary_String(base, val->TypeName), "Mode");
+    failed += check_value(modes[i],
+      (val->Flags & VTK_BINARY_VALUE_ENUM), VTK_BINARY_VALUE_ENUM);
+  }
+
+  /* the typedefs */
+  val = find_typedef(base, c, "RealType");
+  if (val == NULL)
+  {
+    fprintf(stderr, "vtkBinaryThing::RealType was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_value("RealType", val->Type, VTK_PARSE_DOUBLE);
+  }
+  val = find_typedef(base, c, "Triple");
+  if (val == NULL)
+  {
+    fprintf(stderr, "vtkBinaryThing::Triple was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_value("Triple dimensions", val->NumberOfDimensions, 1);
+    if (val->NumberOfDimensions == 1)
+    {
+      failed += check_string("Triple dimension", vtkWrapBinary_String(base,
+        vtkWrapBinary_Array(base, val->Dimensions)[0]), "3");
+    }
+  }
+
+  /* a property with a Set/Get pair */
+  property = find_property(base, c, "Radius");
+  if (property == NULL)
+  {
+    fprintf(stderr, "the Radius property was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_value("Radius type", property->Type, VTK_PARSE_DOUBLE);
+    failed += check_value("Radius methods", property->PublicMethods,
+      (VTK_METHOD_GET | VTK_METHOD_SET));
+    failed += check_method(base, c, "SetRadius", VTK_METHOD_SET, property);
+    failed += check_method(base, c, "GetRadius", VTK_METHOD_GET, property);
+  }
+
+  /* a property with enum constants */
+  property = find_property(base, c, "Mode");
+  if (property == NULL)
+  {
+    fprintf(stderr, "the Mode property was not found\n");
+    failed++;
+  }
+  else
+  {
+    failed += check_value("Mode enum constants",
+      property->NumberOfEnumConstantNames, 3);
+    names = vtkWrapBinary_Array(base, property->EnumConstantNames);
+    for (i = 0; i < 3 && i < (int)property->NumberOfEnumConstantNames; i++)
+    {
+      failed += check_string("Mode enum constant",
+        vtkWrapBinary_String(base, names[i]), modes[i]);
+    }
+  }
+
+  return failed;
+}
+
+int main(int argc, char *argv[])
+{
+  char *base;
+  char *filename;
+  size_t size, truncatedSize;
+  int failed = 0;
+  FILE *fp;
+
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: %s <binary file>\n", argv[0]);
+    return 1;
+  }
+
+  base = read_file(argv[1], &size);
+  if (base == NULL)
+  {
+    fprintf(stderr, "Could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  if (!vtkWrapBinary_IsValid(base, size))
+  {
+    fprintf(stderr, "%s is not a valid binary file\n", argv[1]);
+    free(base);
+    return 1;
+  }
+
+  failed += check_file(base);
+
+  /* write all but the last few bytes of the string table */
+  filename = (char *)malloc(strlen(argv[1]) + 11);
+  sprintf(filename, "%s.truncated", argv[1]);
+  fp = fopen(filename, "wb");
+  if (fp == NULL || fwrite(base, 1, size - 4, fp) != size - 4)
+  {
+    fprintf(stderr, "Could not write %s\n", filename);
+    failed++;
+  }
+  if (fp)
+  {
+    fclose(fp);
+  }
+  free(base);
+
+  base = read_file(filename, &truncatedSize);
+  if (base == NULL || truncatedSize != size - 4)
+  {
+    fprintf(stderr, "Could not read %s\n", filename);
+    failed++;
+  }
+  else if (vtkWrapBinary_IsValid(base, truncatedSize) ||
+           vtkWrapBinary_IsValid(base, (size_t)8))
+  {
+    fprintf(stderr, "vtkWrapBinary_IsValid() accepted %s\n", filename);
+    failed++;
+  }
+  free(base);
+  free(filename);
+
+  return (failed != 0);
+}
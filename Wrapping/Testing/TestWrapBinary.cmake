@@ -0,0 +1,68 @@
+#
+# TestWrapBinary.cmake - check the file that vtkWrapBinary writes
+#
+# Usage: cmake -DBINARY_EXE=<vtkWrapBinary> -DREADER_EXE=<TestWrapBinary>
+#              -DWORK_DIR=<dir> -P TestWrapBinary.cmake
+#
+# The header has a class template, a method template, an enum, typedefs,
+# and properties.  The TestWrapBinary program walks the file with the
+# macros in vtkWrapBinary.h, and checks a truncated copy of the file.
+
+IF(NOT BINARY_EXE OR NOT READER_EXE OR NOT WORK_DIR)
+  MESSAGE(FATAL_ERROR "BINARY_EXE, READER_EXE and WORK_DIR must be set")
+ENDIF(NOT BINARY_EXE OR NOT READER_EXE OR NOT WORK_DIR)
+
+FILE(REMOVE_RECURSE "${WORK_DIR}")
+FILE(MAKE_DIRECTORY "${WORK_DIR}")
+
+FILE(WRITE "${WORK_DIR}/vtkObject.h"
+  "class vtkObject\n{\npublic:\n"
+  "  static vtkObject *New();\n"
+  "  virtual void Modified();\n};\n")
+FILE(WRITE "${WORK_DIR}/vtkBinaryThing.h"
+  "#include \"vtkObject.h\"\n"
+  "template<class T>\n"
+  "class vtkBinaryTemplate\n{\npublic:\n"
+  "  T GetValue();\n};\n"
+  "class vtkBinaryThing : public vtkObject\n{\npublic:\n"
+  "  static vtkBinaryThing *New();\n"
+  "  typedef double RealType;\n"
+  "  typedef int Triple[3];\n"
+  "  enum Mode { Nearest, Linear, Cubic };\n"
+  "  void SetMode(int m);\n"
+  "  int GetMode();\n"
+  "  void SetModeToNearest();\n"
+  "  void SetModeToLinear();\n"
+  "  void SetModeToCubic();\n"
+  "  void SetRadius(double r);\n"
+  "  double GetRadius();\n"
+  "  template<class T>\n"
+  "  T Convert(T x);\n"
+  "protected:\n"
+  "  vtkBinaryThing();\n"
+  "  ~vtkBinaryThing();\n};\n")
+
+# run vtkWrapBinary and check the file that it writes
+MACRO(CHECK_BINARY)
+  EXECUTE_PROCESS(
+    COMMAND "${BINARY_EXE}" --concrete --vtkobject
+      -o "${WORK_DIR}/vtkBinaryThing.bin" "${WORK_DIR}/vtkBinaryThing.h"
+    RESULT_VARIABLE TMP_RESULT)
+  IF(NOT TMP_RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "vtkWrapBinary failed: ${TMP_RESULT}")
+  ENDIF(NOT TMP_RESULT EQUAL 0)
+  EXECUTE_PROCESS(
+    COMMAND "${READER_EXE}" "${WORK_DIR}/vtkBinaryThing.bin"
+    RESULT_VARIABLE TMP_RESULT)
+  IF(NOT TMP_RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "vtkBinaryThing.bin is not correct")
+  ENDIF(NOT TMP_RESULT EQUAL 0)
+ENDMACRO(CHECK_BINARY)
+
+# the second run finds that the file has not changed
+CHECK_BINARY()
+CHECK_BINARY()
+FILE(GLOB TMP_TEMP_FILES "${WORK_DIR}/*.tmp")
+IF(TMP_TEMP_FILES)
+  MESSAGE(FATAL_ERROR "temporary files were left behind: ${TMP_TEMP_FILES}")
+ENDIF(TMP_TEMP_FILES)
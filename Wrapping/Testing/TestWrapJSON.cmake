@@ -0,0 +1,35 @@
+#
+# TestWrapJSON.cmake - check the output of vtkWrapJSON against a file
+# that was checked by hand
+#
+# Usage: cmake -DJSON_EXE=<vtkWrapJSON> -DSOURCE_DIR=<dir> -DWORK_DIR=<dir>
+#              -P TestWrapJSON.cmake
+#
+# The header vtkJSONThing.h has array sizes that hold quotes, backslashes,
+# and UTF-8 text.  The sizes are attributes, so only the quotes and the
+# backslashes are escaped, and the UTF-8 text must be kept.
+
+IF(NOT JSON_EXE OR NOT SOURCE_DIR OR NOT WORK_DIR)
+  MESSAGE(FATAL_ERROR "JSON_EXE, SOURCE_DIR and WORK_DIR must be set")
+ENDIF(NOT JSON_EXE OR NOT SOURCE_DIR OR NOT WORK_DIR)
+
+FILE(REMOVE_RECURSE "${WORK_DIR}")
+FILE(MAKE_DIRECTORY "${WORK_DIR}")
+
+EXECUTE_PROCESS(
+  COMMAND "${JSON_EXE}" --concrete
+    -o "${WORK_DIR}/vtkJSONThing.json" "${SOURCE_DIR}/vtkJSONThing.h"
+  RESULT_VARIABLE TMP_RESULT)
+IF(NOT TMP_RESULT EQUAL 0)
+  MESSAGE(FATAL_ERROR "vtkWrapJSON failed: ${TMP_RESULT}")
+ENDIF(NOT TMP_RESULT EQUAL 0)
+
+EXECUTE_PROCESS(
+  COMMAND "${CMAKE_COMMAND}" -E compare_files
+    "${WORK_DIR}/vtkJSONThing.json" "${SOURCE_DIR}/vtkJSONThing.json"
+  RESULT_VARIABLE TMP_RESULT)
+IF(NOT TMP_RESULT EQUAL 0)
+  FILE(READ "${WORK_DIR}/vtkJSONThing.json" TMP_JSON)
+  MESSAGE(FATAL_ERROR
+    "vtkJSONThing.json differs from the expected output, got:\n${TMP_JSON}")
+ENDIF(NOT TMP_RESULT EQUAL 0)
@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    TestXMLBundle.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ TestXMLBundle reads every document in a bundle with the bundle reader,
+ and compares it with the file "<dir>/<name>.xml" that vtkWrapXML wrote
+ for the same class without "--bundle".  It is run by TestXMLBundle.cmake.
+
+ Usage: TestXMLBundle <bundle> <dir> <number of entries>
+*/
+
+#include "vtkWrapXMLBundle.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* read a whole file, return NULL on failure */
+static char *read_file(const char *filename, size_t *size)
+{
+  char *text = NULL;
+  size_t n = 0;
+  size_t m = 4096;
+  size_t r;
+  FILE *fp;
+
+  fp = fopen(filename, "rb");
+  if (fp == NULL)
+  {
+    return NULL;
+  }
+
+  text = (char *)malloc(m);
+  while ((r = fread(&text[n], 1, m - n, fp)) > 0)
+  {
+    n += r;
+    if (n == m)
+    {
+      m *= 2;
+      text = (char *)realloc(text, m);
+    }
+  }
+  fclose(fp);
+
+  *size = n;
+  return text;
+}
+
+int main(int argc, char *argv[])
+{
+  XMLBundleInfo *info;
+  const char *name;
+  const char *doc;
+  char *filename;
+  char *text;
+  size_t length, size;
+  int failed = 0;
+  int i, n;
+
+  if (argc != 4)
+  {
+    fprintf(stderr, "Usage: %s <bundle> <dir> <number of entries>\n",
+            argv[0]);
+    return 1;
+  }
+
+  info = vtkWrapXMLBundle_ReadFile(argv[1]);
+  if (info == NULL)
+  {
+    fprintf(stderr, "Could not read the bundle %s\n", argv[1]);
+    return 1;
+  }
+
+  n = atoi(argv[3]);
+  if (info->NumberOfEntries != (unsigned long)n)
+  {
+    fprintf(stderr, "%s has %lu entries, expected %d\n",
+            argv[1], info->NumberOfEntries, n);
+    failed++;
+  }
+
+  for (i = 0; i < (int)info->NumberOfEntries; i++)
+  {
+    name = vtkWrapXMLBundle_GetName(info, i);
+    if (vtkWrapXMLBundle_FindEntry(info, name) != i)
+    {
+      fprintf(stderr, "FindEntry(\"%s\") did not return %d\n", name, i);
+      failed++;
+    }
+
+    /* get the document twice, the second time it is already inflated */
+    doc = vtkWrapXMLBundle_GetDocument(info, i, &length);
+    if (doc == NULL ||
+        vtkWrapXMLBundle_GetDocument(info, i, &length) != doc)
+    {
+      fprintf(stderr, "GetDocument failed for %s\n", name);
+      failed++;
+      continue;
+    }
+
+    filename = (char *)malloc(strlen(argv[2]) + strlen(name) + 6);
+    sprintf(filename, "%s/%s.xml", argv[2], name);
+    text = read_file(filename, &size);
+    if (text == NULL)
+    {
+      fprintf(stderr, "Could not read %s\n", filename);
+      failed++;
+    }
+    else if (size != length || memcmp(text, doc, size) != 0)
+    {
+      fprintf(stderr, "The document for %s differs from %s\n",
+              name, filename);
+      failed++;
+    }
+    free(text);
+    free(filename);
+  }
+
+  if (vtkWrapXMLBundle_FindEntry(info, "vtkNotInTheBundle") != -1 ||
+      vtkWrapXMLBundle_GetName(info, n) != NULL ||
+      vtkWrapXMLBundle_GetDocument(info, -1, &length) != NULL)
+  {
+    fprintf(stderr, "A missing entry was found in %s\n", argv[1]);
+    failed++;
+  }
+
+  vtkWrapXMLBundle_Free(info);
+
+  return (failed != 0);
+}
@@ -0,0 +1,109 @@
+#
+# TestXMLBundle.cmake - check that the documents in an XML bundle are
+# the same as the files that vtkWrapXML writes without "--bundle"
+#
+# Usage: cmake -DXML_EXE=<vtkWrapXML> -DREADER_EXE=<TestXMLBundle>
+#              -DWORK_DIR=<dir> -P TestXMLBundle.cmake
+#
+# A small kit is wrapped one class at a time, and then into a bundle,
+# once with the documents stored and once with them compressed.  The
+# TestXMLBundle program reads every document back from each bundle.
+
+IF(NOT XML_EXE OR NOT READER_EXE OR NOT WORK_DIR)
+  MESSAGE(FATAL_ERROR "XML_EXE, READER_EXE and WORK_DIR must be set")
+ENDIF(NOT XML_EXE OR NOT READER_EXE OR NOT WORK_DIR)
+
+FILE(REMOVE_RECURSE "${WORK_DIR}")
+FILE(MAKE_DIRECTORY "${WORK_DIR}/src" "${WORK_DIR}/xml")
+
+FILE(WRITE "${WORK_DIR}/src/vtkObjectBase.h"
+  "class vtkObjectBase\n{\npublic:\n"
+  "  virtual const char *GetClassName();\n"
+  "  virtual int IsA(const char *name);\n};\n")
+FILE(WRITE "${WORK_DIR}/src/vtkObject.h"
+  "#include \"vtkObjectBase.h\"\n"
+  "class vtkObject : public vtkObjectBase\n{\npublic:\n"
+  "  static vtkObject *New();\n"
+  "  virtual void Modified();\n"
+  "  virtual unsigned long GetMTime();\n};\n")
+
+# a class with many similar methods, so that it is worth compressing
+SET(TMP_METHODS)
+FOREACH(TMP_NAME Origin Spacing Center Extent Bounds Direction Scale)
+  SET(TMP_METHODS "${TMP_METHODS}\
+  /**\n   * Set the ${TMP_NAME} of the data, the default is zero.\n   */\n\
+  void Set${TMP_NAME}(double x, double y, double z);\n\
+  void Set${TMP_NAME}(const double x[3]);\n\
+  double *Get${TMP_NAME}();\n\
+  void Get${TMP_NAME}(double x[3]);\n")
+ENDFOREACH(TMP_NAME)
+FILE(WRITE "${WORK_DIR}/src/vtkImageThing.h"
+  "#include \"vtkObject.h\"\n"
+  "class vtkImageThing : public vtkObject\n{\npublic:\n"
+  "  static vtkImageThing *New();\n"
+  "${TMP_METHODS}"
+  "  enum Mode { Nearest, Linear, Cubic };\n"
+  "  void SetMode(int m);\n"
+  "  int GetMode();\n"
+  "protected:\n"
+  "  vtkImageThing();\n"
+  "  ~vtkImageThing();\n};\n")
+
+# a class with text that must be escaped
+FILE(WRITE "${WORK_DIR}/src/vtkQuoted.h"
+  "#include \"vtkObject.h\"\n"
+  "/**\n * A class with \"quotes\" & <brackets> in its comments.\n */\n"
+  "class vtkQuoted : public vtkObject\n{\npublic:\n"
+  "  void SetText(const char *text = \"a<b & c>d\");\n"
+  "  bool Less(int a = (1 < 2));\n};\n")
+
+SET(TMP_CLASSES vtkObjectBase vtkObject vtkImageThing vtkQuoted)
+LIST(LENGTH TMP_CLASSES TMP_COUNT)
+
+# the options for each class, the same for the bundle and for the files
+SET(TMP_ARGS_vtkObjectBase --abstract --vtkobject)
+SET(TMP_ARGS_vtkObject --concrete --vtkobject)
+SET(TMP_ARGS_vtkImageThing --concrete --vtkobject)
+SET(TMP_ARGS_vtkQuoted --concrete --special)
+
+SET(TMP_BUNDLE_ARGS)
+FOREACH(TMP_CLASS ${TMP_CLASSES})
+  EXECUTE_PROCESS(
+    COMMAND "${XML_EXE}" ${TMP_ARGS_${TMP_CLASS}}
+      -o "${WORK_DIR}/xml/${TMP_CLASS}.xml"
+      "${WORK_DIR}/src/${TMP_CLASS}.h"
+    RESULT_VARIABLE TMP_RESULT)
+  IF(NOT TMP_RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "vtkWrapXML failed for ${TMP_CLASS}: ${TMP_RESULT}")
+  ENDIF(NOT TMP_RESULT EQUAL 0)
+  SET(TMP_BUNDLE_ARGS ${TMP_BUNDLE_ARGS} ${TMP_ARGS_${TMP_CLASS}}
+    "${WORK_DIR}/src/${TMP_CLASS}.h")
+ENDFOREACH(TMP_CLASS)
+
+# write a bundle and read it back
+MACRO(CHECK_BUNDLE TMP_BUNDLE)
+  EXECUTE_PROCESS(
+    COMMAND "${XML_EXE}" --bundle ${ARGN} -o "${WORK_DIR}/${TMP_BUNDLE}"
+      ${TMP_BUNDLE_ARGS}
+    RESULT_VARIABLE TMP_RESULT)
+  IF(NOT TMP_RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "vtkWrapXML --bundle ${ARGN} failed: ${TMP_RESULT}")
+  ENDIF(NOT TMP_RESULT EQUAL 0)
+  EXECUTE_PROCESS(
+    COMMAND "${READER_EXE}" "${WORK_DIR}/${TMP_BUNDLE}"
+      "${WORK_DIR}/xml" ${TMP_COUNT}
+    RESULT_VARIABLE TMP_RESULT)
+  IF(NOT TMP_RESULT EQUAL 0)
+    MESSAGE(FATAL_ERROR "${TMP_BUNDLE} does not match the XML files")
+  ENDIF(NOT TMP_RESULT EQUAL 0)
+  FILE(READ "${WORK_DIR}/${TMP_BUNDLE}" TMP_HEX HEX)
+  STRING(LENGTH "${TMP_HEX}" TMP_SIZE_${TMP_BUNDLE})
+ENDMACRO(CHECK_BUNDLE)
+
+CHECK_BUNDLE(stored.xmlb)
+CHECK_BUNDLE(compressed.xmlb --compress)
+
+# make sure that some of the documents were really compressed
+IF(NOT TMP_SIZE_compressed.xmlb LESS TMP_SIZE_stored.xmlb)
+  MESSAGE(FATAL_ERROR "no documents were compressed in compressed.xmlb")
+ENDIF(NOT TMP_SIZE_compressed.xmlb LESS TMP_SIZE_stored.xmlb)
@@ -0,0 +1,11 @@
+/**
+ * A class for TestWrapJSON, the array sizes are written as JSON
+ * attributes and they hold quotes, backslashes, and UTF-8 text.
+ */
+class vtkJSONThing
+{
+public:
+  void SetText(const char t[sizeof("café \"q\" \\ x")]);
+  int Table[2][sizeof("€")];
+  double Values[3];
+};
@@ -0,0 +1,731 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    WrapVTKBench.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ WrapVTKBench generates synthetic VTK-style headers and measures how
+ quickly they can be wrapped.  No VTK installation is needed.
+
+ Usage: WrapVTKBench [options]
+
+ -d <dir>            directory for the generated headers
+ -r <count>          number of repetitions, the best time is reported
+ --target <s>=<MB/s> exit with an error if stage "s" is slower than this
+
+ The headers come in five kinds (many properties, nested templates,
+ heavy macro use, long doxygen comments, and many overloads), and in
+ three sizes.  The stages that are timed for each header are:
+
+ parse       vtkParse_ParseFile()
+ properties  vtkParseProperties_Create()
+ merge       vtkParseMerge_MergeSuperClasses()
+ xml         vtkParse_ParseHeaderFile() and vtkWrapXML_WriteFile(),
+             which are what vtkWrapXML_Run() does for each header
+
+ The xml stage runs in-process, so it does not include the startup of
+ the vtkWrapXML program.
+*/
+
+#include "vtkParse.h"
+#include "vtkParseData.h"
+#include "vtkParseMain.h"
+#include "vtkParseMerge.h"
+#include "vtkParseProperties.h"
+#include "vtkParseTiming.h"
+#include "vtkWrapXMLWriter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <direct.h>
+#define bench_mkdir(d) _mkdir(d)
+#else
+#define bench_mkdir(d) mkdir(d, 0777)
+#endif
+
+/* the kinds of headers that are generated */
+enum
+{
+  BENCH_PROPERTIES,
+  BENCH_TEMPLATES,
+  BENCH_MACROS,
+  BENCH_COMMENTS,
+  BENCH_OVERLOADS,
+  BENCH_NUMBER_OF_KINDS
+};
+
+static const char *bench_kind_names[BENCH_NUMBER_OF_KINDS] = {
+  "Properties",
+  "Templates",
+  "Macros",
+  "Comments",
+  "Overloads"
+};
+
+/* the sizes of the headers, in members per class */
+#define BENCH_NUMBER_OF_SIZES 3
+static const int bench_sizes[BENCH_NUMBER_OF_SIZES] = { 10, 100, 1000 };
+
+/* the stages that are timed */
+enum
+{
+  BENCH_PARSE,
+  BENCH_PROPERTIES_STAGE,
+  BENCH_MERGE,
+  BENCH_XML,
+  BENCH_NUMBER_OF_STAGES
+};
+
+static const char *bench_stage_names[BENCH_NUMBER_OF_STAGES] = {
+  "parse",
+  "properties",
+  "merge",
+  "xml"
+};
+
+/* parameter types that are used for generating methods */
+#define BENCH_NUMBER_OF_TYPES 8
+static const char *bench_types[BENCH_NUMBER_OF_TYPES] = {
+  "int",
+  "double",
+  "float",
+  "const char *",
+  "vtkIdType",
+  "vtkBenchObject *",
+  "const double *",
+  "unsigned short"
+};
+
+/* a generated header file */
+typedef struct _BenchHeader
+{
+  char ClassName[64];
+  char *FileName;
+  size_t Bytes;
+  double Times[BENCH_NUMBER_OF_STAGES];
+} BenchHeader;
+
+/* Print the usage */
+static void bench_usage(FILE *fp)
+{
+  fprintf(fp,
+    "Usage: WrapVTKBench [options]\n"
+    "  -d <dir>             directory for the generated headers\n"
+    "  -r <count>           number of repetitions\n"
+    "  --target <s>=<MB/s>  required throughput for stage \"s\"\n");
+}
+
+/* Make the path "dir/name.ext" in a new string */
+static char *bench_path(const char *dir, const char *name, const char *ext)
+{
+  char *path;
+
+  path = (char *)malloc(strlen(dir) + strlen(name) + strlen(ext) + 2);
+  sprintf(path, "%s/%s%s", dir, name, ext);
+
+  return path;
+}
+
+/* Open a file for writing, or exit */
+static FILE *bench_open(const char *path)
+{
+  FILE *fp;
+
+  fp = fopen(path, "w");
+  if (!fp)
+  {
+    fprintf(stderr, "WrapVTKBench: cannot write %s\n", path);
+    exit(1);
+  }
+
+  return fp;
+}
+
+/* Write the two base classes that the other classes derive from */
+static void bench_write_base_classes(const char *dir)
+{
+  char *path;
+  FILE *fp;
+  int i;
+
+  path = bench_path(dir, "vtkBenchObjectBase", ".h");
+  fp = bench_open(path);
+  free(path);
+  fprintf(fp,
+    "#ifndef vtkBenchObjectBase_h\n"
+    "#define vtkBenchObjectBase_h\n"
+    "\n"
+    "/**\n"
+    " * @class vtkBenchObjectBase\n"
+    " * @brief The root of the synthetic class hierarchy.\n"
+    " */\n"
+    "class vtkBenchObjectBase\n"
+    "{\n"
+    "public:\n"
+    "  const char *GetClassName() const;\n"
+    "  static int IsTypeOf(const char *name);\n"
+    "  virtual int IsA(const char *name);\n"
+    "  virtual void Delete();\n"
+    "  void Register(vtkBenchObjectBase *o);\n"
+    "  virtual void UnRegister(vtkBenchObjectBase *o);\n"
+    "  int GetReferenceCount();\n"
+    "  void SetReferenceCount(int count);\n"
+    "protected:\n"
+    "  vtkBenchObjectBase();\n"
+    "  virtual ~vtkBenchObjectBase();\n"
+    "};\n"
+    "\n"
+    "#endif\n");
+  fclose(fp);
+
+  path = bench_path(dir, "vtkBenchObject", ".h");
+  fp = bench_open(path);
+  free(path);
+  fprintf(fp,
+    "#ifndef vtkBenchObject_h\n"
+    "#define vtkBenchObject_h\n"
+    "\n"
+    "#include \"vtkBenchObjectBase.h\"\n"
+    "\n"
+    "#define VTK_BENCH_MAX_VALUE 1024\n"
+    "#define vtkBenchDeclareMacro(name, type) \\\n"
+    "  virtual void Set##name(type _arg); \\\n"
+    "  virtual type Get##name();\n"
+    "\n"
+    "template<class T> class vtkBenchArray\n"
+    "{\n"
+    "public:\n"
+    "  typedef T ValueType;\n"
+    "  T GetValue(vtkIdType i);\n"
+    "  void SetValue(vtkIdType i, T v);\n"
+    "};\n"
+    "\n"
+    "template<class K, class V> class vtkBenchMap\n"
+    "{\n"
+    "public:\n"
+    "  V Find(const K& key);\n"
+    "  void Insert(const K& key, const V& value);\n"
+    "};\n"
+    "\n"
+    "/**\n"
+    " * @class vtkBenchObject\n"
+    " * @brief The superclass of all of the synthetic classes.\n"
+    " */\n"
+    "class vtkBenchObject : public vtkBenchObjectBase\n"
+    "{\n"
+    "public:\n"
+    "  static vtkBenchObject *New();\n"
+    "  vtkTypeMacro(vtkBenchObject, vtkBenchObjectBase);\n"
+    "  virtual void DebugOn();\n"
+    "  virtual void DebugOff();\n"
+    "  bool GetDebug();\n"
+    "  void SetDebug(bool debugFlag);\n"
+    "  virtual void Modified();\n"
+    "  virtual unsigned long GetMTime();\n");
+  for (i = 0; i < 20; i++)
+  {
+    fprintf(fp,
+      "  virtual void Update%d();\n"
+      "  virtual int GetStatus%d(int which) const;\n", i, i);
+  }
+  fprintf(fp,
+    "protected:\n"
+    "  vtkBenchObject();\n"
+    "  ~vtkBenchObject();\n"
+    "};\n"
+    "\n"
+    "#endif\n");
+  fclose(fp);
+}
+
+/* Write many set/get properties */
+static void bench_write_properties(FILE *fp, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    fprintf(fp,
+      "  // Description:\n"
+      "  // Set/Get property number %d.\n", i);
+    switch (i % 5)
+    {
+      case 0:
+        fprintf(fp,
+          "  vtkSetMacro(Value%d, double);\n"
+          "  vtkGetMacro(Value%d, double);\n", i, i);
+        break;
+      case 1:
+        fprintf(fp,
+          "  vtkSetClampMacro(Level%d, int, 0, %d);\n"
+          "  vtkGetMacro(Level%d, int);\n", i, i, i);
+        break;
+      case 2:
+        fprintf(fp,
+          "  vtkSetMacro(Flag%d, int);\n"
+          "  vtkGetMacro(Flag%d, int);\n"
+          "  vtkBooleanMacro(Flag%d, int);\n", i, i, i);
+        break;
+      case 3:
+        fprintf(fp,
+          "  vtkSetVector3Macro(Point%d, double);\n"
+          "  vtkGetVector3Macro(Point%d, double);\n", i, i);
+        break;
+      case 4:
+        fprintf(fp,
+          "  vtkSetStringMacro(Name%d);\n"
+          "  vtkGetStringMacro(Name%d);\n", i, i);
+        break;
+    }
+  }
+}
+
+/* Write a nested template type with the given depth */
+static void bench_write_nested_type(FILE *fp, int depth)
+{
+  if (depth == 0)
+  {
+    fprintf(fp, "double");
+  }
+  else if (depth % 2 == 0)
+  {
+    fprintf(fp, "vtkBenchArray< ");
+    bench_write_nested_type(fp, depth - 1);
+    fprintf(fp, " >");
+  }
+  else
+  {
+    fprintf(fp, "vtkBenchMap< int, ");
+    bench_write_nested_type(fp, depth - 1);
+    fprintf(fp, " >");
+  }
+}
+
+/* Write methods with deeply nested template types */
+static void bench_write_templates(FILE *fp, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    if (i % 4 == 3)
+    {
+      fprintf(fp,
+        "  template<class T, int N> void Fill%d(T value, const T (&a)[N]);\n",
+        i);
+    }
+    else
+    {
+      fprintf(fp, "  void SetTable%d(const ", i);
+      bench_write_nested_type(fp, 1 + i % 8);
+      fprintf(fp, "& table);\n");
+    }
+  }
+}
+
+/* Write methods that are declared through macros */
+static void bench_write_macros(FILE *fp, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    fprintf(fp,
+      "#define VTK_BENCH_VALUE_%d (%d + VTK_BENCH_MAX_VALUE)\n", i, i);
+  }
+  fprintf(fp, "\n");
+  for (i = 0; i < n; i++)
+  {
+    fprintf(fp,
+      "  vtkBenchDeclareMacro(Item%d, %s)\n"
+      "  static const int Limit%d = VTK_BENCH_VALUE_%d;\n",
+      i, bench_types[i % BENCH_NUMBER_OF_TYPES], i, i);
+  }
+}
+
+/* Write methods with long doxygen comments */
+static void bench_write_comments(FILE *fp, int n)
+{
+  int i, j;
+
+  for (i = 0; i < n; i++)
+  {
+    fprintf(fp,
+      "  /**\n"
+      "   * Compute result number %d for the given input.\n"
+      "   *\n", i);
+    for (j = 0; j < 12; j++)
+    {
+      fprintf(fp,
+        "   * This is line %d of a long description that uses <b>markup</b>,\n"
+        "   * \"quotes\", & ampersands, so that escaping is exercised.\n", j);
+    }
+    fprintf(fp,
+      "   *\n"
+      "   * @param input the value to use for the computation\n"
+      "   * @param count the number of times to apply it\n"
+      "   * @return the result of the computation\n"
+      "   * @sa vtkBenchObject\n"
+      "   */\n"
+      "  double Compute%d(double input, int count);\n", i);
+  }
+}
+
+/* Write many overloads of the same methods */
+static void bench_write_overloads(FILE *fp, int n)
+{
+  int i, j, k, m;
+
+  for (i = 0; i < n; i++)
+  {
+    /* the digits of "i" in base 8 select the parameter types */
+    fprintf(fp, "  %svoid %s(", (i % 3 == 0 ? "virtual " : ""),
+            (i % 2 == 0 ? "SetInput" : "AddInput"));
+    k = i;
+    m = 1 + (i % 3);
+    for (j = 0; j < m; j++)
+    {
+      fprintf(fp, "%s%s", (j == 0 ? "" : ", "),
+              bench_types[k % BENCH_NUMBER_OF_TYPES]);
+      k /= BENCH_NUMBER_OF_TYPES;
+    }
+    fprintf(fp, ")%s;\n", (i % 5 == 4 ? " const" : ""));
+  }
+}
+
+/* Write one synthetic header, return its size in bytes */
+static size_t bench_write_header(
+  const char *dir, int kind, int size, BenchHeader *header)
+{
+  FILE *fp;
+  long bytes;
+  const char *name;
+
+  sprintf(header->ClassName, "vtkBench%s%d", bench_kind_names[kind], size);
+  name = header->ClassName;
+
+  header->FileName = bench_path(dir, name, ".h");
+  fp = bench_open(header->FileName);
+
+  fprintf(fp,
+    "#ifndef %s_h\n"
+    "#define %s_h\n"
+    "\n"
+    "#include \"vtkBenchObject.h\"\n"
+    "\n"
+    "/**\n"
+    " * @class %s\n"
+    " * @brief A synthetic class with %d members.\n"
+    " */\n"
+    "class %s : public vtkBenchObject\n"
+    "{\n"
+    "public:\n"
+    "  static %s *New();\n"
+    "  vtkTypeMacro(%s, vtkBenchObject);\n",
+    name, name, name, size, name, name, name);
+
+  switch (kind)
+  {
+    case BENCH_PROPERTIES:
+      bench_write_properties(fp, size);
+      break;
+    case BENCH_TEMPLATES:
+      bench_write_templates(fp, size);
+      break;
+    case BENCH_MACROS:
+      bench_write_macros(fp, size);
+      break;
+    case BENCH_COMMENTS:
+      bench_write_comments(fp, size);
+      break;
+    case BENCH_OVERLOADS:
+      bench_write_overloads(fp, size);
+      break;
+  }
+
+  fprintf(fp,
+    "protected:\n"
+    "  %s();\n"
+    "  ~%s();\n"
+    "};\n"
+    "\n"
+    "#endif\n",
+    name, name);
+
+  bytes = ftell(fp);
+  fclose(fp);
+
+  header->Bytes = (size_t)bytes;
+  return header->Bytes;
+}
+
+/* Write the hierarchy file that is needed for merging */
+static void bench_write_hierarchy(
+  const char *path, BenchHeader *headers, int n)
+{
+  FILE *fp;
+  int i;
+
+  fp = bench_open(path);
+  fprintf(fp,
+    "vtkBenchArray<T> ; vtkBenchObject.h ; WrapVTKBench\n"
+    "vtkBenchMap<K,V> ; vtkBenchObject.h ; WrapVTKBench\n"
+    "vtkBenchObject : vtkBenchObjectBase ; vtkBenchObject.h ; WrapVTKBench\n"
+    "vtkBenchObjectBase ; vtkBenchObjectBase.h ; WrapVTKBench\n");
+  for (i = 0; i < n; i++)
+  {
+    fprintf(fp, "%s : vtkBenchObject ; %s.h ; WrapVTKBench\n",
+            headers[i].ClassName, headers[i].ClassName);
+  }
+  fclose(fp);
+}
+
+/* Parse a header file, or exit if it cannot be parsed */
+static FileInfo *bench_parse(const char *filename)
+{
+  FileInfo *data;
+  FILE *fp;
+
+  fp = fopen(filename, "r");
+  if (!fp)
+  {
+    fprintf(stderr, "WrapVTKBench: cannot read %s\n", filename);
+    exit(1);
+  }
+
+  data = vtkParse_ParseFile(filename, fp, stderr);
+  fclose(fp);
+
+  if (!data || !data->MainClass)
+  {
+    fprintf(stderr, "WrapVTKBench: cannot parse %s\n", filename);
+    exit(1);
+  }
+
+  return data;
+}
+
+/* Time one stage for a header, return the time in seconds */
+static double bench_time_stage(
+  int stage, BenchHeader *header, const char *dir)
+{
+  FileInfo *data = NULL;
+  ClassProperties *properties;
+  MergeInfo *merge;
+  char *outname;
+  double t = 0.0;
+
+  if (stage != BENCH_PARSE && stage != BENCH_XML)
+  {
+    data = bench_parse(header->FileName);
+  }
+
+  switch (stage)
+  {
+    case BENCH_PARSE:
+      t = vtkParse_WallTime();
+      data = bench_parse(header->FileName);
+      t = vtkParse_WallTime() - t;
+      break;
+    case BENCH_PROPERTIES_STAGE:
+      t = vtkParse_WallTime();
+      properties = vtkParseProperties_Create(data->MainClass);
+      t = vtkParse_WallTime() - t;
+      vtkParseProperties_Free(properties);
+      break;
+    case BENCH_MERGE:
+      t = vtkParse_WallTime();
+      merge = vtkParseMerge_MergeSuperClasses(
+        data, data->Contents, data->MainClass);
+      t = vtkParse_WallTime() - t;
+      if (merge)
+      {
+        vtkParseMerge_FreeMergeInfo(merge);
+      }
+      break;
+    case BENCH_XML:
+      outname = bench_path(dir, header->ClassName, ".xml");
+      t = vtkParse_WallTime();
+      data = vtkParse_ParseHeaderFile(header->FileName);
+      if (!data || !vtkWrapXML_WriteFile(data, outname, VTKXML_FORMAT_XML))
+      {
+        fprintf(stderr, "WrapVTKBench: cannot wrap %s\n", header->FileName);
+        exit(1);
+      }
+      t = vtkParse_WallTime() - t;
+      free(outname);
+      break;
+  }
+
+  if (data)
+  {
+    vtkParse_Free(data);
+  }
+
+  return t;
+}
+
+int main(int argc, char *argv[])
+{
+  const char *dir = "WrapVTKBench.tmp";
+  char *hierarchy;
+  double targets[BENCH_NUMBER_OF_STAGES];
+  double totals[BENCH_NUMBER_OF_STAGES];
+  double t, mb;
+  size_t bytes = 0;
+  int nrep = 5;
+  int nheaders = BENCH_NUMBER_OF_KINDS*BENCH_NUMBER_OF_SIZES;
+  int failed = 0;
+  BenchHeader headers[BENCH_NUMBER_OF_KINDS*BENCH_NUMBER_OF_SIZES];
+  OptionInfo *options;
+  int i, j, k;
+
+  for (j = 0; j < BENCH_NUMBER_OF_STAGES; j++)
+  {
+    targets[j] = 0.0;
+    totals[j] = 0.0;
+  }
+
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+    {
+      dir = argv[++i];
+    }
+    else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+    {
+      nrep = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--target") == 0 && i+1 < argc)
+    {
+      const char *cp = argv[++i];
+      size_t l = strcspn(cp, "=");
+      for (j = 0; j < BENCH_NUMBER_OF_STAGES; j++)
+      {
+        if (strlen(bench_stage_names[j]) == l &&
+            strncmp(bench_stage_names[j], cp, l) == 0 && cp[l] == '=')
+        {
+          targets[j] = atof(&cp[l+1]);
+          break;
+        }
+      }
+      if (j == BENCH_NUMBER_OF_STAGES)
+      {
+        bench_usage(stderr);
+        return 1;
+      }
+    }
+    else
+    {
+      bench_usage(stderr);
+      return (strcmp(argv[i], "--help") == 0 ? 0 : 1);
+    }
+  }
+
+  if (nrep < 1)
+  {
+    nrep = 1;
+  }
+
+  /* generate the headers */
+  if (bench_mkdir(dir) != 0 && errno != EEXIST)
+  {
+    fprintf(stderr, "WrapVTKBench: cannot create directory %s\n", dir);
+    return 1;
+  }
+  bench_write_base_classes(dir);
+  for (i = 0; i < BENCH_NUMBER_OF_KINDS; i++)
+  {
+    for (j = 0; j < BENCH_NUMBER_OF_SIZES; j++)
+    {
+      bytes += bench_write_header(
+        dir, i, bench_sizes[j], &headers[i*BENCH_NUMBER_OF_SIZES + j]);
+    }
+  }
+  hierarchy = bench_path(dir, "WrapVTKBenchHierarchy", ".txt");
+  bench_write_hierarchy(hierarchy, headers, nheaders);
+
+  /* the merge needs the hierarchy file, and the header directory */
+  vtkParse_IncludeDirectory(dir);
+  options = vtkParse_GetCommandLineOptions();
+  options->HierarchyFileName = hierarchy;
+  options->HintFileName = NULL;
+
+  /* the xml stage parses the headers in the same way as vtkWrapXML */
+  vtkParse_DefineMacro("__VTK_WRAP__", 0);
+  vtkParse_DefineMacro("__VTK_WRAP_XML__", 0);
+
+  /* time all of the stages, keeping the best time for each */
+  for (i = 0; i < nheaders; i++)
+  {
+    for (j = 0; j < BENCH_NUMBER_OF_STAGES; j++)
+    {
+      headers[i].Times[j] = 0.0;
+      for (k = 0; k < nrep; k++)
+      {
+        t = bench_time_stage(j, &headers[i], dir);
+        if (k == 0 || t < headers[i].Times[j])
+        {
+          headers[i].Times[j] = t;
+        }
+      }
+      totals[j] += headers[i].Times[j];
+    }
+  }
+
+  /* print the time for each header */
+  fprintf(stdout, "%-28s %10s", "header", "bytes");
+  for (j = 0; j < BENCH_NUMBER_OF_STAGES; j++)
+  {
+    fprintf(stdout, " %12s", bench_stage_names[j]);
+  }
+  fprintf(stdout, "\n");
+  for (i = 0; i < nheaders; i++)
+  {
+    fprintf(stdout, "%-28s %10lu", headers[i].ClassName,
+            (unsigned long)headers[i].Bytes);
+    for (j = 0; j < BENCH_NUMBER_OF_STAGES; j++)
+    {
+      fprintf(stdout, " %9.3f ms", 1e3*headers[i].Times[j]);
+    }
+    fprintf(stdout, "\n");
+  }
+
+  /* print the throughput for each stage */
+  mb = 1e-6*bytes;
+  fprintf(stdout, "\n%-12s %12s %12s %12s\n",
+          "stage", "time (ms)", "headers/s", "MB/s");
+  for (j = 0; j < BENCH_NUMBER_OF_STAGES; j++)
+  {
+    t = totals[j];
+    fprintf(stdout, "%-12s %12.3f %12.1f %12.3f",
+            bench_stage_names[j], 1e3*t, (t > 0 ? nheaders/t : 0.0),
+            (t > 0 ? mb/t : 0.0));
+    if (targets[j] > 0 && (t <= 0 || mb/t < targets[j]))
+    {
+      fprintf(stdout, "  below target of %g MB/s", targets[j]);
+      failed = 1;
+    }
+    fprintf(stdout, "\n");
+  }
+
+  for (i = 0; i < nheaders; i++)
+  {
+    free(headers[i].FileName);
+  }
+  free(hierarchy);
+
+  return failed;
+}
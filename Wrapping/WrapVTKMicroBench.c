@@ -0,0 +1,602 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    WrapVTKMicroBench.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ WrapVTKMicroBench times the primitives that the parser and the wrapper
+ tools depend on: the tokenizer, the preprocessor's expression evaluator
+ and macro expander, hierarchy lookups, "is type of" checks, typedef
+ expansion, and signature comparison.
+
+ Usage: WrapVTKMicroBench [options] [name...]
+
+ -w <count>   number of warm-up samples, which are discarded
+ -r <count>   number of timed samples
+ -d <dir>     directory for the temporary hierarchy file
+ --json       print one JSON object per benchmark
+
+ If names are given, then only the benchmarks with those names are run.
+ Each sample performs a fixed batch of operations, and the reported
+ times are in nanoseconds per operation.  The JSON output is meant to be
+ saved as a baseline and compared against later runs by a script.
+*/
+
+#include "vtkParse.h"
+#include "vtkParseData.h"
+#include "vtkParseExtras.h"
+#include "vtkParseHierarchy.h"
+#include "vtkParsePreprocess.h"
+#include "vtkParseString.h"
+#include "vtkParseTiming.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the state shared by the benchmarks */
+typedef struct _MicroBenchState
+{
+  char *Text;                   /* a large buffer of source code */
+  size_t TextLength;
+  StringCache Strings;          /* strings used by the preprocessor */
+  PreprocessInfo *Preprocessor; /* a preprocessor with VTK macros */
+  HierarchyInfo *Hierarchy;     /* a hierarchy with many classes */
+  FileInfo *File;               /* a class with many overloads */
+} MicroBenchState;
+
+/* a benchmark, which does "ops" operations each time it is run */
+typedef struct _MicroBench
+{
+  const char *Name;
+  unsigned long (*Run)(MicroBenchState *state);
+} MicroBench;
+
+/* a chunk of VTK-style source, repeated to make the tokenizer input */
+static const char *microbench_source =
+  "/**\n"
+  " * Set the input data for the given port and connection.\n"
+  " */\n"
+  "template<class T>\n"
+  "void vtkImageReslice::SetInputData(int port, vtkDataObject *input)\n"
+  "{\n"
+  "  static const double tolerance = 1.0e-12;\n"
+  "  vtkIdType numPts = this->GetNumberOfPoints() << 2;\n"
+  "  for (int i = 0; i < port && i != 0x7fffffff; ++i)\n"
+  "  {\n"
+  "    this->Values[i] = (numPts > 0 ? 'c' : L'\\n');\n"
+  "    const char *name = \"a \\\"quoted\\\" string\";\n"
+  "  }\n"
+  "#if defined(VTK_USE_64BIT_IDS) && VTK_SIZEOF_LONG_LONG == 8\n"
+  "  this->Modified();\n"
+  "#endif\n"
+  "}\n";
+
+/* realistic "#if" expressions */
+static const char *microbench_expressions[] = {
+  "defined(VTK_USE_64BIT_IDS) && VTK_SIZEOF_LONG_LONG == 8",
+  "VTK_MAJOR_VERSION > 5 || (VTK_MAJOR_VERSION == 5 && "
+    "VTK_MINOR_VERSION >= 10)",
+  "!defined(VTK_LEGACY_REMOVE)",
+  "defined(_MSC_VER) && _MSC_VER >= 1400",
+  "VTK_SIZEOF_VOID_P == 8 && !defined(__CUDACC__)",
+  "(VTK_TYPE_UINT32_MAX >> 16) + 0x10 - 'a' * 2 > 0",
+  "defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && "
+    "__GNUC_MINOR__ >= 2))",
+  "VTK_BUILD_SHARED_LIBS + 0 != 0",
+  NULL
+};
+
+/* the macro calls to expand */
+static const char *microbench_macro_args[] = {
+  "(x)",
+  "(vtkBenchInner(1), vtkBenchMiddle(2, 3))",
+  "(vtkBenchMiddle(vtkBenchInner(a), vtkBenchInner(b)), c)",
+  NULL
+};
+
+/* the names that are looked up in the hierarchy */
+static const char *microbench_plain_names[] = {
+  "vtkBenchClass0",
+  "vtkBenchClass1234",
+  "vtkBenchClass4999",
+  "vtkBenchClassMissing",
+  "vtkIdType",
+  NULL
+};
+
+static const char *microbench_templated_names[] = {
+  "vtkBenchArray<double>",
+  "vtkBenchMap<int,vtkBenchArray<float> >",
+  "vtkBenchClass42::Mode",
+  "vtkBenchClass4000::Mode",
+  "vtkBenchArray<vtkBenchArray<int> >",
+  NULL
+};
+
+/* Benchmark the tokenizer over a large buffer */
+static unsigned long microbench_tokenizer(MicroBenchState *state)
+{
+  StringTokenizer tokens;
+  unsigned long n = 0;
+
+  vtkParse_InitTokenizer(&tokens, state->Text, WS_DEFAULT);
+  do
+  {
+    n++;
+  }
+  while (vtkParse_NextToken(&tokens));
+
+  return n;
+}
+
+/* Benchmark the evaluation of "#if" expressions */
+static unsigned long microbench_evaluate(MicroBenchState *state)
+{
+  preproc_int_t val;
+  int is_unsigned;
+  unsigned long n = 0;
+  int i, j;
+
+  for (j = 0; j < 100; j++)
+  {
+    for (i = 0; microbench_expressions[i]; i++)
+    {
+      vtkParsePreprocess_EvaluateExpression(
+        state->Preprocessor, microbench_expressions[i], &val, &is_unsigned);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* Benchmark the expansion of nested function-like macros */
+static unsigned long microbench_expand(MicroBenchState *state)
+{
+  MacroInfo *macro;
+  const char *text;
+  unsigned long n = 0;
+  int i, j;
+
+  macro = vtkParsePreprocess_GetMacro(state->Preprocessor, "vtkBenchOuter");
+  for (j = 0; j < 100; j++)
+  {
+    for (i = 0; microbench_macro_args[i]; i++)
+    {
+      text = vtkParsePreprocess_ExpandMacro(
+        state->Preprocessor, macro, microbench_macro_args[i]);
+      vtkParsePreprocess_FreeMacroExpansion(state->Preprocessor, macro, text);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* Benchmark hierarchy lookups of plain names */
+static unsigned long microbench_find_plain(MicroBenchState *state)
+{
+  unsigned long n = 0;
+  int i, j;
+
+  for (j = 0; j < 100; j++)
+  {
+    for (i = 0; microbench_plain_names[i]; i++)
+    {
+      vtkParseHierarchy_FindEntry(state->Hierarchy, microbench_plain_names[i]);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* Benchmark hierarchy lookups of templated and scoped names */
+static unsigned long microbench_find_templated(MicroBenchState *state)
+{
+  unsigned long n = 0;
+  int i, j;
+
+  for (j = 0; j < 100; j++)
+  {
+    for (i = 0; microbench_templated_names[i]; i++)
+    {
+      vtkParseHierarchy_FindEntry(
+        state->Hierarchy, microbench_templated_names[i]);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* the classes and base classes for the "is type of" checks */
+static const char *microbench_derived_names[] = {
+  "vtkBenchDeep19",
+  "vtkBenchClass1234",
+  NULL
+};
+
+static const char *microbench_base_names[] = {
+  "vtkObject",
+  "vtkBenchDeep3",
+  "vtkBenchClass0",
+  "vtkBenchClassMissing",
+  NULL
+};
+
+/* Benchmark checks of whether one class is derived from another */
+static unsigned long microbench_is_type_of(MicroBenchState *state)
+{
+  HierarchyEntry *entries[2];
+  unsigned long n = 0;
+  int i, j, k;
+
+  for (i = 0; microbench_derived_names[i]; i++)
+  {
+    entries[i] = vtkParseHierarchy_FindEntry(
+      state->Hierarchy, microbench_derived_names[i]);
+  }
+
+  for (k = 0; k < 100; k++)
+  {
+    for (i = 0; microbench_derived_names[i]; i++)
+    {
+      for (j = 0; microbench_base_names[j]; j++)
+      {
+        vtkParseHierarchy_IsTypeOf(
+          state->Hierarchy, entries[i], microbench_base_names[j]);
+        n++;
+      }
+    }
+  }
+
+  return n;
+}
+
+/* the inherited types that are expanded in vtkBenchDeep19 */
+static const char *microbench_typedef_names[] = {
+  "ValueType",
+  "PointerType",
+  "vtkIdType",
+  "vtkBenchClassMissing",
+  NULL
+};
+
+/* Benchmark expansion of typedefs through the class hierarchy */
+static unsigned long microbench_expand_typedefs(MicroBenchState *state)
+{
+  ValueInfo val;
+  unsigned long n = 0;
+  int i, j;
+
+  for (j = 0; j < 100; j++)
+  {
+    for (i = 0; microbench_typedef_names[i]; i++)
+    {
+      vtkParse_InitValue(&val);
+      val.Type = VTK_PARSE_UNKNOWN;
+      val.TypeName = microbench_typedef_names[i];
+      vtkParseHierarchy_ExpandTypedefsInValue(
+        state->Hierarchy, &val, &state->Strings, "vtkBenchDeep19");
+      free((char **)val.Dimensions);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* Benchmark signature comparison between all pairs of methods */
+static unsigned long microbench_compare(MicroBenchState *state)
+{
+  ClassInfo *cls = state->File->MainClass;
+  unsigned long n = 0;
+  unsigned long i, j;
+
+  for (i = 0; i < cls->NumberOfFunctions; i++)
+  {
+    for (j = 0; j < cls->NumberOfFunctions; j++)
+    {
+      vtkParse_CompareFunctionSignature(cls->Functions[i], cls->Functions[j]);
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* the list of all the benchmarks */
+static const MicroBench microbench_list[] = {
+  { "tokenizer", microbench_tokenizer },
+  { "evaluate_expression", microbench_evaluate },
+  { "expand_macro", microbench_expand },
+  { "find_entry_plain", microbench_find_plain },
+  { "find_entry_templated", microbench_find_templated },
+  { "is_type_of", microbench_is_type_of },
+  { "expand_typedefs", microbench_expand_typedefs },
+  { "compare_signature", microbench_compare },
+  { NULL, NULL }
+};
+
+/* Set up the state for the benchmarks */
+static void microbench_setup(MicroBenchState *state, const char *dir)
+{
+  static const char *types[] = {
+    "int", "double", "float", "const char *", "vtkIdType",
+    "vtkObject *", "const double *", "unsigned short" };
+  char path[1024];
+  char *text;
+  size_t n, m, l;
+  FILE *fp;
+  int i, j, k;
+
+  /* make a buffer of about one megabyte */
+  l = strlen(microbench_source);
+  m = (1024*1024)/l + 1;
+  state->TextLength = l*m;
+  state->Text = (char *)malloc(state->TextLength + 1);
+  for (n = 0; n < m; n++)
+  {
+    memcpy(&state->Text[n*l], microbench_source, l);
+  }
+  state->Text[state->TextLength] = '\0';
+
+  /* make a preprocessor with the macros that VTK usually has */
+  state->Preprocessor = (PreprocessInfo *)malloc(sizeof(PreprocessInfo));
+  vtkParsePreprocess_Init(state->Preprocessor, NULL);
+  vtkParse_InitStringCache(&state->Strings);
+  state->Preprocessor->Strings = &state->Strings;
+  vtkParsePreprocess_AddStandardMacros(state->Preprocessor, VTK_PARSE_NATIVE);
+  vtkParsePreprocess_AddMacro(state->Preprocessor, "VTK_MAJOR_VERSION", "6");
+  vtkParsePreprocess_AddMacro(state->Preprocessor, "VTK_MINOR_VERSION", "2");
+  vtkParsePreprocess_AddMacro(state->Preprocessor, "VTK_USE_64BIT_IDS", "1");
+  vtkParsePreprocess_AddMacro(state->Preprocessor, "VTK_SIZEOF_LONG_LONG", "8");
+  vtkParsePreprocess_AddMacro(state->Preprocessor, "VTK_SIZEOF_VOID_P", "8");
+  vtkParsePreprocess_AddMacro(
+    state->Preprocessor, "VTK_TYPE_UINT32_MAX", "0xffffffffu");
+  vtkParsePreprocess_HandleDirective(
+    state->Preprocessor, "#define vtkBenchInner(x) ((x) + 1)");
+  vtkParsePreprocess_HandleDirective(
+    state->Preprocessor,
+    "#define vtkBenchMiddle(x, y) vtkBenchInner(x) * vtkBenchInner(y)");
+  vtkParsePreprocess_HandleDirective(
+    state->Preprocessor,
+    "#define vtkBenchOuter(a, b) "
+    "vtkBenchMiddle(a, vtkBenchMiddle(b, a)) + #a");
+
+  /* write and read a hierarchy file with many classes */
+  sprintf(path, "%s/WrapVTKMicroBench.txt", dir);
+  fp = fopen(path, "w");
+  if (!fp)
+  {
+    fprintf(stderr, "WrapVTKMicroBench: cannot write %s\n", path);
+    exit(1);
+  }
+  fprintf(fp,
+    "vtkBenchArray<T> ; vtkBenchArray.h ; vtkBench\n"
+    "vtkBenchMap<K,V> ; vtkBenchMap.h ; vtkBench\n"
+    "vtkIdType = long long ; vtkType.h ; vtkBench\n"
+    "vtkObject ; vtkObject.h ; vtkBench\n");
+  for (i = 0; i < 5000; i++)
+  {
+    fprintf(fp,
+      "vtkBenchClass%d : vtkObject ; vtkBenchClass%d.h ; vtkBench\n"
+      "vtkBenchClass%d::Mode : enum ; vtkBenchClass%d.h ; vtkBench\n",
+      i, i, i, i);
+  }
+  fprintf(fp,
+    "vtkBenchDeep0 : vtkObject ; vtkBenchDeep0.h ; vtkBench\n"
+    "vtkBenchDeep0::PointerType = ValueType * ; vtkBenchDeep0.h ; vtkBench\n"
+    "vtkBenchDeep0::ValueType = vtkIdType ; vtkBenchDeep0.h ; vtkBench\n");
+  for (i = 1; i < 20; i++)
+  {
+    fprintf(fp,
+      "vtkBenchDeep%d : vtkBenchDeep%d ; vtkBenchDeep%d.h ; vtkBench\n",
+      i, i-1, i);
+  }
+  fclose(fp);
+  state->Hierarchy = vtkParseHierarchy_ReadFile(path);
+  remove(path);
+  if (!state->Hierarchy)
+  {
+    fprintf(stderr, "WrapVTKMicroBench: cannot read %s\n", path);
+    exit(1);
+  }
+
+  /* parse a class with many overloaded methods */
+  m = 64*1024;
+  text = (char *)malloc(m);
+  n = sprintf(text,
+    "class vtkObject;\n"
+    "class vtkBenchOverloads\n"
+    "{\n"
+    "public:\n");
+  for (i = 0; i < 200; i++)
+  {
+    n += sprintf(&text[n], "  %svoid %s(",
+                 (i % 3 == 0 ? "virtual " : ""),
+                 (i % 2 == 0 ? "SetInput" : "AddInput"));
+    k = i;
+    for (j = 0; j < 1 + i % 3; j++)
+    {
+      n += sprintf(&text[n], "%s%s", (j == 0 ? "" : ", "), types[k % 8]);
+      k /= 8;
+    }
+    n += sprintf(&text[n], ")%s;\n", (i % 5 == 4 ? " const" : ""));
+  }
+  n += sprintf(&text[n], "};\n");
+  state->File = vtkParse_ParseMemory("vtkBenchOverloads.h", text, n, stderr);
+  free(text);
+  if (!state->File || !state->File->MainClass)
+  {
+    fprintf(stderr, "WrapVTKMicroBench: cannot parse overloads\n");
+    exit(1);
+  }
+}
+
+/* Free the state */
+static void microbench_teardown(MicroBenchState *state)
+{
+  free(state->Text);
+  vtkParsePreprocess_Free(state->Preprocessor);
+  vtkParse_FreeStringCache(&state->Strings);
+  vtkParseHierarchy_Free(state->Hierarchy);
+  vtkParse_Free(state->File);
+}
+
+/* Compare two doubles for qsort */
+static int microbench_compare_doubles(const void *vp1, const void *vp2)
+{
+  double d1 = *(const double *)vp1;
+  double d2 = *(const double *)vp2;
+  return (d1 < d2 ? -1 : (d1 > d2 ? 1 : 0));
+}
+
+/* Get a percentile from sorted samples */
+static double microbench_percentile(const double *samples, int n, double p)
+{
+  return samples[(int)(p*(n - 1) + 0.5)];
+}
+
+/* Run one benchmark and print the results */
+static void microbench_run(
+  const MicroBench *bench, MicroBenchState *state,
+  int nwarm, int nrep, int json)
+{
+  double *samples;
+  double t, sum = 0.0;
+  unsigned long ops = 0;
+  int i;
+
+  for (i = 0; i < nwarm; i++)
+  {
+    bench->Run(state);
+  }
+
+  samples = (double *)malloc(nrep*sizeof(double));
+  for (i = 0; i < nrep; i++)
+  {
+    t = vtkParse_WallTime();
+    ops = bench->Run(state);
+    t = vtkParse_WallTime() - t;
+    samples[i] = 1e9*t/(ops ? ops : 1);
+    sum += samples[i];
+  }
+  qsort(samples, nrep, sizeof(double), microbench_compare_doubles);
+
+  if (json)
+  {
+    fprintf(stdout,
+      "{\"benchmark\": \"%s\", \"unit\": \"ns/op\", \"ops\": %lu, "
+      "\"samples\": %d, \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+      "\"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f}\n",
+      bench->Name, ops, nrep, samples[0],
+      microbench_percentile(samples, nrep, 0.50),
+      microbench_percentile(samples, nrep, 0.90),
+      microbench_percentile(samples, nrep, 0.99),
+      samples[nrep-1], sum/nrep);
+  }
+  else
+  {
+    fprintf(stdout, "%-22s %9lu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+      bench->Name, ops, samples[0],
+      microbench_percentile(samples, nrep, 0.50),
+      microbench_percentile(samples, nrep, 0.90),
+      microbench_percentile(samples, nrep, 0.99),
+      samples[nrep-1]);
+  }
+
+  free(samples);
+}
+
+int main(int argc, char *argv[])
+{
+  MicroBenchState state;
+  const char *dir = ".";
+  char **names;
+  int nnames = 0;
+  int nwarm = 10;
+  int nrep = 100;
+  int json = 0;
+  int i, j;
+
+  names = (char **)malloc(argc*sizeof(char *));
+
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-w") == 0 && i+1 < argc)
+    {
+      nwarm = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-r") == 0 && i+1 < argc)
+    {
+      nrep = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-d") == 0 && i+1 < argc)
+    {
+      dir = argv[++i];
+    }
+    else if (strcmp(argv[i], "--json") == 0)
+    {
+      json = 1;
+    }
+    else if (argv[i][0] != '-')
+    {
+      names[nnames++] = argv[i];
+    }
+    else
+    {
+      fprintf(stderr,
+        "Usage: WrapVTKMicroBench [options] [name...]\n"
+        "  -w <count>   number of warm-up samples\n"
+        "  -r <count>   number of timed samples\n"
+        "  -d <dir>     directory for temporary files\n"
+        "  --json       print the results as JSON\n");
+      free(names);
+      return (strcmp(argv[i], "--help") == 0 ? 0 : 1);
+    }
+  }
+
+  if (nrep < 1)
+  {
+    nrep = 1;
+  }
+
+  microbench_setup(&state, dir);
+
+  if (!json)
+  {
+    fprintf(stdout, "%-22s %9s %10s %10s %10s %10s %10s\n",
+            "benchmark (ns/op)", "ops", "min", "p50", "p90", "p99", "max");
+  }
+
+  for (i = 0; microbench_list[i].Name; i++)
+  {
+    for (j = 0; j < nnames; j++)
+    {
+      if (strcmp(names[j], microbench_list[i].Name) == 0)
+      {
+        break;
+      }
+    }
+    if (nnames == 0 || j < nnames)
+    {
+      microbench_run(&microbench_list[i], &state, nwarm, nrep, json);
+    }
+  }
+
+  microbench_teardown(&state);
+  free(names);
+
+  return 0;
+}
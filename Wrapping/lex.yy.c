@@ -2082,6 +2082,18 @@ Modify lex.yy.c:
 /* Skip declaring this function.  It is a macro.  */
 #define YY_SKIP_YYWRAP
 
+/* The scanner is wrapped by yylex(), which counts the tokens */
+#define YY_DECL static int scan_token(void)
+
+/* Header files are memory-mapped where mmap() is available */
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#define VTK_PARSE_USE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #pragma warning ( disable : 4018 )
 #pragma warning ( disable : 4127 )
@@ -2131,6 +2143,11 @@ static int pop_buffer();
 static void push_include(const char *filename);
 static void pop_include();
 
+static int push_scan_file(FILE *fp);
+static void push_scan_text(const char *text, size_t n);
+static void pop_scan_file();
+static void switch_to_scan_file();
+
 static void push_macro(MacroInfo *macro);
 static void pop_macro();
 static int in_macro();
@@ -5610,6 +5627,8 @@ void push_include(const char *filename)
       lineno_stack, 2*n*sizeof(int));
   }
 
+  vtkParse_BeginSpan("include", filename);
+
   lineno_stack[include_stack_size] = yyget_lineno();
   yyset_lineno(0);
   include_stack[include_stack_size++] = data;
@@ -5647,7 +5666,8 @@ void pop_include()
   if (include_stack_size > 0)
   {
     --include_stack_size;
-    fclose(yyin);
+    pop_scan_file();
+    vtkParse_EndSpan("include");
     yyset_lineno(lineno_stack[include_stack_size]);
     if (data != include_stack[include_stack_size])
     {
@@ -5657,6 +5677,166 @@ void pop_include()
   }
 }
 
+/*
+ * scan file stack, holds the contents of the main file and includes
+ * in memory so that flex can scan them without refilling its buffer
+ */
+typedef struct _ScanFile
+{
+  char *Text;        /* file contents, followed by two null bytes */
+  size_t Size;       /* size of the contents plus the two nulls */
+  int IsMapped;      /* set if Text was mapped with mmap() */
+} ScanFile;
+
+static size_t scan_file_stack_size = 0;
+static ScanFile *scan_file_stack = NULL;
+
+/*
+ * grow the scan file stack and return the new top entry.
+ */
+static ScanFile *new_scan_file()
+{
+  size_t n = scan_file_stack_size;
+  if (scan_file_stack == NULL)
+  {
+    scan_file_stack = (ScanFile *)malloc(4*sizeof(ScanFile));
+  }
+  /* grow the stack whenever size reaches a power of two */
+  else if (n >= 4 && (n & (n-1)) == 0)
+  {
+    scan_file_stack = (ScanFile *)realloc(
+      scan_file_stack, 2*n*sizeof(ScanFile));
+  }
+  scan_file_stack_size++;
+  return &scan_file_stack[n];
+}
+
+/*
+ * load the contents of a file and push it onto the scan file stack,
+ * the file is mapped if possible, otherwise it is read into memory.
+ * Return zero if the file could not be read.
+ */
+int push_scan_file(FILE *fp)
+{
+  ScanFile *sf;
+  char *text = NULL;
+  size_t n = 0;
+  size_t m = 0;
+  size_t k;
+  int is_mapped = 0;
+#ifdef VTK_PARSE_USE_MMAP
+  struct stat fs;
+  long pagesize;
+
+  /* flex needs two nulls at the end, so only map the file if they
+   * fit into the zero-filled remainder of the final page */
+  pagesize = sysconf(_SC_PAGESIZE);
+  if (pagesize > 2 && ftell(fp) == 0 &&
+      fstat(fileno(fp), &fs) == 0 && S_ISREG(fs.st_mode) &&
+      fs.st_size > 0 && (size_t)fs.st_size % (size_t)pagesize != 0 &&
+      (size_t)fs.st_size % (size_t)pagesize <= (size_t)pagesize - 2)
+  {
+    n = (size_t)fs.st_size;
+    m = n + 2;
+    text = (char *)mmap(NULL, m, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                        fileno(fp), 0);
+    if (text == (char *)MAP_FAILED)
+    {
+      text = NULL;
+      n = 0;
+    }
+    else
+    {
+      is_mapped = 1;
+    }
+  }
+#endif
+
+  /* read the whole file into memory */
+  if (text == NULL)
+  {
+    m = 8192;
+    text = (char *)malloc(m);
+    while ((k = fread(&text[n], 1, m - n - 2, fp)) > 0)
+    {
+      n += k;
+      if (n + 2 == m)
+      {
+        m *= 2;
+        text = (char *)realloc(text, m);
+      }
+    }
+    if (ferror(fp))
+    {
+      free(text);
+      return 0;
+    }
+    m = n + 2;
+  }
+
+  text[n] = '\0';
+  text[n+1] = '\0';
+
+  vtkParse_AddToCounter(VTK_PARSE_COUNT_BYTES, (unsigned long)n);
+
+  sf = new_scan_file();
+  sf->Text = text;
+  sf->Size = m;
+  sf->IsMapped = is_mapped;
+
+  return 1;
+}
+
+/*
+ * copy text into memory and push it onto the scan file stack.
+ */
+void push_scan_text(const char *text, size_t n)
+{
+  ScanFile *sf = new_scan_file();
+
+  sf->Text = (char *)malloc(n + 2);
+  memcpy(sf->Text, text, n);
+  sf->Text[n] = '\0';
+  sf->Text[n+1] = '\0';
+  sf->Size = n + 2;
+  sf->IsMapped = 0;
+}
+
+/*
+ * pop the scan file stack and release the file contents
+ */
+void pop_scan_file()
+{
+  ScanFile *sf;
+
+  if (scan_file_stack_size > 0)
+  {
+    sf = &scan_file_stack[--scan_file_stack_size];
+#ifdef VTK_PARSE_USE_MMAP
+    if (sf->IsMapped)
+    {
+      munmap(sf->Text, sf->Size);
+    }
+    else
+#endif
+    {
+      free(sf->Text);
+    }
+    sf->Text = NULL;
+  }
+}
+
+/*
+ * make flex scan the file on the top of the scan file stack
+ */
+void switch_to_scan_file()
+{
+  ScanFile *sf = &scan_file_stack[scan_file_stack_size-1];
+
+  /* this creates the buffer and switches to it */
+  yy_scan_buffer(sf->Text, (yy_size_t)sf->Size);
+}
+
 
 /*
  * macro stack, to tell what macro is being evaluated
@@ -5845,13 +6025,18 @@ void preprocessor_directive(const char *text, size_t l)
           &cp[1], (*cp != '\"'), &already_loaded);
         if (dp)
         {
-          yyin = fopen(dp, "r");
-          if (yyin)
+          FILE *fp = fopen(dp, "r");
+          if (fp)
           {
-            push_include(dp);
-            push_buffer();
-            yy_switch_to_buffer(yy_create_buffer(yyin,YY_BUF_SIZE));
-            return;
+            int loaded = push_scan_file(fp);
+            fclose(fp);
+            if (loaded)
+            {
+              push_include(dp);
+              push_buffer();
+              switch_to_scan_file();
+              return;
+            }
           }
         }
       }
@@ -5905,3 +6090,18 @@ void preprocessor_directive(const char *text, size_t l)
     }
   }
 }
+
+/*
+ * get the next token for the parser
+ */
+int yylex(void)
+{
+  int token = scan_token();
+
+  if (token != 0)
+  {
+    vtkParse_AddToCounter(VTK_PARSE_COUNT_TOKENS, 1);
+  }
+
+  return token;
+}
@@ -70,6 +70,13 @@ void vtkParse_SetCommandName(const char *name);
 FileInfo *vtkParse_ParseFile(
   const char *filename, FILE *ifile, FILE *errfile);
 
+/**
+ * Parse a header file that has already been read into memory.
+ * The text is copied, so it can be freed after this returns.
+ */
+FileInfo *vtkParse_ParseMemory(
+  const char *filename, const char *text, size_t n, FILE *errfile);
+
 /**
  * Read a hints file and update the FileInfo
  */
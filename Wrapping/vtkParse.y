@@ -133,6 +133,8 @@ to the more usual form y x; without parentheses.
 #include "vtkParse.h"
 #include "vtkParsePreprocess.h"
 #include "vtkParseData.h"
+#include "vtkParseMemory.h"
+#include "vtkParseTiming.h"
 #include "vtkType.h"
 
 static unsigned int vtkParseTypeMap[] =
@@ -259,7 +261,9 @@ void handle_complex_type(ValueInfo *val, unsigned int datatype,
 void handle_function_type(ValueInfo *param, const char *name,
                           const char *funcSig);
 void handle_attribute(const char *att, int pack);
+#ifndef VTK_PARSE_LEGACY_REMOVE
 void add_legacy_parameter(FunctionInfo *func, ValueInfo *param);
+#endif
 
 void outputSetVectorMacro(const char *var, unsigned int paramType,
                           const char *typeText, unsigned long n);
@@ -2752,7 +2756,9 @@ parameter_declaration:
       vtkParse_InitValue(param);
 
       handle_complex_type(param, getType(), $<integer>4, copySig());
+#ifndef VTK_PARSE_LEGACY_REMOVE
       add_legacy_parameter(currentFunction, param);
+#endif
 
       if (getVarName())
       {
@@ -4686,7 +4692,9 @@ void add_parameter(FunctionInfo *func, unsigned int type,
                               vtkstrdup(text));
   }
 
+#ifndef VTK_PARSE_LEGACY_REMOVE
   add_legacy_parameter(func, param);
+#endif
 
   vtkParse_AddParameterToFunction(func, param);
 }
@@ -4938,10 +4946,10 @@ void handle_attribute(const char *att, int pack)
   }
 }
 
+#ifndef VTK_PARSE_LEGACY_REMOVE
 /* add a parameter to the legacy part of the FunctionInfo struct */
 void add_legacy_parameter(FunctionInfo *func, ValueInfo *param)
 {
-#ifndef VTK_PARSE_LEGACY_REMOVE
   unsigned long i = func->NumberOfArguments;
 
   if (i < MAX_ARGS)
@@ -4968,8 +4976,8 @@ void add_legacy_parameter(FunctionInfo *func, ValueInfo *param)
   {
     func->ArrayFailure = 1;
   }
-#endif
 }
+#endif
 
 
 /* reject the function, do not output it */
@@ -5325,14 +5333,43 @@ void vtkParse_SetCommandName(const char *name)
 }
 
 /* Parse a header file and return a FileInfo struct */
+static FileInfo *vtkparse_parse_scan_file(
+  const char *filename, FILE *ifile, FILE *errfile);
+
+/* Parse a header file from a FILE pointer */
 FileInfo *vtkParse_ParseFile(
   const char *filename, FILE *ifile, FILE *errfile)
+{
+  /* the whole file is mapped or loaded, so flex never refills */
+  if (!push_scan_file(ifile))
+  {
+    fprintf(errfile, "Error reading input file %s\n", filename);
+    return NULL;
+  }
+
+  return vtkparse_parse_scan_file(filename, ifile, errfile);
+}
+
+/* Parse a header file that is already in memory */
+FileInfo *vtkParse_ParseMemory(
+  const char *filename, const char *text, size_t n, FILE *errfile)
+{
+  push_scan_text(text, n);
+
+  return vtkparse_parse_scan_file(filename, NULL, errfile);
+}
+
+/* Parse the file on the top of the scan file stack */
+static FileInfo *vtkparse_parse_scan_file(
+  const char *filename, FILE *ifile, FILE *errfile)
 {
   unsigned long i, j;
   int ret;
   FileInfo *file_info;
   char *main_class;
 
+  vtkParse_BeginSpan("header", filename);
+
   /* "data" is a global variable used by the parser */
   data = (FileInfo *)malloc(sizeof(FileInfo));
   vtkParse_InitFile(data);
@@ -5343,7 +5380,9 @@ FileInfo *vtkParse_ParseFile(
   preprocessor = (PreprocessInfo *)malloc(sizeof(PreprocessInfo));
   vtkParsePreprocess_Init(preprocessor, filename);
   preprocessor->Strings = data->Strings;
+  vtkParse_StartPhase(VTK_PARSE_PHASE_MACROS);
   vtkParsePreprocess_AddStandardMacros(preprocessor, VTK_PARSE_NATIVE);
+  vtkParse_StopPhase(VTK_PARSE_PHASE_MACROS);
 
   /* add include files specified on the command line */
   for (i = 0; i < NumberOfIncludeDirectories; i++)
@@ -5396,6 +5435,13 @@ FileInfo *vtkParse_ParseFile(
   templateDepth = 0;
   currentTemplate = NULL;
 
+  /* these are only non-zero here if the previous parse failed */
+  classDepth = 0;
+  currentClass = NULL;
+  access_level = VTK_ACCESS_PUBLIC;
+  typeDepth = 0;
+  pointerScopeDepth = 0;
+
   currentFunction = (FunctionInfo *)malloc(sizeof(FunctionInfo));
   vtkParse_InitFunction(currentFunction);
   startSig();
@@ -5408,15 +5454,37 @@ FileInfo *vtkParse_ParseFile(
 
   yyset_in(ifile);
   yyset_out(errfile);
+  switch_to_scan_file();
+  vtkParse_StartPhase(VTK_PARSE_PHASE_PARSE);
   ret = yyparse();
+  vtkParse_StopPhase(VTK_PARSE_PHASE_PARSE);
 
-  if (ret)
+  /* if the parse stopped inside of a macro or include, unwind them */
+  while (pop_buffer())
   {
-    return NULL;
   }
 
+  /* release the scanner and the file contents */
+  while (functionDepth > 0)
+  {
+    free(currentFunction);
+    currentFunction = functionStack[--functionDepth];
+  }
   free(currentFunction);
+  currentFunction = NULL;
   yylex_destroy();
+  pop_scan_file();
+
+  if (ret)
+  {
+    vtkParsePreprocess_Free(preprocessor);
+    preprocessor = NULL;
+    macroName = NULL;
+    vtkParse_Free(data);
+    data = NULL;
+    vtkParse_EndSpan("header");
+    return NULL;
+  }
 
   /* The main class name should match the file name */
   i = strlen(filename);
@@ -5450,8 +5518,31 @@ FileInfo *vtkParse_ParseFile(
   free(main_class);
 
   /* assign doxygen comments to their targets */
+  vtkParse_StartPhase(VTK_PARSE_PHASE_COMMENTS);
   assignComments(data->Contents);
+  vtkParse_StopPhase(VTK_PARSE_PHASE_COMMENTS);
+
+  /* save the names of the files that were found by the preprocessor */
+  for (i = 0; i < preprocessor->NumberOfIncludeFiles; i++)
+  {
+    if (!filename || strcmp(preprocessor->IncludeFiles[i], filename) != 0)
+    {
+      vtkParse_AddStringToArray(
+        &data->Dependencies, &data->NumberOfDependencies,
+        vtkParse_CacheString(data->Strings, preprocessor->IncludeFiles[i],
+                             strlen(preprocessor->IncludeFiles[i])));
+    }
+  }
+  for (i = 0; i < preprocessor->NumberOfMissingFiles; i++)
+  {
+    vtkParse_AddStringToArray(
+      &data->MissingDependencies, &data->NumberOfMissingDependencies,
+      vtkParse_CacheString(data->Strings, preprocessor->MissingFiles[i],
+                           strlen(preprocessor->MissingFiles[i])));
+  }
 
+  /* the preprocessor is freed, so save its stats now */
+  vtkParse_RecordPreprocessStats(data, preprocessor);
   vtkParsePreprocess_Free(preprocessor);
   preprocessor = NULL;
   macroName = NULL;
@@ -5459,6 +5550,8 @@ FileInfo *vtkParse_ParseFile(
   file_info = data;
   data = NULL;
 
+  vtkParse_EndSpan("header");
+
   return file_info;
 }
 
@@ -5639,8 +5732,8 @@ void vtkParse_IncludeDirectory(const char *dirname)
 /** Return the full path to a header file.  */
 const char *vtkParse_FindIncludeFile(const char *filename)
 {
-  static StringCache cache = {0, 0, 0, 0};
-  static PreprocessInfo info = {0, 0, 0, 0, 0, 0, &cache, 0, 0, 0};
+  static StringCache cache = {0, 0, 0, 0, 0, 0};
+  static PreprocessInfo info = {0, 0, 0, 0, 0, 0, 0, 0, &cache, 0, 0, 0};
   int val;
   unsigned long i;
 
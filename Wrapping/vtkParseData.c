@@ -35,6 +35,10 @@ void vtkParse_InitFile(FileInfo *file_info)
 
   file_info->NumberOfIncludes = 0;
   file_info->Includes = NULL;
+  file_info->NumberOfDependencies = 0;
+  file_info->Dependencies = NULL;
+  file_info->NumberOfMissingDependencies = 0;
+  file_info->MissingDependencies = NULL;
   file_info->MainClass = NULL;
   file_info->Contents = NULL;
 
@@ -56,6 +60,14 @@ void vtkParse_FreeFile(FileInfo *file_info)
   {
     free(file_info->Includes);
   }
+  if (file_info->Dependencies)
+  {
+    free((char **)file_info->Dependencies);
+  }
+  if (file_info->MissingDependencies)
+  {
+    free((char **)file_info->MissingDependencies);
+  }
 
   vtkParse_FreeNamespace(file_info->Contents);
   file_info->Contents = NULL;
@@ -282,6 +282,10 @@ struct _FileInfo
 
   unsigned long NumberOfIncludes;
   struct _FileInfo **Includes;
+  unsigned long NumberOfDependencies;
+  const char **Dependencies; /* files found by the preprocessor */
+  unsigned long NumberOfMissingDependencies;
+  const char **MissingDependencies; /* include paths that were not found */
   ClassInfo *MainClass;
   NamespaceInfo *Contents;
   StringCache *Strings;
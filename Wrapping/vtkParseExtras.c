@@ -111,37 +111,84 @@ size_t vtkParse_NameLength(const char *text)
   return i;
 }
 
+/* the size of the hash table for vtkparse_string_replace */
+#define VTKPARSE_REPLACE_SLOTS 64
+
+/* make room for "m" more chars in the result of a string replacement */
+static char *vtkparse_replace_reserve(
+  char *result, char *result_store, size_t *resultMaxLen, size_t j, size_t m)
+{
+  char *tmp;
+
+  if (j + m >= *resultMaxLen)
+  {
+    do
+    {
+      *resultMaxLen *= 2;
+    }
+    while (j + m >= *resultMaxLen);
+    tmp = (char *)malloc(*resultMaxLen);
+    memcpy(tmp, result, j);
+    if (result != result_store)
+    {
+      free(result);
+    }
+    result = tmp;
+  }
+
+  return result;
+}
+
 /* Search and replace, return the initial string if no replacements
- * occurred, otherwise return a new string. */
+ * occurred, otherwise return a new string.  The string is scanned once,
+ * and each identifier is looked up in a hash table of the names.  The
+ * result is only written after the first replacement, so no memory is
+ * allocated if there are no replacements. */
 static const char *vtkparse_string_replace(
   StringCache *cache, const char *str1,
   unsigned long n, const char *name[], const char *val[])
 {
   const char *cp = str1;
+  unsigned char slots[VTKPARSE_REPLACE_SLOTS];
   char result_store[1024];
   size_t resultMaxLen = 1024;
-  char *result, *tmp;
+  char *result = NULL;
   unsigned long k;
-  size_t i, j, l, m;
+  unsigned int h;
+  size_t i, j, m;
   size_t lastPos, nameBegin, nameEnd;
-  int replaced = 0;
-  int any_replaced = 0;
-
-  result = result_store;
+  int hashed;
 
   if (n == 0)
   {
     return str1;
   }
 
+  /* put the names into the hash table, unless there are too many */
+  hashed = (n <= VTKPARSE_REPLACE_SLOTS/2);
+  if (hashed)
+  {
+    memset(slots, 0, sizeof(slots));
+    for (k = 0; k < n; k++)
+    {
+      if (name[k][0] != '\0')
+      {
+        h = vtkParse_HashId(name[k]) & (VTKPARSE_REPLACE_SLOTS - 1);
+        while (slots[h] != 0)
+        {
+          h = (h + 1) & (VTKPARSE_REPLACE_SLOTS - 1);
+        }
+        slots[h] = (unsigned char)(k + 1);
+      }
+    }
+  }
+
   i = 0;
   j = 0;
-  result[j] = '\0';
+  lastPos = 0;
 
   while (cp[i] != '\0')
   {
-    lastPos = i;
-
     /* skip all chars that aren't part of a name */
     while (!vtkParse_CharType(cp[i], CPRE_ID) && cp[i] != '\0')
     {
@@ -149,10 +196,6 @@ static const char *vtkparse_string_replace(
       {
         i += vtkParse_SkipQuotes(&cp[i]);
       }
-      else if (vtkParse_CharType(cp[i], CPRE_QUOTE))
-      {
-        i += vtkParse_SkipNumber(&cp[i]);
-      }
       else
       {
         i++;
@@ -163,87 +206,96 @@ static const char *vtkparse_string_replace(
     /* skip all chars that are part of a name */
     i += vtkParse_SkipId(&cp[i]);
     nameEnd = i;
-
-    /* search through the list of names to replace */
-    replaced = 0;
     m = nameEnd - nameBegin;
-    for (k = 0; k < n; k++)
+    if (m == 0)
     {
-      l = strlen(name[k]);
-      if (l > 0 && l == m && strncmp(&cp[nameBegin], name[k], l) == 0)
+      break;
+    }
+
+    /* search for the name */
+    k = n;
+    if (hashed)
+    {
+      h = vtkParse_HashId(&cp[nameBegin]) & (VTKPARSE_REPLACE_SLOTS - 1);
+      while (slots[h] != 0)
       {
-        m = strlen(val[k]);
-        replaced = 1;
-        any_replaced = 1;
-        break;
+        k = slots[h] - 1;
+        if (strncmp(&cp[nameBegin], name[k], m) == 0 && name[k][m] == '\0')
+        {
+          break;
+        }
+        k = n;
+        h = (h + 1) & (VTKPARSE_REPLACE_SLOTS - 1);
       }
     }
-
-    /* expand the storage space if needed */
-    if (j + m + (nameBegin - lastPos) + 1 >= resultMaxLen)
+    else
     {
-      resultMaxLen *= 2;
-      tmp = (char *)malloc(resultMaxLen);
-      strcpy(tmp, result);
-      if (result != result_store)
+      for (k = 0; k < n; k++)
       {
-         free(result);
+        if (name[k][0] != '\0' &&
+            strncmp(&cp[nameBegin], name[k], m) == 0 && name[k][m] == '\0')
+        {
+          break;
+        }
       }
-       result = tmp;
     }
 
-    /* copy the old bits */
-    if (nameBegin > lastPos)
+    if (k == n)
     {
-      strncpy(&result[j], &cp[lastPos], nameBegin - lastPos);
-      j += (nameBegin - lastPos);
+      continue;
     }
 
-    /* do the replacement */
-    if (replaced)
+    /* copy the old bits, and then do the replacement */
+    if (result == NULL)
     {
-      strncpy(&result[j], val[k], m);
-      j += m;
-      /* guard against creating double ">>" */
-      if (val[k][m-1] == '>' && cp[nameEnd] == '>')
-      {
-        result[j++] = ' ';
-      }
+      result = result_store;
     }
-    else if (nameEnd > nameBegin)
+    m = strlen(val[k]);
+    result = vtkparse_replace_reserve(
+      result, result_store, &resultMaxLen, j, nameBegin - lastPos + m + 1);
+    memcpy(&result[j], &cp[lastPos], nameBegin - lastPos);
+    j += nameBegin - lastPos;
+    memcpy(&result[j], val[k], m);
+    j += m;
+    /* guard against creating double ">>" */
+    if (m > 0 && val[k][m-1] == '>' && cp[nameEnd] == '>')
     {
-      strncpy(&result[j], &cp[nameBegin], nameEnd - nameBegin);
-      j += (nameEnd - nameBegin);
+      result[j++] = ' ';
     }
+    lastPos = nameEnd;
+  }
 
-    result[j] = '\0';
+  if (result == NULL)
+  {
+    return str1;
   }
 
+  /* copy the bits after the last replacement */
+  m = strlen(&cp[lastPos]);
+  result = vtkparse_replace_reserve(
+    result, result_store, &resultMaxLen, j, m);
+  memcpy(&result[j], &cp[lastPos], m);
+  j += m;
+  result[j] = '\0';
+
   if (cache)
   {
-    if (any_replaced)
+    /* use the efficient CacheString method */
+    cp = vtkParse_CacheString(cache, result, j);
+    if (result != result_store)
     {
-      /* use the efficient CacheString method */
-      cp = vtkParse_CacheString(cache, result, j);
-      if (result != result_store)
-      {
-        free(result);
-      }
+      free(result);
     }
   }
   else
   {
-    if (any_replaced)
+    /* return a string that was allocated with malloc */
+    if (result == result_store)
     {
-      /* return a string that was allocated with malloc */
-      if (result == result_store)
-      {
-        tmp = (char *)malloc(strlen(result) + 1);
-        strcpy(tmp, result);
-        result = tmp;
-      }
-      cp = result;
+      result = (char *)malloc(j + 1);
+      memcpy(result, result_store, j + 1);
     }
+    cp = result;
   }
 
   return cp;
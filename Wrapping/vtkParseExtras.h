@@ -169,7 +169,8 @@ void vtkParse_ExpandValues(
 
 /**
  * Search and replace, return the initial string if no replacements
- * occurred, else return a new string allocated with malloc. */
+ * occurred, else return a new string allocated with malloc.  No memory
+ * is allocated if there are no replacements. */
 const char *vtkParse_StringReplace(
   const char *str1, unsigned long n, const char *name[], const char *val[]);
 
@@ -20,7 +20,9 @@
 -------------------------------------------------------------------------*/
 
 #include "vtkParseHierarchy.h"
+#include "vtkParseHierarchyDB.h"
 #include "vtkParseExtras.h"
+#include "vtkParseTiming.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -86,6 +88,21 @@ static size_t skip_expression(const char *text, const char *delims)
   return i;
 }
 
+/* The lookup tables for a HierarchyInfo.  Each table is built by the
+ * first lookup that needs it, since most tools do only a few lookups.
+ * The HierarchyInfo holds a pointer to this struct, so the tables can
+ * be built even when the HierarchyInfo is const. */
+struct _HierarchyCache
+{
+  int           NumberOfSlots; /* hash table of the entry names */
+  unsigned int *Slots;
+  int          *Ancestry;      /* class intervals for IsTypeOf */
+  int           ExpandedAll;   /* set once every typedef is expanded */
+  int           NumberOfExpansionSlots; /* hash table of expansions */
+  int           NumberOfExpansions;
+  struct _HierarchyExpansion **ExpansionSlots;
+};
+
 /* helper: comparison of entries */
 static int compare_hierarchy_entries(const void *vp1, const void *vp2)
 {
@@ -102,430 +119,711 @@ static void sort_hierarchy_entries(HierarchyInfo *info)
         &compare_hierarchy_entries);
 }
 
-/* Find an entry with a binary search */
-HierarchyEntry *vtkParseHierarchy_FindEntry(
-  const HierarchyInfo *info, const char *classname)
+/* helper: add chars to a hash, this is "djb2" like vtkParse_HashId */
+static unsigned int hash_chars(unsigned int h, const char *cp, size_t n)
 {
-  HierarchyEntry key;
-  HierarchyEntry *entry;
-  size_t i, n, m, l;
-  char name[32];
-  char *cp = NULL;
+  size_t i;
 
-  /* use classname as-is for the search if possible */
-  key.Name = classname;
+  for (i = 0; i < n; i++)
+  {
+    h = (h << 5) + h + (unsigned char)cp[i];
+  }
 
-  /* get portion of name before final template parameters */
-  n = vtkParse_UnscopedNameLength(classname);
-  m = vtkParse_IdentifierLength(classname);
-  while (classname[n] == ':' && classname[n+1] == ':')
+  return h;
+}
+
+/* helper: make a hash table of the entry names, so that they can be
+ * found without any string comparisons except for the final one.  For
+ * names that occur more than once, only the first entry is added. */
+static void build_name_table(const HierarchyInfo *info)
+{
+  struct _HierarchyCache *hc = info->Cache;
+  const char *name;
+  unsigned int h, m;
+  int i;
+
+  m = 16;
+  while (m < 2*(unsigned int)info->NumberOfEntries)
   {
-    i = n + 2;
-    n += 2 + vtkParse_UnscopedNameLength(&classname[i]);
-    m += 2 + vtkParse_IdentifierLength(&classname[i]);
+    m *= 2;
   }
 
-  /* if n == m, no template args were found */
-  if (n != m)
+  hc->NumberOfSlots = (int)m;
+  hc->Slots = (unsigned int *)calloc(2*m, sizeof(unsigned int));
+
+  for (i = 0; i < info->NumberOfEntries; i++)
   {
-    /* need to remove template args: use stack space if possible */
-    cp = name;
-    /* otherwise, use malloc */
-    if (m > 31)
+    name = info->Entries[i].Name;
+    if (i > 0 && strcmp(name, info->Entries[i-1].Name) == 0)
     {
-      cp = (char *)malloc(m+1);
+      continue;
     }
-    n = vtkParse_UnscopedNameLength(classname);
-    m = vtkParse_IdentifierLength(classname);
-    strncpy(cp, classname, m);
-    while (classname[n] == ':' && classname[n+1] == ':')
+
+    h = hash_chars(5381, name, strlen(name));
+    m = h & (hc->NumberOfSlots - 1);
+    while (hc->Slots[2*m + 1] != 0)
     {
-      i = n + 2;
-      n += 2 + vtkParse_UnscopedNameLength(&classname[i]);
-      l = 2 + vtkParse_IdentifierLength(&classname[i]);
-      strncpy(&cp[m], &classname[i-2], l);
-      m += l;
+      m = (m + 1) & (hc->NumberOfSlots - 1);
     }
-    cp[m] = '\0';
-    key.Name = cp;
+    hc->Slots[2*m] = h;
+    hc->Slots[2*m + 1] = (unsigned int)(i + 1);
   }
+}
 
-  entry = (HierarchyEntry *)bsearch(&key, info->Entries,
-    info->NumberOfEntries, sizeof(HierarchyEntry),
-    &compare_hierarchy_entries);
+/* helper: check whether an entry name is the same as a name that has
+ * had its template args removed, e.g. "A::B" matches "A<int>::B<int>" */
+static int match_stripped_name(const char *entryname, const char *name)
+{
+  const char *cp = entryname;
+  size_t i, l;
 
-  if (cp && cp != name)
+  l = vtkParse_IdentifierLength(name);
+  if (strncmp(cp, name, l) != 0)
   {
-    free(cp);
+    return 0;
   }
+  cp += l;
 
-  return entry;
-}
+  i = vtkParse_UnscopedNameLength(name);
+  while (name[i] == ':' && name[i+1] == ':')
+  {
+    i += 2;
+    l = vtkParse_IdentifierLength(&name[i]);
+    if (cp[0] != ':' || cp[1] != ':' || strncmp(&cp[2], &name[i], l) != 0)
+    {
+      return 0;
+    }
+    cp += l + 2;
+    i += vtkParse_UnscopedNameLength(&name[i]);
+  }
 
+  return (*cp == '\0');
+}
 
-/* read a hierarchy file into a HeirarchyInfo struct, or return NULL */
-HierarchyInfo *vtkParseHierarchy_ReadFile(const char *filename)
+/* helper: find the first entry with the given name, or return -1.  If
+ * "strip" is set and the name has template args, then the args are
+ * ignored (but are not removed from a copy of the name, as this would
+ * need memory for the copy). */
+static int find_name(const HierarchyInfo *info, const char *name, int strip)
 {
-  HierarchyInfo *info;
-  HierarchyEntry *entry;
-  int maxClasses = 500;
-  FILE *fp;
-  char *line;
-  char *cp;
-  const char *ccp;
-  size_t maxlen = 15;
-  size_t i, j, n, m;
-  unsigned int bits, pointers;
-  static const char *delims = ">,=";
+  struct _HierarchyCache *hc = info->Cache;
+  const char *entryname;
+  unsigned int h, k, mask;
+  size_t i, j, l, m;
 
-  line = (char *)malloc(maxlen);
+  if (!hc->Slots)
+  {
+    build_name_table(info);
+  }
 
-  fp = fopen(filename, "r");
+  /* hash the name without the template args, and get the length of
+   * the name with (i) and without (m) the template args */
+  l = vtkParse_IdentifierLength(name);
+  h = hash_chars(5381, name, l);
+  m = l;
+  i = (strip ? vtkParse_UnscopedNameLength(name) : l);
+  while (strip && name[i] == ':' && name[i+1] == ':')
+  {
+    j = i + 2;
+    l = vtkParse_IdentifierLength(&name[j]);
+    h = hash_chars(h, &name[i], l + 2);
+    m += l + 2;
+    i = j + vtkParse_UnscopedNameLength(&name[j]);
+  }
 
-  if (fp == NULL)
+  /* if no template args were found, then use the whole name */
+  strip = (strip && i != m);
+  if (!strip)
   {
-    return NULL;
+    h = hash_chars(h, &name[m], strlen(&name[m]));
   }
 
-  info = (HierarchyInfo *)malloc(sizeof(HierarchyInfo));
-  info->NumberOfEntries = 0;
-  info->Entries = (HierarchyEntry *)malloc(maxClasses*sizeof(HierarchyEntry));
-  info->Strings = (StringCache *)malloc(sizeof(StringCache));
-  vtkParse_InitStringCache(info->Strings);
+  mask = (unsigned int)hc->NumberOfSlots - 1;
+  for (k = h & mask; hc->Slots[2*k + 1] != 0; k = (k + 1) & mask)
+  {
+    if (hc->Slots[2*k] == h)
+    {
+      entryname = info->Entries[hc->Slots[2*k + 1] - 1].Name;
+      if (strip ? match_stripped_name(entryname, name)
+                : strcmp(entryname, name) == 0)
+      {
+        return (int)(hc->Slots[2*k + 1] - 1);
+      }
+    }
+  }
 
-  while (fgets(line, (int)maxlen, fp))
+  return -1;
+}
+
+/* Find an entry with a hash table lookup */
+HierarchyEntry *vtkParseHierarchy_FindEntry(
+  const HierarchyInfo *info, const char *classname)
+{
+  int i = find_name(info, classname, 1);
+
+  return (i >= 0 ? &info->Entries[i] : NULL);
+}
+
+/* helper: find the entry for a superclass the way that
+ * vtkParseHierarchy_IsTypeOfTemplated does, or return -1 */
+static int find_superclass_index(const HierarchyInfo *info, const char *name)
+{
+  HierarchyEntry *tmph;
+  int n = info->NumberOfEntries;
+
+  tmph = vtkParseHierarchy_FindEntry(info, name);
+  while (tmph && tmph->IsTypedef && tmph->Typedef->TypeName && n-- > 0)
   {
-    n = strlen(line);
+    tmph = vtkParseHierarchy_FindEntry(info, tmph->Typedef->TypeName);
+  }
 
-    /* if buffer not long enough, increase it */
-    while (n == maxlen-1 && line[n-1] != '\n' && !feof(fp))
+  return (tmph && n >= 0 ? (int)(tmph - info->Entries) : -1);
+}
+
+/* helper: check whether a superclass is a template parameter */
+static int superclass_is_template_parameter(
+  const HierarchyEntry *entry, const char *supername)
+{
+  size_t m;
+  int k;
+
+  for (k = 0; k < entry->NumberOfTemplateParameters; k++)
+  {
+    m = strlen(entry->TemplateParameters[k]);
+    if (strncmp(entry->TemplateParameters[k], supername, m) == 0 &&
+        !isalnum(supername[m]) && supername[m] != '_')
     {
-      maxlen *= 2;
-      line = (char *)realloc(line, maxlen);
-      if (!fgets(&line[n], (int)(maxlen-n), fp)) { break; }
-      n += strlen(&line[n]);
+      return 1;
     }
+  }
 
-    while (n > 0 && isspace(line[n-1]))
+  return 0;
+}
+
+/* helper: number the classes with single inheritance in the order of a
+ * depth-first walk of the class tree, so that every class gets an
+ * interval that holds the intervals of all of its subclasses.  Classes
+ * with multiple inheritance (or with a templated superclass that cannot
+ * be resolved without the template args) get -1, and so do all of their
+ * subclasses.  Ancestry[2*i] is the start and Ancestry[2*i+1] is the end
+ * of the interval for entry i. */
+static void build_ancestry(const HierarchyInfo *info)
+{
+  HierarchyEntry *entry;
+  int n = info->NumberOfEntries;
+  int *ancestry;
+  int *parent;
+  int *state;
+  int *stack;
+  int *first;
+  int *children;
+  int i, j, k, l, p, t;
+
+  parent = (int *)malloc(n*sizeof(int));
+  state = (int *)malloc(n*sizeof(int));
+  stack = (int *)malloc(n*sizeof(int));
+  first = (int *)malloc((n+2)*sizeof(int));
+  children = (int *)malloc((n ? n : 1)*sizeof(int));
+  ancestry = (int *)malloc((n ? 2*n : 1)*sizeof(int));
+  info->Cache->Ancestry = ancestry;
+
+  /* resolve the superclass of each class, -2 if it cannot be done */
+  for (i = 0; i < n; i++)
+  {
+    entry = &info->Entries[i];
+    parent[i] = -1;
+    if (entry->NumberOfSuperClasses > 1)
     {
-      n--;
+      parent[i] = -2;
     }
-    line[n] = '\0';
+    else if (entry->NumberOfSuperClasses == 1)
+    {
+      if (superclass_is_template_parameter(entry, entry->SuperClasses[0]))
+      {
+        parent[i] = -2;
+      }
+      else
+      {
+        parent[i] = find_superclass_index(info, entry->SuperClasses[0]);
+        /* also fill in the cache that IsTypeOfTemplated uses */
+        entry->SuperClassIndex[0] = parent[i];
+      }
+    }
+  }
 
-    if (line[0] == '\0')
+  /* state is 0 if unknown, 1 if in the table, 2 if not, 3 if visiting */
+  memset(state, 0, n*sizeof(int));
+  for (i = 0; i < n; i++)
+  {
+    /* go up until a root, or a class with a known state */
+    l = 0;
+    t = 1;
+    for (j = i; j >= 0 && state[j] == 0; j = parent[j])
     {
-      continue;
+      state[j] = 3;
+      stack[l++] = j;
+    }
+    if (j == -2 || (j >= 0 && state[j] != 1))
+    {
+      /* a class that is not in the table, or a cycle */
+      t = 2;
     }
+    while (l > 0)
+    {
+      state[stack[--l]] = t;
+    }
+  }
 
-    if (info->NumberOfEntries == maxClasses)
+  /* make lists of the subclasses in the table, for each class, with
+   * the roots (the classes without a superclass) in the first list */
+  memset(first, 0, (n+2)*sizeof(int));
+  for (i = 0; i < n; i++)
+  {
+    if (state[i] == 1)
     {
-      maxClasses *= 2;
-      info->Entries = (HierarchyEntry *)realloc(
-        info->Entries, sizeof(HierarchyEntry)*maxClasses*2);
+      first[parent[i] + 2]++;
     }
+  }
+  for (i = 0; i < n+1; i++)
+  {
+    first[i+1] += first[i];
+  }
+  for (i = 0; i < n; i++)
+  {
+    if (state[i] == 1)
+    {
+      children[first[parent[i] + 1]++] = i;
+    }
+  }
 
-    entry = &info->Entries[info->NumberOfEntries++];
-    entry->Name = NULL;
-    entry->HeaderFile = NULL;
-    entry->Module = NULL;
-    entry->NumberOfTemplateParameters = 0;
-    entry->TemplateParameters = NULL;
-    entry->TemplateDefaults = NULL;
-    entry->NumberOfProperties = 0;
-    entry->Properties = NULL;
-    entry->NumberOfSuperClasses = 0;
-    entry->SuperClasses = NULL;
-    entry->SuperClassIndex = NULL;
-    entry->Typedef = NULL;
-    entry->IsTypedef = 0;
-    entry->IsEnum = 0;
+  /* the subclasses of class p are now children[first[p]:first[p+1]],
+   * and the parent array is reused to step through these lists */
+  for (p = 0; p < n; p++)
+  {
+    parent[p] = first[p];
+    ancestry[2*p] = -1;
+    ancestry[2*p+1] = -1;
+  }
 
-    i = skip_space(line);
-    n = vtkParse_NameLength(&line[i]);
-    for (m = 0; m < n; m++)
+  /* walk each tree, the stack holds the classes whose interval is open */
+  t = 0;
+  for (k = 0; k < first[0]; k++)
+  {
+    l = 0;
+    stack[l++] = children[k];
+    ancestry[2*children[k]] = t++;
+    while (l > 0)
     {
-      if (line[i+m] == '<') { break; }
+      p = stack[l-1];
+      if (parent[p] < first[p+1])
+      {
+        /* go down to the next subclass */
+        j = children[parent[p]++];
+        stack[l++] = j;
+        ancestry[2*j] = t++;
+      }
+      else
+      {
+        /* all of the subclasses are done */
+        ancestry[2*p+1] = t;
+        l--;
+      }
     }
+  }
 
-    entry->Name = vtkParse_CacheString(info->Strings, &line[i], m);
-    i += m;
+  free(parent);
+  free(state);
+  free(stack);
+  free(first);
+  free(children);
+}
 
-    if (line[i] == '<')
+/* parse one line of a hierarchy file and add it as an entry */
+static void add_hierarchy_line(
+  HierarchyInfo *info, int *maxClasses, const char *line)
+{
+  HierarchyEntry *entry;
+  char *cp;
+  const char *ccp;
+  size_t i, j, n, m;
+  unsigned int bits, pointers;
+  static const char *delims = ">,=";
+
+  if (info->NumberOfEntries == *maxClasses)
+  {
+    *maxClasses *= 2;
+    info->Entries = (HierarchyEntry *)realloc(
+      info->Entries, sizeof(HierarchyEntry)*(*maxClasses)*2);
+  }
+
+  entry = &info->Entries[info->NumberOfEntries++];
+  entry->Name = NULL;
+  entry->HeaderFile = NULL;
+  entry->Module = NULL;
+  entry->NumberOfTemplateParameters = 0;
+  entry->TemplateParameters = NULL;
+  entry->TemplateDefaults = NULL;
+  entry->NumberOfProperties = 0;
+  entry->Properties = NULL;
+  entry->NumberOfSuperClasses = 0;
+  entry->SuperClasses = NULL;
+  entry->SuperClassIndex = NULL;
+  entry->Typedef = NULL;
+  entry->IsTypedef = 0;
+  entry->IsEnum = 0;
+
+  i = skip_space(line);
+  n = vtkParse_NameLength(&line[i]);
+  for (m = 0; m < n; m++)
+  {
+    if (line[i+m] == '<') { break; }
+  }
+
+  entry->Name = vtkParse_CacheString(info->Strings, &line[i], m);
+  i += m;
+
+  if (line[i] == '<')
+  {
+    i++;
+    i += skip_space(&line[i]);
+
+    for (j = 0; line[i] != '>' && line[i] != '\0'; j++)
     {
-      i++;
-      i += skip_space(&line[i]);
+      if (j == 0)
+      {
+        entry->TemplateParameters = (const char **)malloc(sizeof(char *));
+        entry->TemplateDefaults = (const char **)malloc(sizeof(char *));
+      }
+      else
+      {
+        entry->TemplateParameters = (const char **)realloc(
+          (char **)entry->TemplateParameters, (j+1)*sizeof(char *));
+        entry->TemplateDefaults = (const char **)realloc(
+          (char **)entry->TemplateDefaults, (j+1)*sizeof(char *));
+      }
+      entry->NumberOfTemplateParameters++;
+      entry->TemplateDefaults[j] = NULL;
 
-      for (j = 0; line[i] != '>' && line[i] != '\0'; j++)
+      m = skip_expression(&line[i], delims);
+      while (m > 0 && (line[i+m-1] == ' ' || line[i+m-1] == '\t'))
       {
-        if (j == 0)
-        {
-          entry->TemplateParameters = (const char **)malloc(sizeof(char *));
-          entry->TemplateDefaults = (const char **)malloc(sizeof(char *));
-        }
-        else
-        {
-          entry->TemplateParameters = (const char **)realloc(
-            (char **)entry->TemplateParameters, (j+1)*sizeof(char *));
-          entry->TemplateDefaults = (const char **)realloc(
-            (char **)entry->TemplateDefaults, (j+1)*sizeof(char *));
-        }
-        entry->NumberOfTemplateParameters++;
-        entry->TemplateDefaults[j] = NULL;
+        --m;
+      }
 
+      entry->TemplateParameters[j] =
+        vtkParse_CacheString(info->Strings, &line[i], m);
+      i += m;
+      i += skip_space(&line[i]);
+
+      if (line[i] == '=')
+      {
+        i++;
+        i += skip_space(&line[i]);
         m = skip_expression(&line[i], delims);
         while (m > 0 && (line[i+m-1] == ' ' || line[i+m-1] == '\t'))
         {
           --m;
         }
-
-        entry->TemplateParameters[j] =
+        entry->TemplateDefaults[j] =
           vtkParse_CacheString(info->Strings, &line[i], m);
         i += m;
         i += skip_space(&line[i]);
-
-        if (line[i] == '=')
-        {
-          i++;
-          i += skip_space(&line[i]);
-          m = skip_expression(&line[i], delims);
-          while (m > 0 && (line[i+m-1] == ' ' || line[i+m-1] == '\t'))
-          {
-            --m;
-          }
-          entry->TemplateDefaults[j] =
-            vtkParse_CacheString(info->Strings, &line[i], m);
-          i += m;
-          i += skip_space(&line[i]);
-        }
-
-        if (line[i] == ',')
-        {
-          i++;
-          i += skip_space(&line[i]);
-        }
       }
 
-      if (line[i] == '>')
+      if (line[i] == ',')
       {
         i++;
         i += skip_space(&line[i]);
       }
+    }
 
-      if (line[i] == ':' && line[i+1] == ':')
-      {
-        i += 2;
-        m = vtkParse_NameLength(&line[i]);
-        n = strlen(entry->Name);
-        cp = vtkParse_NewString(info->Strings, n+m+2);
-        strcpy(cp, entry->Name);
-        strcpy(&cp[n], "::");
-        strncpy(&cp[n+2], &line[i], m);
-        i += m;
-        cp[n+m+2] = '\0';
-        entry->Name = cp;
-      }
+    if (line[i] == '>')
+    {
+      i++;
+      i += skip_space(&line[i]);
     }
 
-    i += skip_space(&line[i]);
+    if (line[i] == ':' && line[i+1] == ':')
+    {
+      i += 2;
+      m = vtkParse_NameLength(&line[i]);
+      n = strlen(entry->Name);
+      cp = vtkParse_NewString(info->Strings, n+m+2);
+      strcpy(cp, entry->Name);
+      strcpy(&cp[n], "::");
+      strncpy(&cp[n+2], &line[i], m);
+      i += m;
+      cp[n+m+2] = '\0';
+      entry->Name = cp;
+    }
+  }
+
+  i += skip_space(&line[i]);
 
-    /* classes (and possibly enums) */
-    if (line[i] == ':')
+  /* classes (and possibly enums) */
+  if (line[i] == ':')
+  {
+    i++;
+    i += skip_space(&line[i]);
+    n = vtkParse_NameLength(&line[i]);
+    /* check for enum indicators */
+    if ((n == 3 && strncmp(&line[i], "int", n) == 0) ||
+        (n == 4 && strncmp(&line[i], "enum", n) == 0))
     {
-      i++;
+      entry->IsEnum = 1;
+      i += n;
       i += skip_space(&line[i]);
-      n = vtkParse_NameLength(&line[i]);
-      /* check for enum indicators */
-      if ((n == 3 && strncmp(&line[i], "int", n) == 0) ||
-          (n == 4 && strncmp(&line[i], "enum", n) == 0))
+    }
+    /* else check for superclasses */
+    else for (j = 0; ; j++)
+    {
+      if (j == 0)
       {
-        entry->IsEnum = 1;
-        i += n;
-        i += skip_space(&line[i]);
+        entry->SuperClasses = (const char **)malloc(sizeof(char *));
+        entry->SuperClassIndex = (int *)malloc(sizeof(int));
       }
-      /* else check for superclasses */
-      else for (j = 0; ; j++)
+      else
       {
-        if (j == 0)
-        {
-          entry->SuperClasses = (const char **)malloc(sizeof(char *));
-          entry->SuperClassIndex = (int *)malloc(sizeof(int));
-        }
-        else
-        {
-          entry->SuperClasses = (const char **)realloc(
-            (char **)entry->SuperClasses, (j+1)*sizeof(char *));
-          entry->SuperClassIndex = (int *)realloc(
-            entry->SuperClassIndex, (j+1)*sizeof(int));
-        }
-        entry->NumberOfSuperClasses++;
+        entry->SuperClasses = (const char **)realloc(
+          (char **)entry->SuperClasses, (j+1)*sizeof(char *));
+        entry->SuperClassIndex = (int *)realloc(
+          entry->SuperClassIndex, (j+1)*sizeof(int));
+      }
+      entry->NumberOfSuperClasses++;
 
-        i += skip_space(&line[i]);
-        n = vtkParse_NameLength(&line[i]);
-        entry->SuperClasses[j] =
-          vtkParse_CacheString(info->Strings, &line[i], n);
-        entry->SuperClassIndex[j] = -1;
-        i += n;
+      i += skip_space(&line[i]);
+      n = vtkParse_NameLength(&line[i]);
+      entry->SuperClasses[j] =
+        vtkParse_CacheString(info->Strings, &line[i], n);
+      entry->SuperClassIndex[j] = -1;
+      i += n;
 
-        i += skip_space(&line[i]);
-        if (line[i] != ',')
-        {
-          break;
-        }
-        i++;
+      i += skip_space(&line[i]);
+      if (line[i] != ',')
+      {
+        break;
       }
+      i++;
     }
+  }
 
-    /* read typedefs */
-    else if (line[i] == '=')
+  /* read typedefs */
+  else if (line[i] == '=')
+  {
+    i++;
+    i += skip_space(&line[i]);
+    entry->IsTypedef = 1;
+    entry->Typedef = (ValueInfo *)malloc(sizeof(ValueInfo));
+    vtkParse_InitValue(entry->Typedef);
+
+    /* type is a reference (does this ever occur?) */
+    if (line[i] == '&')
     {
       i++;
       i += skip_space(&line[i]);
-      entry->IsTypedef = 1;
-      entry->Typedef = (ValueInfo *)malloc(sizeof(ValueInfo));
-      vtkParse_InitValue(entry->Typedef);
+      entry->Typedef->Type |= VTK_PARSE_REF;
+    }
+
+    /* type has array dimensions */
+    if (line[i] == '[')
+    {
+      entry->Typedef->Count = 1;
+    }
 
-      /* type is a reference (does this ever occur?) */
-      if (line[i] == '&')
+    while (line[i] == '[')
+    {
+      i++;
+      n = 0;
+      while (line[i+n] != ']' && line[i+n] != '\n' && line[i+n] != '\0')
       {
-        i++;
-        i += skip_space(&line[i]);
-        entry->Typedef->Type |= VTK_PARSE_REF;
+        n++;
       }
-
-      /* type has array dimensions */
-      if (line[i] == '[')
+      ccp = vtkParse_CacheString(info->Strings, &line[i], n);
+      vtkParse_AddStringToArray(&entry->Typedef->Dimensions,
+                                &entry->Typedef->NumberOfDimensions, ccp);
+      if (ccp[0] >= '0' && ccp[0] <= '9')
       {
-        entry->Typedef->Count = 1;
+        entry->Typedef->Count *= (int)strtol(ccp, NULL, 0);
       }
-
-      while (line[i] == '[')
+      else
       {
-        i++;
-        n = 0;
-        while (line[i+n] != ']' && line[i+n] != '\n' && line[i+n] != '\0')
-        {
-          n++;
-        }
-        ccp = vtkParse_CacheString(info->Strings, &line[i], n);
-        vtkParse_AddStringToArray(&entry->Typedef->Dimensions,
-                                  &entry->Typedef->NumberOfDimensions, ccp);
-        if (ccp[0] >= '0' && ccp[0] <= '9')
-        {
-          entry->Typedef->Count *= (int)strtol(ccp, NULL, 0);
-        }
-        else
-        {
-          entry->Typedef->Count = 0;
-        }
-        i += n;
-        if (line[i] == ']')
-        {
-          i++;
-        }
+        entry->Typedef->Count = 0;
       }
-      i += skip_space(&line[i]);
-
-      /* look for pointers (and const pointers) */
-      bits = 0;
-      while (line[i] == '*' || strncmp(&line[i], "const*", 6) == 0)
+      i += n;
+      if (line[i] == ']')
       {
-        bits = (bits << 2);
-        if (line[i] == '*')
-        {
-          bits = (bits | VTK_PARSE_POINTER);
-        }
-        else
-        {
-          bits = (bits | VTK_PARSE_CONST_POINTER);
-          i += 5;
-        }
-        bits = (bits & VTK_PARSE_POINTER_MASK);
         i++;
-        i += skip_space(&line[i]);
       }
+    }
+    i += skip_space(&line[i]);
 
-      /* need to reverse to get correct pointer order */
-      pointers = 0;
-      while (bits)
+    /* look for pointers (and const pointers) */
+    bits = 0;
+    while (line[i] == '*' || strncmp(&line[i], "const*", 6) == 0)
+    {
+      bits = (bits << 2);
+      if (line[i] == '*')
+      {
+        bits = (bits | VTK_PARSE_POINTER);
+      }
+      else
       {
-        pointers = (pointers << 2);
-        pointers = (pointers | (bits & VTK_PARSE_POINTER_LOWMASK));
-        bits = ((bits >> 2) & VTK_PARSE_POINTER_MASK);
+        bits = (bits | VTK_PARSE_CONST_POINTER);
+        i += 5;
       }
+      bits = (bits & VTK_PARSE_POINTER_MASK);
+      i++;
+      i += skip_space(&line[i]);
+    }
+
+    /* need to reverse to get correct pointer order */
+    pointers = 0;
+    while (bits)
+    {
+      pointers = (pointers << 2);
+      pointers = (pointers | (bits & VTK_PARSE_POINTER_LOWMASK));
+      bits = ((bits >> 2) & VTK_PARSE_POINTER_MASK);
+    }
+
+    /* add pointer indirection to correspond to first array dimension */
+    if (entry->Typedef->NumberOfDimensions > 1)
+    {
+      pointers = ((pointers << 2) | VTK_PARSE_ARRAY);
+    }
+    else if (entry->Typedef->NumberOfDimensions == 1)
+    {
+      pointers = ((pointers << 2) | VTK_PARSE_POINTER);
+    }
+
+    /* include the pointers in the type */
+    entry->Typedef->Type |= (pointers & VTK_PARSE_POINTER_MASK);
+
+    /* read the base type (and const) */
+    bits = 0;
+    i += vtkParse_BasicTypeFromString(&line[i], &bits, &ccp, &n);
+    entry->Typedef->TypeName = vtkParse_CacheString(info->Strings, ccp, n);
+    entry->Typedef->Type |= bits;
+  }
+
+  /* get the header file */
+  if (line[i] == ';')
+  {
+    i++;
+    i += skip_space(&line[i]);
+    n = 0;
+    while(line[i+n] != '\0' && line[i+n] != ';' &&
+          !isspace(line[i+n])) { n++; };
+    entry->HeaderFile = vtkParse_CacheString(info->Strings, &line[i], n);
 
-      /* add pointer indirection to correspond to first array dimension */
-      if (entry->Typedef->NumberOfDimensions > 1)
+    i += n;
+    i += skip_space(&line[i]);
+
+    /* get the module */
+    if (line[i] == ';')
+    {
+      i++;
+      i += skip_space(&line[i]);
+      n = 0;
+      while(line[i+n] != '\0' && line[i+n] != ';' &&
+            !isspace(line[i+n])) { n++; };
+      entry->Module = vtkParse_CacheString(info->Strings, &line[i], n);
+
+      i += n;
+      i += skip_space(&line[i]);
+    }
+
+    /* get all flags */
+    while (line[i] == ';')
+    {
+      i++;
+      i += skip_space(&line[i]);
+      if (entry->NumberOfProperties == 0)
       {
-        pointers = ((pointers << 2) | VTK_PARSE_ARRAY);
+        entry->Properties = (const char **)malloc(sizeof(char **));
       }
-      else if (entry->Typedef->NumberOfDimensions == 1)
+      else
       {
-        pointers = ((pointers << 2) | VTK_PARSE_POINTER);
+        entry->Properties = (const char **)realloc(
+          (char **)entry->Properties,
+          (entry->NumberOfProperties+1)*sizeof(char **));
       }
+      n = 0;
+      while (line[i+n] != '\0' && line[i+n] != '\n' && line[i+n] != ';')
+        { n++; }
+      if (n && skip_space(&line[i]) != n)
+      {
+        entry->Properties[entry->NumberOfProperties++] =
+          vtkParse_CacheString(info->Strings, &line[i], n);
+      }
+      i += n;
+    }
+  }
+}
 
-      /* include the pointers in the type */
-      entry->Typedef->Type |= (pointers & VTK_PARSE_POINTER_MASK);
+/* allocate an empty HierarchyInfo */
+static HierarchyInfo *new_hierarchy_info(int maxClasses)
+{
+  HierarchyInfo *info;
+
+  info = (HierarchyInfo *)malloc(sizeof(HierarchyInfo));
+  info->NumberOfEntries = 0;
+  info->Entries = (HierarchyEntry *)malloc(maxClasses*sizeof(HierarchyEntry));
+  info->Strings = (StringCache *)malloc(sizeof(StringCache));
+  info->Cache = (struct _HierarchyCache *)calloc(
+    1, sizeof(struct _HierarchyCache));
+  vtkParse_InitStringCache(info->Strings);
+
+  return info;
+}
+
+/* read a hierarchy file into a HeirarchyInfo struct, or return NULL */
+HierarchyInfo *vtkParseHierarchy_ReadFile(const char *filename)
+{
+  HierarchyInfo *info;
+  int maxClasses = 500;
+  FILE *fp;
+  char *line;
+  size_t maxlen = 15;
+  size_t n;
+
+  line = (char *)malloc(maxlen);
+
+  fp = fopen(filename, "r");
+
+  if (fp == NULL)
+  {
+    return NULL;
+  }
+
+  vtkParse_StartPhase(VTK_PARSE_PHASE_HIERARCHY);
+
+  info = new_hierarchy_info(maxClasses);
+
+  while (fgets(line, (int)maxlen, fp))
+  {
+    n = strlen(line);
 
-      /* read the base type (and const) */
-      bits = 0;
-      i += vtkParse_BasicTypeFromString(&line[i], &bits, &ccp, &n);
-      entry->Typedef->TypeName = vtkParse_CacheString(info->Strings, ccp, n);
-      entry->Typedef->Type |= bits;
+    /* if buffer not long enough, increase it */
+    while (n == maxlen-1 && line[n-1] != '\n' && !feof(fp))
+    {
+      maxlen *= 2;
+      line = (char *)realloc(line, maxlen);
+      if (!fgets(&line[n], (int)(maxlen-n), fp)) { break; }
+      n += strlen(&line[n]);
     }
 
-    /* get the header file */
-    if (line[i] == ';')
+    while (n > 0 && isspace(line[n-1]))
     {
-      i++;
-      i += skip_space(&line[i]);
-      n = 0;
-      while(line[i+n] != '\0' && line[i+n] != ';' &&
-            !isspace(line[i+n])) { n++; };
-      entry->HeaderFile = vtkParse_CacheString(info->Strings, &line[i], n);
-
-      i += n;
-      i += skip_space(&line[i]);
-
-      /* get the module */
-      if (line[i] == ';')
-      {
-        i++;
-        i += skip_space(&line[i]);
-        n = 0;
-        while(line[i+n] != '\0' && line[i+n] != ';' &&
-              !isspace(line[i+n])) { n++; };
-        entry->Module = vtkParse_CacheString(info->Strings, &line[i], n);
-
-        i += n;
-        i += skip_space(&line[i]);
-      }
+      n--;
+    }
+    line[n] = '\0';
 
-      /* get all flags */
-      while (line[i] == ';')
-      {
-        i++;
-        i += skip_space(&line[i]);
-        if (entry->NumberOfProperties == 0)
-        {
-          entry->Properties = (const char **)malloc(sizeof(char **));
-        }
-        else
-        {
-          entry->Properties = (const char **)realloc(
-            (char **)entry->Properties,
-            (entry->NumberOfProperties+1)*sizeof(char **));
-        }
-        n = 0;
-        while (line[i+n] != '\0' && line[i+n] != '\n' && line[i+n] != ';')
-          { n++; }
-        if (n && skip_space(&line[i]) != n)
-        {
-          entry->Properties[entry->NumberOfProperties++] =
-            vtkParse_CacheString(info->Strings, &line[i], n);
-        }
-        i += n;
-      }
+    if (line[0] == '\0')
+    {
+      continue;
     }
+
+    add_hierarchy_line(info, &maxClasses, line);
   }
 
   if (!feof(fp))
@@ -536,11 +834,99 @@ HierarchyInfo *vtkParseHierarchy_ReadFile(const char *filename)
 
   free(line);
 
+  if (info)
+  {
+    sort_hierarchy_entries(info);
+  }
+
+  vtkParse_StopPhase(VTK_PARSE_PHASE_HIERARCHY);
+
+  return info;
+}
+
+/* for sorting the lines from a hierarchy database */
+static int compare_hierarchy_lines(const void *a, const void *b)
+{
+  return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/* read a kit from a hierarchy database, or return NULL */
+HierarchyInfo *vtkParseHierarchy_ReadDatabase(
+  const char *dbname, const char *filename)
+{
+  HierarchyInfo *info;
+  HierarchyDBInfo *db;
+  const char **lines;
+  char *line;
+  int maxClasses = 500;
+  int kit;
+  size_t i, m, n;
+
+  db = vtkParseHierarchyDB_ReadFile(dbname);
+  if (db == NULL)
+  {
+    return NULL;
+  }
+
+  kit = vtkParseHierarchyDB_FindKit(db, filename);
+  if (kit < 0 || !vtkParseHierarchyDB_CheckKit(db, kit))
+  {
+    vtkParseHierarchyDB_Free(db);
+    return NULL;
+  }
+
+  vtkParse_StartPhase(VTK_PARSE_PHASE_HIERARCHY);
+
+  /* use the same order as the lines in the hierarchy file */
+  lines = vtkParseHierarchyDB_GetLines(db, kit, &n);
+  qsort((void *)lines, n, sizeof(const char *), compare_hierarchy_lines);
+
+  info = new_hierarchy_info(maxClasses);
+
+  for (i = 0; i < n; i++)
+  {
+    if (i > 0 && strcmp(lines[i], lines[i-1]) == 0)
+    {
+      continue;
+    }
+
+    /* trim the line, as vtkParseHierarchy_ReadFile would */
+    m = strlen(lines[i]);
+    while (m > 0 && isspace(lines[i][m-1]))
+    {
+      m--;
+    }
+    if (m == 0)
+    {
+      continue;
+    }
+    if (lines[i][m] != '\0')
+    {
+      line = (char *)malloc(m + 1);
+      strncpy(line, lines[i], m);
+      line[m] = '\0';
+      add_hierarchy_line(info, &maxClasses, line);
+      free(line);
+    }
+    else
+    {
+      add_hierarchy_line(info, &maxClasses, lines[i]);
+    }
+  }
+
+  free((void *)lines);
+  vtkParseHierarchyDB_Free(db);
+
   sort_hierarchy_entries(info);
 
+  vtkParse_StopPhase(VTK_PARSE_PHASE_HIERARCHY);
+
   return info;
 }
 
+/* the typedef expansion cache is freed further below */
+static void free_expansions(HierarchyInfo *info);
+
 /* free a HierarchyInfo struct */
 void vtkParseHierarchy_Free(HierarchyInfo *info)
 {
@@ -567,10 +953,63 @@ void vtkParseHierarchy_Free(HierarchyInfo *info)
   }
 
   free(info->Entries);
+  free_expansions(info);
+  free(info->Cache->Slots);
+  free(info->Cache->Ancestry);
+  free(info->Cache);
   free(info);
 }
 
 
+/* helper: use the ancestry table to check whether class is derived
+ * from baseclass, returns -1 if the table cannot be used */
+static int check_ancestry(
+  const HierarchyInfo *info, const HierarchyEntry *entry,
+  const char *baseclass)
+{
+  const int *ancestry;
+  int n = info->NumberOfEntries;
+  int i, j;
+
+  if (entry < info->Entries || entry >= info->Entries + n)
+  {
+    return -1;
+  }
+
+  if (!info->Cache->Ancestry)
+  {
+    build_ancestry(info);
+  }
+  ancestry = info->Cache->Ancestry;
+
+  i = (int)(entry - info->Entries);
+  if (ancestry[2*i] < 0)
+  {
+    return -1;
+  }
+
+  /* if baseclass has no entry, nothing can be derived from it */
+  j = find_name(info, baseclass, 0);
+  if (j < 0)
+  {
+    return 0;
+  }
+
+  /* check every entry with the name, usually there is only one */
+  do
+  {
+    if (ancestry[2*j] >= 0 &&
+        ancestry[2*j] <= ancestry[2*i] &&
+        ancestry[2*i+1] <= ancestry[2*j+1])
+    {
+      return 1;
+    }
+  }
+  while (++j < n && strcmp(info->Entries[j].Name, baseclass) == 0);
+
+  return 0;
+}
+
 /* Check whether class is derived from baseclass.  You must supply
  * the entry for the class (returned by FindEntry) as well as the
  * classname.  If the class is templated, the classname can include
@@ -598,6 +1037,16 @@ int vtkParseHierarchy_IsTypeOfTemplated(
   int iterating = 1;
   int rval = 0;
 
+  /* use the table to quickly rule out classes that are not derived */
+  if (check_ancestry(info, entry, baseclass) == 0)
+  {
+    if (baseclass_with_args)
+    {
+      *baseclass_with_args = NULL;
+    }
+    return 0;
+  }
+
   while (iterating)
   {
     iterating = 0;
@@ -718,11 +1167,14 @@ int vtkParseHierarchy_IsTypeOfTemplated(
         classname_needs_free = supername_needs_free;
         supername_needs_free = 0;
 
-        /* use the iteration loop instead of recursion */
+        /* use the iteration loop instead of recursion, this must be
+         * the last superclass, so stop looping over the superclasses
+         * before "entry" is changed */
         if (j+1 >= entry->NumberOfSuperClasses)
         {
           entry = &info->Entries[i];
           iterating = 1;
+          break;
         }
 
         /* recurse for multiple inheritance */
@@ -766,6 +1218,13 @@ int vtkParseHierarchy_IsTypeOf(
   const HierarchyInfo *info, const HierarchyEntry *entry,
   const char *baseclass)
 {
+  int rval = check_ancestry(info, entry, baseclass);
+
+  if (rval >= 0)
+  {
+    return rval;
+  }
+
   return vtkParseHierarchy_IsTypeOfTemplated(
     info, entry, entry->Name, baseclass, NULL);
 }
@@ -848,11 +1307,182 @@ const char *vtkParseHierarchy_GetProperty(
   return NULL;
 }
 
-/* Expand all unrecognized types in a ValueInfo struct by
- * using the typedefs in the HierarchyInfo struct. */
-int vtkParseHierarchy_ExpandTypedefsInValue(
+/* One change that typedef expansion made to a ValueInfo, either the
+ * expansion of a typedef or the replacement of the type name */
+typedef struct _HierarchyAction
+{
+  ValueInfo  *Typedef;  /* the typedef that was expanded, or NULL */
+  const char *TypeName; /* the new type name, if Typedef is NULL */
+} HierarchyAction;
+
+/* The result of expanding a type name in a scope, as the list of the
+ * changes that were made to the ValueInfo.  The expansion only depends
+ * on the name and the scope, so the changes can be replayed for any
+ * ValueInfo that has the same name. */
+typedef struct _HierarchyExpansion
+{
+  const char      *Scope;   /* the scope, or NULL */
+  const char      *Name;    /* the type name that was expanded */
+  unsigned int     Hash;
+  int              Result;  /* the return value of the expansion */
+  int              NumberOfActions;
+  HierarchyAction *Actions;
+} HierarchyExpansion;
+
+/* helper: add an action to an expansion */
+static void add_expansion_action(
+  HierarchyExpansion *exp, ValueInfo *tdef, const char *name)
+{
+  int n = exp->NumberOfActions;
+
+  /* grow the array when the size reaches a power of two */
+  if (n == 0)
+  {
+    exp->Actions = (HierarchyAction *)malloc(sizeof(HierarchyAction));
+  }
+  else if ((n & (n - 1)) == 0)
+  {
+    exp->Actions = (HierarchyAction *)realloc(
+      exp->Actions, 2*n*sizeof(HierarchyAction));
+  }
+
+  exp->Actions[n].Typedef = tdef;
+  exp->Actions[n].TypeName = name;
+  exp->NumberOfActions++;
+}
+
+/* helper: the hash for a scope and name */
+static unsigned int hash_scoped_name(const char *scope, const char *name)
+{
+  unsigned int h = 0;
+
+  if (scope)
+  {
+    h = hash_chars(5381, scope, strlen(scope));
+  }
+
+  return hash_chars(h*33 + ':', name, strlen(name));
+}
+
+/* helper: find a cached expansion, or return NULL */
+static HierarchyExpansion *find_expansion(
+  const HierarchyInfo *info, const char *scope, const char *name,
+  unsigned int h)
+{
+  struct _HierarchyCache *hc = info->Cache;
+  HierarchyExpansion *exp;
+  unsigned int k, mask;
+
+  if (!hc->ExpansionSlots)
+  {
+    return NULL;
+  }
+
+  mask = (unsigned int)hc->NumberOfExpansionSlots - 1;
+  for (k = h & mask; (exp = hc->ExpansionSlots[k]) != NULL;
+       k = (k + 1) & mask)
+  {
+    if (exp->Hash == h && strcmp(exp->Name, name) == 0 &&
+        (exp->Scope == scope ||
+         (exp->Scope && scope && strcmp(exp->Scope, scope) == 0)))
+    {
+      return exp;
+    }
+  }
+
+  return NULL;
+}
+
+/* helper: add an expansion to the cache, the cache is part of the
+ * hierarchy, but is not considered to be part of its value */
+static void add_expansion(const HierarchyInfo *info, HierarchyExpansion *exp)
+{
+  struct _HierarchyCache *hc = info->Cache;
+  HierarchyExpansion **slots;
+  unsigned int k, mask;
+  int i, n;
+
+  if (!hc->ExpansionSlots)
+  {
+    hc->NumberOfExpansionSlots = 64;
+    hc->NumberOfExpansions = 0;
+    hc->ExpansionSlots = (HierarchyExpansion **)calloc(
+      hc->NumberOfExpansionSlots, sizeof(HierarchyExpansion *));
+  }
+
+  /* keep the table at most half full */
+  if (2*(hc->NumberOfExpansions + 1) > hc->NumberOfExpansionSlots)
+  {
+    n = hc->NumberOfExpansionSlots;
+    slots = hc->ExpansionSlots;
+    hc->NumberOfExpansionSlots = 2*n;
+    hc->ExpansionSlots = (HierarchyExpansion **)calloc(
+      hc->NumberOfExpansionSlots, sizeof(HierarchyExpansion *));
+    mask = (unsigned int)hc->NumberOfExpansionSlots - 1;
+    for (i = 0; i < n; i++)
+    {
+      if (slots[i])
+      {
+        for (k = slots[i]->Hash & mask; hc->ExpansionSlots[k];
+             k = (k + 1) & mask)
+        {
+          ;
+        }
+        hc->ExpansionSlots[k] = slots[i];
+      }
+    }
+    free(slots);
+  }
+
+  mask = (unsigned int)hc->NumberOfExpansionSlots - 1;
+  for (k = exp->Hash & mask; hc->ExpansionSlots[k]; k = (k + 1) & mask)
+  {
+    ;
+  }
+  hc->ExpansionSlots[k] = exp;
+  hc->NumberOfExpansions++;
+}
+
+/* helper: free the cache of typedef expansions */
+static void free_expansions(HierarchyInfo *info)
+{
+  struct _HierarchyCache *hc = info->Cache;
+  int i;
+
+  if (hc->ExpansionSlots)
+  {
+    for (i = 0; i < hc->NumberOfExpansionSlots; i++)
+    {
+      if (hc->ExpansionSlots[i])
+      {
+        free(hc->ExpansionSlots[i]->Actions);
+        free(hc->ExpansionSlots[i]);
+      }
+    }
+    free(hc->ExpansionSlots);
+    hc->ExpansionSlots = NULL;
+  }
+}
+
+/* helper: set the type name of a value, and record the change */
+static void set_expanded_name(
   const HierarchyInfo *info, ValueInfo *val, StringCache *cache,
-  const char *scope)
+  const char *name, size_t n, HierarchyExpansion *rec)
+{
+  val->TypeName = vtkParse_CacheString(cache, name, n);
+  add_expansion_action(
+    rec, NULL, vtkParse_CacheString(info->Strings, name, n));
+}
+
+static int expand_typedefs_cached(
+  const HierarchyInfo *info, ValueInfo *val, StringCache *cache,
+  const char *scope, HierarchyExpansion *rec);
+
+/* helper: expand the typedefs in a value without using the cache for
+ * the value itself, and record every change that is made to it */
+static int expand_typedefs_uncached(
+  const HierarchyInfo *info, ValueInfo *val, StringCache *cache,
+  const char *scope, HierarchyExpansion *rec)
 {
   char text[128];
   char *cp;
@@ -907,8 +1537,7 @@ int vtkParseHierarchy_ExpandTypedefsInValue(
               info, entry->SuperClasses[i], NULL);
             scope_needs_free = (scope != entry->SuperClasses[i]);
             /* recurse if more than one superclass */
-            if (vtkParseHierarchy_ExpandTypedefsInValue(
-                  info, val, cache, scope))
+            if (expand_typedefs_cached(info, val, cache, scope, rec))
             {
               if (scope_needs_free) { free((char *)scope); }
               return 1;
@@ -932,6 +1561,7 @@ int vtkParseHierarchy_ExpandTypedefsInValue(
     if (entry && entry->IsTypedef)
     {
       vtkParse_ExpandTypedef(val, entry->Typedef);
+      add_expansion_action(rec, entry->Typedef, NULL);
       /* check if the typedef includes a scope operator */
       n = vtkParse_UnscopedNameLength(val->TypeName);
       if (val->TypeName[n] == ':' && val->TypeName[n+1] == ':')
@@ -941,8 +1571,7 @@ int vtkParseHierarchy_ExpandTypedefsInValue(
         vtkParse_InitValue(&prefix);
         prefix.Type = VTK_PARSE_UNKNOWN;
         prefix.TypeName = vtkParse_CacheString(cache, val->TypeName, n);
-        vtkParseHierarchy_ExpandTypedefsInValue(
-            info, &prefix, cache, scope);
+        expand_typedefs_cached(info, &prefix, cache, scope, NULL);
         l = strlen(prefix.TypeName);
         if (l != n || strncmp(prefix.TypeName, val->TypeName, l) != 0)
         {
@@ -953,7 +1582,7 @@ int vtkParseHierarchy_ExpandTypedefsInValue(
           strncpy(cp, prefix.TypeName, l);
           strncpy(cp + l, &val->TypeName[n], m - l);
           cp[m] = '\0';
-          val->TypeName = vtkParse_CacheString(cache, cp, m);
+          set_expanded_name(info, val, cache, cp, m, rec);
           free(cp);
         }
       }
@@ -964,7 +1593,7 @@ int vtkParseHierarchy_ExpandTypedefsInValue(
          info, val->TypeName, scope);
       if (newclass != val->TypeName)
       {
-        val->TypeName = vtkParse_CacheString(cache, newclass, strlen(newclass));
+        set_expanded_name(info, val, cache, newclass, strlen(newclass), rec);
         free((char *)newclass);
       }
       result = 1;
@@ -982,6 +1611,134 @@ int vtkParseHierarchy_ExpandTypedefsInValue(
   return result;
 }
 
+/* helper: expand the typedefs in a value, using the cache if the name
+ * was already expanded in the same scope.  The changes are also added
+ * to "rec", if it is not NULL. */
+static int expand_typedefs_cached(
+  const HierarchyInfo *info, ValueInfo *val, StringCache *cache,
+  const char *scope, HierarchyExpansion *rec)
+{
+  HierarchyExpansion *exp;
+  HierarchyAction *action;
+  unsigned int h;
+  int i;
+
+  if (((val->Type & VTK_PARSE_BASE_TYPE) != VTK_PARSE_OBJECT &&
+       (val->Type & VTK_PARSE_BASE_TYPE) != VTK_PARSE_UNKNOWN) ||
+      val->TypeName == 0)
+  {
+    return 1;
+  }
+
+  h = hash_scoped_name(scope, val->TypeName);
+  exp = find_expansion(info, scope, val->TypeName, h);
+
+  if (exp)
+  {
+    /* replay the changes */
+    for (i = 0; i < exp->NumberOfActions; i++)
+    {
+      action = &exp->Actions[i];
+      if (action->Typedef)
+      {
+        vtkParse_ExpandTypedef(val, action->Typedef);
+      }
+      else
+      {
+        val->TypeName = vtkParse_CacheString(
+          cache, action->TypeName, strlen(action->TypeName));
+      }
+    }
+  }
+  else
+  {
+    exp = (HierarchyExpansion *)malloc(sizeof(HierarchyExpansion));
+    exp->Scope = NULL;
+    if (scope)
+    {
+      exp->Scope = vtkParse_CacheString(info->Strings, scope, strlen(scope));
+    }
+    exp->Name = vtkParse_CacheString(
+      info->Strings, val->TypeName, strlen(val->TypeName));
+    exp->Hash = h;
+    exp->NumberOfActions = 0;
+    exp->Actions = NULL;
+    exp->Result = expand_typedefs_uncached(info, val, cache, scope, exp);
+    add_expansion(info, exp);
+  }
+
+  if (rec)
+  {
+    for (i = 0; i < exp->NumberOfActions; i++)
+    {
+      add_expansion_action(rec, exp->Actions[i].Typedef,
+                           exp->Actions[i].TypeName);
+    }
+  }
+
+  return exp->Result;
+}
+
+/* helper: expand every typedef in the hierarchy within its own scope,
+ * so that the cache holds the expansions that are most often needed */
+static void expand_all_typedefs(const HierarchyInfo *info)
+{
+  HierarchyEntry *entry;
+  ValueInfo val;
+  const char *name;
+  const char *scope;
+  size_t l, m;
+  int i;
+
+  for (i = 0; i < info->NumberOfEntries; i++)
+  {
+    entry = &info->Entries[i];
+    if (!entry->IsTypedef)
+    {
+      continue;
+    }
+
+    /* split the name into the scope and the unscoped name */
+    name = entry->Name;
+    scope = NULL;
+    m = 0;
+    for (l = 0; name[l] != '\0'; l++)
+    {
+      if (name[l] == ':' && name[l+1] == ':')
+      {
+        m = l;
+      }
+    }
+    if (m > 0)
+    {
+      scope = vtkParse_CacheString(info->Strings, name, m);
+      name = &name[m+2];
+    }
+
+    vtkParse_InitValue(&val);
+    val.Type = VTK_PARSE_UNKNOWN;
+    val.TypeName = name;
+    expand_typedefs_cached(info, &val, info->Strings, scope, NULL);
+    free((char **)val.Dimensions);
+  }
+}
+
+/* Expand all unrecognized types in a ValueInfo struct by
+ * using the typedefs in the HierarchyInfo struct. */
+int vtkParseHierarchy_ExpandTypedefsInValue(
+  const HierarchyInfo *info, ValueInfo *val, StringCache *cache,
+  const char *scope)
+{
+  /* the first time, expand all the typedefs in the hierarchy */
+  if (!info->Cache->ExpandedAll)
+  {
+    info->Cache->ExpandedAll = 1;
+    expand_all_typedefs(info);
+  }
+
+  return expand_typedefs_cached(info, val, cache, scope, NULL);
+}
+
 /* Expand typedefs found in an expression stored as a string.
  * The value of "text" will be returned if no expansion occurred,
  * else a new string is returned that must be freed with "free()". */
@@ -72,6 +72,10 @@ typedef struct _HierarchyInfo
   int             NumberOfEntries;
   HierarchyEntry *Entries;
   StringCache    *Strings;
+  /* The lookup tables, for internal use only.  They are built by the
+   * first lookup that needs them, so they change even when the
+   * HierarchyInfo is const.  Only the pointer is set when it is read. */
+  struct _HierarchyCache *Cache;
 } HierarchyInfo;
 
 #ifdef __cplusplus
@@ -83,13 +87,24 @@ extern "C" {
  */
 HierarchyInfo *vtkParseHierarchy_ReadFile(const char *filename);
 
+/**
+ * Read a hierarchy file from a hierarchy database, or return NULL if
+ * the database does not have a valid copy of the file.  The result is
+ * the same as from vtkParseHierarchy_ReadFile.  Every line is still
+ * parsed, so this is not faster than reading a hierarchy file, which
+ * already holds the lines of the files that it depends on.
+ */
+HierarchyInfo *vtkParseHierarchy_ReadDatabase(
+  const char *dbname, const char *filename);
+
 /**
  * Free a HierarchyInfo struct
  */
 void vtkParseHierarchy_Free(HierarchyInfo *info);
 
 /**
- * Return the entry for a class or type, or null if not found
+ * Return the entry for a class or type, or null if not found.  Any
+ * template args in the name are ignored, and no memory is allocated.
  */
 HierarchyEntry *vtkParseHierarchy_FindEntry(
   const HierarchyInfo *info, const char *classname);
@@ -104,7 +119,9 @@ const char *vtkParseHierarchy_GetProperty(
   const HierarchyEntry *entry, const char *property);
 
 /**
- * Check whether class is derived from baseclass.
+ * Check whether class is derived from baseclass.  For classes that
+ * have single inheritance all the way up, this uses a table that is
+ * built by the first call, instead of walking the superclasses.
  */
 int vtkParseHierarchy_IsTypeOf(const HierarchyInfo *info,
   const HierarchyEntry *entry, const char *baseclass);
@@ -138,7 +155,9 @@ const char *vtkParseHierarchy_TemplatedSuperClass(
 
 /**
  * Expand all unrecognized types in a ValueInfo struct by
- * using the typedefs in the HierarchyInfo struct.
+ * using the typedefs in the HierarchyInfo struct.  The expansion of
+ * each name in each scope is cached, and the first call expands every
+ * typedef in the hierarchy.
  */
 int vtkParseHierarchy_ExpandTypedefsInValue(
   const HierarchyInfo *info, ValueInfo *data, StringCache *cache,
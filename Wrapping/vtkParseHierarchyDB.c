@@ -0,0 +1,824 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseHierarchyDB.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+#include "vtkParseHierarchyDB.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* the sizes of the parts of the database */
+#define HDB_HEADER_SIZE 36
+#define HDB_KIT_SIZE 32
+#define HDB_DEPEND_SIZE 16
+#define HDB_LINE_SIZE 4
+
+/* a kit that is being written */
+typedef struct _HierarchyDBKit
+{
+  const char    *Name;
+  unsigned long  FileSize;
+  unsigned long  FileTime;
+  unsigned long  FileTimeNSec;
+  size_t         NumberOfLines;
+  const char   **Lines;
+  size_t         NumberOfDepends;
+  unsigned long *Depends;      /* kit index, file size, time, nsec */
+} HierarchyDBKit;
+
+/* Read a 32-bit little-endian integer */
+static unsigned long hdb_get32(const unsigned char *cp)
+{
+  return ((unsigned long)cp[0] |
+          ((unsigned long)cp[1] << 8) |
+          ((unsigned long)cp[2] << 16) |
+          ((unsigned long)cp[3] << 24));
+}
+
+/* Write a 32-bit little-endian integer */
+static void hdb_put32(unsigned char *cp, size_t v)
+{
+  cp[0] = (unsigned char)(v & 0xff);
+  cp[1] = (unsigned char)((v >> 8) & 0xff);
+  cp[2] = (unsigned char)((v >> 16) & 0xff);
+  cp[3] = (unsigned char)((v >> 24) & 0xff);
+}
+
+/* Get the size and time of a file, return zero on failure.  The time
+ * is split into seconds and nanoseconds, the nanoseconds are zero if the
+ * platform does not provide them. */
+static int hdb_file_stat(
+  const char *filename, unsigned long *size, unsigned long *time,
+  unsigned long *nsec)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  WIN32_FILE_ATTRIBUTE_DATA fa;
+  ULONGLONG ticks;
+
+  if (!GetFileAttributesExA(filename, GetFileExInfoStandard, &fa))
+  {
+    return 0;
+  }
+
+  /* the file time is in 100ns ticks */
+  ticks = (((ULONGLONG)fa.ftLastWriteTime.dwHighDateTime << 32) |
+           fa.ftLastWriteTime.dwLowDateTime);
+  *size = (unsigned long)fa.nFileSizeLow;
+  *time = (unsigned long)(ticks/10000000) & 0xfffffffful;
+  *nsec = (unsigned long)(ticks%10000000)*100;
+#else
+  struct stat fs;
+
+  if (stat(filename, &fs) != 0)
+  {
+    return 0;
+  }
+
+  *size = (unsigned long)fs.st_size & 0xfffffffful;
+  *time = (unsigned long)fs.st_mtime & 0xfffffffful;
+#if defined(__APPLE__)
+  *nsec = (unsigned long)fs.st_mtimespec.tv_nsec;
+#elif defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200809L
+  *nsec = (unsigned long)fs.st_mtim.tv_nsec;
+#else
+  *nsec = 0;
+#endif
+#endif
+
+  return 1;
+}
+
+/* Map a file into memory, return NULL on failure */
+static const unsigned char *hdb_map_file(
+  const char *filename, size_t *size)
+{
+  const unsigned char *data = NULL;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE file;
+  HANDLE mapping;
+  LARGE_INTEGER filesize;
+
+  file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return NULL;
+  }
+  if (GetFileSizeEx(file, &filesize) && filesize.QuadPart > 0 &&
+      filesize.HighPart == 0)
+  {
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+    {
+      data = (const unsigned char *)MapViewOfFile(
+        mapping, FILE_MAP_READ, 0, 0, 0);
+      *size = (size_t)filesize.LowPart;
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  struct stat fs;
+  void *map;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    return NULL;
+  }
+  if (fstat(fd, &fs) == 0 && fs.st_size > 0)
+  {
+    map = mmap(NULL, (size_t)fs.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED)
+    {
+      data = (const unsigned char *)map;
+      *size = (size_t)fs.st_size;
+    }
+  }
+  close(fd);
+#endif
+
+  return data;
+}
+
+/* Unmap a file */
+static void hdb_unmap_file(const unsigned char *data, size_t size)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  (void)size;
+  UnmapViewOfFile(data);
+#else
+  munmap((void *)data, size);
+#endif
+}
+
+/* Check that the database is valid, so that the lookups can be fast */
+static int hdb_check(const unsigned char *data, size_t size)
+{
+  unsigned long nkits, nlines, ndepends, i;
+  size_t kits_offset, depends_offset, lines_offset, strings_offset;
+  const unsigned char *cp;
+
+  if (size < HDB_HEADER_SIZE || memcmp(data, "VTKHIDB", 8) != 0 ||
+      hdb_get32(&data[8]) != VTK_HIERARCHY_DB_VERSION ||
+      data[size - 1] != '\0')
+  {
+    return 0;
+  }
+
+  nkits = hdb_get32(&data[12]);
+  nlines = hdb_get32(&data[16]);
+  kits_offset = hdb_get32(&data[20]);
+  depends_offset = hdb_get32(&data[24]);
+  lines_offset = hdb_get32(&data[28]);
+  strings_offset = hdb_get32(&data[32]);
+
+  if (nkits > size/HDB_KIT_SIZE || nlines > size/HDB_LINE_SIZE ||
+      kits_offset != HDB_HEADER_SIZE ||
+      depends_offset != kits_offset + HDB_KIT_SIZE*nkits ||
+      lines_offset < depends_offset ||
+      (lines_offset - depends_offset) % HDB_DEPEND_SIZE != 0 ||
+      strings_offset != lines_offset + HDB_LINE_SIZE*nlines ||
+      strings_offset > size)
+  {
+    return 0;
+  }
+  ndepends = (unsigned long)((lines_offset - depends_offset)/HDB_DEPEND_SIZE);
+
+  /* the last byte is a nul, so every string is terminated */
+  for (i = 0; i < nlines; i++)
+  {
+    if (hdb_get32(&data[lines_offset + HDB_LINE_SIZE*i]) < strings_offset ||
+        hdb_get32(&data[lines_offset + HDB_LINE_SIZE*i]) >= size)
+    {
+      return 0;
+    }
+  }
+
+  for (i = 0; i < ndepends; i++)
+  {
+    if (hdb_get32(&data[depends_offset + HDB_DEPEND_SIZE*i]) >= nkits)
+    {
+      return 0;
+    }
+  }
+
+  for (i = 0; i < nkits; i++)
+  {
+    cp = &data[kits_offset + HDB_KIT_SIZE*i];
+    if (hdb_get32(&cp[0]) < strings_offset ||
+        hdb_get32(&cp[0]) >= size ||
+        hdb_get32(&cp[16]) > nlines ||
+        hdb_get32(&cp[20]) > nlines - hdb_get32(&cp[16]) ||
+        hdb_get32(&cp[24]) > ndepends ||
+        hdb_get32(&cp[28]) > ndepends - hdb_get32(&cp[24]))
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* Open a database */
+HierarchyDBInfo *vtkParseHierarchyDB_ReadFile(const char *filename)
+{
+  HierarchyDBInfo *db;
+  const unsigned char *data;
+  size_t size = 0;
+
+  data = hdb_map_file(filename, &size);
+  if (data == NULL)
+  {
+    return NULL;
+  }
+
+  if (!hdb_check(data, size))
+  {
+    hdb_unmap_file(data, size);
+    return NULL;
+  }
+
+  db = (HierarchyDBInfo *)malloc(sizeof(HierarchyDBInfo));
+  db->Data = data;
+  db->Size = size;
+  db->NumberOfKits = hdb_get32(&data[12]);
+  db->NumberOfLines = hdb_get32(&data[16]);
+
+  return db;
+}
+
+/* Close a database */
+void vtkParseHierarchyDB_Free(HierarchyDBInfo *db)
+{
+  hdb_unmap_file(db->Data, db->Size);
+  free(db);
+}
+
+/* Get the record for kit "i" */
+static const unsigned char *hdb_kit(const HierarchyDBInfo *db, int i)
+{
+  return &db->Data[hdb_get32(&db->Data[20]) + HDB_KIT_SIZE*i];
+}
+
+/* Get the record for dependency "i" */
+static const unsigned char *hdb_depend(
+  const HierarchyDBInfo *db, unsigned long i)
+{
+  return &db->Data[hdb_get32(&db->Data[24]) + HDB_DEPEND_SIZE*i];
+}
+
+/* Find a kit by name, there are few enough to search them all */
+int vtkParseHierarchyDB_FindKit(const HierarchyDBInfo *db, const char *name)
+{
+  unsigned long i;
+
+  for (i = 0; i < db->NumberOfKits; i++)
+  {
+    if (strcmp((const char *)&db->Data[hdb_get32(hdb_kit(db, (int)i))],
+               name) == 0)
+    {
+      return (int)i;
+    }
+  }
+
+  return -1;
+}
+
+/* Get the name of a kit */
+const char *vtkParseHierarchyDB_GetKitName(const HierarchyDBInfo *db, int i)
+{
+  if (i < 0 || (unsigned long)i >= db->NumberOfKits)
+  {
+    return NULL;
+  }
+
+  return (const char *)&db->Data[hdb_get32(hdb_kit(db, i))];
+}
+
+/* Check that the dependencies of a kit have not changed */
+static int hdb_check_depends(
+  const HierarchyDBInfo *db, int i, unsigned char *visited)
+{
+  const unsigned char *cp;
+  const unsigned char *dp;
+  const unsigned char *kp;
+  unsigned long j, n;
+
+  if (visited[i])
+  {
+    return 1;
+  }
+  visited[i] = 1;
+
+  cp = hdb_kit(db, i);
+  j = hdb_get32(&cp[24]);
+  n = j + hdb_get32(&cp[28]);
+  for (; j < n; j++)
+  {
+    dp = hdb_depend(db, j);
+    kp = hdb_kit(db, (int)hdb_get32(&dp[0]));
+    if (hdb_get32(&kp[4]) != hdb_get32(&dp[4]) ||
+        hdb_get32(&kp[8]) != hdb_get32(&dp[8]) ||
+        hdb_get32(&kp[12]) != hdb_get32(&dp[12]) ||
+        !hdb_check_depends(db, (int)hdb_get32(&dp[0]), visited))
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* Check that a kit matches its hierarchy file */
+int vtkParseHierarchyDB_CheckKit(const HierarchyDBInfo *db, int i)
+{
+  const unsigned char *cp;
+  unsigned char *visited;
+  const char *filename;
+  unsigned long size, time, nsec;
+  int result;
+
+  if (i < 0 || (unsigned long)i >= db->NumberOfKits)
+  {
+    return 0;
+  }
+
+  /* only the file's stat is checked, its contents are not read */
+  cp = hdb_kit(db, i);
+  filename = (const char *)&db->Data[hdb_get32(&cp[0])];
+  if (!hdb_file_stat(filename, &size, &time, &nsec) ||
+      size != hdb_get32(&cp[4]) || time != hdb_get32(&cp[8]) ||
+      nsec != hdb_get32(&cp[12]))
+  {
+    return 0;
+  }
+
+  visited = (unsigned char *)calloc(db->NumberOfKits, 1);
+  result = hdb_check_depends(db, i, visited);
+  free(visited);
+
+  return result;
+}
+
+/* Get the lines for a kit and for all the kits it depends on */
+const char **vtkParseHierarchyDB_GetLines(
+  const HierarchyDBInfo *db, int i, size_t *np)
+{
+  const char **lines;
+  const unsigned char *cp;
+  unsigned char *visited;
+  int *stack;
+  size_t n = 0;
+  size_t m = 0;
+  size_t lines_offset;
+  unsigned long j, k, l;
+  int top = 0;
+
+  *np = 0;
+  if (i < 0 || (unsigned long)i >= db->NumberOfKits)
+  {
+    return NULL;
+  }
+
+  /* each kit is pushed at most once */
+  visited = (unsigned char *)calloc(db->NumberOfKits, 1);
+  stack = (int *)malloc(db->NumberOfKits*sizeof(int));
+  stack[top++] = i;
+  visited[i] = 1;
+  while (top > 0)
+  {
+    cp = hdb_kit(db, stack[--top]);
+    m += hdb_get32(&cp[20]);
+    j = hdb_get32(&cp[24]);
+    l = j + hdb_get32(&cp[28]);
+    for (; j < l; j++)
+    {
+      k = hdb_get32(hdb_depend(db, j));
+      if (!visited[k])
+      {
+        visited[k] = 1;
+        stack[top++] = (int)k;
+      }
+    }
+  }
+
+  lines = (const char **)malloc((m + 1)*sizeof(const char *));
+  lines_offset = hdb_get32(&db->Data[28]);
+  for (k = 0; k < db->NumberOfKits; k++)
+  {
+    if (visited[k])
+    {
+      cp = hdb_kit(db, (int)k);
+      j = hdb_get32(&cp[16]);
+      l = j + hdb_get32(&cp[20]);
+      for (; j < l; j++)
+      {
+        lines[n++] = (const char *)&db->Data[
+          hdb_get32(&db->Data[lines_offset + HDB_LINE_SIZE*j])];
+      }
+    }
+  }
+  lines[n] = NULL;
+
+  free(stack);
+  free(visited);
+
+  *np = n;
+  return lines;
+}
+
+/* Get a line by index */
+const char *vtkParseHierarchyDB_GetLine(const HierarchyDBInfo *db, long i)
+{
+  if (i < 0 || (unsigned long)i >= db->NumberOfLines)
+  {
+    return NULL;
+  }
+
+  return (const char *)&db->Data[
+    hdb_get32(&db->Data[hdb_get32(&db->Data[28]) + HDB_LINE_SIZE*i])];
+}
+
+/* for sorting and searching lines */
+static int hdb_compare_lines(const void *a, const void *b)
+{
+  return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/* Copy a kit from an existing database */
+static void hdb_copy_kit(
+  const HierarchyDBInfo *db, int i, HierarchyDBKit *kit)
+{
+  const unsigned char *cp;
+  unsigned long j, k;
+
+  cp = hdb_kit(db, i);
+  kit->Name = vtkParseHierarchyDB_GetKitName(db, i);
+  kit->FileSize = hdb_get32(&cp[4]);
+  kit->FileTime = hdb_get32(&cp[8]);
+  kit->FileTimeNSec = hdb_get32(&cp[12]);
+  kit->NumberOfLines = hdb_get32(&cp[20]);
+  kit->Lines = (const char **)malloc(
+    (kit->NumberOfLines + 1)*sizeof(const char *));
+  for (j = 0; j < kit->NumberOfLines; j++)
+  {
+    kit->Lines[j] = vtkParseHierarchyDB_GetLine(
+      db, (long)(hdb_get32(&cp[16]) + j));
+  }
+  kit->NumberOfDepends = hdb_get32(&cp[28]);
+  kit->Depends = (unsigned long *)malloc(
+    (4*kit->NumberOfDepends + 1)*sizeof(unsigned long));
+  for (j = 0; j < kit->NumberOfDepends; j++)
+  {
+    for (k = 0; k < 4; k++)
+    {
+      kit->Depends[4*j + k] =
+        hdb_get32(&hdb_depend(db, hdb_get32(&cp[24]) + j)[4*k]);
+    }
+  }
+}
+
+/* Build the database file contents from a set of kits */
+static unsigned char *hdb_build(
+  HierarchyDBKit *kits, size_t nkits, size_t *sizep)
+{
+  unsigned char *data;
+  const char *line;
+  size_t nlines = 0;
+  size_t ndepends = 0;
+  size_t kits_offset, depends_offset, lines_offset, strings_offset;
+  size_t size, pos, i, j, k, n, l;
+
+  for (i = 0; i < nkits; i++)
+  {
+    nlines += kits[i].NumberOfLines;
+    ndepends += kits[i].NumberOfDepends;
+  }
+
+  kits_offset = HDB_HEADER_SIZE;
+  depends_offset = kits_offset + HDB_KIT_SIZE*nkits;
+  lines_offset = depends_offset + HDB_DEPEND_SIZE*ndepends;
+  strings_offset = lines_offset + HDB_LINE_SIZE*nlines;
+
+  size = strings_offset;
+  for (i = 0; i < nkits; i++)
+  {
+    size += strlen(kits[i].Name) + 1;
+    for (j = 0; j < kits[i].NumberOfLines; j++)
+    {
+      size += strlen(kits[i].Lines[j]) + 1;
+    }
+  }
+
+  data = (unsigned char *)calloc(size, 1);
+  memcpy(data, "VTKHIDB", 8);
+  hdb_put32(&data[8], VTK_HIERARCHY_DB_VERSION);
+  hdb_put32(&data[12], nkits);
+  hdb_put32(&data[16], nlines);
+  hdb_put32(&data[20], kits_offset);
+  hdb_put32(&data[24], depends_offset);
+  hdb_put32(&data[28], lines_offset);
+  hdb_put32(&data[32], strings_offset);
+
+  pos = strings_offset;
+  n = 0;
+  k = 0;
+  for (i = 0; i < nkits; i++)
+  {
+    unsigned char *cp = &data[kits_offset + HDB_KIT_SIZE*i];
+
+    l = strlen(kits[i].Name) + 1;
+    memcpy(&data[pos], kits[i].Name, l);
+    hdb_put32(&cp[0], pos);
+    hdb_put32(&cp[4], kits[i].FileSize);
+    hdb_put32(&cp[8], kits[i].FileTime);
+    hdb_put32(&cp[12], kits[i].FileTimeNSec);
+    hdb_put32(&cp[16], n);
+    hdb_put32(&cp[20], kits[i].NumberOfLines);
+    hdb_put32(&cp[24], k);
+    hdb_put32(&cp[28], kits[i].NumberOfDepends);
+    pos += l;
+
+    for (j = 0; j < kits[i].NumberOfDepends; j++)
+    {
+      cp = &data[depends_offset + HDB_DEPEND_SIZE*k++];
+      hdb_put32(&cp[0], kits[i].Depends[4*j]);
+      hdb_put32(&cp[4], kits[i].Depends[4*j + 1]);
+      hdb_put32(&cp[8], kits[i].Depends[4*j + 2]);
+      hdb_put32(&cp[12], kits[i].Depends[4*j + 3]);
+    }
+
+    for (j = 0; j < kits[i].NumberOfLines; j++)
+    {
+      line = kits[i].Lines[j];
+      l = strlen(line) + 1;
+      memcpy(&data[pos], line, l);
+      hdb_put32(&data[lines_offset + HDB_LINE_SIZE*n], pos);
+      pos += l;
+      n++;
+    }
+  }
+
+  *sizep = size;
+  return data;
+}
+
+/* Hold a lock on the database while it is being rewritten */
+#if defined(_WIN32) && !defined(__CYGWIN__)
+typedef HANDLE hdb_lock_t;
+#else
+typedef int hdb_lock_t;
+#endif
+
+/* Acquire the lock, return zero on failure */
+static int hdb_lock(const char *filename, hdb_lock_t *lock)
+{
+  char *lockname;
+  int result = 0;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  int tries;
+#endif
+
+  lockname = (char *)malloc(strlen(filename) + 6);
+  strcpy(lockname, filename);
+  strcat(lockname, ".lock");
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  /* a file that is open without sharing acts as the lock */
+  for (tries = 0; tries < 6000; tries++)
+  {
+    *lock = CreateFileA(lockname, GENERIC_WRITE, 0, NULL, OPEN_ALWAYS,
+                        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (*lock != INVALID_HANDLE_VALUE)
+    {
+      result = 1;
+      break;
+    }
+    if (GetLastError() != ERROR_SHARING_VIOLATION)
+    {
+      break;
+    }
+    Sleep(50);
+  }
+#else
+  *lock = open(lockname, O_RDWR | O_CREAT, 0666);
+  if (*lock >= 0)
+  {
+    if (lockf(*lock, F_LOCK, 0) == 0)
+    {
+      result = 1;
+    }
+    else
+    {
+      close(*lock);
+    }
+  }
+#endif
+
+  free(lockname);
+  return result;
+}
+
+/* Release the lock */
+static void hdb_unlock(hdb_lock_t lock)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  CloseHandle(lock);
+#else
+  lockf(lock, F_ULOCK, 0);
+  close(lock);
+#endif
+}
+
+/* Write the database to a temporary file, and then rename it */
+static int hdb_write_file(
+  const char *filename, const unsigned char *data, size_t size,
+  HierarchyDBInfo *db)
+{
+  char *tmpname;
+  FILE *fp;
+  int result = 0;
+
+  tmpname = (char *)malloc(strlen(filename) + 5);
+  strcpy(tmpname, filename);
+  strcat(tmpname, ".tmp");
+
+  fp = fopen(tmpname, "wb");
+  if (fp)
+  {
+    result = (fwrite(data, 1, size, fp) == size);
+    result &= (fclose(fp) == 0);
+  }
+
+  /* the old file must be unmapped before it can be replaced */
+  if (db)
+  {
+    vtkParseHierarchyDB_Free(db);
+  }
+
+  if (result)
+  {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    result = (MoveFileExA(tmpname, filename, MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+    result = (rename(tmpname, filename) == 0);
+#endif
+  }
+  if (!result)
+  {
+    remove(tmpname);
+  }
+
+  free(tmpname);
+  return result;
+}
+
+/* Replace or add the segment for a kit */
+int vtkParseHierarchyDB_WriteKit(
+  const char *filename, const char *name, char *lines[],
+  int ndepends, char *depends[])
+{
+  HierarchyDBInfo *db;
+  HierarchyDBKit *kits;
+  HierarchyDBKit *kit;
+  const char **closure;
+  const char **tmp;
+  unsigned char *data;
+  size_t nkits = 0;
+  size_t nclosure = 0;
+  size_t size, n, i, j;
+  int knew, k, d;
+  hdb_lock_t lock;
+  int result;
+
+  if (!hdb_lock(filename, &lock))
+  {
+    return 0;
+  }
+
+  /* a database that is missing or invalid is simply replaced */
+  db = vtkParseHierarchyDB_ReadFile(filename);
+  if (db)
+  {
+    nkits = db->NumberOfKits;
+  }
+  knew = (db ? vtkParseHierarchyDB_FindKit(db, name) : -1);
+  if (knew < 0)
+  {
+    knew = (int)nkits++;
+  }
+
+  kits = (HierarchyDBKit *)malloc(nkits*sizeof(HierarchyDBKit));
+  for (k = 0; k < (int)nkits; k++)
+  {
+    if (k != knew)
+    {
+      hdb_copy_kit(db, k, &kits[k]);
+    }
+  }
+
+  kit = &kits[knew];
+  kit->Name = name;
+  kit->NumberOfLines = 0;
+  kit->Lines = NULL;
+  kit->NumberOfDepends = 0;
+  kit->Depends = (unsigned long *)malloc(
+    (4*(size_t)ndepends + 1)*sizeof(unsigned long));
+  closure = (const char **)malloc(sizeof(const char *));
+
+  /* only the dependencies with valid segments can be used */
+  for (i = 0; db && i < (size_t)ndepends; i++)
+  {
+    d = vtkParseHierarchyDB_FindKit(db, depends[i]);
+    for (j = 0; j < kit->NumberOfDepends; j++)
+    {
+      if ((int)kit->Depends[4*j] == d)
+      {
+        break;
+      }
+    }
+    if (d < 0 || d == knew || j < kit->NumberOfDepends ||
+        !vtkParseHierarchyDB_CheckKit(db, d))
+    {
+      continue;
+    }
+
+    n = kit->NumberOfDepends++;
+    kit->Depends[4*n] = (unsigned long)d;
+    kit->Depends[4*n + 1] = hdb_get32(&hdb_kit(db, d)[4]);
+    kit->Depends[4*n + 2] = hdb_get32(&hdb_kit(db, d)[8]);
+    kit->Depends[4*n + 3] = hdb_get32(&hdb_kit(db, d)[12]);
+
+    tmp = vtkParseHierarchyDB_GetLines(db, d, &n);
+    closure = (const char **)realloc(
+      (void *)closure, (nclosure + n + 1)*sizeof(const char *));
+    memcpy((void *)&closure[nclosure], (const void *)tmp,
+           n*sizeof(const char *));
+    nclosure += n;
+    free((void *)tmp);
+  }
+  qsort((void *)closure, nclosure, sizeof(const char *), hdb_compare_lines);
+
+  /* the segment holds the lines that are not in the dependencies */
+  for (n = 0; lines[n] != NULL; n++) { ; }
+  kit->Lines = (const char **)malloc((n + 1)*sizeof(const char *));
+  for (i = 0; i < n; i++)
+  {
+    if (nclosure == 0 ||
+        bsearch((const void *)&lines[i], (const void *)closure, nclosure,
+                sizeof(const char *), hdb_compare_lines) == NULL)
+    {
+      kit->Lines[kit->NumberOfLines++] = lines[i];
+    }
+  }
+  free((void *)closure);
+
+  result = hdb_file_stat(
+    name, &kit->FileSize, &kit->FileTime, &kit->FileTimeNSec);
+
+  if (result)
+  {
+    data = hdb_build(kits, nkits, &size);
+    result = hdb_write_file(filename, data, size, db);
+    db = NULL;
+    free(data);
+  }
+
+  for (i = 0; i < nkits; i++)
+  {
+    free((void *)kits[i].Lines);
+    free(kits[i].Depends);
+  }
+  free(kits);
+
+  if (db)
+  {
+    vtkParseHierarchyDB_Free(db);
+  }
+
+  hdb_unlock(lock);
+
+  return result;
+}
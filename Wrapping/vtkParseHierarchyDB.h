@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseHierarchyDB.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file provides a database that holds the hierarchy files for all
+ of the kits, so that the hierarchy of a kit can be loaded without
+ reading the text files of the kits that it depends on.
+
+ The database has one segment per kit, and the segment is named after
+ the kit's hierarchy file.  A segment holds only the lines that are not
+ already in the kits that it depends on, so the lines for a kit are the
+ lines in its segment plus the lines for each of its dependencies.
+
+ A segment is valid only if its hierarchy file has the same size and
+ modification time (to the nanosecond, where the platform provides it)
+ as when the segment was written, and if each of its dependencies is
+ unchanged since then.  The contents of the file are not read.  If a
+ segment is not valid, then the hierarchy file should be read instead.
+
+ All integers are 32-bit little-endian, and all offsets are from the
+ start of the file:
+
+ header:   "VTKHIDB\0", version, number of kits, number of lines,
+           offset of kits, offset of dependencies, offset of lines,
+           offset of strings
+ kits:     name, file size, file time, file time nanoseconds,
+           first line, number of lines, first dependency,
+           number of dependencies (one set per kit)
+ depends:  kit index, file size, file time, file time nanoseconds
+           (one set per dependency)
+ lines:    the offset of each line, the lines of each kit are sorted
+ strings:  the kit names and the lines, each followed by a nul
+
+ The database is written by vtkWrapHierarchy, which replaces the
+ segment for its kit while holding a lock on the database.  The
+ database is replaced by renaming a new file, so readers can keep the
+ old file mapped.  There is no index of the names, a reader gets the
+ lines for a kit and parses them.  This file does not depend on the
+ parser.
+*/
+
+#ifndef VTK_PARSE_HIERARCHY_DB_H
+#define VTK_PARSE_HIERARCHY_DB_H
+
+#include <stddef.h>
+
+/**
+ * The database version, change this when the layout changes
+ */
+#define VTK_HIERARCHY_DB_VERSION 3
+
+/**
+ * A database that has been opened for reading
+ */
+typedef struct _HierarchyDBInfo
+{
+  const unsigned char *Data;   /* the contents of the database file */
+  size_t               Size;   /* the size of the database file */
+  unsigned long        NumberOfKits;
+  unsigned long        NumberOfLines;
+} HierarchyDBInfo;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Open a database file.  Returns NULL if the file could not be read,
+ * or if it is not a valid database.
+ */
+HierarchyDBInfo *vtkParseHierarchyDB_ReadFile(const char *filename);
+
+/**
+ * Close a database.
+ */
+void vtkParseHierarchyDB_Free(HierarchyDBInfo *db);
+
+/**
+ * Find the kit for a hierarchy file.  Returns -1 if not found.
+ */
+int vtkParseHierarchyDB_FindKit(const HierarchyDBInfo *db, const char *name);
+
+/**
+ * Get the name of the hierarchy file for a kit.
+ */
+const char *vtkParseHierarchyDB_GetKitName(const HierarchyDBInfo *db, int i);
+
+/**
+ * Check that the segment for a kit matches its hierarchy file, and
+ * that its dependencies are unchanged.  Returns 0 if the segment is
+ * not valid.
+ */
+int vtkParseHierarchyDB_CheckKit(const HierarchyDBInfo *db, int i);
+
+/**
+ * Get all of the lines for a kit, including the lines for the kits that
+ * it depends on.  The lines are not sorted.  The array must be freed
+ * with free(), but the lines are valid until the database is freed.
+ */
+const char **vtkParseHierarchyDB_GetLines(
+  const HierarchyDBInfo *db, int i, size_t *n);
+
+/**
+ * Get a line by index.
+ */
+const char *vtkParseHierarchyDB_GetLine(const HierarchyDBInfo *db, long i);
+
+/**
+ * Replace the segment for a kit, or add it if the database does not
+ * have it.  The "lines" must be the sorted, nul-terminated contents of
+ * the hierarchy file, which must already have been written.  The
+ * "depends" are the hierarchy files that were merged into this one,
+ * only those that have valid segments are used.  Returns 0 on failure.
+ */
+int vtkParseHierarchyDB_WriteKit(
+  const char *filename, const char *name, char *lines[],
+  int ndepends, char *depends[]);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -22,6 +22,8 @@ This file provides a unified front-end for the wrapper generators.
 #include "vtkParse.h"
 #include "vtkParseData.h"
 #include "vtkParseMain.h"
+#include "vtkParseMemory.h"
+#include "vtkParseTiming.h"
 #include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -34,6 +36,16 @@ This file provides a unified front-end for the wrapper generators.
 /* This is the struct that contains the options */
 OptionInfo options;
 
+/* The name of the executable, for the timings and the trace */
+static const char *parse_command_name = NULL;
+
+/* The per-file options that were in effect for each file argument */
+#define PARSE_FILE_VTKOBJECT 1
+#define PARSE_FILE_SPECIAL 2
+#define PARSE_FILE_CONCRETE 4
+#define PARSE_FILE_ABSTRACT 8
+static int *parse_file_flags = NULL;
+
 /* Get the base filename */
 static const char *parse_exename(const char *cmd)
 {
@@ -63,7 +75,12 @@ static void parse_print_help(FILE *fp, const char *cmd, int multi)
     "  -I <dir>          add an include directory\n"
     "  -D <macro[=def]>  define a preprocessor macro\n"
     "  -U <macro>        undefine a preprocessor macro\n"
-    "  @<file>           read arguments from a file\n",
+    "  @<file>           read arguments from a file\n"
+    "  --timings         print the time spent in each phase\n"
+    "  --timings=json    print the times as JSON\n"
+    "  --trace <file>    append trace events to the file\n"
+    "  --mem-stats       print the memory used by the parse\n"
+    "  --db <file>       the hierarchy database to use\n",
     parse_exename(cmd));
 
   /* args for describing a singe header file input */
@@ -73,7 +90,14 @@ static void parse_print_help(FILE *fp, const char *cmd, int multi)
     "  --hints <file>    the hints file to use\n"
     "  --types <file>    the type hierarchy file to use\n"
     "  --vtkobject       vtkObjectBase-derived class\n"
-    "  --special         non-vtkObjectBase class\n");
+    "  --special         non-vtkObjectBase class\n"
+    "  --bundle          write all input files to one bundle\n"
+    "  --compress        compress the documents in the bundle\n");
+  }
+  else
+  {
+    fprintf(fp,
+    "  -j <n>            parse with n worker processes\n");
   }
 }
 
@@ -221,6 +245,8 @@ static void parse_expand_args(
 {
   int i;
 
+  vtkParse_StartPhase(VTK_PARSE_PHASE_OPTIONS);
+
   *argn = 0;
   *args = (char **)malloc(sizeof(char *));
 
@@ -242,6 +268,38 @@ static void parse_expand_args(
       parse_append_arg(argn, args, argv[i]);
     }
   }
+
+  vtkParse_StopPhase(VTK_PARSE_PHASE_OPTIONS);
+}
+
+/* Print the timings, this is called at exit if "--timings" was given */
+static void parse_print_timings(void)
+{
+  vtkParse_PrintTimings(stderr, parse_command_name, options.InputFileName,
+                        (options.Timings == 2));
+}
+
+/* Set up the timings report and the trace file, if requested */
+static void parse_start_timings(const char *cmd)
+{
+  const char *tracefile;
+
+  parse_command_name = parse_exename(cmd);
+
+  if (options.Timings)
+  {
+    atexit(parse_print_timings);
+  }
+
+  tracefile = options.TraceFileName;
+  if (tracefile == NULL)
+  {
+    tracefile = getenv("VTK_WRAP_TRACE");
+  }
+  if (tracefile && tracefile[0] != '\0')
+  {
+    vtkParse_StartTrace(tracefile, parse_command_name, options.InputFileName);
+  }
 }
 
 /* Check the options: "multi" should be zero for wrapper tools that
@@ -266,6 +324,14 @@ static int parse_check_options(int argc, char *argv[], int multi)
   options.IsSpecialObject = 0;
   options.HierarchyFileName = 0;
   options.HintFileName = 0;
+  options.Timings = 0;
+  options.TraceFileName = NULL;
+  options.MemStats = 0;
+  options.Bundle = 0;
+  options.NumberOfPreprocessorOptions = 0;
+  options.PreprocessorOptions = NULL;
+  options.NumberOfJobs = 1;
+  options.DatabaseFileName = NULL;
 
   for (i = 1; i < argc; i++)
   {
@@ -280,17 +346,56 @@ static int parse_check_options(int argc, char *argv[], int multi)
       fprintf(stdout, "%s %s\n", parse_exename(argv[0]), ver);
       return 0;
     }
+    else if (strcmp(argv[i], "--timings") == 0)
+    {
+      options.Timings = 1;
+    }
+    else if (strcmp(argv[i], "--timings=json") == 0)
+    {
+      options.Timings = 2;
+    }
+    else if (strcmp(argv[i], "--mem-stats") == 0)
+    {
+      options.MemStats = 1;
+    }
+    else if (strcmp(argv[i], "--trace") == 0)
+    {
+      i++;
+      if (i >= argc || argv[i][0] == '-')
+      {
+        return -1;
+      }
+      options.TraceFileName = argv[i];
+    }
+    else if (strcmp(argv[i], "--db") == 0)
+    {
+      i++;
+      if (i >= argc || argv[i][0] == '-')
+      {
+        return -1;
+      }
+      options.DatabaseFileName = argv[i];
+    }
     else if (argv[i][0] != '-')
     {
       if (options.NumberOfFiles == 0)
       {
         options.Files = (char **)malloc(sizeof(char *));
+        parse_file_flags = (int *)malloc(sizeof(int));
       }
       else if ((options.NumberOfFiles & (options.NumberOfFiles - 1)) == 0)
       {
         options.Files = (char **)realloc(
           options.Files, 2*options.NumberOfFiles*sizeof(char *));
+        parse_file_flags = (int *)realloc(
+          parse_file_flags, 2*options.NumberOfFiles*sizeof(int));
       }
+      /* with "--bundle", each file uses the flags that precede it */
+      parse_file_flags[options.NumberOfFiles] =
+        ((options.IsVTKObject ? PARSE_FILE_VTKOBJECT : 0) |
+         (options.IsSpecialObject ? PARSE_FILE_SPECIAL : 0) |
+         (options.IsConcrete ? PARSE_FILE_CONCRETE : 0) |
+         (options.IsAbstract ? PARSE_FILE_ABSTRACT : 0));
       options.Files[options.NumberOfFiles++] = argv[i];
     }
     else if (argv[i][0] == '-' && isalpha(argv[i][1]))
@@ -311,6 +416,14 @@ static int parse_check_options(int argc, char *argv[], int multi)
       {
         options.OutputFileName = cp;
       }
+      else if (c == 'j' && multi)
+      {
+        options.NumberOfJobs = atoi(cp);
+        if (options.NumberOfJobs < 1)
+        {
+          return -1;
+        }
+      }
       else if (c == 'I')
       {
         vtkParse_IncludeDirectory(cp);
@@ -326,6 +439,26 @@ static int parse_check_options(int argc, char *argv[], int multi)
       {
         vtkParse_UndefineMacro(cp);
       }
+
+      /* keep the options that change the preprocessor, in order */
+      if (c == 'I' || c == 'D' || c == 'U')
+      {
+        j = options.NumberOfPreprocessorOptions;
+        if (j == 0)
+        {
+          options.PreprocessorOptions = (char **)malloc(sizeof(char *));
+        }
+        else if ((j & (j - 1)) == 0)
+        {
+          options.PreprocessorOptions = (char **)realloc(
+            options.PreprocessorOptions, 2*j*sizeof(char *));
+        }
+        options.PreprocessorOptions[j] = (char *)malloc(strlen(cp) + 3);
+        options.PreprocessorOptions[j][0] = '-';
+        options.PreprocessorOptions[j][1] = c;
+        strcpy(&options.PreprocessorOptions[j][2], cp);
+        options.NumberOfPreprocessorOptions++;
+      }
     }
     else if (!multi && strcmp(argv[i], "--hints") == 0)
     {
@@ -348,16 +481,106 @@ static int parse_check_options(int argc, char *argv[], int multi)
     else if (!multi && strcmp(argv[i], "--vtkobject") == 0)
     {
       options.IsVTKObject = 1;
+      options.IsSpecialObject = 0;
     }
     else if (!multi && strcmp(argv[i], "--special") == 0)
     {
       options.IsSpecialObject = 1;
+      options.IsVTKObject = 0;
+    }
+    else if (!multi && strcmp(argv[i], "--concrete") == 0)
+    {
+      options.IsConcrete = 1;
+      options.IsAbstract = 0;
+    }
+    else if (!multi && strcmp(argv[i], "--abstract") == 0)
+    {
+      options.IsAbstract = 1;
+      options.IsConcrete = 0;
+    }
+    else if (!multi && strcmp(argv[i], "--bundle") == 0)
+    {
+      options.Bundle |= 1;
+    }
+    else if (!multi && strcmp(argv[i], "--compress") == 0)
+    {
+      options.Bundle |= 2;
     }
   }
 
+  /* "--compress" is only for bundles */
+  if (options.Bundle == 2)
+  {
+    fprintf(stderr, "The \"--compress\" option requires \"--bundle\".\n");
+    return -1;
+  }
+
   return i;
 }
 
+/* Parse the input file, apply the hints, and check if abstract */
+static FileInfo *parse_input_file(FILE *ifile, FILE *hfile)
+{
+  FileInfo *data;
+
+  /* if a hierarchy is was given, then BTX/ETX can be ignored */
+  vtkParse_SetIgnoreBTX(0);
+  if (options.HierarchyFileName)
+  {
+    vtkParse_SetIgnoreBTX(1);
+  }
+
+  /* parse the input file */
+  data = vtkParse_ParseFile(options.InputFileName, ifile, stderr);
+  fclose(ifile);
+
+  if (!data)
+  {
+    if (hfile)
+    {
+      fclose(hfile);
+    }
+    return NULL;
+  }
+
+  /* fill in some blanks by using the hints file */
+  if (hfile)
+  {
+    vtkParse_StartPhase(VTK_PARSE_PHASE_HINTS);
+    vtkParse_ReadHints(data, hfile, stderr);
+    vtkParse_StopPhase(VTK_PARSE_PHASE_HINTS);
+    fclose(hfile);
+  }
+
+  /* print the memory that is held by the parse */
+  if (options.MemStats)
+  {
+    ParseMemoryStats stats;
+    vtkParse_GetMemoryStats(data, &stats);
+    vtkParse_PrintMemoryStats(stderr, options.InputFileName, &stats);
+  }
+
+  if (!options.IsSpecialObject && data->MainClass)
+  {
+    /* mark class as abstract unless it has New() method */
+    int nfunc = data->MainClass->NumberOfFunctions;
+    int ifunc;
+    for (ifunc = 0; ifunc < nfunc; ifunc++)
+    {
+      FunctionInfo *func = data->MainClass->Functions[ifunc];
+      if (func && func->Access == VTK_ACCESS_PUBLIC &&
+          func->Name && strcmp(func->Name, "New") == 0 &&
+          func->NumberOfParameters == 0)
+      {
+        break;
+      }
+    }
+    data->MainClass->IsAbstract = ((ifunc == nfunc) ? 1 : 0);
+  }
+
+  return data;
+}
+
 /* Return a pointer to the static OptionInfo struct */
 OptionInfo *vtkParse_GetCommandLineOptions()
 {
@@ -398,7 +621,9 @@ FileInfo *vtkParse_Main(int argc, char *argv[])
     free(args);
     exit(0);
   }
-  else if (argi < 0 || options.NumberOfFiles != expected_files)
+  else if (argi < 0 || (options.Bundle ?
+           (options.NumberOfFiles == 0 || options.OutputFileName == NULL) :
+           options.NumberOfFiles != expected_files))
   {
     parse_print_help(stderr, args[0], 0);
     exit(1);
@@ -407,6 +632,16 @@ FileInfo *vtkParse_Main(int argc, char *argv[])
   /* open the input file */
   options.InputFileName = options.Files[0];
 
+  /* print the timings and write the trace at exit */
+  parse_start_timings(args[0]);
+
+  /* for a bundle, the caller parses each file */
+  if (options.Bundle)
+  {
+    free(args);
+    return NULL;
+  }
+
   if (!(ifile = fopen(options.InputFileName, "r")))
   {
     fprintf(stderr, "Error opening input file %s\n", options.InputFileName);
@@ -447,46 +682,55 @@ FileInfo *vtkParse_Main(int argc, char *argv[])
     exit(1);
   }
 
-  /* if a hierarchy is was given, then BTX/ETX can be ignored */
-  vtkParse_SetIgnoreBTX(0);
-  if (options.HierarchyFileName)
-  {
-    vtkParse_SetIgnoreBTX(1);
-  }
-
-  /* parse the input file */
-  data = vtkParse_ParseFile(options.InputFileName, ifile, stderr);
+  /* parse the input file, and close the files */
+  data = parse_input_file(ifile, hfile);
 
   if (!data)
   {
     exit(1);
   }
 
-  /* fill in some blanks by using the hints file */
-  if (hfile)
+  return data;
+}
+
+/* Parse one of the input files, for tools that write a bundle */
+FileInfo *vtkParse_ParseInputFile(int i)
+{
+  int flags = parse_file_flags[i];
+
+  options.IsVTKObject = ((flags & PARSE_FILE_VTKOBJECT) != 0);
+  options.IsSpecialObject = ((flags & PARSE_FILE_SPECIAL) != 0);
+  options.IsConcrete = ((flags & PARSE_FILE_CONCRETE) != 0);
+  options.IsAbstract = ((flags & PARSE_FILE_ABSTRACT) != 0);
+
+  return vtkParse_ParseHeaderFile(options.Files[i]);
+}
+
+/* Parse a header with the options from the command line */
+FileInfo *vtkParse_ParseHeaderFile(const char *filename)
+{
+  FILE *ifile;
+  FILE *hfile = 0;
+
+  options.InputFileName = (char *)filename;
+
+  if (!(ifile = fopen(filename, "r")))
   {
-    vtkParse_ReadHints(data, hfile, stderr);
+    fprintf(stderr, "Error opening input file %s\n", filename);
+    return NULL;
   }
 
-  if (!options.IsSpecialObject && data->MainClass)
+  if (options.HintFileName && options.HintFileName[0] != '\0')
   {
-    /* mark class as abstract unless it has New() method */
-    int nfunc = data->MainClass->NumberOfFunctions;
-    int ifunc;
-    for (ifunc = 0; ifunc < nfunc; ifunc++)
+    if (!(hfile = fopen(options.HintFileName, "r")))
     {
-      FunctionInfo *func = data->MainClass->Functions[ifunc];
-      if (func && func->Access == VTK_ACCESS_PUBLIC &&
-          func->Name && strcmp(func->Name, "New") == 0 &&
-          func->NumberOfParameters == 0)
-      {
-        break;
-      }
+      fprintf(stderr, "Error opening hint file %s\n", options.HintFileName);
+      fclose(ifile);
+      return NULL;
     }
-    data->MainClass->IsAbstract = ((ifunc == nfunc) ? 1 : 0);
   }
 
-  return data;
+  return parse_input_file(ifile, hfile);
 }
 
 /* Command-line argument handler for wrapper tools */
@@ -523,4 +767,7 @@ void vtkParse_MainMulti(int argc, char *argv[])
 
   /* the input file */
   options.InputFileName = options.Files[0];
+
+  /* print the timings and write the trace at exit */
+  parse_start_timings(argv[0]);
 }
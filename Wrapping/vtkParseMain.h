@@ -31,6 +31,14 @@
  --special         wrap a non-vtkObjectBase class
  --hints <file>    hints file
  --types <file>    type hierarchy file
+ --timings         print the time spent in each phase
+ --timings=json    print the times as JSON
+ --trace <file>    append trace events to the file
+ --mem-stats       print the memory used by the parse
+ --bundle          write all input files to one bundle
+ --compress        compress the documents in the bundle
+ -j <n>            parse the input files with n worker processes
+ --db <file>       hierarchy database
 
  Notes:
 
@@ -45,6 +53,32 @@
 
  3) The options "--vtkobject" and "--special" are ignored if the
     "--types" option is used.
+
+ 4) The "--timings" report is printed to stderr when the program exits.
+
+ 5) The "--trace" file is written in Chrome's trace event format, and
+    can be shared by all the wrapper processes in a build.  If "--trace"
+    is not given, the VTK_WRAP_TRACE environment variable is used.
+
+ 6) The "--mem-stats" report is printed to stderr after each header
+    file is parsed.
+
+ 7) With "--bundle", any number of input files can be given, and "-o"
+    is required.  vtkParse_Main() does not parse the files, instead
+    the tool parses them one by one with vtkParse_ParseInputFile().
+    Each file uses the "--vtkobject", "--special", "--concrete", and
+    "--abstract" options that precede it, so an "@file" can give the
+    options for each file on the same line as the file.  The option
+    "--compress" can only be used with "--bundle".
+
+ 8) The "-j" option is only for tools that take multiple input files,
+    currently this is only vtkWrapHierarchy.
+
+ 9) The "--db" file holds the hierarchy files of all the kits, see
+    vtkParseHierarchyDB.h.  vtkWrapHierarchy adds its output to it, and
+    reads the kits it depends on from it.  The other tools can also use
+    it instead of reading the "--types" file, but since they have to
+    parse every line either way, this is not faster.
 */
 
 #ifndef VTK_PARSE_MAIN_H
@@ -68,6 +102,14 @@ typedef struct _OptionInfo
   int           IsSpecialObject;   /* set when "--special" is set */
   int           IsConcrete;        /* set when "--concrete" is set */
   int           IsAbstract;        /* set when "--abstract" is set */
+  int           Timings;           /* 1 for "--timings", 2 for json */
+  char         *TraceFileName;     /* the file preceded by "--trace" */
+  int           MemStats;          /* set when "--mem-stats" is set */
+  int           Bundle;            /* 1 for "--bundle", 3 to compress */
+  int           NumberOfPreprocessorOptions;
+  char        **PreprocessorOptions; /* the "-D", "-U", and "-I" options */
+  int           NumberOfJobs;      /* the "-j" option, default is 1 */
+  char         *DatabaseFileName;  /* the file preceded by "--db" */
 } OptionInfo;
 
 #ifdef __cplusplus
@@ -81,9 +123,25 @@ OptionInfo *vtkParse_GetCommandLineOptions();
 
 /**
  * The main function, parses the file and returns the result.
+ * If "--bundle" was given, it returns NULL without parsing.
  */
 FileInfo *vtkParse_Main(int argc, char *argv[]);
 
+/**
+ * Parse input file "i" in the same way as vtkParse_Main(), with the
+ * hints and the options from the command line that precede the file.
+ * This is for tools that take multiple files with "--bundle".  Returns
+ * NULL on error.
+ */
+FileInfo *vtkParse_ParseInputFile(int i);
+
+/**
+ * Parse a header in the same way as vtkParse_Main(), with the hints
+ * and the options from the command line.  This is for tools that find
+ * the headers themselves, such as vtkWrapBench.  Returns NULL on error.
+ */
+FileInfo *vtkParse_ParseHeaderFile(const char *filename);
+
 /**
  * A main function that can take multiple input files.
  * It does not parse the files.  It will exit on error.
@@ -0,0 +1,259 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseMemory.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+#include "vtkParseMemory.h"
+#include <string.h>
+
+/* the names of the node types, as they appear in the report */
+static const char *memory_node_names[VTK_PARSE_NUMBER_OF_NODE_TYPES] = {
+  "ClassInfo",
+  "EnumInfo",
+  "FunctionInfo",
+  "ValueInfo",
+  "TemplateInfo",
+  "UsingInfo",
+  "CommentInfo"
+};
+
+/* the preprocessor stats for the most recently parsed file */
+static const FileInfo *memory_file = NULL;
+static unsigned long memory_macros = 0;
+static unsigned long memory_histogram[VTK_PARSE_MACRO_HISTOGRAM_SIZE];
+static unsigned long memory_includes = 0;
+
+/* Add a node to the stats */
+static void memory_node(ParseMemoryStats *stats, parse_node_t t, size_t size)
+{
+  stats->NodeCounts[t]++;
+  stats->NodeBytes[t] += size;
+}
+
+/* Add an array to the stats, the array sizes are always a power of two
+ * because they are grown by array_size_check() in vtkParseData.c */
+static void memory_array(ParseMemoryStats *stats, unsigned long n, size_t size)
+{
+  unsigned long m = 1;
+
+  if (n > 0)
+  {
+    while (m < n)
+    {
+      m <<= 1;
+    }
+    stats->NumberOfArrays++;
+    stats->ArrayBytes += m*size;
+    stats->ArraySlack += (m - n)*size;
+  }
+}
+
+static void memory_template(ParseMemoryStats *stats, TemplateInfo *info);
+static void memory_function(ParseMemoryStats *stats, FunctionInfo *info);
+
+/* Add a value to the stats */
+static void memory_value(ParseMemoryStats *stats, ValueInfo *info)
+{
+  memory_node(stats, VTK_PARSE_NODE_VALUE, sizeof(ValueInfo));
+  memory_array(stats, info->NumberOfDimensions, sizeof(char *));
+  if (info->Function)
+  {
+    memory_function(stats, info->Function);
+  }
+  if (info->Template)
+  {
+    memory_template(stats, info->Template);
+  }
+}
+
+/* Add a template to the stats */
+static void memory_template(ParseMemoryStats *stats, TemplateInfo *info)
+{
+  unsigned long i;
+
+  memory_node(stats, VTK_PARSE_NODE_TEMPLATE, sizeof(TemplateInfo));
+  memory_array(stats, info->NumberOfParameters, sizeof(ValueInfo *));
+  for (i = 0; i < info->NumberOfParameters; i++)
+  {
+    memory_value(stats, info->Parameters[i]);
+  }
+}
+
+/* Add a function to the stats */
+static void memory_function(ParseMemoryStats *stats, FunctionInfo *info)
+{
+  unsigned long i;
+
+  memory_node(stats, VTK_PARSE_NODE_FUNCTION, sizeof(FunctionInfo));
+  if (info->Template)
+  {
+    memory_template(stats, info->Template);
+  }
+  memory_array(stats, info->NumberOfParameters, sizeof(ValueInfo *));
+  for (i = 0; i < info->NumberOfParameters; i++)
+  {
+    memory_value(stats, info->Parameters[i]);
+  }
+  if (info->ReturnValue)
+  {
+    memory_value(stats, info->ReturnValue);
+  }
+  memory_array(stats, info->NumberOfPreconds, sizeof(char *));
+}
+
+/* Add a class or namespace to the stats, this follows vtkParse_FreeClass */
+static void memory_class(ParseMemoryStats *stats, ClassInfo *info)
+{
+  unsigned long i;
+
+  memory_node(stats, VTK_PARSE_NODE_CLASS, sizeof(ClassInfo));
+  if (info->Template)
+  {
+    memory_template(stats, info->Template);
+  }
+
+  memory_array(stats, info->NumberOfSuperClasses, sizeof(char *));
+  memory_array(stats, info->NumberOfItems, sizeof(ItemInfo));
+
+  memory_array(stats, info->NumberOfClasses, sizeof(ClassInfo *));
+  for (i = 0; i < info->NumberOfClasses; i++)
+  {
+    memory_class(stats, info->Classes[i]);
+  }
+
+  memory_array(stats, info->NumberOfFunctions, sizeof(FunctionInfo *));
+  for (i = 0; i < info->NumberOfFunctions; i++)
+  {
+    memory_function(stats, info->Functions[i]);
+  }
+
+  memory_array(stats, info->NumberOfConstants, sizeof(ValueInfo *));
+  for (i = 0; i < info->NumberOfConstants; i++)
+  {
+    memory_value(stats, info->Constants[i]);
+  }
+
+  memory_array(stats, info->NumberOfVariables, sizeof(ValueInfo *));
+  for (i = 0; i < info->NumberOfVariables; i++)
+  {
+    memory_value(stats, info->Variables[i]);
+  }
+
+  /* the enum constants are stored with the class, not the enum */
+  memory_array(stats, info->NumberOfEnums, sizeof(EnumInfo *));
+  for (i = 0; i < info->NumberOfEnums; i++)
+  {
+    memory_node(stats, VTK_PARSE_NODE_ENUM, sizeof(EnumInfo));
+  }
+
+  memory_array(stats, info->NumberOfTypedefs, sizeof(ValueInfo *));
+  for (i = 0; i < info->NumberOfTypedefs; i++)
+  {
+    memory_value(stats, info->Typedefs[i]);
+  }
+
+  memory_array(stats, info->NumberOfUsings, sizeof(UsingInfo *));
+  for (i = 0; i < info->NumberOfUsings; i++)
+  {
+    memory_node(stats, VTK_PARSE_NODE_USING, sizeof(UsingInfo));
+  }
+
+  memory_array(stats, info->NumberOfNamespaces, sizeof(NamespaceInfo *));
+  for (i = 0; i < info->NumberOfNamespaces; i++)
+  {
+    memory_class(stats, info->Namespaces[i]);
+  }
+
+  memory_array(stats, info->NumberOfComments, sizeof(CommentInfo *));
+  for (i = 0; i < info->NumberOfComments; i++)
+  {
+    memory_node(stats, VTK_PARSE_NODE_COMMENT, sizeof(CommentInfo));
+  }
+}
+
+/* Get the memory used by a parsed file */
+void vtkParse_GetMemoryStats(FileInfo *data, ParseMemoryStats *stats)
+{
+  int i;
+
+  memset(stats, 0, sizeof(ParseMemoryStats));
+
+  if (data->Strings)
+  {
+    stats->NumberOfChunks = data->Strings->NumberOfChunks;
+    stats->ChunkSize = data->Strings->ChunkSize;
+    stats->StringBytes = data->Strings->AllocatedBytes;
+    stats->WastedBytes = data->Strings->WastedBytes;
+  }
+
+  if (data->Contents)
+  {
+    memory_class(stats, data->Contents);
+  }
+
+  if (data == memory_file)
+  {
+    stats->NumberOfMacros = memory_macros;
+    for (i = 0; i < VTK_PARSE_MACRO_HISTOGRAM_SIZE; i++)
+    {
+      stats->MacroHistogram[i] = memory_histogram[i];
+    }
+    stats->NumberOfIncludeFiles = memory_includes;
+  }
+}
+
+/* Record the preprocessor stats for the file that is being parsed */
+void vtkParse_RecordPreprocessStats(FileInfo *data, PreprocessInfo *info)
+{
+  memory_file = data;
+  memory_macros = vtkParsePreprocess_MacroTableStats(
+    info, memory_histogram, VTK_PARSE_MACRO_HISTOGRAM_SIZE);
+  memory_includes = info->NumberOfIncludeFiles;
+}
+
+/* Print the memory stats */
+void vtkParse_PrintMemoryStats(
+  FILE *fp, const char *name, const ParseMemoryStats *stats)
+{
+  size_t nodebytes = 0;
+  int i;
+
+  fprintf(fp, "memory stats for %s\n", (name ? name : ""));
+  fprintf(fp, "  %-14s %8s %12s\n", "item", "count", "bytes");
+  fprintf(fp, "  %-14s %8lu %12lu\n", "string chunks",
+          stats->NumberOfChunks, (unsigned long)stats->StringBytes);
+  fprintf(fp, "  %-14s %8s %12lu\n", "chunk size", "",
+          (unsigned long)stats->ChunkSize);
+  fprintf(fp, "  %-14s %8s %12lu\n", "chunk waste", "",
+          (unsigned long)stats->WastedBytes);
+  for (i = 0; i < VTK_PARSE_NUMBER_OF_NODE_TYPES; i++)
+  {
+    fprintf(fp, "  %-14s %8lu %12lu\n", memory_node_names[i],
+            stats->NodeCounts[i], (unsigned long)stats->NodeBytes[i]);
+    nodebytes += stats->NodeBytes[i];
+  }
+  fprintf(fp, "  %-14s %8lu %12lu\n", "arrays",
+          stats->NumberOfArrays, (unsigned long)stats->ArrayBytes);
+  fprintf(fp, "  %-14s %8s %12lu\n", "array slack", "",
+          (unsigned long)stats->ArraySlack);
+  fprintf(fp, "  %-14s %8s %12lu\n", "total", "",
+          (unsigned long)(stats->StringBytes + nodebytes + stats->ArrayBytes));
+  fprintf(fp, "  %-14s %8lu\n", "macros", stats->NumberOfMacros);
+  fprintf(fp, "  %-14s %8lu\n", "include files", stats->NumberOfIncludeFiles);
+  fprintf(fp, "  %-14s %8s %12s\n", "macro buckets", "length", "buckets");
+  for (i = 0; i < VTK_PARSE_MACRO_HISTOGRAM_SIZE; i++)
+  {
+    fprintf(fp, "  %-14s %7d%s %12lu\n", "", i,
+            (i == VTK_PARSE_MACRO_HISTOGRAM_SIZE - 1 ? "+" : " "),
+            stats->MacroHistogram[i]);
+  }
+}
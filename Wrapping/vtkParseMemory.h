@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseMemory.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file provides memory accounting for the data from the parser.
+
+ The memory held by a FileInfo is reported in three parts: the strings
+ in its StringCache, the nodes of the parse tree (classes, functions,
+ values, etc.), and the pointer arrays that hold the nodes.  Since the
+ arrays grow by doubling their size, up to half of each array can be
+ unused, and this "slack" is reported separately.
+
+ The preprocessor is freed at the end of the parse, so the size of the
+ macro table and the number of include files are recorded by the parser
+ before the preprocessor is freed.  The report is printed by the wrapper
+ tools when the "--mem-stats" option is given.
+*/
+
+#ifndef VTK_PARSE_MEMORY_H
+#define VTK_PARSE_MEMORY_H
+
+#include "vtkParseData.h"
+#include "vtkParsePreprocess.h"
+#include <stdio.h>
+
+/**
+ * The kinds of nodes in the parse tree
+ */
+typedef enum _parse_node_t
+{
+  VTK_PARSE_NODE_CLASS = 0,  /* ClassInfo, for classes and namespaces */
+  VTK_PARSE_NODE_ENUM,       /* EnumInfo */
+  VTK_PARSE_NODE_FUNCTION,   /* FunctionInfo */
+  VTK_PARSE_NODE_VALUE,      /* ValueInfo */
+  VTK_PARSE_NODE_TEMPLATE,   /* TemplateInfo */
+  VTK_PARSE_NODE_USING,      /* UsingInfo */
+  VTK_PARSE_NODE_COMMENT,    /* CommentInfo */
+  VTK_PARSE_NUMBER_OF_NODE_TYPES
+} parse_node_t;
+
+/**
+ * The number of bins in the histogram of macro hash bucket lengths
+ */
+#define VTK_PARSE_MACRO_HISTOGRAM_SIZE 8
+
+/**
+ * The memory used by a parsed file
+ */
+typedef struct _ParseMemoryStats
+{
+  unsigned long  NumberOfChunks;  /* StringCache chunks */
+  size_t         ChunkSize;       /* the current chunk size */
+  size_t         StringBytes;     /* total size of the chunks */
+  size_t         WastedBytes;     /* unused bytes at the ends of chunks */
+  unsigned long  NodeCounts[VTK_PARSE_NUMBER_OF_NODE_TYPES];
+  size_t         NodeBytes[VTK_PARSE_NUMBER_OF_NODE_TYPES];
+  unsigned long  NumberOfArrays;  /* arrays of nodes or strings */
+  size_t         ArrayBytes;      /* total size of the arrays */
+  size_t         ArraySlack;      /* unused bytes at the ends of arrays */
+  unsigned long  NumberOfMacros;  /* macros at the end of the parse */
+  unsigned long  MacroHistogram[VTK_PARSE_MACRO_HISTOGRAM_SIZE];
+  unsigned long  NumberOfIncludeFiles; /* files seen by the preprocessor */
+} ParseMemoryStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Get the memory used by a parsed file.  The macro and include counts
+ * are only available for the file that was most recently parsed, and
+ * will be zero for any other file.
+ */
+void vtkParse_GetMemoryStats(FileInfo *data, ParseMemoryStats *stats);
+
+/**
+ * Print the memory stats as a table.  The "name" is used as a label.
+ */
+void vtkParse_PrintMemoryStats(
+  FILE *fp, const char *name, const ParseMemoryStats *stats);
+
+/**
+ * Record the macro table size and the include file count.  This is
+ * called by the parser, just before it frees the preprocessor.
+ */
+void vtkParse_RecordPreprocessStats(FileInfo *data, PreprocessInfo *info);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -18,6 +18,7 @@
 #include "vtkParseData.h"
 #include "vtkParseExtras.h"
 #include "vtkParseHierarchy.h"
+#include "vtkParseTiming.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -75,13 +76,15 @@ unsigned long vtkParseMerge_PushClass(MergeInfo *info, const char *classname)
 }
 
 /* add a function to the MergeInfo */
-unsigned long vtkParseMerge_PushFunction(MergeInfo *info, unsigned long depth)
+unsigned long vtkParseMerge_PushFunction(
+  MergeInfo *info, unsigned long depth, const FunctionInfo *func)
 {
   unsigned long n = info->NumberOfFunctions;
   unsigned long m = 0;
   unsigned long i;
   unsigned long *overrides;
   unsigned long **classes;
+  unsigned long *signatures;
 
   /* if no elements yet, reserve four slots */
   if (n == 0)
@@ -98,24 +101,29 @@ unsigned long vtkParseMerge_PushFunction(MergeInfo *info, unsigned long depth)
   {
     overrides = (unsigned long *)malloc(m*sizeof(unsigned long));
     classes = (unsigned long **)malloc(m*sizeof(unsigned long *));
+    signatures = (unsigned long *)malloc(m*sizeof(unsigned long));
     if (n)
     {
       for (i = 0; i < n; i++)
       {
         overrides[i] = info->NumberOfOverrides[i];
         classes[i] = info->OverrideClasses[i];
+        signatures[i] = info->SignatureIds[i];
       }
       free(info->NumberOfOverrides);
       free(info->OverrideClasses);
+      free(info->SignatureIds);
     }
     info->NumberOfOverrides = overrides;
     info->OverrideClasses = classes;
+    info->SignatureIds = signatures;
   }
 
   info->NumberOfFunctions = n+1;
   info->NumberOfOverrides[n] = 1;
   info->OverrideClasses[n] = (unsigned long *)malloc(sizeof(unsigned long));
   info->OverrideClasses[n][0] = depth;
+  info->SignatureIds[n] = vtkParse_AddParametersToTable(info->Types, func);
 
   return n;
 }
@@ -164,12 +172,14 @@ MergeInfo *vtkParseMerge_CreateMergeInfo(ClassInfo *classInfo)
   MergeInfo *info = (MergeInfo *)malloc(sizeof(MergeInfo));
   info->NumberOfClasses = 0;
   info->NumberOfFunctions = 0;
+  info->Types = (TypeTable *)malloc(sizeof(TypeTable));
+  vtkParse_InitTypeTable(info->Types);
 
   vtkParseMerge_PushClass(info, classInfo->Name);
   n = classInfo->NumberOfFunctions;
   for (i = 0; i < n; i++)
   {
-    vtkParseMerge_PushFunction(info, 0);
+    vtkParseMerge_PushFunction(info, 0, classInfo->Functions[i]);
   }
 
   return info;
@@ -196,8 +206,12 @@ void vtkParseMerge_FreeMergeInfo(MergeInfo *info)
   {
     free(info->NumberOfOverrides);
     free(info->OverrideClasses);
+    free(info->SignatureIds);
   }
 
+  vtkParse_FreeTypeTable(info->Types);
+  free(info->Types);
+
   free(info);
 }
 
@@ -356,7 +370,7 @@ void vtkParseMerge_MergeUsing(
           vtkParse_AddFunctionToClass(merge, f2);
           if (info)
           {
-            vtkParseMerge_PushFunction(info, depth);
+            vtkParseMerge_PushFunction(info, depth, f2);
           }
           if (lastval == NULL)
           {
@@ -375,7 +389,7 @@ void vtkParseMerge_MergeUsing(
         vtkParse_AddFunctionToClass(merge, f2);
         if (info)
         {
-          vtkParseMerge_PushFunction(info, depth);
+          vtkParseMerge_PushFunction(info, depth, f2);
         }
       }
     }
@@ -417,7 +431,7 @@ void vtkParseMerge_MergeUsing(
 unsigned long vtkParseMerge_Merge(
   FileInfo *finfo, MergeInfo *info, ClassInfo *merge, ClassInfo *super)
 {
-  unsigned long i, j, ii, n, m, depth;
+  unsigned long i, j, ii, n, m, depth, sig;
   int match;
   FunctionInfo *func;
   FunctionInfo *f1;
@@ -466,13 +480,18 @@ unsigned long vtkParseMerge_Merge(
       {
         if (match)
         {
+          /* compare the interned parameter signatures if possible */
+          sig = vtkParse_AddParametersToTable(info->Types, f1);
+
           /* look for override of this signature */
           for (j = 0; j < m; j++)
           {
             f2 = merge->Functions[j];
             if (f2->Name && strcmp(f2->Name, f1->Name) == 0)
             {
-              if (vtkParse_CompareFunctionSignature(f1, f2) != 0)
+              if ((sig != 0 && info->SignatureIds[j] != 0) ?
+                  (sig == info->SignatureIds[j]) :
+                  (vtkParse_CompareFunctionSignature(f1, f2) != 0))
               {
                 merge_function(f2, f1);
                 vtkParseMerge_PushOverride(info, j, depth);
@@ -484,7 +503,7 @@ unsigned long vtkParseMerge_Merge(
         {
           /* copy into the merge */
           vtkParse_AddFunctionToClass(merge, f1);
-          vtkParseMerge_PushFunction(info, depth);
+          vtkParseMerge_PushFunction(info, depth, f1);
           m++;
         }
         /* remove from future consideration */
@@ -507,15 +526,185 @@ unsigned long vtkParseMerge_Merge(
   return depth;
 }
 
+/* A class template that has been instantiated, with the header file
+ * that it came from, so that the header is only parsed once */
+typedef struct _MergeTemplate
+{
+  char          *Key;   /* the template name and args */
+  ClassInfo     *Class; /* the instantiated class */
+  FileInfo      *File;  /* the parsed header */
+  const NamespaceInfo *Data; /* the namespace that has the class */
+} MergeTemplate;
+
+/* The templates are kept for the life of the process, and are found
+ * through a hash table that holds the index of each template plus one.
+ * Nothing is shared between processes, so the cache only helps a tool
+ * that merges many classes, such as "vtkWrapXML --bundle" or the bench
+ * programs.  A tool that wraps one header per process will only find
+ * a template here if the header reaches it more than once. */
+static unsigned long merge_num_templates = 0;
+static MergeTemplate *merge_templates = NULL;
+static unsigned long merge_template_hash_size = 0;
+static unsigned long *merge_template_hash = NULL;
+
+/* Free the instantiated templates when the process exits */
+static void merge_free_templates(void)
+{
+  unsigned long i;
+
+  for (i = 0; i < merge_num_templates; i++)
+  {
+    free(merge_templates[i].Key);
+    vtkParse_FreeClass(merge_templates[i].Class);
+    vtkParse_Free(merge_templates[i].File);
+  }
+  free(merge_templates);
+  free(merge_template_hash);
+  merge_num_templates = 0;
+  merge_templates = NULL;
+  merge_template_hash_size = 0;
+  merge_template_hash = NULL;
+}
+
+/* Make the key for a template instantiation, the name of the template
+ * followed by the full list of args.  Free the key with free(). */
+static char *merge_template_key(
+  const char *name, unsigned long n, const char *args[])
+{
+  unsigned long i;
+  size_t k, l;
+  char *key;
+
+  k = strlen(name) + 2;
+  for (i = 0; i < n; i++)
+  {
+    k += strlen(args[i]) + 2;
+  }
+  key = (char *)malloc(k);
+  l = strlen(name);
+  memcpy(key, name, l);
+  key[l++] = '<';
+  for (i = 0; i < n; i++)
+  {
+    k = strlen(args[i]);
+    memcpy(&key[l], args[i], k);
+    l += k;
+    if (i+1 < n)
+    {
+      key[l++] = ',';
+      key[l++] = ' ';
+    }
+  }
+  key[l++] = '>';
+  key[l] = '\0';
+
+  return key;
+}
+
+/* Compute the hash for a template key */
+static unsigned long merge_hash_key(const char *key)
+{
+  unsigned long h = 5381;
+
+  while (*key != '\0')
+  {
+    h = (h << 5) + h + (unsigned char)(*key++);
+  }
+
+  return h;
+}
+
+/* Find an instantiated template, or return NULL */
+static const MergeTemplate *merge_find_template(const char *key)
+{
+  unsigned long m = merge_template_hash_size;
+  unsigned long h, i;
+
+  if (m == 0)
+  {
+    return NULL;
+  }
+
+  h = merge_hash_key(key);
+  while ((i = merge_template_hash[h & (m-1)]) != 0)
+  {
+    if (strcmp(merge_templates[i-1].Key, key) == 0)
+    {
+      return &merge_templates[i-1];
+    }
+    h++;
+  }
+
+  return NULL;
+}
+
+/* Add a copy of an instantiated template, the key and the header are
+ * taken, and the header must not be modified after this */
+static void merge_add_template(
+  char *key, const ClassInfo *cinfo, FileInfo *finfo,
+  const NamespaceInfo *data)
+{
+  unsigned long n = merge_num_templates;
+  unsigned long i, h, m;
+  ClassInfo *copy;
+
+  if (n == 0)
+  {
+    atexit(merge_free_templates);
+  }
+
+  /* grow the array if n is a power of two */
+  if ((n & (n-1)) == 0)
+  {
+    merge_templates = (MergeTemplate *)realloc(
+      merge_templates, (n == 0 ? 1 : 2*n)*sizeof(MergeTemplate));
+  }
+
+  copy = (ClassInfo *)malloc(sizeof(ClassInfo));
+  vtkParse_CopyClass(copy, cinfo);
+  merge_templates[n].Key = key;
+  merge_templates[n].Class = copy;
+  merge_templates[n].File = finfo;
+  merge_templates[n].Data = data;
+  merge_num_templates = n + 1;
+
+  /* keep the load factor at or below one half */
+  if (2*merge_num_templates > merge_template_hash_size)
+  {
+    m = (merge_template_hash_size ? 2*merge_template_hash_size : 64);
+    free(merge_template_hash);
+    merge_template_hash_size = m;
+    merge_template_hash = (unsigned long *)calloc(m, sizeof(unsigned long));
+    for (i = 0; i < merge_num_templates; i++)
+    {
+      h = merge_hash_key(merge_templates[i].Key);
+      while (merge_template_hash[h & (m-1)] != 0) { h++; }
+      merge_template_hash[h & (m-1)] = i + 1;
+    }
+  }
+  else
+  {
+    m = merge_template_hash_size;
+    h = merge_hash_key(key);
+    while (merge_template_hash[h & (m-1)] != 0) { h++; }
+    merge_template_hash[h & (m-1)] = n + 1;
+  }
+}
+
 /* Recursive suproutine to add the methods of "classname" and all its
- * superclasses to "merge" */
+ * superclasses to "merge".  If "shared" is set, then "finfo" is held by
+ * the template cache, and its classes must be copied before the merge
+ * takes their methods. */
 void vtkParseMerge_MergeHelper(
   FileInfo *finfo, const NamespaceInfo *data, const HierarchyInfo *hinfo,
-  const char *classname, FILE *hintfile, MergeInfo *info, ClassInfo *merge)
+  const char *classname, FILE *hintfile, MergeInfo *info, ClassInfo *merge,
+  int shared)
 {
   FILE *fp = NULL;
   ClassInfo *cinfo = NULL;
   ClassInfo *new_cinfo = NULL;
+  const MergeTemplate *cached = NULL;
+  char *template_key = NULL;
   HierarchyEntry *entry = NULL;
   char *new_classname = NULL;
   const char **template_args = NULL;
@@ -524,6 +713,7 @@ void vtkParseMerge_MergeHelper(
   const char *header;
   const char *filename;
   unsigned long i, j, n, m;
+  int parsed = 0;
   int recurse;
 
   /* Note: this method does not deal with scoping yet.
@@ -587,6 +777,26 @@ void vtkParseMerge_MergeHelper(
       }
       return;
     }
+
+    /* a template that was instantiated before is taken from the cache,
+     * the key is the name plus the args (including the defaults) */
+    if (template_arg_count > 0)
+    {
+      template_key = merge_template_key(
+        entry->Name, template_arg_count, template_args);
+      cached = merge_find_template(template_key);
+    }
+  }
+
+  if (cached)
+  {
+    finfo = cached->File;
+    data = cached->Data;
+    cinfo = cached->Class;
+    shared = 1;
+  }
+  else if (n > 0 && !cinfo)
+  {
     header = entry->HeaderFile;
     if (!header)
     {
@@ -611,6 +821,7 @@ void vtkParseMerge_MergeHelper(
       exit(1);
     }
 
+    vtkParse_BeginSpan("superclass", classname);
     finfo = vtkParse_ParseFile(filename, fp, stderr);
     fclose(fp);
 
@@ -619,12 +830,15 @@ void vtkParseMerge_MergeHelper(
       if (hintfile) { fclose(hintfile); }
       exit(1);
     }
+    parsed = 1;
+    shared = 0;
 
     if (hintfile)
     {
       rewind(hintfile);
       vtkParse_ReadHints(finfo, hintfile, stderr);
     }
+    vtkParse_EndSpan("superclass");
 
     data = finfo->Contents;
     if (nspacename)
@@ -670,10 +884,29 @@ void vtkParseMerge_MergeHelper(
   {
     if (template_args)
     {
+      /* the merge takes functions from the class, so it gets a copy */
+      new_cinfo = (ClassInfo *)malloc(sizeof(ClassInfo));
+      vtkParse_CopyClass(new_cinfo, cinfo);
+      if (!cached)
+      {
+        vtkParse_InstantiateClassTemplate(
+          new_cinfo, finfo->Strings, template_arg_count, template_args);
+        if (parsed)
+        {
+          /* only cache the templates from headers parsed here, because
+           * the caller might free its own FileInfo */
+          merge_add_template(template_key, new_cinfo, finfo, data);
+          template_key = NULL;
+          shared = 1;
+        }
+      }
+      cinfo = new_cinfo;
+    }
+    else if (shared && info)
+    {
+      /* the classes in a cached header must be kept intact */
       new_cinfo = (ClassInfo *)malloc(sizeof(ClassInfo));
       vtkParse_CopyClass(new_cinfo, cinfo);
-      vtkParse_InstantiateClassTemplate(
-        new_cinfo, finfo->Strings, template_arg_count, template_args);
       cinfo = new_cinfo;
     }
 
@@ -702,11 +935,13 @@ void vtkParseMerge_MergeHelper(
       for (i = 0; i < n; i++)
       {
         vtkParseMerge_MergeHelper(finfo, data, hinfo, cinfo->SuperClasses[i],
-                                  hintfile, info, merge);
+                                  hintfile, info, merge, shared);
       }
     }
   }
 
+  free(template_key);
+
   if (template_arg_count > 0)
   {
     vtkParse_FreeTemplateDecomposition(
@@ -714,6 +949,24 @@ void vtkParseMerge_MergeHelper(
   }
 }
 
+/* Read the hierarchy, use the database if it has a valid copy */
+static HierarchyInfo *merge_read_hierarchy(OptionInfo *oinfo)
+{
+  HierarchyInfo *hinfo = NULL;
+
+  if (oinfo->DatabaseFileName)
+  {
+    hinfo = vtkParseHierarchy_ReadDatabase(
+      oinfo->DatabaseFileName, oinfo->HierarchyFileName);
+  }
+  if (hinfo == NULL)
+  {
+    hinfo = vtkParseHierarchy_ReadFile(oinfo->HierarchyFileName);
+  }
+
+  return hinfo;
+}
+
 /* Merge the methods from the superclasses */
 MergeInfo *vtkParseMerge_MergeSuperClasses(
   FileInfo *finfo, NamespaceInfo *data, ClassInfo *classInfo)
@@ -724,11 +977,13 @@ MergeInfo *vtkParseMerge_MergeSuperClasses(
   OptionInfo *oinfo = NULL;
   unsigned long i, n;
 
+  vtkParse_StartPhase(VTK_PARSE_PHASE_MERGE);
+
   oinfo = vtkParse_GetCommandLineOptions();
 
   if (oinfo->HierarchyFileName)
   {
-    hinfo = vtkParseHierarchy_ReadFile(oinfo->HierarchyFileName);
+    hinfo = merge_read_hierarchy(oinfo);
 
     if (oinfo->HintFileName)
     {
@@ -742,7 +997,7 @@ MergeInfo *vtkParseMerge_MergeSuperClasses(
     {
       vtkParseMerge_MergeHelper(finfo, data, hinfo,
                                 classInfo->SuperClasses[i],
-                                hintfile, info, classInfo);
+                                hintfile, info, classInfo, 0);
     }
 
     if (hintfile)
@@ -756,6 +1011,8 @@ MergeInfo *vtkParseMerge_MergeSuperClasses(
     vtkParseHierarchy_Free(hinfo);
   }
 
+  vtkParse_StopPhase(VTK_PARSE_PHASE_MERGE);
+
   return info;
 }
 
@@ -782,11 +1039,13 @@ void vtkParseMerge_ApplyUsingDeclarations(
     return;
   }
 
+  vtkParse_StartPhase(VTK_PARSE_PHASE_MERGE);
+
   oinfo = vtkParse_GetCommandLineOptions();
 
   if (oinfo->HierarchyFileName)
   {
-    hinfo = vtkParseHierarchy_ReadFile(oinfo->HierarchyFileName);
+    hinfo = merge_read_hierarchy(oinfo);
 
     if (oinfo->HintFileName)
     {
@@ -798,7 +1057,7 @@ void vtkParseMerge_ApplyUsingDeclarations(
     {
       vtkParseMerge_MergeHelper(finfo, data, hinfo,
                                 classInfo->SuperClasses[i],
-                                hintfile, NULL, classInfo);
+                                hintfile, NULL, classInfo, 0);
     }
 
     if (hintfile)
@@ -811,4 +1070,6 @@ void vtkParseMerge_ApplyUsingDeclarations(
   {
     vtkParseHierarchy_Free(hinfo);
   }
+
+  vtkParse_StopPhase(VTK_PARSE_PHASE_MERGE);
 }
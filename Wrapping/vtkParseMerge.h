@@ -21,6 +21,7 @@
 #define VTK_PARSE_MERGE_H
 
 #include "vtkParseData.h"
+#include "vtkParseTypeTable.h"
 
 /**
  * This struct is meant to supplement ClassInfo, it gives information
@@ -33,6 +34,8 @@ typedef struct _MergeInfo
   unsigned long   NumberOfFunctions;  /* must match FunctionInfo */
   unsigned long  *NumberOfOverrides; /* n classes that define this function */
   unsigned long **OverrideClasses;  /* class for the override */
+  unsigned long  *SignatureIds;     /* parameter signature in Types */
+  TypeTable      *Types;            /* types used in the signatures */
 } MergeInfo;
 
 #ifdef __cplusplus
@@ -44,7 +47,9 @@ extern "C" {
  * This will find and parse the header files for all the superclasses,
  * and recursively add all inherited superclass methods into one ClassInfo.
  * The returned MergeInfo object provides information about which class
- * each inherited method was inherited from.
+ * each inherited method was inherited from.  Templated superclasses are
+ * instantiated once per set of template args, and are then reused for
+ * the life of the process.
  */
 MergeInfo *vtkParseMerge_MergeSuperClasses(
   FileInfo *finfo, NamespaceInfo *data, ClassInfo *classInfo);
@@ -13,6 +13,7 @@
 =========================================================================*/
 
 #include "vtkParsePreprocess.h"
+#include "vtkParseTiming.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -133,6 +134,8 @@ static MacroInfo *preproc_new_macro(
   MacroInfo *macro = (MacroInfo *)malloc(sizeof(MacroInfo));
   vtkParsePreprocess_InitMacro(macro);
 
+  vtkParse_AddToCounter(VTK_PARSE_COUNT_DEFINES, 1);
+
   if (name)
   {
     size_t n = vtkParse_SkipId(name);
@@ -1592,6 +1595,15 @@ static int preproc_add_include_file(PreprocessInfo *info, const char *name)
   return 1;
 }
 
+/**
+ * Call stat() on a file, and count the call.
+ */
+static int preproc_stat(const char *path, struct stat *fs)
+{
+  vtkParse_AddToCounter(VTK_PARSE_COUNT_STATS, 1);
+  return stat(path, fs);
+}
+
 /**
  * Find an include file.  If "cache_only" is set, then do a check to
  * see if the file was previously found without going to the filesystem.
@@ -1740,10 +1752,10 @@ const char *preproc_find_include_file(
         }
       }
 #if defined(_WIN32) && !defined(__CYGWIN__)
-      else if (stat(output, &fs) == 0 &&
+      else if (preproc_stat(output, &fs) == 0 &&
                (fs.st_mode & _S_IFMT) != _S_IFDIR)
 #else
-      else if (stat(output, &fs) == 0 &&
+      else if (preproc_stat(output, &fs) == 0 &&
                !S_ISDIR(fs.st_mode))
 #endif
       {
@@ -1755,6 +1767,16 @@ const char *preproc_find_include_file(
         free(output);
         return info->IncludeFiles[nn];
       }
+      else
+      {
+        /* save the paths that were searched, since a file that is
+         * added later at one of these paths would change the result */
+        nn = info->NumberOfMissingFiles;
+        info->MissingFiles = (const char **)preproc_array_check(
+          (char **)info->MissingFiles, sizeof(char *), nn);
+        info->MissingFiles[info->NumberOfMissingFiles++] =
+          vtkParse_CacheString(info->Strings, output, strlen(output));
+      }
     }
   }
 
@@ -1896,6 +1918,10 @@ static int preproc_include_file(
     return VTK_PARSE_FILE_OPEN_ERROR;
   }
 
+  vtkParse_AddToCounter(VTK_PARSE_COUNT_INCLUDES, 1);
+  vtkParse_StartPhase(VTK_PARSE_PHASE_INCLUDES);
+  vtkParse_BeginSpan("include", path);
+
   save_external = info->IsExternal;
   save_filename = info->FileName;
   info->IsExternal = 1;
@@ -1958,12 +1984,16 @@ static int preproc_include_file(
             free(tbuf);
             free(line);
             info->IsExternal = save_external;
+            vtkParse_EndSpan("include");
+            vtkParse_StopPhase(VTK_PARSE_PHASE_INCLUDES);
             return VTK_PARSE_FILE_READ_ERROR;
           }
           errno = 0;
           clearerr(fp);
         }
 
+        vtkParse_AddToCounter(VTK_PARSE_COUNT_BYTES, (unsigned long)n);
+
         if (n + r < tbuflen)
         {
           /* this only occurs if the final fread does not fill the buffer */
@@ -2148,6 +2178,9 @@ static int preproc_include_file(
   info->IsExternal = save_external;
   info->FileName = save_filename;
 
+  vtkParse_EndSpan("include");
+  vtkParse_StopPhase(VTK_PARSE_PHASE_INCLUDES);
+
   return result;
 }
 
@@ -3848,6 +3881,8 @@ const char *vtkParsePreprocess_ExpandMacro(
   int depth = 1;
   int c;
 
+  vtkParse_AddToCounter(VTK_PARSE_COUNT_EXPANSIONS, 1);
+
   if (macro->IsFunction)
   {
     if (argstring == NULL || *cp != '(')
@@ -4509,6 +4544,8 @@ void vtkParsePreprocess_Init(
   info->IncludeDirectories = NULL;
   info->NumberOfIncludeFiles = 0;
   info->IncludeFiles = NULL;
+  info->NumberOfMissingFiles = 0;
+  info->MissingFiles = NULL;
   info->Strings = NULL;
   info->IsExternal = 0;
   info->ConditionalDepth = 0;
@@ -4543,6 +4580,7 @@ void vtkParsePreprocess_Free(PreprocessInfo *info)
         while (*mptr)
         {
           vtkParsePreprocess_FreeMacro(*mptr++);
+          vtkParse_AddToCounter(VTK_PARSE_COUNT_MACROS, 1);
         }
       }
       free(info->MacroHashTable[i]);
@@ -4552,6 +4590,43 @@ void vtkParsePreprocess_Free(PreprocessInfo *info)
 
   free((char **)info->IncludeDirectories);
   free((char **)info->IncludeFiles);
+  free((char **)info->MissingFiles);
 
   free(info);
 }
+
+/**
+ * Count the macros, and make a histogram of the bucket lengths
+ */
+unsigned long vtkParsePreprocess_MacroTableStats(
+  PreprocessInfo *info, unsigned long *histogram, unsigned long nbins)
+{
+  unsigned long i, j, n, count;
+  unsigned long total = 0;
+  MacroInfo **mptr;
+
+  for (j = 0; j < nbins; j++)
+  {
+    histogram[j] = 0;
+  }
+
+  n = PREPROC_HASH_TABLE_SIZE;
+  for (i = 0; i < n; i++)
+  {
+    count = 0;
+    if (info->MacroHashTable && (mptr = info->MacroHashTable[i]) != NULL)
+    {
+      while (*mptr++)
+      {
+        count++;
+      }
+    }
+    total += count;
+    if (nbins > 0)
+    {
+      histogram[(count < nbins ? count : nbins - 1)]++;
+    }
+  }
+
+  return total;
+}
@@ -77,6 +77,8 @@ typedef struct _PreprocessInfo
   const char   **IncludeDirectories;
   unsigned long  NumberOfIncludeFiles; /* all included files */
   const char   **IncludeFiles;
+  unsigned long  NumberOfMissingFiles; /* include paths not found */
+  const char   **MissingFiles;
   StringCache   *Strings;          /* to aid string allocation */
   int            IsExternal;       /* label all macros as "external" */
   int            ConditionalDepth; /* internal state variable */
@@ -240,6 +242,15 @@ void vtkParsePreprocess_Init(
  */
 void vtkParsePreprocess_Free(PreprocessInfo *info);
 
+/**
+ * Count the macros in the macro hash table, and fill in a histogram
+ * of the number of macros in each hash bucket.  Bin "i" of the histogram
+ * counts the buckets that hold "i" macros, except for the last bin,
+ * which counts all buckets that hold "nbins-1" macros or more.
+ */
+unsigned long vtkParsePreprocess_MacroTableStats(
+  PreprocessInfo *info, unsigned long *histogram, unsigned long nbins);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
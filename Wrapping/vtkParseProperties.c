@@ -14,6 +14,7 @@
 
 #include "vtkParseData.h"
 #include "vtkParseProperties.h"
+#include "vtkParseTiming.h"
 #include "vtkConfigure.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,6 +29,8 @@
 typedef struct _MethodAttributes
 {
   const char *Name;       /* method name */
+  unsigned int NameType;  /* VTK_METHOD_NAME flags for the name */
+  size_t PrefixLength;    /* length of e.g. "Set", "GetNth", "RemoveAll" */
   unsigned int Type;      /* data type of gettable/settable value */
   unsigned long Count;    /* count for gettable/settable value */
   const char *ClassName;  /* class name for if the type is a class */
@@ -45,196 +48,275 @@ typedef struct _MethodAttributes
   int IsRHS;              /* method is GetValue(val), not val = GetValue() */
 } MethodAttributes;
 
+/*-------------------------------------------------------------------
+ * A hash table that maps a name to the methods that have that name,
+ * with the methods in the order in which they were added. */
+
+typedef struct _MethodIndexEntry
+{
+  const char *Name;       /* the name, which need not be terminated */
+  size_t Length;          /* the length of the name */
+  unsigned long NumberOfMethods;
+  unsigned long *Methods; /* the method indices */
+} MethodIndexEntry;
+
+typedef struct _MethodIndex
+{
+  unsigned long NumberOfSlots;
+  unsigned long NumberOfEntries;
+  MethodIndexEntry *Slots;
+} MethodIndex;
+
 typedef struct _ClassPropertyMethods
 {
   unsigned long NumberOfMethods;
   MethodAttributes **Methods;
+  MethodIndex NameIndex;  /* methods by name, for repeats */
+  MethodIndex StemIndex;  /* methods by possible property name */
 } ClassPropertyMethods;
 
 /*-------------------------------------------------------------------
- * Checks for various common method names for property access */
+ * Functions for the method index */
 
-static int isSetMethod(const char *name)
+static unsigned long hashMethodName(const char *name, size_t n)
 {
-  return (name && name[0] == 'S' && name[1] == 'e' && name[2] == 't' &&
-          isupper(name[3]));
-}
+  unsigned long h = 5381;
+  size_t i;
 
-static int isSetNthMethod(const char *name)
-{
-  if (isSetMethod(name))
+  for (i = 0; i < n; i++)
   {
-    return (name[3] == 'N' && name[4] == 't' && name[5] == 'h' &&
-            isupper(name[6]));
+    h = ((h << 5) + h) + (unsigned char)name[i];
   }
 
-  return 0;
+  return h;
 }
 
-static int isSetNumberOfMethod(const char *name)
+static void initMethodIndex(MethodIndex *index)
 {
-  size_t n;
-
-  if (isSetMethod(name))
-  {
-    n = strlen(name);
-    return (name[3] == 'N' && name[4] == 'u' && name[5] == 'm' &&
-            name[6] == 'b' && name[7] == 'e' && name[8] == 'r' &&
-            name[9] == 'O' && name[10] == 'f' && isupper(name[11]) &&
-            name[n-1] == 's');
-  }
-
-  return 0;
+  index->NumberOfSlots = 0;
+  index->NumberOfEntries = 0;
+  index->Slots = NULL;
 }
 
-static int isGetMethod(const char *name)
+static void freeMethodIndex(MethodIndex *index)
 {
-  return (name && name[0] == 'G' && name[1] == 'e' && name[2] == 't' &&
-          isupper(name[3]));
-}
+  unsigned long i;
 
-static int isGetNthMethod(const char *name)
-{
-  if (isGetMethod(name))
+  for (i = 0; i < index->NumberOfSlots; i++)
   {
-    return (name[3] == 'N' && name[4] == 't' && name[5] == 'h' &&
-            isupper(name[6]));
+    free(index->Slots[i].Methods);
   }
-
-  return 0;
+  free(index->Slots);
 }
 
-static int isGetNumberOfMethod(const char *name)
+/* find the slot for a name, which is either empty or a match */
+static MethodIndexEntry *findMethodSlot(
+  const MethodIndex *index, const char *name, size_t n)
 {
-  size_t n;
+  MethodIndexEntry *entry;
+  unsigned long mask = index->NumberOfSlots - 1;
+  unsigned long h;
 
-  if (isGetMethod(name))
+  h = hashMethodName(name, n) & mask;
+  for (;;)
   {
-    n = strlen(name);
-    return (name[3] == 'N' && name[4] == 'u' && name[5] == 'm' &&
-            name[6] == 'b' && name[7] == 'e' && name[8] == 'r' &&
-            name[9] == 'O' && name[10] == 'f' && isupper(name[11]) &&
-            name[n-1] == 's');
+    entry = &index->Slots[h];
+    if (entry->Name == NULL ||
+        (entry->Length == n && strncmp(entry->Name, name, n) == 0))
+    {
+      return entry;
+    }
+    h = (h + 1) & mask;
   }
-
-  return 0;
 }
 
-static int isBooleanMethod(const char *name)
+/* get the entry for a name, or NULL if there are no methods for it */
+static const MethodIndexEntry *findMethodIndexEntry(
+  const MethodIndex *index, const char *name, size_t n)
 {
-  size_t n;
+  const MethodIndexEntry *entry;
 
-  if (name)
+  if (index->NumberOfSlots == 0)
   {
-    n = strlen(name);
-    if ((n > 2 && name[n-2] == 'O' && name[n-1] == 'n') ||
-        (n > 3 && name[n-3] == 'O' && name[n-2] == 'f' && name[n-1] == 'f'))
-    {
-      return 1;
-    }
+    return NULL;
   }
 
-  return 0;
+  entry = findMethodSlot(index, name, n);
+  return (entry->Name ? entry : NULL);
 }
 
-static int isEnumeratedMethod(const char *name)
+/* add method "i" under the given name */
+static void addToMethodIndex(
+  MethodIndex *index, const char *name, size_t n, unsigned long i)
 {
-  size_t i, n;
-
-  if (isSetMethod(name))
-  {
-    n = strlen(name) - 3;
-    for (i = 3; i < n; i++)
+  MethodIndexEntry *entry;
+  MethodIndexEntry *oldSlots;
+  unsigned long oldNumberOfSlots, j;
+
+  /* keep the table at most half full */
+  if (2*(index->NumberOfEntries + 1) > index->NumberOfSlots)
+  {
+    oldSlots = index->Slots;
+    oldNumberOfSlots = index->NumberOfSlots;
+    index->NumberOfSlots = (oldNumberOfSlots ? 2*oldNumberOfSlots : 64);
+    index->Slots = (MethodIndexEntry *)calloc(
+      index->NumberOfSlots, sizeof(MethodIndexEntry));
+    for (j = 0; j < oldNumberOfSlots; j++)
     {
-      if (name[i+0] == 'T' && name[i+1] == 'o' &&
-          (isupper(name[i+2]) || isdigit(name[i+2])))
+      if (oldSlots[j].Name)
       {
-        return 1;
+        *findMethodSlot(index, oldSlots[j].Name, oldSlots[j].Length) =
+          oldSlots[j];
       }
     }
+    free(oldSlots);
   }
 
-  return 0;
-}
-
-static int isAsStringMethod(const char *name)
-{
-  size_t n;
-
-  if (isGetMethod(name))
+  entry = findMethodSlot(index, name, n);
+  if (entry->Name == NULL)
   {
-    n = strlen(name);
-    if (n > 11)
-    {
-      if (name[n-8] == 'A' && name[n-7] == 's' && name[n-6] == 'S' &&
-          name[n-5] == 't' && name[n-4] == 'r' && name[n-3] == 'i' &&
-          name[n-2] == 'n' && name[n-1] == 'g')
-      {
-        return 1;
-      }
-    }
+    entry->Name = name;
+    entry->Length = n;
+    index->NumberOfEntries++;
   }
 
-  return 0;
-}
+  /* a method is only added once for each name */
+  j = entry->NumberOfMethods;
+  if (j > 0 && entry->Methods[j-1] == i)
+  {
+    return;
+  }
 
-static int isAddMethod(const char *name)
-{
-  return (name && name[0] == 'A' && name[1] == 'd' && name[2] == 'd' &&
-          isupper(name[3]) && !isBooleanMethod(name));
+  /* if j is a power of two, allocate more space */
+  if (j == 0)
+  {
+    entry->Methods = (unsigned long *)malloc(sizeof(unsigned long));
+  }
+  else if ((j & (j - 1)) == 0)
+  {
+    entry->Methods = (unsigned long *)realloc(
+      entry->Methods, 2*j*sizeof(unsigned long));
+  }
+  entry->Methods[entry->NumberOfMethods++] = i;
 }
 
-static int isRemoveMethod(const char *name)
-{
-  return (name && name[0] == 'R' && name[1] == 'e' && name[2] == 'm' &&
-          name[3] == 'o' && name[4] == 'v' && name[5] == 'e' &&
-          isupper(name[6]) && !isBooleanMethod(name));
-}
+/*-------------------------------------------------------------------
+ * Classify a method name by its prefix and suffix.  The prefix is
+ * matched one character at a time, like a trie, and the suffixes are
+ * only checked for the prefixes that allow them.  The length of the
+ * prefix is returned in prefixLength. */
 
-static int isRemoveAllMethod(const char *name)
+unsigned int vtkParseProperties_ClassifyMethodName(
+  const char *name, size_t *prefixLength)
 {
-  size_t n;
+  unsigned int flags = 0;
+  size_t i, n;
 
-  if (isRemoveMethod(name))
+  *prefixLength = 0;
+  if (name == NULL)
   {
-    n = strlen(name);
-    return (name[6] == 'A' && name[7] == 'l' && name[8] == 'l' &&
-            isupper(name[9]) && name[n-1] == 's');
+    return 0;
   }
 
-  return 0;
-}
+  n = strlen(name);
 
-static int isGetMinValueMethod(const char *name)
-{
-  size_t n;
-
-  if (isGetMethod(name))
+  /* "On" and "Off" can follow any name */
+  if (n > 2 && name[n-2] == 'O' && name[n-1] == 'n')
   {
-    n = strlen(name);
-    if (n > 11 && strcmp("MinValue", &name[n-8]) == 0)
-    {
-      return 1;
-    }
+    flags = VTK_METHOD_NAME_ON;
+  }
+  else if (n > 3 && name[n-3] == 'O' && name[n-2] == 'f' && name[n-1] == 'f')
+  {
+    flags = VTK_METHOD_NAME_OFF;
   }
 
-  return 0;
-}
+  switch (name[0])
+  {
+    case 'S':
+    case 'G':
+      if (name[1] != 'e' || name[2] != 't' || !isupper(name[3]))
+      {
+        break;
+      }
+      flags |= (name[0] == 'S' ? VTK_METHOD_NAME_SET : VTK_METHOD_NAME_GET);
+      *prefixLength = 3;
+      if (name[3] == 'N')
+      {
+        if (name[4] == 't' && name[5] == 'h' && isupper(name[6]))
+        {
+          flags |= VTK_METHOD_NAME_NTH;
+          *prefixLength = 6;
+        }
+        else if (strncmp(&name[4], "umberOf", 7) == 0 &&
+                 isupper(name[11]) && name[n-1] == 's')
+        {
+          flags |= VTK_METHOD_NAME_NUMBER_OF;
+        }
+      }
+      if (name[0] == 'S')
+      {
+        /* "ToSomething" can be anywhere, but not in the last 3 chars */
+        for (i = 3; i + 3 < n; i++)
+        {
+          if (name[i] == 'T' && name[i+1] == 'o' &&
+              (isupper(name[i+2]) || isdigit(name[i+2])))
+          {
+            flags |= VTK_METHOD_NAME_VALUE_TO;
+            break;
+          }
+        }
+      }
+      else if (n > 11)
+      {
+        if (strcmp(&name[n-8], "AsString") == 0)
+        {
+          flags |= VTK_METHOD_NAME_AS_STRING;
+        }
+        else if (strcmp(&name[n-8], "MinValue") == 0)
+        {
+          flags |= VTK_METHOD_NAME_MIN_VALUE;
+        }
+        else if (strcmp(&name[n-8], "MaxValue") == 0)
+        {
+          flags |= VTK_METHOD_NAME_MAX_VALUE;
+        }
+      }
+      break;
 
-static int isGetMaxValueMethod(const char *name)
-{
-  size_t n;
+    case 'A':
+      if (name[1] == 'd' && name[2] == 'd' && isupper(name[3]) &&
+          (flags & VTK_METHOD_NAME_BOOLEAN) == 0)
+      {
+        flags |= VTK_METHOD_NAME_ADD;
+        *prefixLength = 3;
+      }
+      break;
 
-  if (isGetMethod(name))
-  {
-    n = strlen(name);
-    if (n > 11 && strcmp("MaxValue", &name[n-8]) == 0)
-    {
-      return 1;
-    }
+    case 'R':
+      if (strncmp(&name[1], "emove", 5) == 0 && isupper(name[6]) &&
+          (flags & VTK_METHOD_NAME_BOOLEAN) == 0)
+      {
+        flags |= VTK_METHOD_NAME_REMOVE;
+        *prefixLength = 6;
+        if (name[6] == 'A' && name[7] == 'l' && name[8] == 'l' &&
+            isupper(name[9]) && name[n-1] == 's')
+        {
+          flags |= VTK_METHOD_NAME_REMOVE_ALL;
+          *prefixLength = 9;
+        }
+      }
+      break;
   }
 
-  return 0;
+  return flags;
+}
+
+/*-------------------------------------------------------------------
+ * check whether the method name has all of the given METHOD_NAME flags */
+
+static int methodNameIs(const MethodAttributes *meth, unsigned int flags)
+{
+  return ((meth->NameType & flags) == flags);
 }
 
 /*-------------------------------------------------------------------
@@ -245,11 +327,7 @@ static int isGetMaxValueMethod(const char *name)
 
 static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
 {
-  size_t n;
-  const char *name;
-  name = meth->Name;
-
-  if (isSetMethod(name))
+  if (methodNameIs(meth, VTK_METHOD_NAME_SET))
   {
     if (meth->IsEnumerated)
     {
@@ -257,7 +335,7 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
     }
     else if (meth->IsIndexed)
     {
-      if (isSetNthMethod(name))
+      if (methodNameIs(meth, VTK_METHOD_NAME_NTH))
       {
         return VTK_METHOD_SET_NTH;
       }
@@ -270,7 +348,7 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
     {
       return VTK_METHOD_SET_MULTI;
     }
-    else if (shortForm && isSetNumberOfMethod(name))
+    else if (shortForm && methodNameIs(meth, VTK_METHOD_NAME_NUMBER_OF))
     {
       return VTK_METHOD_SET_NUMBER_OF;
     }
@@ -281,8 +359,7 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
   }
   else if (meth->IsBoolean)
   {
-    n = strlen(name);
-    if (name[n-1] == 'n')
+    if (methodNameIs(meth, VTK_METHOD_NAME_ON))
     {
       return VTK_METHOD_BOOL_ON;
     }
@@ -291,23 +368,23 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
       return VTK_METHOD_BOOL_OFF;
     }
   }
-  else if (isGetMethod(name))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_GET))
   {
-    if (shortForm && isGetMinValueMethod(name))
+    if (shortForm && methodNameIs(meth, VTK_METHOD_NAME_MIN_VALUE))
     {
       return VTK_METHOD_GET_MIN_VALUE;
     }
-    else if (shortForm && isGetMaxValueMethod(name))
+    else if (shortForm && methodNameIs(meth, VTK_METHOD_NAME_MAX_VALUE))
     {
       return VTK_METHOD_GET_MAX_VALUE;
     }
-    else if (shortForm && isAsStringMethod(name))
+    else if (shortForm && methodNameIs(meth, VTK_METHOD_NAME_AS_STRING))
     {
       return VTK_METHOD_GET_AS_STRING;
     }
     else if (meth->IsIndexed && meth->IsRHS)
     {
-      if (isGetNthMethod(name))
+      if (methodNameIs(meth, VTK_METHOD_NAME_NTH))
       {
         return VTK_METHOD_GET_NTH_RHS;
       }
@@ -318,7 +395,7 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
     }
     else if (meth->IsIndexed)
     {
-      if (isGetNthMethod(name))
+      if (methodNameIs(meth, VTK_METHOD_NAME_NTH))
       {
         return VTK_METHOD_GET_NTH;
       }
@@ -335,7 +412,7 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
     {
       return VTK_METHOD_GET_RHS;
     }
-    else if (shortForm && isGetNumberOfMethod(name))
+    else if (shortForm && methodNameIs(meth, VTK_METHOD_NAME_NUMBER_OF))
     {
       return VTK_METHOD_GET_NUMBER_OF;
     }
@@ -344,9 +421,9 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
       return VTK_METHOD_GET;
     }
   }
-  else if (isRemoveMethod(name))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_REMOVE))
   {
-    if (isRemoveAllMethod(name))
+    if (methodNameIs(meth, VTK_METHOD_NAME_REMOVE_ALL))
     {
       return VTK_METHOD_REMOVE_ALL;
     }
@@ -359,7 +436,7 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
       return VTK_METHOD_REMOVE;
     }
   }
-  else if (isAddMethod(name))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_ADD))
   {
     if (meth->IsIndexed)
     {
@@ -382,33 +459,21 @@ static unsigned int methodCategory(MethodAttributes *meth, int shortForm)
  * remove the following prefixes from a method name:
  * Set, Get, Add, Remove */
 
-static const char *nameWithoutPrefix(const char *name)
+static const char *nameWithoutPrefix(const MethodAttributes *meth)
 {
-  if (isGetNthMethod(name) || isSetNthMethod(name))
+  if (meth->Name)
   {
-    return &name[6];
-  }
-  else if (isGetMethod(name) || isSetMethod(name) || isAddMethod(name))
-  {
-    return &name[3];
-  }
-  else if (isRemoveAllMethod(name))
-  {
-    return &name[9];
-  }
-  else if (isRemoveMethod(name))
-  {
-    return &name[6];
+    return &meth->Name[meth->PrefixLength];
   }
 
-  return name;
+  return NULL;
 }
 
 /*-------------------------------------------------------------------
  * check for a valid suffix, i.e. "On" or "Off" or "ToSomething" */
 
 static int isValidSuffix(
-  const char *methName, const char *propertyName, const char *suffix)
+  const MethodAttributes *meth, const char *propertyName, const char *suffix)
 {
   if ((suffix[0] == 'O' && suffix[1] == 'n' && suffix[2] == '\0') ||
       (suffix[0] == 'O' && suffix[1] == 'f' && suffix[2] == 'f' &&
@@ -417,14 +482,14 @@ static int isValidSuffix(
     return 1;
   }
 
-  else if (isSetMethod(methName) &&
+  else if (methodNameIs(meth, VTK_METHOD_NAME_SET) &&
       suffix[0] == 'T' && suffix[1] == 'o' &&
       (isupper(suffix[2]) || isdigit(suffix[2])))
   {
     return 1;
   }
 
-  else if (isGetMethod(methName) &&
+  else if (methodNameIs(meth, VTK_METHOD_NAME_GET) &&
       ((suffix[0] == 'A' && suffix[1] == 's' &&
        (isupper(suffix[2]) || isdigit(suffix[2]))) ||
       (((suffix[0] == 'M' && suffix[1] == 'a' && suffix[2] == 'x') ||
@@ -435,13 +500,12 @@ static int isValidSuffix(
     return 1;
   }
 
-  else if (isRemoveAllMethod(methName))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_REMOVE_ALL))
   {
     return (suffix[0] == 's' && suffix[1] == '\0');
   }
 
-  else if (isGetNumberOfMethod(methName) ||
-           isSetNumberOfMethod(methName))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_NUMBER_OF))
   {
     if (strncmp(propertyName, "NumberOf", 8) == 0)
     {
@@ -460,6 +524,62 @@ static int isValidSuffix(
   return 0;
 }
 
+/*-------------------------------------------------------------------
+ * add method "i" to the index under every property name that it might
+ * match, i.e. its name without the prefix and without each possible
+ * suffix that is accepted by isValidSuffix() */
+
+static void addMethodStems(MethodIndex *index,
+                           const MethodAttributes *meth, unsigned long i)
+{
+  const char *bases[2];
+  const char *base;
+  size_t j, k, m;
+
+  bases[0] = nameWithoutPrefix(meth);
+  bases[1] = NULL;
+  if (methodNameIs(meth, VTK_METHOD_NAME_NUMBER_OF))
+  {
+    bases[1] = &meth->Name[11];
+  }
+
+  for (j = 0; j < 2 && bases[j]; j++)
+  {
+    base = bases[j];
+    m = strlen(base);
+
+    addToMethodIndex(index, base, m, i);
+    if (m >= 2 && strcmp(&base[m-2], "On") == 0)
+    {
+      addToMethodIndex(index, base, m-2, i);
+    }
+    if (m >= 3 && strcmp(&base[m-3], "Off") == 0)
+    {
+      addToMethodIndex(index, base, m-3, i);
+    }
+    if (m >= 1 && base[m-1] == 's')
+    {
+      addToMethodIndex(index, base, m-1, i);
+    }
+    if (m >= 8 && (strcmp(&base[m-8], "MinValue") == 0 ||
+                   strcmp(&base[m-8], "MaxValue") == 0))
+    {
+      addToMethodIndex(index, base, m-8, i);
+    }
+
+    /* the "ToSomething" and "AsSomething" suffixes can start anywhere */
+    for (k = 0; k + 2 < m; k++)
+    {
+      if (((base[k] == 'T' && base[k+1] == 'o') ||
+           (base[k] == 'A' && base[k+1] == 's')) &&
+          (isupper(base[k+2]) || isdigit(base[k+2])))
+      {
+        addToMethodIndex(index, base, k, i);
+      }
+    }
+  }
+}
+
 /*-------------------------------------------------------------------
  * Convert the FunctionInfo into a MethodAttributes, which will make
  * it easier to find matched Set/Get methods.  A return value of zero
@@ -475,6 +595,8 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
   int indexed = 0;
 
   attrs->Name = func->Name;
+  attrs->NameType = vtkParseProperties_ClassifyMethodName(
+    func->Name, &attrs->PrefixLength);
   attrs->HasProperty = 0;
   attrs->Type = 0;
   attrs->Count = 0;
@@ -520,7 +642,8 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
     {
       indexed = 1;
 
-      if (!isSetNumberOfMethod(func->Name))
+      if (!methodNameIs(attrs,
+                        (VTK_METHOD_NAME_SET | VTK_METHOD_NAME_NUMBER_OF)))
       {
         /* make sure this isn't a multi-value int method */
         tmptype = func->Parameters[0]->Type;
@@ -555,7 +678,7 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
       func->NumberOfParameters == (unsigned long)indexed)
   {
     /* methods of the form "type GetValue()" or "type GetValue(i)" */
-    if (isGetMethod(func->Name))
+    if (methodNameIs(attrs, VTK_METHOD_NAME_GET))
     {
       attrs->HasProperty = 1;
       attrs->Type = func->ReturnValue->Type;
@@ -573,7 +696,7 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
       func->NumberOfParameters == (unsigned long)(1 + indexed))
   {
     /* "void SetValue(type)" or "void SetValue(int, type)" */
-    if (isSetMethod(func->Name))
+    if (methodNameIs(attrs, VTK_METHOD_NAME_SET))
     {
       attrs->HasProperty = 1;
       attrs->IsRHS = 1;
@@ -584,7 +707,7 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
       return 1;
     }
     /* "void GetValue(type *)" or "void GetValue(int, type *)" */
-    else if (isGetMethod(func->Name) &&
+    else if (methodNameIs(attrs, VTK_METHOD_NAME_GET) &&
              /* func->Parameters[indexed]->Count > 0 && */
              (func->Parameters[indexed]->Type & VTK_PARSE_INDIRECT) ==
               VTK_PARSE_POINTER &&
@@ -599,7 +722,8 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
       return 1;
     }
     /* "void AddValue(vtkObject *)" or "void RemoveValue(vtkObject *)" */
-    else if ((isAddMethod(func->Name) || isRemoveMethod(func->Name)) &&
+    else if ((methodNameIs(attrs, VTK_METHOD_NAME_ADD) ||
+              methodNameIs(attrs, VTK_METHOD_NAME_REMOVE)) &&
              (func->Parameters[indexed]->Type & VTK_PARSE_UNQUALIFIED_TYPE) ==
               VTK_PARSE_OBJECT_PTR)
     {
@@ -632,7 +756,7 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
     if (allSame)
     {
       /* "void SetValue(type x, type y, type z)" */
-      if (isSetMethod(func->Name) &&
+      if (methodNameIs(attrs, VTK_METHOD_NAME_SET) &&
           (tmptype & VTK_PARSE_INDIRECT) == 0 &&
           (!func->ReturnValue ||
            (func->ReturnValue->Type & VTK_PARSE_UNQUALIFIED_TYPE) == VTK_PARSE_VOID))
@@ -646,7 +770,7 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
         return 1;
       }
       /* "void GetValue(type& x, type& x, type& x)" */
-      else if (isGetMethod(func->Name) &&
+      else if (methodNameIs(attrs, VTK_METHOD_NAME_GET) &&
                (tmptype & VTK_PARSE_REF) != 0 &&
                (tmptype & VTK_PARSE_CONST) == 0 &&
                (!func->ReturnValue ||
@@ -661,7 +785,7 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
         return 1;
       }
       /* "void AddValue(type x, type y, type z)" */
-      else if (isAddMethod(func->Name) &&
+      else if (methodNameIs(attrs, VTK_METHOD_NAME_ADD) &&
                (tmptype & VTK_PARSE_INDIRECT) == 0 &&
                (!func->ReturnValue ||
                 (func->ReturnValue->Type & VTK_PARSE_UNQUALIFIED_TYPE) ==
@@ -693,21 +817,21 @@ static int getMethodAttributes(FunctionInfo *func, MethodAttributes *attrs)
     attrs->ClassName = "void";
 
     /* "void ValueOn()" or "void ValueOff()" */
-    if (isBooleanMethod(func->Name))
+    if ((attrs->NameType & VTK_METHOD_NAME_BOOLEAN) != 0)
     {
       attrs->HasProperty = 1;
       attrs->IsBoolean = 1;
       return 1;
     }
     /* "void SetValueToEnum()" */
-    else if (isEnumeratedMethod(func->Name))
+    else if (methodNameIs(attrs, VTK_METHOD_NAME_VALUE_TO))
     {
       attrs->HasProperty = 1;
       attrs->IsEnumerated = 1;
       return 1;
     }
     /* "void RemoveAllValues()" */
-    else if (isRemoveAllMethod(func->Name))
+    else if (methodNameIs(attrs, VTK_METHOD_NAME_REMOVE_ALL))
     {
       attrs->HasProperty = 1;
       return 1;
@@ -749,7 +873,7 @@ static int methodMatchesProperty(
 
   /* get the property name and compare it to the method name */
   propertyName = property->Name;
-  name = nameWithoutPrefix(meth->Name);
+  name = nameWithoutPrefix(meth);
 
   if (name == 0 || propertyName == 0)
   {
@@ -760,7 +884,7 @@ static int methodMatchesProperty(
    * SetNumberOf(), GetVarMinValue(), GetVarMaxValue() methods */
   *longMatch = 0;
   n = strlen(propertyName);
-  if (isGetNumberOfMethod(meth->Name) || isSetNumberOfMethod(meth->Name))
+  if (methodNameIs(meth, VTK_METHOD_NAME_NUMBER_OF))
   {
     if (strncmp(propertyName, "NumberOf", 8) == 0 && isupper(propertyName[8]))
     {
@@ -773,21 +897,21 @@ static int methodMatchesProperty(
       name = &meth->Name[11];
     }
   }
-  else if (isGetMinValueMethod(meth->Name))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_MIN_VALUE))
   {
     if (n >= 8 && strcmp(&propertyName[n-8], "MinValue") == 0)
     {
       *longMatch = 1;
     }
   }
-  else if (isGetMaxValueMethod(meth->Name))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_MAX_VALUE))
   {
     if (n >= 8 && strcmp(&propertyName[n-8], "MaxValue") == 0)
     {
       *longMatch = 1;
     }
   }
-  else if (isAsStringMethod(meth->Name))
+  else if (methodNameIs(meth, VTK_METHOD_NAME_AS_STRING))
   {
     if (n >= 8 && strcmp(&propertyName[n-8], "AsString") == 0)
     {
@@ -803,7 +927,7 @@ static int methodMatchesProperty(
 
   /* make sure that any non-matching bits are valid suffixes */
   methSuffix = &name[n];
-  if (!isValidSuffix(meth->Name, propertyName, methSuffix))
+  if (!isValidSuffix(meth, propertyName, methSuffix))
   {
     return 0;
   }
@@ -816,7 +940,7 @@ static int methodMatchesProperty(
   methType = (methType & VTK_PARSE_UNQUALIFIED_TYPE);
 
   /* check for RemoveAll method matching an Add method*/
-  if (isRemoveAllMethod(meth->Name) &&
+  if (methodNameIs(meth, VTK_METHOD_NAME_REMOVE_ALL) &&
       methType == VTK_PARSE_VOID &&
       (methType & VTK_PARSE_INDIRECT) == 0 &&
       ((methodBitfield & (VTK_METHOD_ADD | VTK_METHOD_ADD_MULTI)) != 0))
@@ -825,7 +949,8 @@ static int methodMatchesProperty(
   }
 
   /* check for GetNumberOf and SetNumberOf for indexed properties */
-  if (isGetNumberOfMethod(meth->Name) &&
+  if (methodNameIs(meth,
+                   (VTK_METHOD_NAME_GET | VTK_METHOD_NAME_NUMBER_OF)) &&
       (methType == VTK_PARSE_INT ||
        methType == VTK_PARSE_SIZE_T ||
        methType == VTK_PARSE_ID_TYPE) &&
@@ -835,7 +960,8 @@ static int methodMatchesProperty(
     return 1;
   }
 
-  if (isSetNumberOfMethod(meth->Name) &&
+  if (methodNameIs(meth,
+                   (VTK_METHOD_NAME_SET | VTK_METHOD_NAME_NUMBER_OF)) &&
       (methType == VTK_PARSE_INT ||
        methType == VTK_PARSE_SIZE_T ||
        methType == VTK_PARSE_ID_TYPE) &&
@@ -870,7 +996,7 @@ static int methodMatchesProperty(
   /* promote "void" to enumerated type for e.g. boolean methods, and */
   /* check for GetValueAsString method, assume it has matching enum */
   if (meth->IsBoolean || meth->IsEnumerated ||
-      (isAsStringMethod(meth->Name) &&
+      (methodNameIs(meth, VTK_METHOD_NAME_AS_STRING) &&
        (methType & VTK_PARSE_UNQUALIFIED_TYPE) == VTK_PARSE_CHAR_PTR))
   {
     if ((propertyType & VTK_PARSE_INDIRECT) == 0 &&
@@ -925,7 +1051,7 @@ static void initializePropertyInfo(
     typeClass = "int";
   }
 
-  property->Name = nameWithoutPrefix(meth->Name);
+  property->Name = nameWithoutPrefix(meth);
 
   /* get property type, but don't include "ref" as part of type,
    * and use a pointer if the method is multi-valued */
@@ -991,22 +1117,31 @@ static void findAllMatches(
   unsigned int methodCategories[],
   int methodHasProperty[], unsigned long methodProperties[])
 {
-  unsigned long i, j, k, n;
+  unsigned long i, j, k, l, n;
   size_t m;
   MethodAttributes *meth;
+  const MethodIndexEntry *entry;
   unsigned int methodBit;
   int longMatch;
   int foundNoMatches = 0;
 
-  n = methods->NumberOfMethods;
+  /* only the methods indexed under the property name can match */
+  entry = findMethodIndexEntry(
+    &methods->StemIndex, property->Name, strlen(property->Name));
+  if (entry == NULL)
+  {
+    return;
+  }
+  n = entry->NumberOfMethods;
 
   /* loop repeatedly until no more matches are found */
   while (!foundNoMatches)
   {
     foundNoMatches = 1;
 
-    for (i = 0; i < n; i++)
+    for (l = 0; l < n; l++)
     {
+      i = entry->Methods[l];
       if (matchedMethods[i]) { continue; }
 
       meth = methods->Methods[i];
@@ -1087,20 +1222,25 @@ static int searchForRepeatedMethods(
   ClassProperties *properties, ClassPropertyMethods *methods,
   unsigned long j)
 {
-  unsigned long i, n;
+  unsigned long i, l, n;
   MethodAttributes *attrs;
   MethodAttributes *meth;
-  n = methods->NumberOfMethods;
+  const MethodIndexEntry *entry;
 
   attrs = methods->Methods[j];
 
-  for (i = 0; i < n; i++)
+  /* only the methods with the same name can be repeats */
+  entry = findMethodIndexEntry(
+    &methods->NameIndex, attrs->Name, strlen(attrs->Name));
+  n = (entry ? entry->NumberOfMethods : 0);
+
+  for (l = 0; l < n; l++)
   {
+    i = entry->Methods[l];
     meth = methods->Methods[i];
 
-    /* check whether the function name and basic structure are matched */
-    if (meth->Name && strcmp(attrs->Name, meth->Name) == 0 &&
-        ((attrs->Type & VTK_PARSE_POINTER_MASK) ==
+    /* check whether the basic structure is matched */
+    if (((attrs->Type & VTK_PARSE_POINTER_MASK) ==
            (meth->Type & VTK_PARSE_POINTER_MASK)) &&
         attrs->Access == meth->Access &&
         attrs->IsHinted == meth->IsHinted &&
@@ -1209,6 +1349,11 @@ static void categorizeProperties(
     {
       matchedMethods[i] = 1;
     }
+    /* a method that is a repeat now might not be one later */
+    if (methods->Methods[i]->HasProperty)
+    {
+      addMethodStems(&methods->StemIndex, methods->Methods[i], i);
+    }
   }
 
   /* start with the set methods */
@@ -1216,9 +1361,10 @@ static void categorizeProperties(
   {
     /* all set methods except for SetValueToEnum() methods
      * and SetNumberOf() methods */
-    if (!matchedMethods[i] && isSetMethod(methods->Methods[i]->Name) &&
+    if (!matchedMethods[i] &&
+        methodNameIs(methods->Methods[i], VTK_METHOD_NAME_SET) &&
         !methods->Methods[i]->IsEnumerated &&
-        !isSetNumberOfMethod(methods->Methods[i]->Name))
+        !methodNameIs(methods->Methods[i], VTK_METHOD_NAME_NUMBER_OF))
     {
       addProperty(properties, methods, i, matchedMethods);
     }
@@ -1229,9 +1375,10 @@ static void categorizeProperties(
   {
     /* all get methods except for GetValueAs() methods
      * and GetNumberOf() methods */
-    if (!matchedMethods[i] && isGetMethod(methods->Methods[i]->Name) &&
-        !isAsStringMethod(methods->Methods[i]->Name) &&
-        !isGetNumberOfMethod(methods->Methods[i]->Name))
+    if (!matchedMethods[i] &&
+        methodNameIs(methods->Methods[i], VTK_METHOD_NAME_GET) &&
+        !methodNameIs(methods->Methods[i], VTK_METHOD_NAME_AS_STRING) &&
+        !methodNameIs(methods->Methods[i], VTK_METHOD_NAME_NUMBER_OF))
     {
       addProperty(properties, methods, i, matchedMethods);
     }
@@ -1241,7 +1388,9 @@ static void categorizeProperties(
    * matching indexed Set methods */
   for (i = 0; i < n; i++)
   {
-    if (!matchedMethods[i] && isSetNumberOfMethod(methods->Methods[i]->Name))
+    if (!matchedMethods[i] &&
+        methodNameIs(methods->Methods[i],
+                     (VTK_METHOD_NAME_SET | VTK_METHOD_NAME_NUMBER_OF)))
     {
       addProperty(properties, methods, i, matchedMethods);
     }
@@ -1251,7 +1400,9 @@ static void categorizeProperties(
    * matching indexed Get methods */
   for (i = 0; i < n; i++)
   {
-    if (!matchedMethods[i] && isGetNumberOfMethod(methods->Methods[i]->Name))
+    if (!matchedMethods[i] &&
+        methodNameIs(methods->Methods[i],
+                     (VTK_METHOD_NAME_GET | VTK_METHOD_NAME_NUMBER_OF)))
     {
       addProperty(properties, methods, i, matchedMethods);
     }
@@ -1261,7 +1412,8 @@ static void categorizeProperties(
   for (i = 0; i < n; i++)
   {
     /* all add methods */
-    if (!matchedMethods[i] && isAddMethod(methods->Methods[i]->Name))
+    if (!matchedMethods[i] &&
+        methodNameIs(methods->Methods[i], VTK_METHOD_NAME_ADD))
     {
       addProperty(properties, methods, i, matchedMethods);
     }
@@ -1289,6 +1441,11 @@ static void categorizePropertyMethods(
     func = data->Functions[i];
     attrs = (MethodAttributes *)malloc(sizeof(MethodAttributes));
     methods->Methods[methods->NumberOfMethods++] = attrs;
+    if (func->Name)
+    {
+      addToMethodIndex(&methods->NameIndex, func->Name,
+                       strlen(func->Name), i);
+    }
 
     /* copy the func into a MethodAttributes struct if possible */
     if (getMethodAttributes(func, attrs))
@@ -1308,9 +1465,13 @@ ClassProperties *vtkParseProperties_Create(ClassInfo *data)
   ClassProperties *properties;
   ClassPropertyMethods *methods;
 
+  vtkParse_StartPhase(VTK_PARSE_PHASE_PROPERTIES);
+
   methods = (ClassPropertyMethods *)malloc(sizeof(ClassPropertyMethods));
   methods->Methods = (MethodAttributes **)malloc(sizeof(MethodAttributes *)*
                                                  data->NumberOfFunctions);
+  initMethodIndex(&methods->NameIndex);
+  initMethodIndex(&methods->StemIndex);
 
   /* categorize the methods according to what properties they reference
    * and what they do to that property */
@@ -1343,9 +1504,13 @@ ClassProperties *vtkParseProperties_Create(ClassInfo *data)
     free(methods->Methods[i]);
   }
 
+  freeMethodIndex(&methods->NameIndex);
+  freeMethodIndex(&methods->StemIndex);
   free(methods->Methods);
   free(methods);
 
+  vtkParse_StopPhase(VTK_PARSE_PHASE_PROPERTIES);
+
   return properties;
 }
 
@@ -22,6 +22,7 @@
 #define VTK_PARSE_PROPERTIES_H
 
 #include "vtkParseType.h"
+#include <stddef.h>
 
 /**
  * bitfield values to say what methods are available for a property
@@ -87,6 +88,27 @@
 #define VTK_METHOD_SET_BOOL \
   (VTK_METHOD_BOOL_ON|VTK_METHOD_BOOL_OFF)
 
+/**
+ * bitfield values for the parts of a method name that are used to
+ * find properties, see vtkParseProperties_ClassifyMethodName()
+ */
+#define VTK_METHOD_NAME_SET        0x0001  /* SetValue() */
+#define VTK_METHOD_NAME_GET        0x0002  /* GetValue() */
+#define VTK_METHOD_NAME_ADD        0x0004  /* AddValue() */
+#define VTK_METHOD_NAME_REMOVE     0x0008  /* RemoveValue() */
+#define VTK_METHOD_NAME_REMOVE_ALL 0x0010  /* RemoveAllValues() */
+#define VTK_METHOD_NAME_NTH        0x0020  /* SetNthValue(), GetNthValue() */
+#define VTK_METHOD_NAME_NUMBER_OF  0x0040  /* SetNumberOfValues(), etc. */
+#define VTK_METHOD_NAME_ON         0x0080  /* ValueOn() */
+#define VTK_METHOD_NAME_OFF        0x0100  /* ValueOff() */
+#define VTK_METHOD_NAME_VALUE_TO   0x0200  /* SetValueToSomething() */
+#define VTK_METHOD_NAME_AS_STRING  0x0400  /* GetValueAsString() */
+#define VTK_METHOD_NAME_MIN_VALUE  0x0800  /* GetValueMinValue() */
+#define VTK_METHOD_NAME_MAX_VALUE  0x1000  /* GetValueMaxValue() */
+
+#define VTK_METHOD_NAME_BOOLEAN \
+  (VTK_METHOD_NAME_ON|VTK_METHOD_NAME_OFF)
+
 /**
  * A struct that contains all the property information that
  * can be ascertained from the vtkParse info
@@ -142,6 +164,15 @@ void vtkParseProperties_Free(ClassProperties *properties);
  */
 const char *vtkParseProperties_MethodTypeAsString(unsigned int methodType);
 
+/**
+ * Classify a method name by its prefix and suffix, and return the
+ * VTK_METHOD_NAME flags for it.  The length of the prefix (Set, Get,
+ * Add, Remove, SetNth, GetNth, or RemoveAll) is returned in
+ * prefixLength, or zero if the name has none of these prefixes.
+ */
+unsigned int vtkParseProperties_ClassifyMethodName(
+  const char *name, size_t *prefixLength);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -528,6 +528,8 @@ void vtkParse_InitStringCache(StringCache *cache)
   cache->Chunks = NULL;
   cache->ChunkSize = 0;
   cache->Position = 0;
+  cache->AllocatedBytes = 0;
+  cache->WastedBytes = 0;
 }
 
 /* allocate a string of n+1 bytes */
@@ -546,11 +548,18 @@ char *vtkParse_NewString(StringCache *cache, size_t n)
 
   if (cache->NumberOfChunks == 0 || nextPosition > cache->ChunkSize)
   {
+    /* the rest of the current chunk will not be used */
+    if (cache->NumberOfChunks > 0 && cache->Position < cache->ChunkSize)
+    {
+      cache->WastedBytes += cache->ChunkSize - cache->Position;
+    }
+
     if (n + 1 > cache->ChunkSize)
     {
       cache->ChunkSize = n + 1;
     }
     cp = (char *)malloc(cache->ChunkSize);
+    cache->AllocatedBytes += cache->ChunkSize;
 
     /* if empty, alloc for the first time */
     if (cache->NumberOfChunks == 0)
@@ -594,6 +603,8 @@ void vtkParse_FreeStringCache(StringCache *cache)
 
   cache->Chunks = NULL;
   cache->NumberOfChunks = 0;
+  cache->AllocatedBytes = 0;
+  cache->WastedBytes = 0;
 }
 
 /* duplicate the first n bytes of a string and terminate it */
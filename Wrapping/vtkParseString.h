@@ -212,6 +212,8 @@ typedef struct _StringCache
   char         **Chunks;
   size_t         ChunkSize;
   size_t         Position;
+  size_t         AllocatedBytes; /* the total size of all chunks */
+  size_t         WastedBytes;    /* unused bytes at the ends of chunks */
 } StringCache;
 
 /**
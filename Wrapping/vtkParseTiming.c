@@ -0,0 +1,392 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseTiming.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+#include "vtkParseTiming.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#include <sys/locking.h>
+#else
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* the names of the phases, as they appear in the report */
+static const char *timing_phase_names[VTK_PARSE_NUMBER_OF_PHASES] = {
+  "options",
+  "hierarchy",
+  "hints",
+  "macros",
+  "includes",
+  "parse",
+  "comments",
+  "merge",
+  "properties",
+  "output"
+};
+
+/* the names of the counters, as they appear in the report */
+static const char *timing_counter_names[VTK_PARSE_NUMBER_OF_COUNTERS] = {
+  "bytes",
+  "tokens",
+  "defines",
+  "expansions",
+  "includes",
+  "stats",
+  "macros"
+};
+
+/* the accumulated times for each phase */
+static struct
+{
+  double WallTime;     /* total wall time in seconds */
+  double CPUTime;      /* total CPU time in seconds */
+  double WallStart;    /* wall time when the phase was started */
+  clock_t CPUStart;    /* CPU time when the phase was started */
+  unsigned long Calls; /* number of times the phase was started */
+  int Depth;           /* for phases that are re-entered */
+} timing_phases[VTK_PARSE_NUMBER_OF_PHASES];
+
+/* the counters */
+static unsigned long timing_counters[VTK_PARSE_NUMBER_OF_COUNTERS];
+
+/* the trace file, and the trace events that are waiting to be written */
+static char *trace_file_name = NULL;
+static char *trace_buffer = NULL;
+static size_t trace_length = 0;
+static size_t trace_capacity = 0;
+static unsigned long trace_pid = 0;
+static int trace_depth = 0;
+
+/* Get the wall-clock time in seconds */
+double vtkParse_WallTime(void)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart/(double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+#endif
+}
+
+/* Get the CPU time in seconds */
+double vtkParse_CPUTime(void)
+{
+  return (double)clock()/CLOCKS_PER_SEC;
+}
+
+/* Start the timer for a phase */
+void vtkParse_StartPhase(parse_phase_t phase)
+{
+  timing_phases[phase].Calls++;
+  if (timing_phases[phase].Depth++ == 0)
+  {
+    timing_phases[phase].WallStart = vtkParse_WallTime();
+    timing_phases[phase].CPUStart = clock();
+  }
+}
+
+/* Stop the timer for a phase */
+void vtkParse_StopPhase(parse_phase_t phase)
+{
+  if (--timing_phases[phase].Depth == 0)
+  {
+    timing_phases[phase].CPUTime +=
+      (double)(clock() - timing_phases[phase].CPUStart)/CLOCKS_PER_SEC;
+    timing_phases[phase].WallTime +=
+      vtkParse_WallTime() - timing_phases[phase].WallStart;
+  }
+}
+
+/* Add to one of the counters */
+void vtkParse_AddToCounter(parse_counter_t counter, unsigned long n)
+{
+  timing_counters[counter] += n;
+}
+
+/* Get the value of one of the counters */
+unsigned long vtkParse_GetCounter(parse_counter_t counter)
+{
+  return timing_counters[counter];
+}
+
+/* Print a string as a JSON string */
+static void timing_print_json_string(FILE *fp, const char *text)
+{
+  fputc('\"', fp);
+  for (; text && *text != '\0'; text++)
+  {
+    if (*text == '\"' || *text == '\\')
+    {
+      fputc('\\', fp);
+      fputc(*text, fp);
+    }
+    else if ((unsigned char)(*text) < 0x20)
+    {
+      fprintf(fp, "\\u%04x", (unsigned int)(*text));
+    }
+    else
+    {
+      fputc(*text, fp);
+    }
+  }
+  fputc('\"', fp);
+}
+
+/* Print the times and counts */
+void vtkParse_PrintTimings(
+  FILE *fp, const char *tool, const char *name, int json)
+{
+  int i;
+
+  if (json)
+  {
+    fprintf(fp, "{\"tool\": ");
+    timing_print_json_string(fp, tool);
+    fprintf(fp, ", \"file\": ");
+    timing_print_json_string(fp, name);
+    fprintf(fp, ", \"phases\": {");
+    for (i = 0; i < VTK_PARSE_NUMBER_OF_PHASES; i++)
+    {
+      fprintf(fp,
+              "%s\"%s\": {\"calls\": %lu, \"wall\": %.6f, \"cpu\": %.6f}",
+              (i == 0 ? "" : ", "), timing_phase_names[i],
+              timing_phases[i].Calls, timing_phases[i].WallTime,
+              timing_phases[i].CPUTime);
+    }
+    fprintf(fp, "}, \"counts\": {");
+    for (i = 0; i < VTK_PARSE_NUMBER_OF_COUNTERS; i++)
+    {
+      fprintf(fp, "%s\"%s\": %lu", (i == 0 ? "" : ", "),
+              timing_counter_names[i], timing_counters[i]);
+    }
+    fprintf(fp, "}}\n");
+  }
+  else
+  {
+    fprintf(fp, "%s timings for %s\n", (tool ? tool : ""), (name ? name : ""));
+    fprintf(fp, "  %-12s %8s %12s %12s\n", "phase", "calls", "wall (ms)",
+            "cpu (ms)");
+    for (i = 0; i < VTK_PARSE_NUMBER_OF_PHASES; i++)
+    {
+      fprintf(fp, "  %-12s %8lu %12.3f %12.3f\n", timing_phase_names[i],
+              timing_phases[i].Calls, 1e3*timing_phases[i].WallTime,
+              1e3*timing_phases[i].CPUTime);
+    }
+    fprintf(fp, "  %-12s %8s\n", "counter", "count");
+    for (i = 0; i < VTK_PARSE_NUMBER_OF_COUNTERS; i++)
+    {
+      fprintf(fp, "  %-12s %8lu\n", timing_counter_names[i],
+              timing_counters[i]);
+    }
+  }
+}
+
+/* Append text to the trace buffer */
+static void trace_append(const char *text, size_t n)
+{
+  if (trace_length + n > trace_capacity)
+  {
+    trace_capacity = (trace_capacity ? 2*trace_capacity : 4096);
+    while (trace_length + n > trace_capacity)
+    {
+      trace_capacity *= 2;
+    }
+    trace_buffer = (char *)realloc(trace_buffer, trace_capacity);
+  }
+  memcpy(&trace_buffer[trace_length], text, n);
+  trace_length += n;
+}
+
+/* Append a null-terminated string to the trace buffer */
+static void trace_append_text(const char *text)
+{
+  trace_append(text, strlen(text));
+}
+
+/* Append a JSON string to the trace buffer */
+static void trace_append_string(const char *text)
+{
+  char esc[8];
+
+  trace_append_text("\"");
+  for (; text && *text != '\0'; text++)
+  {
+    if (*text == '\"' || *text == '\\')
+    {
+      esc[0] = '\\';
+      esc[1] = *text;
+      trace_append(esc, 2);
+    }
+    else if ((unsigned char)(*text) < 0x20)
+    {
+      sprintf(esc, "\\u%04x", (unsigned int)(*text));
+      trace_append(esc, 6);
+    }
+    else
+    {
+      trace_append(text, 1);
+    }
+  }
+  trace_append_text("\"");
+}
+
+/* Append the phase, timestamp, and process to the trace buffer */
+static void trace_append_event(char phase)
+{
+  char text[128];
+
+  sprintf(text, "\"ph\": \"%c\", \"ts\": %.3f, \"pid\": %lu, \"tid\": 0}",
+          phase, 1e6*vtkParse_WallTime(), trace_pid);
+  trace_append_text(text);
+  trace_append_text(",\n");
+}
+
+/* Lock or unlock the trace file */
+static void trace_lock_file(FILE *fp, int lock)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  /* lock the first byte, which is used as a mutex */
+  _lseek(_fileno(fp), 0, SEEK_SET);
+  while (_locking(_fileno(fp), (lock ? _LK_LOCK : _LK_UNLCK), 1) != 0 &&
+         lock)
+  {
+    continue;
+  }
+#else
+  struct flock fl;
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type = (lock ? F_WRLCK : F_UNLCK);
+  fl.l_whence = SEEK_SET;
+  fl.l_start = 0;
+  fl.l_len = 0;
+  while (fcntl(fileno(fp), F_SETLKW, &fl) == -1 && errno == EINTR)
+  {
+    continue;
+  }
+#endif
+}
+
+/* Write the trace events to the trace file, this is called at exit */
+static void trace_write_file(void)
+{
+  FILE *fp;
+
+  /* end any spans that were left open by an early exit */
+  while (trace_depth > 0)
+  {
+    vtkParse_EndSpan(NULL);
+  }
+
+  fp = fopen(trace_file_name, "a");
+  if (!fp)
+  {
+    fprintf(stderr, "Error opening trace file %s\n", trace_file_name);
+    return;
+  }
+
+  /* the closing bracket is optional in the trace event format,
+   * so the events from each process can simply be appended */
+  trace_lock_file(fp, 1);
+  fseek(fp, 0, SEEK_END);
+  if (ftell(fp) == 0)
+  {
+    fputs("[\n", fp);
+  }
+  fwrite(trace_buffer, 1, trace_length, fp);
+  fflush(fp);
+  trace_lock_file(fp, 0);
+  fclose(fp);
+
+  free(trace_buffer);
+  free(trace_file_name);
+  trace_buffer = NULL;
+  trace_file_name = NULL;
+}
+
+/* Start collecting trace events */
+void vtkParse_StartTrace(
+  const char *filename, const char *tool, const char *name)
+{
+  char *label;
+
+  if (trace_file_name)
+  {
+    return;
+  }
+
+  trace_file_name = (char *)malloc(strlen(filename) + 1);
+  strcpy(trace_file_name, filename);
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  trace_pid = (unsigned long)_getpid();
+#else
+  trace_pid = (unsigned long)getpid();
+#endif
+
+  /* label the process with the tool and the input file */
+  label = (char *)malloc(strlen(tool) + strlen(name) + 2);
+  sprintf(label, "%s %s", tool, name);
+  trace_append_text("{\"name\": \"process_name\", \"args\": {\"name\": ");
+  trace_append_string(label);
+  trace_append_text("}, ");
+  trace_append_event('M');
+  free(label);
+
+  atexit(trace_write_file);
+}
+
+/* Begin a span in the trace */
+void vtkParse_BeginSpan(const char *category, const char *name)
+{
+  if (trace_file_name)
+  {
+    trace_append_text("{\"name\": ");
+    trace_append_string(name);
+    trace_append_text(", \"cat\": ");
+    trace_append_string(category);
+    trace_append_text(", ");
+    trace_append_event('B');
+    trace_depth++;
+  }
+}
+
+/* End the most recent span in the trace */
+void vtkParse_EndSpan(const char *category)
+{
+  if (trace_file_name && trace_depth > 0)
+  {
+    trace_append_text("{\"cat\": ");
+    trace_append_string(category);
+    trace_append_text(", ");
+    trace_append_event('E');
+    trace_depth--;
+  }
+}
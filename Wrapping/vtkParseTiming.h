@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseTiming.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file provides timers and counters for the phases of wrapping.
+
+ The wall-clock time and the CPU time are accumulated separately for
+ each phase, along with the number of times that the phase was entered.
+ Phases can nest within each other (for example, include files are
+ preprocessed while the parser is running, and superclass headers are
+ parsed while merging), so the reported times are inclusive.  If a
+ phase is re-entered while it is already running, e.g. for recursive
+ includes, only the outermost interval is timed.
+
+ The timers are always running, since they are only called a handful
+ of times per file.  The report is printed by the wrapper tools when
+ the "--timings" option is given.
+
+ This file also provides spans for Chrome's trace event format, so that
+ all of the wrapper processes in a build can write to one trace file,
+ which can then be loaded into a trace viewer.
+*/
+
+#ifndef VTK_PARSE_TIMING_H
+#define VTK_PARSE_TIMING_H
+
+#include <stdio.h>
+
+/**
+ * The timed phases of the wrapper tools
+ */
+typedef enum _parse_phase_t
+{
+  VTK_PARSE_PHASE_OPTIONS = 0,  /* expansion of the command-line args */
+  VTK_PARSE_PHASE_HIERARCHY,    /* reading hierarchy files */
+  VTK_PARSE_PHASE_HINTS,        /* reading the hints file */
+  VTK_PARSE_PHASE_MACROS,       /* defining the standard macros */
+  VTK_PARSE_PHASE_INCLUDES,     /* preprocessing the include files */
+  VTK_PARSE_PHASE_PARSE,        /* running the parser */
+  VTK_PARSE_PHASE_COMMENTS,     /* assigning comments */
+  VTK_PARSE_PHASE_MERGE,        /* merging superclass methods */
+  VTK_PARSE_PHASE_PROPERTIES,   /* finding the class properties */
+  VTK_PARSE_PHASE_OUTPUT,       /* writing the output file */
+  VTK_PARSE_NUMBER_OF_PHASES
+} parse_phase_t;
+
+/**
+ * The counted quantities
+ */
+typedef enum _parse_counter_t
+{
+  VTK_PARSE_COUNT_BYTES = 0,    /* bytes read from header files */
+  VTK_PARSE_COUNT_TOKENS,       /* tokens given to the parser */
+  VTK_PARSE_COUNT_DEFINES,      /* macros that were defined */
+  VTK_PARSE_COUNT_EXPANSIONS,   /* macros that were expanded */
+  VTK_PARSE_COUNT_INCLUDES,     /* header files read by the preprocessor */
+  VTK_PARSE_COUNT_STATS,        /* stat calls for finding headers */
+  VTK_PARSE_COUNT_MACROS,       /* macros in the table when it was freed */
+  VTK_PARSE_NUMBER_OF_COUNTERS
+} parse_counter_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Start the timer for a phase.
+ */
+void vtkParse_StartPhase(parse_phase_t phase);
+
+/**
+ * Stop the timer for a phase.  This must be called once for every
+ * call to vtkParse_StartPhase().
+ */
+void vtkParse_StopPhase(parse_phase_t phase);
+
+/**
+ * Get the wall-clock time in seconds, from an arbitrary starting point.
+ */
+double vtkParse_WallTime(void);
+
+/**
+ * Get the CPU time used by the process, in seconds.
+ */
+double vtkParse_CPUTime(void);
+
+/**
+ * Add to one of the counters.
+ */
+void vtkParse_AddToCounter(parse_counter_t counter, unsigned long n);
+
+/**
+ * Get the current value of one of the counters.
+ */
+unsigned long vtkParse_GetCounter(parse_counter_t counter);
+
+/**
+ * Print the times and counts.  The "tool" and "name" (the name of the
+ * input file) are only used to label the report.  If "json" is set, then
+ * the report is a single line of JSON instead of a table.  The times
+ * are given in milliseconds in the table, and in seconds in the JSON.
+ */
+void vtkParse_PrintTimings(
+  FILE *fp, const char *tool, const char *name, int json);
+
+/**
+ * Start collecting trace events for the given trace file.  The events
+ * are appended to the file when the program exits, while the file is
+ * locked, so many processes can share the same trace file.  The "tool"
+ * and "name" are used to label the process in the trace.
+ */
+void vtkParse_StartTrace(
+  const char *filename, const char *tool, const char *name);
+
+/**
+ * Begin a span in the trace, the category should be a short word like
+ * "header" or "include".  Nothing is done if tracing was not started.
+ */
+void vtkParse_BeginSpan(const char *category, const char *name);
+
+/**
+ * End the most recent span in the trace.  Spans that have not ended
+ * when the program exits are ended automatically.
+ */
+void vtkParse_EndSpan(const char *category);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
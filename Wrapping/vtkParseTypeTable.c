@@ -0,0 +1,306 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseTypeTable.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+#include "vtkParseTypeTable.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* compare strings, allowing either to be null */
+static int typetable_same_string(const char *cp1, const char *cp2)
+{
+  if (cp1 == cp2)
+  {
+    return 1;
+  }
+  if (cp1 == NULL || cp2 == NULL)
+  {
+    return 0;
+  }
+  return (strcmp(cp1, cp2) == 0);
+}
+
+/* add a string to a hash value */
+static unsigned long typetable_hash_string(unsigned long h, const char *cp)
+{
+  if (cp)
+  {
+    while (*cp != '\0')
+    {
+      h = (h << 5) + h + (unsigned char)(*cp++);
+    }
+  }
+  return (h << 5) + h;
+}
+
+/* compute the hash for a type */
+static unsigned long typetable_hash_type(
+  unsigned int type, const char *classname)
+{
+  return typetable_hash_string(5381 + type, classname);
+}
+
+/* compute the hash for a signature */
+static unsigned long typetable_hash_signature(
+  unsigned long n, const unsigned long *ids)
+{
+  unsigned long h = 5381 + n;
+  unsigned long i;
+
+  for (i = 0; i < n; i++)
+  {
+    h = (h << 5) + h + ids[i];
+  }
+
+  return h;
+}
+
+/* check whether the type with the given id matches */
+static int typetable_match_type(
+  const TypeTable *table, unsigned long id, unsigned int type,
+  const char *classname)
+{
+  return (table->Types[id] == type &&
+          typetable_same_string(table->TypeNames[id], classname));
+}
+
+/* check whether the signature with the given id matches */
+static int typetable_match_signature(
+  const TypeTable *table, unsigned long id,
+  unsigned long n, const unsigned long *ids)
+{
+  const unsigned long *sig = table->Signatures[id];
+
+  return (sig[0] == n && memcmp(&sig[1], ids, n*sizeof(unsigned long)) == 0);
+}
+
+/* rebuild the type hash with double the size */
+static void typetable_grow_type_hash(TypeTable *table)
+{
+  unsigned long m = (table->TypeHashSize ? 2*table->TypeHashSize : 64);
+  unsigned long i, h;
+
+  free(table->TypeHash);
+  table->TypeHashSize = m;
+  table->TypeHash = (unsigned long *)calloc(m, sizeof(unsigned long));
+
+  for (i = 1; i < table->NumberOfTypes; i++)
+  {
+    h = typetable_hash_type(table->Types[i], table->TypeNames[i]);
+    while (table->TypeHash[h & (m-1)] != 0) { h++; }
+    table->TypeHash[h & (m-1)] = i;
+  }
+}
+
+/* rebuild the signature hash with double the size */
+static void typetable_grow_signature_hash(TypeTable *table)
+{
+  unsigned long m =
+    (table->SignatureHashSize ? 2*table->SignatureHashSize : 64);
+  unsigned long i, h;
+
+  free(table->SignatureHash);
+  table->SignatureHashSize = m;
+  table->SignatureHash = (unsigned long *)calloc(m, sizeof(unsigned long));
+
+  for (i = 1; i < table->NumberOfSignatures; i++)
+  {
+    h = typetable_hash_signature(
+      table->Signatures[i][0], &table->Signatures[i][1]);
+    while (table->SignatureHash[h & (m-1)] != 0) { h++; }
+    table->SignatureHash[h & (m-1)] = i;
+  }
+}
+
+/* Initialize the table */
+void vtkParse_InitTypeTable(TypeTable *table)
+{
+  table->NumberOfTypes = 1;
+  table->Types = NULL;
+  table->TypeNames = NULL;
+  table->NumberOfSignatures = 1;
+  table->Signatures = NULL;
+  table->TypeHashSize = 0;
+  table->TypeHash = NULL;
+  table->SignatureHashSize = 0;
+  table->SignatureHash = NULL;
+}
+
+/* Free the table */
+void vtkParse_FreeTypeTable(TypeTable *table)
+{
+  unsigned long i;
+
+  for (i = 1; i < table->NumberOfSignatures; i++)
+  {
+    free(table->Signatures[i]);
+  }
+
+  free(table->Types);
+  free((char **)table->TypeNames);
+  free(table->Signatures);
+  free(table->TypeHash);
+  free(table->SignatureHash);
+
+  vtkParse_InitTypeTable(table);
+}
+
+/* Add a type to the table */
+unsigned long vtkParse_AddTypeToTable(
+  TypeTable *table, unsigned int type, const char *classname)
+{
+  unsigned long h, i, n, m;
+
+  /* keep the load factor at or below one half */
+  n = table->NumberOfTypes;
+  if (2*n > table->TypeHashSize)
+  {
+    typetable_grow_type_hash(table);
+  }
+
+  m = table->TypeHashSize;
+  h = typetable_hash_type(type, classname);
+  while ((i = table->TypeHash[h & (m-1)]) != 0)
+  {
+    if (typetable_match_type(table, i, type, classname))
+    {
+      return i;
+    }
+    h++;
+  }
+
+  /* double the arrays whenever size is a power of two */
+  if ((n & (n-1)) == 0)
+  {
+    table->Types = (unsigned int *)realloc(
+      table->Types, 2*n*sizeof(unsigned int));
+    table->TypeNames = (const char **)realloc(
+      (char **)table->TypeNames, 2*n*sizeof(const char *));
+  }
+
+  table->Types[n] = type;
+  table->TypeNames[n] = classname;
+
+  table->TypeHash[h & (m-1)] = n;
+  table->NumberOfTypes = n + 1;
+
+  return n;
+}
+
+/* Add a signature to the table */
+unsigned long vtkParse_AddSignatureToTable(
+  TypeTable *table, unsigned long n, const unsigned long *ids)
+{
+  unsigned long h, i, k, m;
+
+  /* keep the load factor at or below one half */
+  k = table->NumberOfSignatures;
+  if (2*k > table->SignatureHashSize)
+  {
+    typetable_grow_signature_hash(table);
+  }
+
+  m = table->SignatureHashSize;
+  h = typetable_hash_signature(n, ids);
+  while ((i = table->SignatureHash[h & (m-1)]) != 0)
+  {
+    if (typetable_match_signature(table, i, n, ids))
+    {
+      return i;
+    }
+    h++;
+  }
+
+  /* double the array whenever size is a power of two */
+  if ((k & (k-1)) == 0)
+  {
+    table->Signatures = (unsigned long **)realloc(
+      table->Signatures, 2*k*sizeof(unsigned long *));
+  }
+
+  table->Signatures[k] = (unsigned long *)malloc((n+1)*sizeof(unsigned long));
+  table->Signatures[k][0] = n;
+  if (n)
+  {
+    memcpy(&table->Signatures[k][1], ids, n*sizeof(unsigned long));
+  }
+
+  table->SignatureHash[h & (m-1)] = k;
+  table->NumberOfSignatures = k + 1;
+
+  return k;
+}
+
+/* Get a signature id for the parameters of a function */
+unsigned long vtkParse_AddParametersToTable(
+  TypeTable *table, const FunctionInfo *func)
+{
+  unsigned long ids[32];
+  unsigned long *idp = ids;
+  unsigned long i, n, ndims;
+  unsigned long sig = 0;
+  unsigned int type;
+  ValueInfo *param;
+
+  /* uninstantiated templates cannot be compared */
+  if (func->Template)
+  {
+    return 0;
+  }
+
+  n = func->NumberOfParameters;
+  if (2*n > sizeof(ids)/sizeof(ids[0]))
+  {
+    idp = (unsigned long *)malloc(2*n*sizeof(unsigned long));
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    param = func->Parameters[i];
+    if (param->Function)
+    {
+      break;
+    }
+
+    /* qualifiers only matter for pointers and references, this must
+     * be kept consistent with vtkParse_CompareFunctionSignature() */
+    type = (param->Type & (VTK_PARSE_UNQUALIFIED_TYPE | VTK_PARSE_CONST |
+                           VTK_PARSE_VOLATILE | VTK_PARSE_RVALUE));
+    if ((type & VTK_PARSE_INDIRECT) == 0)
+    {
+      type &= VTK_PARSE_UNQUALIFIED_TYPE;
+    }
+
+    /* only the dimensionality of multi-dimensional arrays matters */
+    ndims = param->NumberOfDimensions;
+    if (ndims < 2)
+    {
+      ndims = 0;
+    }
+
+    idp[2*i] = vtkParse_AddTypeToTable(table, type, param->TypeName);
+    idp[2*i + 1] = ndims;
+  }
+
+  if (i == n)
+  {
+    sig = vtkParse_AddSignatureToTable(table, 2*n, idp);
+  }
+
+  if (idp != ids)
+  {
+    free(idp);
+  }
+
+  return sig;
+}
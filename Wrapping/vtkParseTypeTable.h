@@ -0,0 +1,98 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkParseTypeTable.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file provides a compact table of interned type descriptors.
+
+ Each distinct combination of Type and TypeName that is added to the
+ table is stored exactly once, in a struct-of-arrays layout, and is
+ identified by a small integer id.  Array dimensions are not part of
+ the type.  A signature can hold them as extra values if they matter.
+ Two types are the same if and only if their ids are the same, so code
+ that needs to compare many types (for example, when matching method
+ signatures) can compare integers instead of strings.
+
+ Lists of type ids can also be interned as signatures, so that a whole
+ parameter list can be compared with a single integer comparison.
+
+ The id zero is never used for a valid entry, it is returned when a
+ type cannot be represented in the table (e.g. function pointers).
+*/
+
+#ifndef VTK_PARSE_TYPE_TABLE_H
+#define VTK_PARSE_TYPE_TABLE_H
+
+#include "vtkParseData.h"
+
+/**
+ * The table of types, stored as parallel arrays indexed by id.
+ * Entry zero of each array is unused.
+ */
+typedef struct _TypeTable
+{
+  unsigned long   NumberOfTypes;      /* number of ids in use, plus one */
+  unsigned int   *Types;              /* the type bitfield for each id */
+  const char    **TypeNames;          /* the type name for each id */
+  unsigned long   NumberOfSignatures; /* number of signatures, plus one */
+  unsigned long **Signatures;         /* length, followed by the type ids */
+  unsigned long   TypeHashSize;       /* size of type hash, power of two */
+  unsigned long  *TypeHash;           /* open-addressed hash of type ids */
+  unsigned long   SignatureHashSize;  /* size of signature hash */
+  unsigned long  *SignatureHash;      /* open-addressed hash of signatures */
+} TypeTable;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize an empty type table.
+ */
+void vtkParse_InitTypeTable(TypeTable *table);
+
+/**
+ * Free the contents of a type table.  Strings are not freed, they are
+ * assumed to be persistent, as elsewhere in vtkParse.
+ */
+void vtkParse_FreeTypeTable(TypeTable *table);
+
+/**
+ * Add a type to the table, or find it if it is already present,
+ * and return its id.  The classname is not copied.
+ */
+unsigned long vtkParse_AddTypeToTable(
+  TypeTable *table, unsigned int type, const char *classname);
+
+/**
+ * Add a list of type ids to the table as a signature, or find it if
+ * it is already present, and return the signature id.
+ */
+unsigned long vtkParse_AddSignatureToTable(
+  TypeTable *table, unsigned long n, const unsigned long *ids);
+
+/**
+ * Get a signature id for the parameter list of a function, such that
+ * two functions have the same id if and only if the parameters match
+ * according to vtkParse_CompareFunctionSignature().  Zero is returned
+ * for templated functions, and for functions that have function pointer
+ * parameters, since these must be compared with the slower method.
+ */
+unsigned long vtkParse_AddParametersToTable(
+  TypeTable *table, const FunctionInfo *func);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
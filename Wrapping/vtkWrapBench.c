@@ -0,0 +1,670 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapBench.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ vtkWrapBench replays the wrapping of a directory tree of real headers,
+ such as an installed VTK include directory, and reports how long each
+ header took.  Both vtkWrapHierarchy and vtkWrapXML are run in-process
+ for every header, so no CMake configuration or VTK build is needed.
+
+ Usage: vtkWrapBench [options] <dir or header> ... [@<file>]
+
+ -o <dir>         the directory for the output (default vtkWrapBench.tmp)
+ --kit <name>     the kit name for the hierarchy file (default "Bench")
+ --json           print the report as JSON
+
+ The usual wrapper options (-I, -D, -U, @file, --timings, --trace) are
+ also accepted, so the response file from a VTK build can be used as-is.
+ Directories are searched recursively for ".h" files.
+
+ The hierarchy is generated first, from all of the headers, and is then
+ used while the XML is generated for each header.  The report gives the
+ distribution of the per-header times for each of these, the slowest
+ headers, the peak memory use of the process, and the size of the string
+ cache and the macro table for each header.
+*/
+
+#include "vtkParse.h"
+#include "vtkParseData.h"
+#include "vtkParseMain.h"
+#include "vtkParseMemory.h"
+#include "vtkParseTiming.h"
+#include "vtkWrapHierarchyWriter.h"
+#include "vtkWrapXMLWriter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#include <direct.h>
+#include <psapi.h>
+#define wrapbench_mkdir(d) _mkdir(d)
+#else
+#include <dirent.h>
+#include <sys/resource.h>
+#define wrapbench_mkdir(d) mkdir(d, 0777)
+#endif
+
+/* the number of headers in the "slowest" list */
+#define WRAPBENCH_SLOWEST 20
+
+/* the stages that are timed for each header */
+enum
+{
+  WRAPBENCH_HIERARCHY,
+  WRAPBENCH_XML,
+  WRAPBENCH_TOTAL,
+  WRAPBENCH_NUMBER_OF_STAGES
+};
+
+static const char *wrapbench_stage_names[WRAPBENCH_NUMBER_OF_STAGES] = {
+  "hierarchy",
+  "xml",
+  "total"
+};
+
+/* the results for one header */
+typedef struct _WrapBenchHeader
+{
+  char *FileName;
+  int Failed;
+  double Times[WRAPBENCH_NUMBER_OF_STAGES];
+  size_t StringBytes;   /* bytes held by the StringCache */
+  unsigned long Macros; /* macros in the macro table */
+} WrapBenchHeader;
+
+/* a growable list of headers */
+typedef struct _WrapBenchList
+{
+  int NumberOfHeaders;
+  WrapBenchHeader *Headers;
+} WrapBenchList;
+
+/* Print the usage */
+static void wrapbench_usage(FILE *fp)
+{
+  fprintf(fp,
+    "Usage: vtkWrapBench [options] <dir or header> ... [@<file>]\n"
+    "  -o <dir>         the directory for the output\n"
+    "  --kit <name>     the kit name for the hierarchy file\n"
+    "  --json           print the report as JSON\n"
+    "  -I <dir>         add an include directory\n"
+    "  -D <macro[=def]> add a macro definition\n"
+    "  -U <macro>       cancel a macro definition\n"
+    "  @<file>          read arguments from a file\n");
+}
+
+/* Check whether a file name ends in ".h" */
+static int wrapbench_is_header(const char *name)
+{
+  size_t l = strlen(name);
+  return (l > 2 && name[l-2] == '.' && name[l-1] == 'h');
+}
+
+/* Check whether a path is a directory */
+static int wrapbench_is_dir(const char *path)
+{
+  struct stat fs;
+  return (stat(path, &fs) == 0 && (fs.st_mode & S_IFMT) == S_IFDIR);
+}
+
+/* Add a header to the list */
+static void wrapbench_add_header(WrapBenchList *list, const char *path)
+{
+  WrapBenchHeader *header;
+  int n = list->NumberOfHeaders;
+
+  /* if count is zero or a power of two, double the size */
+  if (n == 0 || (n & (n - 1)) == 0)
+  {
+    list->Headers = (WrapBenchHeader *)realloc(
+      list->Headers, (n == 0 ? 1 : 2*n)*sizeof(WrapBenchHeader));
+  }
+
+  header = &list->Headers[list->NumberOfHeaders++];
+  memset(header, 0, sizeof(WrapBenchHeader));
+  header->FileName = (char *)malloc(strlen(path) + 1);
+  strcpy(header->FileName, path);
+}
+
+/* Search a directory recursively for headers */
+static void wrapbench_find_headers(WrapBenchList *list, const char *dir)
+{
+  char *path;
+  const char *name;
+  size_t l = strlen(dir);
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  WIN32_FIND_DATA entry;
+  HANDLE h;
+
+  path = (char *)malloc(l + 3);
+  sprintf(path, "%s/*", dir);
+  h = FindFirstFile(path, &entry);
+  free(path);
+  if (h == INVALID_HANDLE_VALUE)
+  {
+    return;
+  }
+  do
+  {
+    name = entry.cFileName;
+#else
+  DIR *d;
+  struct dirent *entry;
+
+  d = opendir(dir);
+  if (!d)
+  {
+    return;
+  }
+  while ((entry = readdir(d)) != NULL)
+  {
+    name = entry->d_name;
+#endif
+    if (name[0] == '.')
+    {
+      continue;
+    }
+    path = (char *)malloc(l + strlen(name) + 2);
+    sprintf(path, "%s/%s", dir, name);
+    if (wrapbench_is_dir(path))
+    {
+      wrapbench_find_headers(list, path);
+    }
+    else if (wrapbench_is_header(name))
+    {
+      wrapbench_add_header(list, path);
+    }
+    free(path);
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  }
+  while (FindNextFile(h, &entry));
+  FindClose(h);
+#else
+  }
+  closedir(d);
+#endif
+}
+
+/* Sort the headers by name */
+static int wrapbench_compare_names(const void *vp1, const void *vp2)
+{
+  return strcmp(((const WrapBenchHeader *)vp1)->FileName,
+                ((const WrapBenchHeader *)vp2)->FileName);
+}
+
+/* Sort the headers by decreasing total time */
+static int wrapbench_compare_times(const void *vp1, const void *vp2)
+{
+  double t1 = (*(WrapBenchHeader * const *)vp1)->Times[WRAPBENCH_TOTAL];
+  double t2 = (*(WrapBenchHeader * const *)vp2)->Times[WRAPBENCH_TOTAL];
+  return (t1 < t2 ? 1 : (t1 > t2 ? -1 : 0));
+}
+
+/* Sort strings in increasing order */
+static int wrapbench_compare_strings(const void *vp1, const void *vp2)
+{
+  return strcmp(*(const char * const *)vp1, *(const char * const *)vp2);
+}
+
+/* Sort doubles in increasing order */
+static int wrapbench_compare_doubles(const void *vp1, const void *vp2)
+{
+  double t1 = *(const double *)vp1;
+  double t2 = *(const double *)vp2;
+  return (t1 < t2 ? -1 : (t1 > t2 ? 1 : 0));
+}
+
+/* Get the name of the output file for a header */
+static char *wrapbench_output_name(
+  const char *dir, const char *filename, const char *ext)
+{
+  char *path;
+  size_t i, l;
+
+  i = strlen(filename);
+  while (i > 0 && filename[i-1] != '/' && filename[i-1] != '\\')
+  {
+    i--;
+  }
+  l = strlen(&filename[i]);
+  if (wrapbench_is_header(filename))
+  {
+    l -= 2;
+  }
+
+  path = (char *)malloc(strlen(dir) + l + strlen(ext) + 2);
+  sprintf(path, "%s/%.*s%s", dir, (int)l, &filename[i], ext);
+  return path;
+}
+
+/* Get the peak resident set size of the process, in bytes */
+static size_t wrapbench_peak_rss(void)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+  {
+    return (size_t)pmc.PeakWorkingSetSize;
+  }
+  return 0;
+#else
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) != 0)
+  {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return (size_t)ru.ru_maxrss;
+#else
+  return (size_t)ru.ru_maxrss*1024;
+#endif
+#endif
+}
+
+/* Run vtkWrapHierarchy for one header, and add its lines to "lines" */
+static char **wrapbench_hierarchy(
+  WrapBenchHeader *header, const char *kit, char **lines)
+{
+  FILE *fp;
+  FileInfo *data;
+  double t;
+
+  fp = fopen(header->FileName, "r");
+  if (!fp)
+  {
+    fprintf(stderr, "vtkWrapBench: cannot read %s\n", header->FileName);
+    header->Failed = 1;
+    return lines;
+  }
+
+  /* this follows vtkWrapHierarchy_ParseHeaderFile() */
+  t = vtkParse_WallTime();
+  vtkParse_SetIgnoreBTX(1);
+  data = vtkParse_ParseFile(header->FileName, fp, stderr);
+  if (data)
+  {
+    lines = vtkWrapHierarchy_AddFileContents(lines, data, kit, "");
+    vtkParse_Free(data);
+  }
+  else
+  {
+    header->Failed = 1;
+  }
+  header->Times[WRAPBENCH_HIERARCHY] = vtkParse_WallTime() - t;
+  fclose(fp);
+
+  return lines;
+}
+
+/* Run vtkWrapXML for one header */
+static void wrapbench_xml(WrapBenchHeader *header, const char *dir)
+{
+  FileInfo *data;
+  ParseMemoryStats stats;
+  char *outname;
+  double t;
+
+  outname = wrapbench_output_name(dir, header->FileName, ".xml");
+
+  /* parse and write the header in the same way as vtkWrapXML_Run() */
+  t = vtkParse_WallTime();
+  data = vtkParse_ParseHeaderFile(header->FileName);
+  if (!data)
+  {
+    header->Failed = 1;
+    free(outname);
+    return;
+  }
+
+  if (!vtkWrapXML_WriteFile(data, outname, VTKXML_FORMAT_XML))
+  {
+    fprintf(stderr, "vtkWrapBench: cannot write %s\n", outname);
+    header->Failed = 1;
+  }
+
+  header->Times[WRAPBENCH_XML] = vtkParse_WallTime() - t;
+  vtkParse_GetMemoryStats(data, &stats);
+  header->StringBytes = stats.StringBytes;
+  header->Macros = stats.NumberOfMacros;
+
+  free(outname);
+  vtkParse_Free(data);
+}
+
+/* Print a string as a JSON string */
+static void wrapbench_print_json_string(const char *text)
+{
+  putchar('\"');
+  for (; *text != '\0'; text++)
+  {
+    if (*text == '\"' || *text == '\\')
+    {
+      putchar('\\');
+      putchar(*text);
+    }
+    else if ((unsigned char)(*text) < 0x20)
+    {
+      printf("\\u%04x", (unsigned int)(*text));
+    }
+    else
+    {
+      putchar(*text);
+    }
+  }
+  putchar('\"');
+}
+
+/* Compute a percentile from a sorted array */
+static double wrapbench_percentile(const double *a, int n, int p)
+{
+  int i = (n*p + 99)/100 - 1;
+  return a[i < 0 ? 0 : i];
+}
+
+/* Print the report */
+static void wrapbench_report(
+  WrapBenchList *list, double *totals, size_t peak, int json)
+{
+  WrapBenchHeader **slowest;
+  double *times;
+  double sum;
+  size_t bytes = 0;
+  size_t maxbytes = 0;
+  unsigned long macros = 0;
+  unsigned long maxmacros = 0;
+  int nfailed = 0;
+  int nslow;
+  int i, j, n;
+
+  /* collect the headers that were wrapped successfully */
+  times = (double *)malloc((list->NumberOfHeaders + 1)*sizeof(double));
+  slowest = (WrapBenchHeader **)malloc(
+    (list->NumberOfHeaders + 1)*sizeof(WrapBenchHeader *));
+  n = 0;
+  for (i = 0; i < list->NumberOfHeaders; i++)
+  {
+    WrapBenchHeader *header = &list->Headers[i];
+    if (header->Failed)
+    {
+      nfailed++;
+      continue;
+    }
+    slowest[n++] = header;
+    bytes += header->StringBytes;
+    macros += header->Macros;
+    maxbytes = (header->StringBytes > maxbytes ? header->StringBytes : maxbytes);
+    maxmacros = (header->Macros > maxmacros ? header->Macros : maxmacros);
+  }
+  qsort(slowest, n, sizeof(WrapBenchHeader *), wrapbench_compare_times);
+  nslow = (n < WRAPBENCH_SLOWEST ? n : WRAPBENCH_SLOWEST);
+
+  if (json)
+  {
+    printf("{\"headers\": %d, \"failed\": %d, \"unit\": \"ms\"",
+           list->NumberOfHeaders, nfailed);
+  }
+  else
+  {
+    printf("vtkWrapBench: %d headers, %d failed\n",
+           list->NumberOfHeaders, nfailed);
+    printf("%-12s %10s %10s %10s %10s %10s %10s %10s\n", "stage (ms)",
+           "total", "mean", "min", "p50", "p90", "p99", "max");
+  }
+
+  /* the latency distribution for each stage */
+  for (j = 0; j < WRAPBENCH_NUMBER_OF_STAGES; j++)
+  {
+    sum = 0.0;
+    for (i = 0; i < n; i++)
+    {
+      times[i] = 1e3*slowest[i]->Times[j];
+      sum += times[i];
+    }
+    if (n == 0)
+    {
+      times[0] = 0.0;
+    }
+    qsort(times, n, sizeof(double), wrapbench_compare_doubles);
+    if (json)
+    {
+      printf(", \"%s\": {\"total\": %.3f, \"mean\": %.3f, \"min\": %.3f, "
+             "\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+             wrapbench_stage_names[j], 1e3*totals[j],
+             (n ? sum/n : 0.0), times[0],
+             wrapbench_percentile(times, n, 50),
+             wrapbench_percentile(times, n, 90),
+             wrapbench_percentile(times, n, 99),
+             times[(n ? n-1 : 0)]);
+    }
+    else
+    {
+      printf("%-12s %10.1f %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+             wrapbench_stage_names[j], 1e3*totals[j],
+             (n ? sum/n : 0.0), times[0],
+             wrapbench_percentile(times, n, 50),
+             wrapbench_percentile(times, n, 90),
+             wrapbench_percentile(times, n, 99),
+             times[(n ? n-1 : 0)]);
+    }
+  }
+
+  /* the memory use */
+  if (json)
+  {
+    printf(", \"peak_rss\": %lu, \"string_cache\": {\"total\": %lu, "
+           "\"mean\": %lu, \"max\": %lu}, \"macros\": {\"mean\": %lu, "
+           "\"max\": %lu}",
+           (unsigned long)peak, (unsigned long)bytes,
+           (unsigned long)(n ? bytes/n : 0), (unsigned long)maxbytes,
+           (n ? macros/n : 0), maxmacros);
+  }
+  else
+  {
+    printf("\npeak RSS             %10.1f MB\n", peak/1048576.0);
+    printf("string cache (mean)  %10.1f kB\n",
+           (n ? bytes/n : 0)/1024.0);
+    printf("string cache (max)   %10.1f kB\n", maxbytes/1024.0);
+    printf("macro table (mean)   %10lu\n", (n ? macros/n : 0));
+    printf("macro table (max)    %10lu\n", maxmacros);
+  }
+
+  /* the slowest headers */
+  if (json)
+  {
+    printf(", \"slowest\": [");
+  }
+  else
+  {
+    printf("\n%-40s %10s %10s %10s %10s %8s\n", "slowest headers (ms)",
+           "hierarchy", "xml", "total", "strings", "macros");
+  }
+  for (i = 0; i < nslow; i++)
+  {
+    WrapBenchHeader *header = slowest[i];
+    if (json)
+    {
+      printf("%s{\"file\": ", (i == 0 ? "" : ", "));
+      wrapbench_print_json_string(header->FileName);
+      printf(", \"hierarchy\": %.3f, \"xml\": %.3f, \"total\": %.3f, "
+             "\"string_cache\": %lu, \"macros\": %lu}",
+             1e3*header->Times[WRAPBENCH_HIERARCHY],
+             1e3*header->Times[WRAPBENCH_XML],
+             1e3*header->Times[WRAPBENCH_TOTAL],
+             (unsigned long)header->StringBytes, header->Macros);
+    }
+    else
+    {
+      const char *name = header->FileName;
+      size_t l = strlen(name);
+      printf("%-40s %10.3f %10.3f %10.3f %8.1f kB %8lu\n",
+             (l > 40 ? &name[l-40] : name),
+             1e3*header->Times[WRAPBENCH_HIERARCHY],
+             1e3*header->Times[WRAPBENCH_XML],
+             1e3*header->Times[WRAPBENCH_TOTAL],
+             header->StringBytes/1024.0, header->Macros);
+    }
+  }
+  if (json)
+  {
+    printf("]}\n");
+  }
+
+  free(times);
+  free(slowest);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *dir;
+  const char *kit = "Bench";
+  char *hierarchy;
+  char **lines = NULL;
+  char **args;
+  double totals[WRAPBENCH_NUMBER_OF_STAGES];
+  double t;
+  size_t j, n = 0;
+  int json = 0;
+  int nargs = 1;
+  int i;
+  OptionInfo *options;
+  WrapBenchList list;
+
+  /* remove our own options, and pass the rest to vtkParse_MainMulti */
+  args = (char **)malloc((argc + 1)*sizeof(char *));
+  args[0] = argv[0];
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--kit") == 0 && i+1 < argc)
+    {
+      kit = argv[++i];
+    }
+    else if (strcmp(argv[i], "--json") == 0)
+    {
+      json = 1;
+    }
+    else if (strcmp(argv[i], "--help") == 0)
+    {
+      wrapbench_usage(stdout);
+      return 0;
+    }
+    else
+    {
+      args[nargs++] = argv[i];
+    }
+  }
+  args[nargs] = NULL;
+
+  if (nargs == 1)
+  {
+    wrapbench_usage(stderr);
+    return 1;
+  }
+
+  vtkParse_MainMulti(nargs, args);
+  options = vtkParse_GetCommandLineOptions();
+  vtkParse_SetRecursive(0);
+
+  /* find all of the headers */
+  list.NumberOfHeaders = 0;
+  list.Headers = NULL;
+  for (i = 0; i < options->NumberOfFiles; i++)
+  {
+    if (wrapbench_is_dir(options->Files[i]))
+    {
+      wrapbench_find_headers(&list, options->Files[i]);
+    }
+    else if (wrapbench_is_header(options->Files[i]))
+    {
+      wrapbench_add_header(&list, options->Files[i]);
+    }
+  }
+  if (list.NumberOfHeaders == 0)
+  {
+    fprintf(stderr, "vtkWrapBench: no headers were found\n");
+    return 1;
+  }
+  qsort(list.Headers, list.NumberOfHeaders, sizeof(WrapBenchHeader),
+        wrapbench_compare_names);
+
+  dir = options->OutputFileName;
+  if (dir == NULL)
+  {
+    dir = "vtkWrapBench.tmp";
+  }
+  if (wrapbench_mkdir(dir) != 0 && errno != EEXIST)
+  {
+    fprintf(stderr, "vtkWrapBench: cannot create directory %s\n", dir);
+    return 1;
+  }
+
+  for (j = 0; j < WRAPBENCH_NUMBER_OF_STAGES; j++)
+  {
+    totals[j] = 0.0;
+  }
+
+  /* generate the hierarchy, one header at a time */
+  t = vtkParse_WallTime();
+  lines = (char **)malloc(sizeof(char *));
+  lines[0] = NULL;
+  for (i = 0; i < list.NumberOfHeaders; i++)
+  {
+    lines = wrapbench_hierarchy(&list.Headers[i], kit, lines);
+  }
+  while (lines[n] != NULL)
+  {
+    n++;
+  }
+  qsort(lines, n, sizeof(char *), wrapbench_compare_strings);
+  hierarchy = wrapbench_output_name(dir, kit, "Hierarchy.txt");
+  vtkWrapHierarchy_TryWriteHierarchyFile(hierarchy, lines);
+  totals[WRAPBENCH_HIERARCHY] = vtkParse_WallTime() - t;
+
+  /* generate the XML, with the hierarchy */
+  vtkParse_DefineMacro("__VTK_WRAP_XML__", 0);
+  options->HierarchyFileName = hierarchy;
+  t = vtkParse_WallTime();
+  for (i = 0; i < list.NumberOfHeaders; i++)
+  {
+    if (!list.Headers[i].Failed)
+    {
+      wrapbench_xml(&list.Headers[i], dir);
+    }
+    list.Headers[i].Times[WRAPBENCH_TOTAL] =
+      list.Headers[i].Times[WRAPBENCH_HIERARCHY] +
+      list.Headers[i].Times[WRAPBENCH_XML];
+  }
+  totals[WRAPBENCH_XML] = vtkParse_WallTime() - t;
+  totals[WRAPBENCH_TOTAL] =
+    totals[WRAPBENCH_HIERARCHY] + totals[WRAPBENCH_XML];
+
+  wrapbench_report(&list, totals, wrapbench_peak_rss(), json);
+
+  for (j = 0; j < n; j++)
+  {
+    free(lines[j]);
+  }
+  free(lines);
+  for (i = 0; i < list.NumberOfHeaders; i++)
+  {
+    free(list.Headers[i].FileName);
+  }
+  free(list.Headers);
+  free(hierarchy);
+  free(args);
+
+  return 0;
+}
@@ -0,0 +1,734 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapBinary.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ The vtkWrapBinary program will read VTK header files and write the
+ same information as vtkWrapXML, but in the binary format that is
+ described in vtkWrapBinary.h.  The records are written depth-first,
+ so that the offsets of the children are known when each parent is
+ written, and the strings are gathered into a table as they are seen.
+ As with vtkWrapXML, the output file is only replaced if it changed.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vtkParse.h"
+#include "vtkParseProperties.h"
+#include "vtkParseMerge.h"
+#include "vtkParseMain.h"
+#include "vtkParseTiming.h"
+#include "vtkWrapBinary.h"
+#include "vtkWrapXMLWriter.h"
+
+/* ----- Binary state information ----- */
+
+typedef struct _wrapbinary_state
+{
+  FileInfo *data;        /* the data that was parsed */
+  NamespaceInfo *scope;  /* the namespace that is being written */
+  unsigned char *buffer; /* the header and the records */
+  size_t length;         /* the bytes used in the buffer */
+  size_t size;           /* the allocated size of the buffer */
+  char *strings;         /* the string table */
+  size_t stringsLength;  /* the bytes used in the string table */
+  size_t stringsSize;    /* the allocated size of the string table */
+  binary_u32_t *hash;    /* hash table of string references */
+  size_t hashSize;       /* the number of slots, a power of two */
+  size_t hashCount;      /* the number of slots that are used */
+  binary_u32_t mainClass; /* offset of the main class */
+} wrapbinary_state_t;
+
+/* ----- Output primitives ----- */
+
+/**
+ * Make room for "n" more bytes in a growable buffer
+ */
+static void *vtkWrapBinary_Grow(
+  void *buffer, size_t length, size_t n, size_t *size)
+{
+  if (length + n > *size)
+  {
+    while (length + n > *size)
+    {
+      *size *= 2;
+    }
+    buffer = realloc(buffer, *size);
+  }
+  return buffer;
+}
+
+/**
+ * Append a record, all fields are converted to little-endian.
+ * Returns the offset of the record.
+ */
+static binary_u32_t vtkWrapBinary_AddRecord(
+  wrapbinary_state_t *w, const binary_u32_t *fields, size_t n)
+{
+  size_t offset = w->length;
+  unsigned char *cp;
+  size_t i;
+
+  w->buffer = (unsigned char *)vtkWrapBinary_Grow(
+    w->buffer, w->length, 4*n, &w->size);
+  cp = &w->buffer[offset];
+  for (i = 0; i < n; i++)
+  {
+    cp[0] = (unsigned char)(fields[i] & 0xff);
+    cp[1] = (unsigned char)((fields[i] >> 8) & 0xff);
+    cp[2] = (unsigned char)((fields[i] >> 16) & 0xff);
+    cp[3] = (unsigned char)((fields[i] >> 24) & 0xff);
+    cp += 4;
+  }
+  w->length += 4*n;
+
+  return (binary_u32_t)offset;
+}
+
+/* append a struct of binary_u32_t as a record */
+#define vtkWrapBinary_AddStruct(w, s) \
+  vtkWrapBinary_AddRecord((w), (const binary_u32_t *)(s), \
+                       sizeof(*(s))/sizeof(binary_u32_t))
+
+/**
+ * Append an array of offsets, returns zero for an empty array
+ */
+static binary_u32_t vtkWrapBinary_AddArray(
+  wrapbinary_state_t *w, const binary_u32_t *offsets, unsigned long n)
+{
+  if (n == 0)
+  {
+    return 0;
+  }
+  return vtkWrapBinary_AddRecord(w, offsets, n);
+}
+
+/**
+ * Hash a string, for the string table
+ */
+static size_t vtkWrapBinary_Hash(const char *text)
+{
+  size_t h = 5381;
+
+  while (*text)
+  {
+    h = (h << 5) + h + (unsigned char)*text++;
+  }
+
+  return h;
+}
+
+/**
+ * Add a string slot to the hash table
+ */
+static void vtkWrapBinary_HashInsert(wrapbinary_state_t *w, binary_u32_t ref)
+{
+  size_t mask = w->hashSize - 1;
+  size_t h = vtkWrapBinary_Hash(&w->strings[ref]) & mask;
+
+  while (w->hash[h] != 0)
+  {
+    h = (h + 1) & mask;
+  }
+  w->hash[h] = ref;
+}
+
+/**
+ * Get the reference for a string, adding it to the table if needed.
+ * Each string is stored only once.
+ */
+static binary_u32_t vtkWrapBinary_AddString(
+  wrapbinary_state_t *w, const char *text)
+{
+  binary_u32_t *oldhash;
+  size_t oldsize;
+  size_t mask, h, i, l;
+  binary_u32_t ref;
+
+  if (text == NULL)
+  {
+    return 0;
+  }
+
+  /* look for the string */
+  mask = w->hashSize - 1;
+  h = vtkWrapBinary_Hash(text) & mask;
+  while ((ref = w->hash[h]) != 0)
+  {
+    if (strcmp(&w->strings[ref], text) == 0)
+    {
+      return ref;
+    }
+    h = (h + 1) & mask;
+  }
+
+  /* add the string */
+  l = strlen(text) + 1;
+  w->strings = (char *)vtkWrapBinary_Grow(
+    w->strings, w->stringsLength, l, &w->stringsSize);
+  ref = (binary_u32_t)w->stringsLength;
+  memcpy(&w->strings[ref], text, l);
+  w->stringsLength += l;
+  w->hash[h] = ref;
+
+  /* keep the hash table at most half full */
+  if (++w->hashCount > w->hashSize/2)
+  {
+    oldhash = w->hash;
+    oldsize = w->hashSize;
+    w->hashSize *= 2;
+    w->hash = (binary_u32_t *)calloc(w->hashSize, sizeof(binary_u32_t));
+    for (i = 0; i < oldsize; i++)
+    {
+      if (oldhash[i])
+      {
+        vtkWrapBinary_HashInsert(w, oldhash[i]);
+      }
+    }
+    free(oldhash);
+  }
+
+  return ref;
+}
+
+/**
+ * Append an array of strings, returns zero for an empty array
+ */
+static binary_u32_t vtkWrapBinary_AddStrings(
+  wrapbinary_state_t *w, const char **strings, unsigned long n)
+{
+  binary_u32_t *refs;
+  binary_u32_t offset;
+  unsigned long i;
+
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  refs = (binary_u32_t *)malloc(n*sizeof(binary_u32_t));
+  for (i = 0; i < n; i++)
+  {
+    refs[i] = vtkWrapBinary_AddString(w, strings[i]);
+  }
+  offset = vtkWrapBinary_AddRecord(w, refs, n);
+  free(refs);
+
+  return offset;
+}
+
+/**
+ * Initialize the state, and reserve space for the header
+ */
+void vtkWrapBinary_InitState(wrapbinary_state_t *w, FileInfo *data)
+{
+  BinaryFileHeader header;
+
+  w->data = data;
+  w->scope = data->Contents;
+  w->size = 65536;
+  w->buffer = (unsigned char *)malloc(w->size);
+  w->length = 0;
+  w->stringsSize = 65536;
+  w->strings = (char *)malloc(w->stringsSize);
+  w->hashSize = 1024;
+  w->hash = (binary_u32_t *)calloc(w->hashSize, sizeof(binary_u32_t));
+  w->hashCount = 0;
+  w->mainClass = 0;
+
+  /* the reference zero is for NULL, so the table starts with a nul */
+  w->strings[0] = '\0';
+  w->stringsLength = 1;
+
+  memset(&header, 0, sizeof(header));
+  vtkWrapBinary_AddStruct(w, &header);
+}
+
+/**
+ * Free the state
+ */
+void vtkWrapBinary_FinishState(wrapbinary_state_t *w)
+{
+  free(w->buffer);
+  free(w->strings);
+  free(w->hash);
+  w->buffer = NULL;
+  w->strings = NULL;
+  w->hash = NULL;
+}
+
+/* ----- Records ----- */
+
+/* needed for function pointers, and for template parameters */
+static binary_u32_t vtkWrapBinary_Function(
+  wrapbinary_state_t *w, FunctionInfo *func);
+static binary_u32_t vtkWrapBinary_Value(wrapbinary_state_t *w, ValueInfo *val);
+
+/**
+ * Write template parameters, and return their offset
+ */
+static binary_u32_t vtkWrapBinary_Template(
+  wrapbinary_state_t *w, TemplateInfo *args)
+{
+  BinaryTemplate rec;
+  binary_u32_t *offsets;
+  unsigned long i, n;
+
+  if (args == NULL)
+  {
+    return 0;
+  }
+
+  n = args->NumberOfParameters;
+  offsets = (binary_u32_t *)malloc((n + 1)*sizeof(binary_u32_t));
+  for (i = 0; i < n; i++)
+  {
+    offsets[i] = vtkWrapBinary_Value(w, args->Parameters[i]);
+  }
+
+  rec.NumberOfParameters = n;
+  rec.Parameters = vtkWrapBinary_AddArray(w, offsets, n);
+  free(offsets);
+
+  return vtkWrapBinary_AddStruct(w, &rec);
+}
+
+/**
+ * Write a value, and return its offset
+ */
+static binary_u32_t vtkWrapBinary_Value(wrapbinary_state_t *w, ValueInfo *val)
+{
+  BinaryValue rec;
+
+  if (val == NULL)
+  {
+    return 0;
+  }
+
+  rec.ItemType = val->ItemType;
+  rec.Access = val->Access;
+  rec.Name = vtkWrapBinary_AddString(w, val->Name);
+  rec.Comment = vtkWrapBinary_AddString(w, val->Comment);
+  rec.Value = vtkWrapBinary_AddString(w, val->Value);
+  rec.Type = val->Type;
+  rec.TypeName = vtkWrapBinary_AddString(w, val->TypeName);
+  rec.Count = (binary_u32_t)val->Count;
+  rec.CountHint = vtkWrapBinary_AddString(w, val->CountHint);
+  rec.NumberOfDimensions = val->NumberOfDimensions;
+  rec.Dimensions = vtkWrapBinary_AddStrings(
+    w, val->Dimensions, val->NumberOfDimensions);
+  rec.Function = 0;
+  if (val->Function)
+  {
+    rec.Function = vtkWrapBinary_Function(w, val->Function);
+  }
+  rec.Template = vtkWrapBinary_Template(w, val->Template);
+  rec.Flags = ((val->IsStatic ? VTK_BINARY_VALUE_STATIC : 0) |
+               (val->IsEnum ? VTK_BINARY_VALUE_ENUM : 0) |
+               (val->IsPack ? VTK_BINARY_VALUE_PACK : 0));
+
+  return vtkWrapBinary_AddStruct(w, &rec);
+}
+
+/**
+ * Write a function, and return its offset
+ */
+static binary_u32_t vtkWrapBinary_Function(
+  wrapbinary_state_t *w, FunctionInfo *func)
+{
+  BinaryFunction rec;
+  binary_u32_t *offsets;
+  unsigned long i, n;
+
+  rec.ItemType = func->ItemType;
+  rec.Access = func->Access;
+  rec.Name = vtkWrapBinary_AddString(w, func->Name);
+  rec.Comment = vtkWrapBinary_AddString(w, func->Comment);
+  rec.Class = vtkWrapBinary_AddString(w, func->Class);
+  rec.Signature = vtkWrapBinary_AddString(w, func->Signature);
+  rec.Template = vtkWrapBinary_Template(w, func->Template);
+
+  n = func->NumberOfParameters;
+  offsets = (binary_u32_t *)malloc((n + 1)*sizeof(binary_u32_t));
+  for (i = 0; i < n; i++)
+  {
+    offsets[i] = vtkWrapBinary_Value(w, func->Parameters[i]);
+  }
+  rec.NumberOfParameters = n;
+  rec.Parameters = vtkWrapBinary_AddArray(w, offsets, n);
+  free(offsets);
+
+  rec.ReturnValue = vtkWrapBinary_Value(w, func->ReturnValue);
+  rec.NumberOfPreconds = func->NumberOfPreconds;
+  rec.Preconds = vtkWrapBinary_AddStrings(
+    w, func->Preconds, func->NumberOfPreconds);
+  rec.Macro = vtkWrapBinary_AddString(w, func->Macro);
+  rec.SizeHint = vtkWrapBinary_AddString(w, func->SizeHint);
+  rec.Flags = ((func->IsOperator ? VTK_BINARY_FUNCTION_OPERATOR : 0) |
+               (func->IsVariadic ? VTK_BINARY_FUNCTION_VARIADIC : 0) |
+               (func->IsLegacy ? VTK_BINARY_FUNCTION_LEGACY : 0) |
+               (func->IsStatic ? VTK_BINARY_FUNCTION_STATIC : 0) |
+               (func->IsVirtual ? VTK_BINARY_FUNCTION_VIRTUAL : 0) |
+               (func->IsPureVirtual ? VTK_BINARY_FUNCTION_PURE_VIRTUAL : 0) |
+               (func->IsConst ? VTK_BINARY_FUNCTION_CONST : 0) |
+               (func->IsDeleted ? VTK_BINARY_FUNCTION_DELETED : 0) |
+               (func->IsFinal ? VTK_BINARY_FUNCTION_FINAL : 0) |
+               (func->IsExplicit ? VTK_BINARY_FUNCTION_EXPLICIT : 0));
+
+  return vtkWrapBinary_AddStruct(w, &rec);
+}
+
+/**
+ * Write a using declaration, and return its offset
+ */
+static binary_u32_t vtkWrapBinary_Using(wrapbinary_state_t *w, UsingInfo *item)
+{
+  BinaryUsing rec;
+
+  rec.ItemType = item->ItemType;
+  rec.Access = item->Access;
+  rec.Name = vtkWrapBinary_AddString(w, item->Name);
+  rec.Comment = vtkWrapBinary_AddString(w, item->Comment);
+  rec.Scope = vtkWrapBinary_AddString(w, item->Scope);
+
+  return vtkWrapBinary_AddStruct(w, &rec);
+}
+
+/**
+ * Write a comment, and return its offset
+ */
+static binary_u32_t vtkWrapBinary_Comment(
+  wrapbinary_state_t *w, CommentInfo *item)
+{
+  BinaryComment rec;
+
+  rec.Type = item->Type;
+  rec.Comment = vtkWrapBinary_AddString(w, item->Comment);
+  rec.Name = vtkWrapBinary_AddString(w, item->Name);
+
+  return vtkWrapBinary_AddStruct(w, &rec);
+}
+
+/**
+ * Write a property, and return its offset
+ */
+static binary_u32_t vtkWrapBinary_Property(
+  wrapbinary_state_t *w, PropertyInfo *property)
+{
+  BinaryProperty rec;
+  unsigned long n = 0;
+
+  /* the enum constant names are a NULL-terminated list */
+  if (property->EnumConstantNames)
+  {
+    while (property->EnumConstantNames[n])
+    {
+      n++;
+    }
+  }
+
+  rec.Name = vtkWrapBinary_AddString(w, property->Name);
+  rec.Type = property->Type;
+  rec.Count = (binary_u32_t)property->Count;
+  rec.ClassName = vtkWrapBinary_AddString(w, property->ClassName);
+  rec.NumberOfEnumConstantNames = n;
+  rec.EnumConstantNames = vtkWrapBinary_AddStrings(
+    w, property->EnumConstantNames, n);
+  rec.PublicMethods = property->PublicMethods;
+  rec.ProtectedMethods = property->ProtectedMethods;
+  rec.PrivateMethods = property->PrivateMethods;
+  rec.LegacyMethods = property->LegacyMethods;
+  rec.Comment = vtkWrapBinary_AddString(w, property->Comment);
+  rec.IsStatic = property->IsStatic;
+
+  return vtkWrapBinary_AddStruct(w, &rec);
+}
+
+/* the kinds of arrays in a class */
+typedef binary_u32_t (*wrapbinary_value_func)(wrapbinary_state_t *, void *);
+
+/**
+ * Write an array of records with the given function
+ */
+static binary_u32_t vtkWrapBinary_AddRecords(
+  wrapbinary_state_t *w, void **items, unsigned long n,
+  wrapbinary_value_func func)
+{
+  binary_u32_t *offsets;
+  binary_u32_t offset;
+  unsigned long i;
+
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  offsets = (binary_u32_t *)malloc(n*sizeof(binary_u32_t));
+  for (i = 0; i < n; i++)
+  {
+    offsets[i] = func(w, items[i]);
+  }
+  offset = vtkWrapBinary_AddArray(w, offsets, n);
+  free(offsets);
+
+  return offset;
+}
+
+/* the record functions, with the signature needed for arrays */
+static binary_u32_t vtkWrapBinary_Class(wrapbinary_state_t *w, void *item);
+
+static binary_u32_t vtkWrapBinary_AnyFunction(
+  wrapbinary_state_t *w, void *item)
+{
+  return vtkWrapBinary_Function(w, (FunctionInfo *)item);
+}
+
+static binary_u32_t vtkWrapBinary_AnyValue(wrapbinary_state_t *w, void *item)
+{
+  return vtkWrapBinary_Value(w, (ValueInfo *)item);
+}
+
+static binary_u32_t vtkWrapBinary_AnyUsing(wrapbinary_state_t *w, void *item)
+{
+  return vtkWrapBinary_Using(w, (UsingInfo *)item);
+}
+
+static binary_u32_t vtkWrapBinary_AnyComment(
+  wrapbinary_state_t *w, void *item)
+{
+  return vtkWrapBinary_Comment(w, (CommentInfo *)item);
+}
+
+static binary_u32_t vtkWrapBinary_AnyProperty(
+  wrapbinary_state_t *w, void *item)
+{
+  return vtkWrapBinary_Property(w, (PropertyInfo *)item);
+}
+
+/**
+ * Write a class, namespace, or enum, and return its offset.  For
+ * classes, the using declarations are applied and the properties are
+ * found, just as they are for vtkWrapXML.
+ */
+static binary_u32_t vtkWrapBinary_Class(wrapbinary_state_t *w, void *item)
+{
+  ClassInfo *classInfo = (ClassInfo *)item;
+  ClassProperties *properties = NULL;
+  NamespaceInfo *scope = w->scope;
+  BinaryClass rec;
+  binary_u32_t *values;
+  binary_u32_t offset;
+  unsigned long i, n;
+  int isClass;
+
+  isClass = (classInfo->ItemType == VTK_CLASS_INFO ||
+             classInfo->ItemType == VTK_STRUCT_INFO ||
+             classInfo->ItemType == VTK_UNION_INFO);
+
+  if (isClass)
+  {
+    if (classInfo->NumberOfSuperClasses)
+    {
+      vtkParseMerge_ApplyUsingDeclarations(w->data, scope, classInfo);
+    }
+    properties = vtkParseProperties_Create(classInfo);
+  }
+  else if (classInfo->ItemType == VTK_NAMESPACE_INFO)
+  {
+    w->scope = classInfo;
+  }
+
+  rec.ItemType = classInfo->ItemType;
+  rec.Access = classInfo->Access;
+  rec.Name = vtkWrapBinary_AddString(w, classInfo->Name);
+  rec.Comment = vtkWrapBinary_AddString(w, classInfo->Comment);
+  rec.Template = vtkWrapBinary_Template(w, classInfo->Template);
+  rec.NumberOfSuperClasses = classInfo->NumberOfSuperClasses;
+  rec.SuperClasses = vtkWrapBinary_AddStrings(
+    w, classInfo->SuperClasses, classInfo->NumberOfSuperClasses);
+
+  /* the items are pairs of values */
+  n = classInfo->NumberOfItems;
+  rec.NumberOfItems = n;
+  rec.Items = 0;
+  if (n > 0)
+  {
+    values = (binary_u32_t *)malloc(2*n*sizeof(binary_u32_t));
+    for (i = 0; i < n; i++)
+    {
+      values[2*i] = classInfo->Items[i].Type;
+      values[2*i + 1] = classInfo->Items[i].Index;
+    }
+    rec.Items = vtkWrapBinary_AddRecord(w, values, 2*n);
+    free(values);
+  }
+
+  rec.NumberOfClasses = classInfo->NumberOfClasses;
+  rec.Classes = vtkWrapBinary_AddRecords(w, (void **)classInfo->Classes,
+    classInfo->NumberOfClasses, vtkWrapBinary_Class);
+  rec.NumberOfFunctions = classInfo->NumberOfFunctions;
+  rec.Functions = vtkWrapBinary_AddRecords(w, (void **)classInfo->Functions,
+    classInfo->NumberOfFunctions, vtkWrapBinary_AnyFunction);
+  rec.NumberOfConstants = classInfo->NumberOfConstants;
+  rec.Constants = vtkWrapBinary_AddRecords(w, (void **)classInfo->Constants,
+    classInfo->NumberOfConstants, vtkWrapBinary_AnyValue);
+  rec.NumberOfVariables = classInfo->NumberOfVariables;
+  rec.Variables = vtkWrapBinary_AddRecords(w, (void **)classInfo->Variables,
+    classInfo->NumberOfVariables, vtkWrapBinary_AnyValue);
+  rec.NumberOfEnums = classInfo->NumberOfEnums;
+  rec.Enums = vtkWrapBinary_AddRecords(w, (void **)classInfo->Enums,
+    classInfo->NumberOfEnums, vtkWrapBinary_Class);
+  rec.NumberOfTypedefs = classInfo->NumberOfTypedefs;
+  rec.Typedefs = vtkWrapBinary_AddRecords(w, (void **)classInfo->Typedefs,
+    classInfo->NumberOfTypedefs, vtkWrapBinary_AnyValue);
+  rec.NumberOfUsings = classInfo->NumberOfUsings;
+  rec.Usings = vtkWrapBinary_AddRecords(w, (void **)classInfo->Usings,
+    classInfo->NumberOfUsings, vtkWrapBinary_AnyUsing);
+  rec.NumberOfNamespaces = classInfo->NumberOfNamespaces;
+  rec.Namespaces = vtkWrapBinary_AddRecords(w, (void **)classInfo->Namespaces,
+    classInfo->NumberOfNamespaces, vtkWrapBinary_Class);
+  rec.NumberOfComments = classInfo->NumberOfComments;
+  rec.Comments = vtkWrapBinary_AddRecords(w, (void **)classInfo->Comments,
+    classInfo->NumberOfComments, vtkWrapBinary_AnyComment);
+
+  rec.Flags = ((classInfo->IsAbstract ? VTK_BINARY_CLASS_ABSTRACT : 0) |
+               (classInfo->IsFinal ? VTK_BINARY_CLASS_FINAL : 0) |
+               (classInfo->HasDelete ? VTK_BINARY_CLASS_HAS_DELETE : 0));
+
+  /* the properties, and the property for each method */
+  rec.NumberOfProperties = 0;
+  rec.Properties = 0;
+  rec.MethodTypes = 0;
+  rec.MethodProperties = 0;
+  if (properties)
+  {
+    rec.NumberOfProperties = properties->NumberOfProperties;
+    rec.Properties = vtkWrapBinary_AddRecords(w, (void **)properties->Properties,
+      properties->NumberOfProperties, vtkWrapBinary_AnyProperty);
+
+    n = properties->NumberOfMethods;
+    if (n > 0)
+    {
+      values = (binary_u32_t *)malloc(n*sizeof(binary_u32_t));
+      for (i = 0; i < n; i++)
+      {
+        values[i] = properties->MethodTypes[i];
+      }
+      rec.MethodTypes = vtkWrapBinary_AddRecord(w, values, n);
+      for (i = 0; i < n; i++)
+      {
+        values[i] = (properties->MethodHasProperty[i] ?
+          (binary_u32_t)properties->MethodProperties[i] :
+          VTK_BINARY_NO_PROPERTY);
+      }
+      rec.MethodProperties = vtkWrapBinary_AddRecord(w, values, n);
+      free(values);
+    }
+
+    vtkParseProperties_Free(properties);
+  }
+
+  offset = vtkWrapBinary_AddStruct(w, &rec);
+  w->scope = scope;
+
+  if (classInfo == w->data->MainClass)
+  {
+    w->mainClass = offset;
+  }
+
+  return offset;
+}
+
+/**
+ * Write the file info, the string table, and the header
+ */
+void vtkWrapBinary_File(wrapbinary_state_t *w, FileInfo *data)
+{
+  BinaryFileHeader header;
+  size_t n;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, VTK_BINARY_MAGIC, 8);
+  header.Version = VTK_BINARY_VERSION;
+
+  header.FileName = vtkWrapBinary_AddString(w, data->FileName);
+  header.NameComment = vtkWrapBinary_AddString(w, data->NameComment);
+  header.Description = vtkWrapBinary_AddString(w, data->Description);
+  header.Caveats = vtkWrapBinary_AddString(w, data->Caveats);
+  header.SeeAlso = vtkWrapBinary_AddString(w, data->SeeAlso);
+  if (data->Contents)
+  {
+    header.Contents = vtkWrapBinary_Class(w, data->Contents);
+  }
+  header.MainClass = w->mainClass;
+
+  /* append the string table */
+  header.Strings = (binary_u32_t)w->length;
+  header.StringsSize = (binary_u32_t)w->stringsLength;
+  w->buffer = (unsigned char *)vtkWrapBinary_Grow(
+    w->buffer, w->length, w->stringsLength, &w->size);
+  memcpy(&w->buffer[w->length], w->strings, w->stringsLength);
+  w->length += w->stringsLength;
+  header.Size = (binary_u32_t)w->length;
+
+  /* write the header over the space that was reserved for it */
+  n = w->length;
+  memcpy(w->buffer, header.Magic, 8);
+  w->length = 8;
+  vtkWrapBinary_AddRecord(w, &header.Version,
+                       (sizeof(header) - 8)/sizeof(binary_u32_t));
+  w->length = n;
+}
+
+int main(int argc, char *argv[])
+{
+  FileInfo *data;
+  OptionInfo *options;
+  wrapbinary_state_t ws;
+
+  /* recurse through included headers (off for now) */
+  vtkParse_SetRecursive(0);
+
+  /* pre-define a macro to identify the language */
+  vtkParse_DefineMacro("__VTK_WRAP_BINARY__", 0);
+
+  /* handle args, parse header, get output file handle */
+  data = vtkParse_Main(argc, argv);
+
+  /* get the command-line options */
+  options = vtkParse_GetCommandLineOptions();
+
+  /* the records are kept in memory until they are complete */
+  vtkParse_StartPhase(VTK_PARSE_PHASE_OUTPUT);
+  vtkParse_BeginSpan("output", options->OutputFileName);
+
+  vtkWrapBinary_InitState(&ws, data);
+  vtkWrapBinary_File(&ws, data);
+
+  /* write the file, if it has changed */
+  if (!vtkWrapXML_WriteFileIfChanged(
+         options->OutputFileName, (const char *)ws.buffer, ws.length, 1))
+  {
+    fprintf(stderr, "Error writing output file %s\n", options->OutputFileName);
+    exit(1);
+  }
+
+  vtkWrapBinary_FinishState(&ws);
+  vtkParse_EndSpan("output");
+  vtkParse_StopPhase(VTK_PARSE_PHASE_OUTPUT);
+
+  vtkParse_Free(data);
+
+  return 0;
+}
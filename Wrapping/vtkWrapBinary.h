@@ -0,0 +1,296 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapBinary.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file describes the binary files that are written by vtkWrapBinary.
+
+ The binary file holds the same information as the FileInfo from the
+ parser, plus the ClassProperties for each class.  It is meant to be
+ mapped into memory and used as-is, so this header is all that is
+ needed to read it.  There is no code to link against.
+
+ Every record in the file is a struct of 32-bit little-endian unsigned
+ integers, aligned to four bytes.  A record refers to another record
+ by its offset from the start of the file, where zero means NULL.  An
+ array is stored as a count and an offset, the offset points to a list
+ of record offsets (or of string references, for arrays of strings).
+
+ All strings are stored once in the string table at the end of the
+ file.  A string is referred to by its offset from the start of the
+ string table, where zero means NULL.  The strings are nul-terminated.
+
+ On a big-endian machine, the integers must be byte-swapped before
+ use, and vtkWrapBinary_IsValid() will return zero.
+
+ The layout of the file is:
+
+ BinaryFileHeader: the magic number, the version, and the file info
+ records:          all the records, children before their parents
+ strings:          the string table
+
+ Each version of this file adds fields only at the end of the records,
+ and changes the version number if the layout changes in any other way.
+*/
+
+#ifndef VTK_WRAP_BINARY_H
+#define VTK_WRAP_BINARY_H
+
+#include <stddef.h>
+
+/**
+ * The magic number and the version
+ */
+#define VTK_BINARY_MAGIC "VTKWRAPB"
+#define VTK_BINARY_VERSION 1
+
+/**
+ * An unsigned 32-bit integer
+ */
+typedef unsigned int binary_u32_t;
+
+/**
+ * Flags for values
+ */
+#define VTK_BINARY_VALUE_STATIC 0x0001
+#define VTK_BINARY_VALUE_ENUM   0x0002
+#define VTK_BINARY_VALUE_PACK   0x0004
+
+/**
+ * Flags for functions
+ */
+#define VTK_BINARY_FUNCTION_OPERATOR     0x0001
+#define VTK_BINARY_FUNCTION_VARIADIC     0x0002
+#define VTK_BINARY_FUNCTION_LEGACY       0x0004
+#define VTK_BINARY_FUNCTION_STATIC       0x0008
+#define VTK_BINARY_FUNCTION_VIRTUAL      0x0010
+#define VTK_BINARY_FUNCTION_PURE_VIRTUAL 0x0020
+#define VTK_BINARY_FUNCTION_CONST        0x0040
+#define VTK_BINARY_FUNCTION_DELETED      0x0080
+#define VTK_BINARY_FUNCTION_FINAL        0x0100
+#define VTK_BINARY_FUNCTION_EXPLICIT     0x0200
+
+/**
+ * Flags for classes
+ */
+#define VTK_BINARY_CLASS_ABSTRACT   0x0001
+#define VTK_BINARY_CLASS_FINAL      0x0002
+#define VTK_BINARY_CLASS_HAS_DELETE 0x0004
+
+/**
+ * The MethodProperties value for methods that have no property
+ */
+#define VTK_BINARY_NO_PROPERTY 0xffffffffu
+
+/**
+ * The file header, and the FileInfo
+ */
+typedef struct _BinaryFileHeader
+{
+  char          Magic[8];     /* "VTKWRAPB" */
+  binary_u32_t  Version;      /* VTK_BINARY_VERSION */
+  binary_u32_t  Size;         /* the size of the file */
+  binary_u32_t  Strings;      /* offset of the string table */
+  binary_u32_t  StringsSize;  /* the size of the string table */
+  binary_u32_t  FileName;     /* string */
+  binary_u32_t  NameComment;  /* string */
+  binary_u32_t  Description;  /* string */
+  binary_u32_t  Caveats;      /* string */
+  binary_u32_t  SeeAlso;      /* string */
+  binary_u32_t  MainClass;    /* BinaryClass, or zero */
+  binary_u32_t  Contents;     /* BinaryClass for the file namespace */
+} BinaryFileHeader;
+
+/**
+ * An item in a class or namespace, in declaration order.  The Type is
+ * a parse_item_t, and the Index is for the array of that type.
+ */
+typedef struct _BinaryItem
+{
+  binary_u32_t  Type;
+  binary_u32_t  Index;
+} BinaryItem;
+
+/**
+ * A comment, the Type is a parse_dox_t
+ */
+typedef struct _BinaryComment
+{
+  binary_u32_t  Type;
+  binary_u32_t  Comment;      /* string */
+  binary_u32_t  Name;         /* string */
+} BinaryComment;
+
+/**
+ * Template parameters
+ */
+typedef struct _BinaryTemplate
+{
+  binary_u32_t  NumberOfParameters;
+  binary_u32_t  Parameters;   /* array of BinaryValue */
+} BinaryTemplate;
+
+/**
+ * A typedef, constant, variable, parameter, or return value
+ */
+typedef struct _BinaryValue
+{
+  binary_u32_t  ItemType;     /* parse_item_t */
+  binary_u32_t  Access;       /* parse_access_t */
+  binary_u32_t  Name;         /* string */
+  binary_u32_t  Comment;      /* string */
+  binary_u32_t  Value;        /* string */
+  binary_u32_t  Type;         /* as defined in vtkParseType.h */
+  binary_u32_t  TypeName;     /* string */
+  binary_u32_t  Count;
+  binary_u32_t  CountHint;    /* string */
+  binary_u32_t  NumberOfDimensions;
+  binary_u32_t  Dimensions;   /* array of strings */
+  binary_u32_t  Function;     /* BinaryFunction, for function pointers */
+  binary_u32_t  Template;     /* BinaryTemplate, or zero */
+  binary_u32_t  Flags;        /* VTK_BINARY_VALUE flags */
+} BinaryValue;
+
+/**
+ * A function or method
+ */
+typedef struct _BinaryFunction
+{
+  binary_u32_t  ItemType;     /* parse_item_t */
+  binary_u32_t  Access;       /* parse_access_t */
+  binary_u32_t  Name;         /* string */
+  binary_u32_t  Comment;      /* string */
+  binary_u32_t  Class;        /* string */
+  binary_u32_t  Signature;    /* string */
+  binary_u32_t  Template;     /* BinaryTemplate, or zero */
+  binary_u32_t  NumberOfParameters;
+  binary_u32_t  Parameters;   /* array of BinaryValue */
+  binary_u32_t  ReturnValue;  /* BinaryValue, or zero */
+  binary_u32_t  NumberOfPreconds;
+  binary_u32_t  Preconds;     /* array of strings */
+  binary_u32_t  Macro;        /* string */
+  binary_u32_t  SizeHint;     /* string */
+  binary_u32_t  Flags;        /* VTK_BINARY_FUNCTION flags */
+} BinaryFunction;
+
+/**
+ * A using declaration or directive
+ */
+typedef struct _BinaryUsing
+{
+  binary_u32_t  ItemType;     /* parse_item_t */
+  binary_u32_t  Access;       /* parse_access_t */
+  binary_u32_t  Name;         /* string */
+  binary_u32_t  Comment;      /* string */
+  binary_u32_t  Scope;        /* string */
+} BinaryUsing;
+
+/**
+ * A property, as found by vtkParseProperties
+ */
+typedef struct _BinaryProperty
+{
+  binary_u32_t  Name;         /* string */
+  binary_u32_t  Type;         /* as defined in vtkParseType.h */
+  binary_u32_t  Count;
+  binary_u32_t  ClassName;    /* string */
+  binary_u32_t  NumberOfEnumConstantNames;
+  binary_u32_t  EnumConstantNames; /* array of strings */
+  binary_u32_t  PublicMethods;     /* VTK_METHOD bitfields */
+  binary_u32_t  ProtectedMethods;
+  binary_u32_t  PrivateMethods;
+  binary_u32_t  LegacyMethods;
+  binary_u32_t  Comment;      /* string */
+  binary_u32_t  IsStatic;
+} BinaryProperty;
+
+/**
+ * A class, struct, union, namespace, or enum.  The properties are
+ * only present for classes, structs, and unions.  MethodTypes and
+ * MethodProperties have one value per function, they give the
+ * VTK_METHOD type of the function and the index of its property.
+ */
+typedef struct _BinaryClass
+{
+  binary_u32_t  ItemType;     /* parse_item_t */
+  binary_u32_t  Access;       /* parse_access_t */
+  binary_u32_t  Name;         /* string */
+  binary_u32_t  Comment;      /* string */
+  binary_u32_t  Template;     /* BinaryTemplate, or zero */
+  binary_u32_t  NumberOfSuperClasses;
+  binary_u32_t  SuperClasses; /* array of strings */
+  binary_u32_t  NumberOfItems;
+  binary_u32_t  Items;        /* BinaryItem[NumberOfItems] */
+  binary_u32_t  NumberOfClasses;
+  binary_u32_t  Classes;      /* array of BinaryClass */
+  binary_u32_t  NumberOfFunctions;
+  binary_u32_t  Functions;    /* array of BinaryFunction */
+  binary_u32_t  NumberOfConstants;
+  binary_u32_t  Constants;    /* array of BinaryValue */
+  binary_u32_t  NumberOfVariables;
+  binary_u32_t  Variables;    /* array of BinaryValue */
+  binary_u32_t  NumberOfEnums;
+  binary_u32_t  Enums;        /* array of BinaryClass */
+  binary_u32_t  NumberOfTypedefs;
+  binary_u32_t  Typedefs;     /* array of BinaryValue */
+  binary_u32_t  NumberOfUsings;
+  binary_u32_t  Usings;       /* array of BinaryUsing */
+  binary_u32_t  NumberOfNamespaces;
+  binary_u32_t  Namespaces;   /* array of BinaryClass */
+  binary_u32_t  NumberOfComments;
+  binary_u32_t  Comments;     /* array of BinaryComment */
+  binary_u32_t  Flags;        /* VTK_BINARY_CLASS flags */
+  binary_u32_t  NumberOfProperties;
+  binary_u32_t  Properties;   /* array of BinaryProperty */
+  binary_u32_t  MethodTypes;      /* binary_u32_t[NumberOfFunctions] */
+  binary_u32_t  MethodProperties; /* binary_u32_t[NumberOfFunctions] */
+} BinaryClass;
+
+/**
+ * Check the magic number, version, and size of a mapped file.  This
+ * also checks that the machine is little-endian.
+ */
+#define vtkWrapBinary_IsValid(base, size) \
+  ((size) >= sizeof(BinaryFileHeader) && \
+   *(const binary_u32_t *)(base) == 0x574b5456u && \
+   ((const BinaryFileHeader *)(base))->Version == VTK_BINARY_VERSION && \
+   ((const BinaryFileHeader *)(base))->Size == (size))
+
+/**
+ * Get the file header
+ */
+#define vtkWrapBinary_Header(base) \
+  ((const BinaryFileHeader *)(base))
+
+/**
+ * Get a record from its offset, or NULL if the offset is zero
+ */
+#define vtkWrapBinary_Record(base, type, offset) \
+  ((offset) ? (const type *)((const char *)(base) + (offset)) \
+            : (const type *)NULL)
+
+/**
+ * Get an array of offsets or string references
+ */
+#define vtkWrapBinary_Array(base, offset) \
+  ((const binary_u32_t *)((const char *)(base) + (offset)))
+
+/**
+ * Get a string from its reference, or NULL if the reference is zero
+ */
+#define vtkWrapBinary_String(base, ref) \
+  ((ref) ? ((const char *)(base) + \
+            ((const BinaryFileHeader *)(base))->Strings + (ref)) \
+         : (const char *)NULL)
+
+#endif
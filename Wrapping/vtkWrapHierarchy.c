@@ -35,875 +35,956 @@
 
  name = [2][3]* const int ; header.h ; kit [; flags]
 
+ The lines from each header file are also saved in a cache file, which
+ has the same name as the output file plus ".cache".  For each header,
+ the cache holds the size and hash of the header and of every file that
+ the preprocessor found while parsing it, and the paths where the
+ preprocessor looked for an include file but did not find one.  When
+ the tool is run again, only the headers that have changed (or whose
+ dependencies have changed, or that would now find a file at one of
+ the missing paths) are parsed, and the lines for the other headers
+ are taken from the cache.  The cache is discarded if the "-D", "-U",
+ or "-I" options have changed, or if the tool itself has changed.
+
+ With "-j <n>", the headers are parsed by n worker processes, and the
+ lines from the workers are merged after they exit.  The lines are
+ sorted and duplicates are removed, so the output does not depend on
+ the number of workers.  The "-j" option is ignored on Windows.
+
+ With "--db <file>", the output is also stored in a database that holds
+ the hierarchy files for all of the kits.  The prior files are taken
+ from the database when it has a valid copy of them, so that they do
+ not have to be read again.
+
 */
 
 #include "vtkParse.h"
 #include "vtkParseData.h"
+#include "vtkParseHierarchyDB.h"
 #include "vtkParseMain.h"
+#include "vtkParseMemory.h"
 #include "vtkParsePreprocess.h"
+#include "vtkParseTiming.h"
+#include "vtkWrapHierarchyWriter.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <sys/stat.h>
 #ifdef _WIN32
 # include <windows.h>
 #else
 # include <unistd.h>
+# include <sys/types.h>
+# include <sys/wait.h>
 #endif
 
 /**
- * Helper to append a text line to an array of lines
+ * The size and the hash of a file, or Exists = 0 if it can't be read
+ */
+typedef struct _HierarchySignature
+{
+  const char    *FileName;
+  unsigned long  Size;
+  unsigned int   Hash;
+  int            Exists;
+} HierarchySignature;
+
+/**
+ * A hash table of the signatures that have been computed so far, so
+ * that each dependency is read only once
+ */
+typedef struct _HierarchySignatureTable
+{
+  size_t              NumberOfSlots;
+  size_t              NumberOfSignatures;
+  HierarchySignature *Slots;
+} HierarchySignatureTable;
+
+/**
+ * The cached lines for one header file
  */
-static char **append_unique_line(char **lines, char *line, size_t *np)
+typedef struct _HierarchyRecord
 {
-  size_t l, n;
+  char          *Entry;        /* the line from the data file */
+  unsigned long  Size;         /* the size of the header */
+  unsigned int   Hash;         /* the hash of the header */
+  size_t         NumberOfDependencies;
+  char         **Dependencies; /* "size hash filename" for each file */
+  size_t         NumberOfMissing;
+  char         **Missing;      /* include paths that did not exist */
+  size_t         NumberOfLines;
+  char         **Lines;        /* the hierarchy lines for the header */
+} HierarchyRecord;
+
+static void vtkWrapHierarchy_AddDependency(
+  HierarchyRecord *record, HierarchySignatureTable *table,
+  const char *filename);
+static void vtkWrapHierarchy_AddMissing(
+  HierarchyRecord *record, const char *filename);
 
-  n = *np;
+/**
+ * Read a header file with vtkParse.tab.c
+ *
+ * If "lines" is provided, the file contents
+ * will be appended to them.  If "record" is provided, the files that
+ * the header depends on are added to it.
+ */
+static char **vtkWrapHierarchy_ParseHeaderFile(
+  FILE *fp, const char *filename, const char *module_name,
+  const char *flags, char **lines,
+  HierarchyRecord *record, HierarchySignatureTable *table)
+{
+  FileInfo *data;
+  size_t k;
 
-  /* check to make sure this line isn't a duplicate */
-  for (l = 0; l < n; l++)
+  /* start with just a single output line and grow from there */
+  if (lines == NULL)
   {
-    if (strcmp(line, lines[l]) == 0)
-    {
-      break;
-    }
+    lines = (char **)malloc(sizeof(char *));
+    lines[0] = NULL;
+  }
+
+  /* always ignore BTX markers when building hierarchy files */
+  vtkParse_SetIgnoreBTX(1);
+
+  /* the "concrete" flag doesn't matter, just set to zero */
+  data = vtkParse_ParseFile(filename, fp, stderr);
+
+  if (!data)
+  {
+    free(lines);
+    return 0;
+  }
+
+  /* print the memory that is held by the parse */
+  if (vtkParse_GetCommandLineOptions()->MemStats)
+  {
+    ParseMemoryStats stats;
+    vtkParse_GetMemoryStats(data, &stats);
+    vtkParse_PrintMemoryStats(stderr, filename, &stats);
   }
-  if (l == n)
+
+  /* append the file contents to the output */
+  lines = vtkWrapHierarchy_AddFileContents(lines, data, module_name, flags);
+
+  /* save the files that the header depends on */
+  if (record)
   {
-    /* allocate more memory if n+1 is a power of two */
-    if (((n+1) & n) == 0)
+    for (k = 0; k < data->NumberOfDependencies; k++)
     {
-      lines = (char **)realloc(lines, (n+1)*2*sizeof(char *));
+      vtkWrapHierarchy_AddDependency(record, table, data->Dependencies[k]);
+    }
+    for (k = 0; k < data->NumberOfMissingDependencies; k++)
+    {
+      vtkWrapHierarchy_AddMissing(record, data->MissingDependencies[k]);
     }
-
-    lines[n] = (char *)malloc(strlen(line)+1);
-    strcpy(lines[n++], line);
-    lines[n] = NULL;
   }
 
-  *np = n;
+  vtkParse_Free(data);
+
   return lines;
 }
 
 /**
- * Helper to append to a line, given the end marker
+ * Add the lines of a hierarchy file to "lines", the duplicates are
+ * removed later when the lines are sorted
  */
-static char *append_to_line(
-  char *line, const char *text, size_t *pos, size_t *maxlen)
+static char **vtkWrapHierarchy_ReadHierarchyFile(FILE *fp, char **lines)
 {
-  size_t n;
+  char *line;
+  size_t maxlen = 15;
+  size_t i, n;
 
-  n = strlen(text);
+  line = (char *)malloc(maxlen);
 
-  if ((*pos) + n + 1 > (*maxlen))
+  if (lines == NULL)
   {
-    *maxlen = ((*pos) + n + 1 + 2*(*maxlen));
-    line = (char *)realloc(line, (*maxlen));
+    lines = (char **)malloc(sizeof(char *));
+    lines[0] = NULL;
   }
 
-  strcpy(&line[*pos], text);
-  *pos = (*pos) + n;
+  for (i = 0; lines[i] != NULL; i++) { ; }
 
-  return line;
-}
+  while (fgets(line, (int)maxlen, fp))
+  {
+    n = strlen(line);
 
-/**
- * Append scope to line
- */
-static char *append_scope_to_line(
-  char *line, size_t *m, size_t *maxlen, const char *scope)
-{
-  if (scope && scope[0] != '\0')
+    /* if buffer not long enough, increase it */
+    while (n == maxlen-1 && line[n-1] != '\n' && !feof(fp))
+    {
+      maxlen *= 2;
+      line = (char *)realloc(line, maxlen);
+      if (!fgets(&line[n], (int)(maxlen-n), fp)) { break; }
+      n += strlen(&line[n]);
+    }
+
+    while (n > 0 && isspace(line[n-1]))
+    {
+      n--;
+    }
+    line[n] = '\0';
+
+    if (line[0] == '\0')
+    {
+      continue;
+    }
+
+    /* allocate more memory if i+1 is a power of two */
+    if (((i+1) & i) == 0)
+    {
+      lines = (char **)realloc(lines, (i+1)*2*sizeof(char *));
+    }
+
+    lines[i] = (char *)malloc(n+1);
+    strcpy(lines[i], line);
+    lines[++i] = NULL;
+  }
+
+  free(line);
+
+  if (!feof(fp))
   {
-    line = append_to_line(line, scope, m, maxlen);
-    line = append_to_line(line, "::", m, maxlen);
+    free(lines);
+    return 0;
   }
 
-  return line;
+  return lines;
 }
 
 /**
- * Append template info
+ * Add the lines for a kit from the hierarchy database to "lines", the
+ * duplicates are removed later when the lines are sorted
  */
-static char *append_template_to_line(
-  char *line, size_t *m, size_t *maxlen, TemplateInfo *template_args)
+static char **vtkWrapHierarchy_ReadDatabaseKit(
+  HierarchyDBInfo *db, int kit, char **lines)
 {
-  ValueInfo *arg;
-  unsigned long j;
+  const char **kit_lines;
+  size_t i, j, m, n;
+
+  if (lines == NULL)
+  {
+    lines = (char **)malloc(sizeof(char *));
+    lines[0] = NULL;
+  }
 
-  line = append_to_line(line, "<", m, maxlen);
+  for (i = 0; lines[i] != NULL; i++) { ; }
 
-  for (j = 0; j < template_args->NumberOfParameters; j++)
+  kit_lines = vtkParseHierarchyDB_GetLines(db, kit, &n);
+  for (j = 0; j < n; j++)
   {
-    arg = template_args->Parameters[j];
-    if (arg->Name)
+    /* trim the line, as vtkWrapHierarchy_ReadHierarchyFile would */
+    m = strlen(kit_lines[j]);
+    while (m > 0 && isspace(kit_lines[j][m-1]))
     {
-      line = append_to_line(line, arg->Name, m, maxlen);
+      m--;
     }
-    if (arg->Value && arg->Value[0] != '\n')
+    if (m == 0)
     {
-      line = append_to_line(line, "=", m, maxlen);
-      line = append_to_line(line, arg->Value, m, maxlen);
+      continue;
     }
-    if (j+1 < template_args->NumberOfParameters)
+
+    /* allocate more memory if i+1 is a power of two */
+    if (((i+1) & i) == 0)
     {
-      line = append_to_line(line, ",", m, maxlen);
+      lines = (char **)realloc(lines, (i+1)*2*sizeof(char *));
     }
-  }
 
-  line = append_to_line(line, ">", m, maxlen);
+    lines[i] = (char *)malloc(m+1);
+    strncpy(lines[i], kit_lines[j], m);
+    lines[i][m] = '\0';
+    lines[++i] = NULL;
+  }
+  free((void *)kit_lines);
 
-  return line;
+  return lines;
 }
 
 /**
- * Append class info
+ * Try to read a file, print error and exit if fail
  */
-static char *append_class_to_line(
-  char *line, size_t *m, size_t *maxlen, ClassInfo *class_info)
+static char **vtkWrapHierarchy_TryReadHierarchyFile(
+  const char *file_name, char **lines)
 {
-  unsigned long j;
+  FILE *input_file;
 
-  line = append_to_line(line, class_info->Name, m, maxlen);
+  input_file = fopen(file_name, "r");
+  if (!input_file)
+  {
+    fprintf(stderr, "vtkWrapHierarchy: couldn't open file %s\n",
+            file_name);
+    exit(1);
+  }
 
-  if (class_info->Template)
+  lines = vtkWrapHierarchy_ReadHierarchyFile(input_file, lines);
+  if (!lines)
   {
-    line = append_template_to_line(line, m, maxlen, class_info->Template);
+    fclose(input_file);
+    fprintf(stderr, "vtkWrapHierarchy: error reading file %s\n",
+            file_name);
+    exit(1);
   }
+  fclose(input_file);
+
+  return lines;
+}
 
-  line = append_to_line(line, " ", m, maxlen);
+/**
+ * Compute the size and the hash of a file
+ */
+static const HierarchySignature *vtkWrapHierarchy_GetSignature(
+  HierarchySignatureTable *table, const char *filename)
+{
+  HierarchySignature *slots;
+  HierarchySignature *sig;
+  unsigned char buffer[4096];
+  unsigned int h;
+  size_t i, k, m, n;
+  FILE *fp;
+
+  /* the table is kept at most half full */
+  if (2*(table->NumberOfSignatures + 1) > table->NumberOfSlots)
+  {
+    n = table->NumberOfSlots;
+    slots = table->Slots;
+    table->NumberOfSlots = (n == 0 ? 256 : 2*n);
+    table->Slots = (HierarchySignature *)calloc(
+      table->NumberOfSlots, sizeof(HierarchySignature));
+    m = table->NumberOfSlots - 1;
+    for (i = 0; i < n; i++)
+    {
+      if (slots[i].FileName)
+      {
+        h = 5381;
+        for (k = 0; slots[i].FileName[k] != '\0'; k++)
+        {
+          h = (h << 5) + h + (unsigned char)slots[i].FileName[k];
+        }
+        for (k = h & m; table->Slots[k].FileName; k = (k + 1) & m) { ; }
+        table->Slots[k] = slots[i];
+      }
+    }
+    free(slots);
+  }
 
-  if (class_info->NumberOfSuperClasses)
+  /* look up the file name */
+  h = 5381;
+  for (k = 0; filename[k] != '\0'; k++)
+  {
+    h = (h << 5) + h + (unsigned char)filename[k];
+  }
+  m = table->NumberOfSlots - 1;
+  for (k = h & m; table->Slots[k].FileName; k = (k + 1) & m)
   {
-    line = append_to_line(line, ": ", m, maxlen);
+    if (strcmp(table->Slots[k].FileName, filename) == 0)
+    {
+      return &table->Slots[k];
+    }
   }
 
-  for (j = 0; j < class_info->NumberOfSuperClasses; j++)
+  sig = &table->Slots[k];
+  sig->FileName = (char *)malloc(strlen(filename) + 1);
+  strcpy((char *)sig->FileName, filename);
+  sig->Size = 0;
+  sig->Hash = 0;
+  sig->Exists = 0;
+  table->NumberOfSignatures++;
+
+  /* compute the FNV-1a hash of the contents */
+  fp = fopen(filename, "rb");
+  if (fp)
   {
-    line = append_to_line(line, class_info->SuperClasses[j], m, maxlen);
-    line = append_to_line(line, " ", m, maxlen);
-    if (j+1 < class_info->NumberOfSuperClasses)
+    h = 2166136261u;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
     {
-      line = append_to_line(line, ", ", m, maxlen);
+      for (i = 0; i < n; i++)
+      {
+        h = (h ^ buffer[i])*16777619u;
+      }
+      sig->Size += (unsigned long)n;
     }
+    sig->Hash = (h & 0xffffffffu);
+    sig->Exists = !ferror(fp);
+    fclose(fp);
   }
 
-  return line;
+  return sig;
 }
 
 /**
- * Append enum info
+ * Free the signatures
  */
-static char *append_enum_to_line(
-  char *line, size_t *m, size_t *maxlen, EnumInfo *enum_info)
+static void vtkWrapHierarchy_FreeSignatures(HierarchySignatureTable *table)
 {
-  line = append_to_line(line, enum_info->Name, m, maxlen);
-  line = append_to_line(line, " : enum ", m, maxlen);
+  size_t i;
 
-  return line;
+  for (i = 0; i < table->NumberOfSlots; i++)
+  {
+    free((char *)table->Slots[i].FileName);
+  }
+  free(table->Slots);
 }
 
 /**
- * Append the trailer, i.e. the filename and flags
+ * Append a string to an array of strings, the string is copied
  */
-static char *append_trailer(
-  char *line, size_t *m, size_t *maxlen,
-  const char *header_file, const char *module_name, const char *flags)
+static char **vtkWrapHierarchy_AppendString(
+  char **strings, size_t *np, const char *text)
 {
-  line = append_to_line(line, "; ", m, maxlen);
-  line = append_to_line(line, header_file, m, maxlen);
+  size_t n = *np;
 
-  line = append_to_line(line, " ; ", m, maxlen);
-  line = append_to_line(line, module_name, m, maxlen);
-
-  if (flags && flags[0] != '\0')
+  /* allocate more memory if n is a power of two */
+  if (n == 0)
+  {
+    strings = (char **)malloc(sizeof(char *));
+  }
+  else if ((n & (n - 1)) == 0)
   {
-    line = append_to_line(line, " ; ", m, maxlen);
-    line = append_to_line(line, flags, m, maxlen);
+    strings = (char **)realloc(strings, 2*n*sizeof(char *));
   }
 
-  return line;
+  strings[n] = (char *)malloc(strlen(text) + 1);
+  strcpy(strings[n], text);
+  *np = n + 1;
+
+  return strings;
 }
 
 /**
- * Append typedef info
+ * Add a dependency, with its signature, to a record
  */
-static char *append_typedef_to_line(
-  char *line, size_t *m, size_t *maxlen, ValueInfo *typedef_info)
+static void vtkWrapHierarchy_AddDependency(
+  HierarchyRecord *record, HierarchySignatureTable *table,
+  const char *filename)
 {
-  unsigned int type;
-  int ndims;
-  int dim;
-
-  line = append_to_line(line, typedef_info->Name, m, maxlen);
-  line = append_to_line(line, " = ", m, maxlen);
-
-  type = typedef_info->Type;
-
-  if ((type & VTK_PARSE_REF) != 0)
-  {
-    line = append_to_line(line, "&", m, maxlen);
-  }
+  const HierarchySignature *sig;
+  char *text;
+
+  sig = vtkWrapHierarchy_GetSignature(table, filename);
+  text = (char *)malloc(strlen(filename) + 32);
+  sprintf(text, "%lu %08x %s", sig->Size, sig->Hash, filename);
+  record->Dependencies = vtkWrapHierarchy_AppendString(
+    record->Dependencies, &record->NumberOfDependencies, text);
+  free(text);
+}
 
-  ndims = typedef_info->NumberOfDimensions;
+/**
+ * Add a path where an include file was not found to a record
+ */
+static void vtkWrapHierarchy_AddMissing(
+  HierarchyRecord *record, const char *filename)
+{
+  record->Missing = vtkWrapHierarchy_AppendString(
+    record->Missing, &record->NumberOfMissing, filename);
+}
 
-  for (dim = 0; dim < ndims; dim++)
-  {
-    line = append_to_line(line, "[", m, maxlen);
-    line = append_to_line(line, typedef_info->Dimensions[dim],
-                          m, maxlen);
-    line = append_to_line(line, "]", m, maxlen);
-  }
+/**
+ * Check whether the header and its dependencies are unchanged
+ */
+static int vtkWrapHierarchy_CheckRecord(
+  HierarchyRecord *record, HierarchySignatureTable *table,
+  const char *filename)
+{
+  const HierarchySignature *sig;
+  unsigned long size;
+  unsigned int hash;
+  size_t i;
+  int k;
 
-  type = (type & VTK_PARSE_POINTER_MASK);
-  if (ndims > 0 && (type & VTK_PARSE_POINTER_LOWMASK) == VTK_PARSE_ARRAY)
-  {
-    type = ((type >> 2) & VTK_PARSE_POINTER_MASK);
-  }
-  else if (ndims == 1)
+  sig = vtkWrapHierarchy_GetSignature(table, filename);
+  if (!sig->Exists || sig->Size != record->Size || sig->Hash != record->Hash)
   {
-    type = ((type >> 2) & VTK_PARSE_POINTER_MASK);
+    return 0;
   }
 
-  /* pointers are printed after brackets, and are intentionally
-   * printed in reverse order as compared to C++ declarations */
-  while (type)
+  for (i = 0; i < record->NumberOfDependencies; i++)
   {
-    unsigned int bits = (type & VTK_PARSE_POINTER_LOWMASK);
-    type = ((type >> 2) & VTK_PARSE_POINTER_MASK);
-
-    if (bits == VTK_PARSE_POINTER)
-    {
-      line = append_to_line(line, "*", m, maxlen);
-    }
-    else if (bits == VTK_PARSE_CONST_POINTER)
+    k = 0;
+    if (sscanf(record->Dependencies[i], "%lu %x %n", &size, &hash, &k) < 2 ||
+        k == 0)
     {
-      line = append_to_line(line, "const*", m, maxlen);
+      return 0;
     }
-    else
+    sig = vtkWrapHierarchy_GetSignature(table, &record->Dependencies[i][k]);
+    if (!sig->Exists || sig->Size != size || sig->Hash != hash)
     {
-      line = append_to_line(line, "[]", m, maxlen);
+      return 0;
     }
   }
 
-  if (line[*m-1] != ' ')
-  {
-    line = append_to_line(line, " ", m, maxlen);
-  }
-
-  if ((type & VTK_PARSE_CONST) != 0)
+  /* a new file at a path that was searched might shadow an include,
+   * or might provide an include that was not found before */
+  for (i = 0; i < record->NumberOfMissing; i++)
   {
-    line = append_to_line(line, "const ", m, maxlen);
+    sig = vtkWrapHierarchy_GetSignature(table, record->Missing[i]);
+    if (sig->Exists)
+    {
+      return 0;
+    }
   }
 
-  line = append_to_line(line, typedef_info->TypeName, m, maxlen);
-  line = append_to_line(line, " ", m, maxlen);
-
-  return line;
+  return 1;
 }
 
 /**
- * Append all types in a class
+ * Free the records
  */
-static char **append_class_contents(
-  char **lines, size_t *np, ClassInfo *data,
-  const char *scope, const char *header_file, const char *module_name)
+static void vtkWrapHierarchy_FreeRecords(HierarchyRecord *records, size_t n)
 {
-  unsigned long i;
-  const char *tmpflags;
-  char *new_scope;
-  char *line;
-  size_t m, n, maxlen;
-  size_t scope_m, scope_maxlen;
+  size_t i, j;
 
-  /* append the name to the scope */
-  new_scope = 0;
-  n = 0;
-  m = 0;
-  if (scope)
-  {
-    n = strlen(scope);
-  }
-  if (data->Name)
-  {
-    m = strlen(data->Name);
-  }
-  if (m && (n || data->Template))
+  for (i = 0; i < n; i++)
   {
-    scope_maxlen = n + m + 3;
-    scope_m = 0;
-    new_scope = (char *)malloc(scope_maxlen);
-    new_scope[0] = '\0';
-    if (n)
+    for (j = 0; j < records[i].NumberOfDependencies; j++)
     {
-      new_scope = append_to_line(new_scope, scope, &scope_m, &scope_maxlen);
-      new_scope = append_to_line(new_scope, "::", &scope_m, &scope_maxlen);
+      free(records[i].Dependencies[j]);
     }
-    new_scope = append_to_line(new_scope, data->Name, &scope_m, &scope_maxlen);
-    if (data->Template)
+    for (j = 0; j < records[i].NumberOfMissing; j++)
     {
-      new_scope = append_template_to_line(
-        new_scope, &scope_m, &scope_maxlen, data->Template);
+      free(records[i].Missing[j]);
     }
-    scope = new_scope;
-  }
-  else if (m)
-  {
-    scope = data->Name;
+    for (j = 0; j < records[i].NumberOfLines; j++)
+    {
+      free(records[i].Lines[j]);
+    }
+    free(records[i].Dependencies);
+    free(records[i].Missing);
+    free(records[i].Lines);
+    free(records[i].Entry);
   }
+  free(records);
+}
+
+/**
+ * Compare records by their entry in the data file
+ */
+static int record_compare(const void *vp1, const void *vp2)
+{
+  return strcmp(((const HierarchyRecord *)vp1)->Entry,
+                ((const HierarchyRecord *)vp2)->Entry);
+}
+
+/**
+ * Read records until the "# end" marker.  If "tool_key" is set, then
+ * the records must be preceded by the version, the tool key, and the
+ * preprocessor options, as for the cache file.  Returns NULL if the
+ * records are incomplete, or if the key or options do not match.
+ */
+static HierarchyRecord *vtkWrapHierarchy_ReadRecords(
+  FILE *fp, const char *tool_key, size_t *np)
+{
+  OptionInfo *opts = vtkParse_GetCommandLineOptions();
+  HierarchyRecord *records = NULL;
+  HierarchyRecord *record = NULL;
+  char *line;
+  size_t maxlen = 128;
+  size_t l, n = 0;
+  int options_matched = (tool_key == NULL);
+  int version_matched = 0;
+  int tool_matched = 0;
+  int complete = 0;
+  int i = 0;
+  int k;
+
+  *np = 0;
 
-  /* start with a buffer of 15 chars and grow from there */
-  maxlen = 15;
-  m = 0;
   line = (char *)malloc(maxlen);
 
-  /* add a line for each type that is found */
-  for (i = 0; i < data->NumberOfItems; i++)
+  while (fgets(line, (int)maxlen, fp))
   {
-    m = 0;
-    line[m] = '\0';
+    l = strlen(line);
 
-    tmpflags = 0;
+    /* if buffer not long enough, increase it */
+    while (l == maxlen-1 && line[l-1] != '\n' && !feof(fp))
+    {
+      maxlen *= 2;
+      line = (char *)realloc(line, maxlen);
+      if (!fgets(&line[l], (int)(maxlen-l), fp)) { break; }
+      l += strlen(&line[l]);
+    }
+
+    if (l > 0 && line[l-1] == '\n')
+    {
+      line[--l] = '\0';
+    }
 
-    if (data->Items[i].Type == VTK_CLASS_INFO ||
-        data->Items[i].Type == VTK_STRUCT_INFO)
+    if (!options_matched)
     {
-      ClassInfo *class_info =
-        data->Classes[data->Items[i].Index];
+      /* the options must match before the first header */
+      if (tool_matched && strncmp(line, "option ", 7) == 0)
+      {
+        if (i >= opts->NumberOfPreprocessorOptions ||
+            strcmp(&line[7], opts->PreprocessorOptions[i++]) != 0)
+        {
+          break;
+        }
+        continue;
+      }
+      if (strcmp(line, "# vtkWrapHierarchy cache 2") == 0 &&
+          !version_matched)
+      {
+        version_matched = 1;
+        continue;
+      }
+      if (version_matched && !tool_matched && strncmp(line, "tool ", 5) == 0)
+      {
+        if (strcmp(&line[5], tool_key) != 0)
+        {
+          break;
+        }
+        tool_matched = 1;
+        continue;
+      }
+      if (!tool_matched || i != opts->NumberOfPreprocessorOptions)
+      {
+        break;
+      }
+      options_matched = 1;
+    }
 
-      line = append_scope_to_line(line, &m, &maxlen, scope);
-      line = append_class_to_line(line, &m, &maxlen, class_info);
-      tmpflags = "WRAP_EXCLUDE";
+    if (strncmp(line, "header ", 7) == 0)
+    {
+      /* allocate more memory if n is a power of two */
+      if (n == 0)
+      {
+        records = (HierarchyRecord *)malloc(sizeof(HierarchyRecord));
+      }
+      else if ((n & (n - 1)) == 0)
+      {
+        records = (HierarchyRecord *)realloc(
+          records, 2*n*sizeof(HierarchyRecord));
+      }
+      record = &records[n++];
+      memset(record, 0, sizeof(HierarchyRecord));
+      k = 0;
+      sscanf(&line[7], "%lu %x %n", &record->Size, &record->Hash, &k);
+      record->Entry = (char *)malloc(l - 7 - k + 1);
+      strcpy(record->Entry, &line[7 + k]);
     }
-    else if (data->Items[i].Type == VTK_ENUM_INFO)
+    else if (record && strncmp(line, "depend ", 7) == 0)
     {
-      line = append_scope_to_line(line, &m, &maxlen, scope);
-      line = append_enum_to_line(line, &m, &maxlen,
-        data->Enums[data->Items[i].Index]);
+      record->Dependencies = vtkWrapHierarchy_AppendString(
+        record->Dependencies, &record->NumberOfDependencies, &line[7]);
     }
-    else if (data->Items[i].Type == VTK_TYPEDEF_INFO)
+    else if (record && strncmp(line, "missing ", 8) == 0)
     {
-      line = append_scope_to_line(line, &m, &maxlen, scope);
-      line = append_typedef_to_line(line, &m, &maxlen,
-        data->Typedefs[data->Items[i].Index]);
+      vtkWrapHierarchy_AddMissing(record, &line[8]);
     }
-    else
+    else if (record && strncmp(line, "line ", 5) == 0)
     {
-      /* unhandled file element */
-      continue;
+      record->Lines = vtkWrapHierarchy_AppendString(
+        record->Lines, &record->NumberOfLines, &line[5]);
     }
-
-    /* append filename and flags */
-    line = append_trailer(
-      line, &m, &maxlen, header_file, module_name, tmpflags);
-
-    /* append the line to the file */
-    lines = append_unique_line(lines, line, np);
-
-    /* for classes, add all typed defined within the class */
-    if ((data->Items[i].Type == VTK_CLASS_INFO ||
-         data->Items[i].Type == VTK_STRUCT_INFO) &&
-        data->Classes[data->Items[i].Index]->Name)
+    else if (strcmp(line, "# end") == 0)
+    {
+      complete = 1;
+      break;
+    }
+    else
     {
-      lines = append_class_contents(lines, np,
-        data->Classes[data->Items[i].Index],
-        scope, header_file, module_name);
+      break;
     }
   }
 
   free(line);
 
-  if (new_scope != 0)
+  /* if anything was wrong with the file, discard it */
+  if (!options_matched || !complete)
   {
-    free(new_scope);
+    vtkWrapHierarchy_FreeRecords(records, n);
+    return NULL;
   }
 
-  return lines;
+  *np = n;
+  return records;
 }
 
-
 /**
- * Append all types in a namespace
+ * Write one record
  */
-static char **append_namespace_contents(
-  char **lines, size_t *np, NamespaceInfo *data, ClassInfo *main_class,
-  const char *scope, const char *header_file, const char *module_name,
-  const char *flags)
+static void vtkWrapHierarchy_WriteRecord(FILE *fp, HierarchyRecord *record)
 {
-  unsigned long i;
-  const char *tmpflags;
-  char *line;
-  char *new_scope;
-  size_t n, m, maxlen;
+  size_t j;
 
-  /* append the name to the scope */
-  new_scope = 0;
-  n = 0;
-  m = 0;
-  if (scope)
+  fprintf(fp, "header %lu %08x %s\n",
+          record->Size, record->Hash, record->Entry);
+  for (j = 0; j < record->NumberOfDependencies; j++)
   {
-    n = strlen(scope);
+    fprintf(fp, "depend %s\n", record->Dependencies[j]);
   }
-  if (data->Name)
+  for (j = 0; j < record->NumberOfMissing; j++)
   {
-    m = strlen(data->Name);
+    fprintf(fp, "missing %s\n", record->Missing[j]);
   }
-  if (m && n)
+  for (j = 0; j < record->NumberOfLines; j++)
   {
-    new_scope = (char *)malloc(m + n + 3);
-    if (n)
-    {
-      strncpy(new_scope, scope, n);
-      new_scope[n++] = ':';
-      new_scope[n++] = ':';
-    }
-    strncpy(&new_scope[n], data->Name, m);
-    new_scope[n+m] = '\0';
-    scope = new_scope;
+    fprintf(fp, "line %s\n", record->Lines[j]);
   }
-  else if (m)
+}
+
+/**
+ * Get a key for the cache from the size and modification time of this
+ * executable, so that the cache is discarded if the tool is rebuilt.
+ * Returns zero if the executable cannot be found.
+ */
+static int vtkWrapHierarchy_GetToolKey(const char *cmd, char *key)
+{
+  struct stat fs;
+#ifdef _WIN32
+  char path[MAX_PATH];
+  DWORD n;
+
+  n = GetModuleFileNameA(NULL, path, MAX_PATH);
+  if (n == 0 || n >= MAX_PATH)
   {
-    scope = data->Name;
+    return 0;
   }
-
-  /* start with a buffer of 15 chars and grow from there */
-  maxlen = 15;
-  m = 0;
-  line = (char *)malloc(maxlen);
-
-  /* add a line for each type that is found */
-  for (i = 0; i < data->NumberOfItems; i++)
+  cmd = path;
+#else
+  /* if there is no path, the tool was found through the PATH */
+  if (strchr(cmd, '/') == NULL)
   {
-    tmpflags = 0;
-    m = 0;
-    line[m] = '\0';
-
-    if (data->Items[i].Type == VTK_CLASS_INFO ||
-        data->Items[i].Type == VTK_STRUCT_INFO)
-    {
-      ClassInfo *class_info =
-        data->Classes[data->Items[i].Index];
-
-      /* all but the main class in each file is excluded from wrapping */
-      tmpflags = "WRAP_EXCLUDE";
-      if (class_info == main_class)
-      {
-        tmpflags = flags;
-      }
-
-      line = append_scope_to_line(line, &m, &maxlen, scope);
-      line = append_class_to_line(line, &m, &maxlen, class_info);
-    }
-    else if (data->Items[i].Type == VTK_ENUM_INFO)
-    {
-      line = append_scope_to_line(line, &m, &maxlen, scope);
-      line = append_enum_to_line(line, &m, &maxlen,
-        data->Enums[data->Items[i].Index]);
-    }
-    else if (data->Items[i].Type == VTK_TYPEDEF_INFO)
-    {
-      line = append_scope_to_line(line, &m, &maxlen, scope);
-      line = append_typedef_to_line(line, &m, &maxlen,
-        data->Typedefs[data->Items[i].Index]);
-    }
-    else if (data->Items[i].Type != VTK_NAMESPACE_INFO)
-    {
-      /* unhandled file element */
-      continue;
-    }
-
-    if (data->Items[i].Type != VTK_NAMESPACE_INFO)
-    {
-      /* append filename and flags */
-      line = append_trailer(
-        line, &m, &maxlen, header_file, module_name, tmpflags);
-
-      /* append the line to the file */
-      lines = append_unique_line(lines, line, np);
-    }
-
-    /* for classes, add all typed defined within the class */
-    if ((data->Items[i].Type == VTK_CLASS_INFO ||
-         data->Items[i].Type == VTK_STRUCT_INFO) &&
-        data->Classes[data->Items[i].Index]->Name)
-    {
-      lines = append_class_contents(lines, np,
-        data->Classes[data->Items[i].Index],
-        scope, header_file, module_name);
-    }
-
-    /* for namespaces, add all types in the namespace */
-    if (data->Items[i].Type == VTK_NAMESPACE_INFO &&
-        data->Namespaces[data->Items[i].Index]->Name)
-    {
-      lines = append_namespace_contents(lines, np,
-        data->Namespaces[data->Items[i].Index], 0,
-        scope, header_file, module_name, "WRAP_EXCLUDE");
-    }
+    cmd = "/proc/self/exe";
   }
+#endif
 
-  free(line);
-
-  if (new_scope != 0)
+  if (stat(cmd, &fs) != 0)
   {
-    free(new_scope);
+    return 0;
   }
 
-  return lines;
+  sprintf(key, "%lu %lu", (unsigned long)fs.st_size,
+          (unsigned long)fs.st_mtime);
+  return 1;
 }
 
 /**
- * Read a header file with vtkParse.tab.c
- *
- * If "lines" is provided, the file contents
- * will be appended to them.
+ * Read the cache file, return NULL if it does not exist, or if it was
+ * written by a different tool or with different preprocessor options
  */
-static char **vtkWrapHierarchy_ParseHeaderFile(
-  FILE *fp, const char *filename, const char *module_name,
-  const char *flags, char **lines)
+static HierarchyRecord *vtkWrapHierarchy_ReadCacheFile(
+  const char *file_name, const char *tool_key, size_t *np)
 {
-  FileInfo *data;
-  const char *header_file;
-  size_t k, n;
+  HierarchyRecord *records;
+  FILE *fp;
 
-  /* start with just a single output line and grow from there */
-  if (lines == NULL)
-  {
-    lines = (char **)malloc(sizeof(char *));
-    lines[0] = NULL;
-  }
+  *np = 0;
 
-  /* always ignore BTX markers when building hierarchy files */
-  vtkParse_SetIgnoreBTX(1);
-
-  /* the "concrete" flag doesn't matter, just set to zero */
-  data = vtkParse_ParseFile(filename, fp, stderr);
-
-  if (!data)
+  fp = fopen(file_name, "r");
+  if (!fp)
   {
-    free(lines);
-    return 0;
+    return NULL;
   }
 
-  /* find the last line in "lines" */
-  n = 0;
-  while (lines[n] != NULL)
-  {
-    n++;
-  }
+  records = vtkWrapHierarchy_ReadRecords(fp, tool_key, np);
+  fclose(fp);
 
-  k = strlen(data->FileName) - 1;
-  while (k > 0 && data->FileName[k-1] != '/' && data->FileName[k-1] != '\\')
+  /* sort the records so that FindRecord can do a binary search */
+  if (records)
   {
-    k--;
+    qsort(records, *np, sizeof(HierarchyRecord), &record_compare);
   }
-  header_file = &data->FileName[k];
-
-  /* append the file contents to the output */
-  lines = append_namespace_contents(
-    lines, &n, data->Contents, data->MainClass, 0,
-    header_file, module_name, flags);
-
-  vtkParse_Free(data);
 
-  return lines;
+  return records;
 }
 
 /**
- * Read a hierarchy file into "lines" without duplicating lines
+ * Find the record for an entry of the data file in the sorted records
  */
-static char **vtkWrapHierarchy_ReadHierarchyFile(FILE *fp, char **lines)
+static HierarchyRecord *vtkWrapHierarchy_FindRecord(
+  HierarchyRecord *records, size_t n, const char *entry)
 {
-  char *line;
-  size_t maxlen = 15;
-  size_t i, n;
-
-  line = (char *)malloc(maxlen);
-
-  if (lines == NULL)
-  {
-    lines = (char **)malloc(sizeof(char *));
-    lines[0] = NULL;
-  }
-
-  while (fgets(line, (int)maxlen, fp))
-  {
-    n = strlen(line);
-
-    /* if buffer not long enough, increase it */
-    while (n == maxlen-1 && line[n-1] != '\n' && !feof(fp))
-    {
-      maxlen *= 2;
-      line = (char *)realloc(line, maxlen);
-      if (!fgets(&line[n], (int)(maxlen-n), fp)) { break; }
-      n += strlen(&line[n]);
-    }
-
-    while (n > 0 && isspace(line[n-1]))
-    {
-      n--;
-    }
-    line[n] = '\0';
+  HierarchyRecord key;
 
-    if (line[0] == '\0')
-    {
-      continue;
-    }
-
-    for (i = 0; lines[i] != NULL; i++)
-    {
-      if (strcmp(line, lines[i]) == 0)
-      {
-        break;
-      }
-    }
-
-    if (lines[i] == NULL)
-    {
-      /* allocate more memory if n+1 is a power of two */
-      if (((i+1) & i) == 0)
-      {
-        lines = (char **)realloc(lines, (i+1)*2*sizeof(char *));
-      }
-
-      lines[i] = (char *)malloc(n+1);
-      strcpy(lines[i], line);
-      lines[i+1] = NULL;
-    }
-  }
-
-  free(line);
-
-  if (!feof(fp))
+  if (records == NULL)
   {
-    free(lines);
-    return 0;
+    return NULL;
   }
 
-  return lines;
+  key.Entry = (char *)entry;
+  return (HierarchyRecord *)bsearch(
+    &key, records, n, sizeof(HierarchyRecord), &record_compare);
 }
 
 /**
- * Compare a file to "lines", return 0 if they are different
+ * Write the cache file, failure is not an error because the cache
+ * is only needed to speed up the next run
  */
-static int vtkWrapHierarchy_CompareHierarchyFile(FILE *fp, char *lines[])
+static void vtkWrapHierarchy_WriteCacheFile(
+  const char *file_name, const char *tool_key,
+  HierarchyRecord *records, size_t n)
 {
-  unsigned char *matched;
-  char *line;
-  size_t maxlen = 15;
-  size_t i, n;
-
-  line = (char *)malloc(maxlen);
-
-  for (i = 0; lines[i] != NULL; i++) { ; };
-  matched = (unsigned char *)malloc(i);
-  memset(matched, 0, i);
+  OptionInfo *options = vtkParse_GetCommandLineOptions();
+  FILE *fp;
+  size_t i;
+  int k;
 
-  while (fgets(line, (int)maxlen, fp))
+  fp = fopen(file_name, "w");
+  if (!fp)
   {
-    n = strlen(line);
-
-    /* if buffer not long enough, increase it */
-    while (n == maxlen-1 && line[n-1] != '\n' && !feof(fp))
-    {
-      maxlen *= 2;
-      line = (char *)realloc(line, maxlen);
-      if (!fgets(&line[n], (int)(maxlen-n), fp)) { break; }
-      n += strlen(&line[n]);
-    }
-
-    while (n > 0 && isspace(line[n-1]))
-    {
-      n--;
-    }
-    line[n] = '\0';
-
-    if (line[0] == '\0')
-    {
-      continue;
-    }
-
-    for (i = 0; lines[i] != NULL; i++)
-    {
-      if (strcmp(line, lines[i]) == 0)
-      {
-        break;
-      }
-    }
-
-    if (lines[i] == NULL)
-    {
-      free(matched);
-      return 0;
-    }
-
-    matched[i] = 1;
+    return;
   }
 
-  for (i = 0; lines[i] != NULL; i++)
+  fprintf(fp, "# vtkWrapHierarchy cache 2\n");
+  fprintf(fp, "tool %s\n", tool_key);
+  for (k = 0; k < options->NumberOfPreprocessorOptions; k++)
   {
-    if (matched[i] == 0)
-    {
-      free(matched);
-      return 0;
-    }
+    fprintf(fp, "option %s\n", options->PreprocessorOptions[k]);
   }
 
-  free(line);
-  free(matched);
-
-  if (!feof(fp))
+  for (i = 0; i < n; i++)
   {
-    return 0;
+    vtkWrapHierarchy_WriteRecord(fp, &records[i]);
   }
+  fprintf(fp, "# end\n");
 
-  return 1;
-}
-
-/**
- * Write "lines" to a hierarchy file
- */
-static int vtkWrapHierarchy_WriteHierarchyFile(FILE *fp, char *lines[])
-{
-  size_t i;
-
-  for (i = 0; lines[i] != NULL; i++)
+  if (fclose(fp) != 0)
   {
-    if (fprintf(fp, "%s\n", lines[i]) < 0)
-    {
-      return 0;
-    }
+    remove(file_name);
   }
-
-  return 1;
 }
 
 /**
- * Try to parse a header file, print error and exit if fail
+ * Parse a header file and store its lines and dependencies in the
+ * record, print an error and return zero if it fails
  */
-static char **vtkWrapHierarchy_TryParseHeaderFile(
-  const char *file_name, const char *module_name,
-  const char *flags, char **lines)
+static int vtkWrapHierarchy_ParseRecord(
+  HierarchyRecord *record, HierarchySignatureTable *table,
+  const char *file_name, const char *module_name, const char *flags)
 {
+  const HierarchySignature *sig;
   FILE *input_file;
+  char **lines;
+  size_t k;
 
-  input_file = fopen(file_name, "r");
+  sig = vtkWrapHierarchy_GetSignature(table, file_name);
+  record->Size = sig->Size;
+  record->Hash = sig->Hash;
 
+  input_file = fopen(file_name, "r");
   if (!input_file)
   {
     fprintf(stderr, "vtkWrapHierarchy: couldn't open file %s\n",
             file_name);
-    exit(1);
+    return 0;
   }
 
   lines = vtkWrapHierarchy_ParseHeaderFile(
-                 input_file, file_name, module_name, flags, lines);
+    input_file, file_name, module_name, flags, NULL, record, table);
+  fclose(input_file);
 
   if (!lines)
   {
-    fclose(input_file);
-    exit(1);
+    return 0;
   }
-  fclose(input_file);
 
-  return lines;
+  for (k = 0; lines[k] != NULL; k++) { ; }
+  record->Lines = lines;
+  record->NumberOfLines = k;
+
+  return 1;
 }
 
+#ifndef _WIN32
 /**
- * Try to read a file, print error and exit if fail
+ * Parse the headers in "pending" with "njobs" worker processes, where
+ * worker "w" parses pending[w], pending[w + njobs], etc.  Each worker
+ * writes its records to a temporary file, and the files are read after
+ * all of the workers have exited.  Exits if any worker fails.
  */
-static char **vtkWrapHierarchy_TryReadHierarchyFile(
-  const char *file_name, char **lines)
+static void vtkWrapHierarchy_ParseInWorkers(
+  int njobs, const size_t *pending, size_t npending,
+  char **files, char **module_names, char **flags,
+  HierarchyRecord *records, HierarchySignatureTable *table)
 {
-  FILE *input_file;
-
-  input_file = fopen(file_name, "r");
-  if (!input_file)
-  {
-    fprintf(stderr, "vtkWrapHierarchy: couldn't open file %s\n",
-            file_name);
-    exit(1);
-  }
-
-  lines = vtkWrapHierarchy_ReadHierarchyFile(input_file, lines);
-  if (!lines)
-  {
-    fclose(input_file);
-    fprintf(stderr, "vtkWrapHierarchy: error reading file %s\n",
-            file_name);
-    exit(1);
-  }
-  fclose(input_file);
+  HierarchyRecord *results;
+  FILE **outputs;
+  pid_t *pids;
+  size_t i, k, m, nresults;
+  int status;
+  int failed = 0;
+  int w;
 
-  return lines;
-}
+  outputs = (FILE **)malloc(njobs*sizeof(FILE *));
+  pids = (pid_t *)malloc(njobs*sizeof(pid_t));
 
-/**
- * Try to write a file, print error and exit if fail
- */
-static int vtkWrapHierarchy_TryWriteHierarchyFile(
-  const char *file_name, char *lines[])
-{
-  FILE *output_file;
-  int matched = 0;
+  /* flush so that the workers do not write the parent's buffers */
+  fflush(NULL);
 
-  output_file = fopen(file_name, "r");
-  if (output_file && vtkWrapHierarchy_CompareHierarchyFile(output_file, lines))
+  for (w = 0; w < njobs; w++)
   {
-    matched = 1;
+    outputs[w] = tmpfile();
+    pids[w] = (outputs[w] ? fork() : -1);
+    if (pids[w] < 0)
+    {
+      fprintf(stderr, "vtkWrapHierarchy: couldn't start worker process\n");
+      exit(1);
+    }
+    if (pids[w] == 0)
+    {
+      /* in the worker, "_exit" skips the parent's "atexit" functions */
+      for (k = w; k < npending; k += njobs)
+      {
+        i = pending[k];
+        if (!vtkWrapHierarchy_ParseRecord(
+              &records[i], table, files[i], module_names[i], flags[i]))
+        {
+          _exit(1);
+        }
+        vtkWrapHierarchy_WriteRecord(outputs[w], &records[i]);
+      }
+      fprintf(outputs[w], "# end\n");
+      _exit(fflush(outputs[w]) == 0 ? 0 : 1);
+    }
   }
-  if (output_file)
+
+  for (w = 0; w < njobs; w++)
   {
-    fclose(output_file);
+    if (waitpid(pids[w], &status, 0) != pids[w] ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      failed = 1;
+    }
   }
 
-  if (!matched)
+  /* collect the records in the same order that they were assigned */
+  for (w = 0; w < njobs && !failed; w++)
   {
-    int tries = 1;
-    output_file = fopen(file_name, "w");
-    while (!output_file && tries < 5)
+    rewind(outputs[w]);
+    results = vtkWrapHierarchy_ReadRecords(outputs[w], NULL, &nresults);
+    m = 0;
+    for (k = w; k < npending && results; k += njobs)
     {
-      /* There are two CMAKE_CUSTOM_COMMANDS for vtkWrapHierarchy,
-       * make sure they do not collide. */
-      tries++;
-#ifdef _WIN32
-      Sleep(1000);
-#else
-      sleep(1);
-#endif
-      output_file = fopen(file_name, "r+");
-      if (output_file &&
-          vtkWrapHierarchy_CompareHierarchyFile(output_file, lines))
-      {
-        /* if the contents match, no need to write it */
-        fclose(output_file);
-        return 0;
-      }
-      if (output_file)
+      i = pending[k];
+      if (m == nresults || strcmp(results[m].Entry, records[i].Entry) != 0)
       {
-        /* close and open in order to truncate the file */
-        fclose(output_file);
-        output_file = fopen(file_name, "w");
+        break;
       }
+      free(records[i].Entry);
+      records[i] = results[m];
+      memset(&results[m++], 0, sizeof(HierarchyRecord));
     }
-    if (!output_file)
-    {
-      fprintf(stderr, "vtkWrapHierarchy: tried %i times to write %s\n",
-              tries, file_name);
-      exit(1);
-    }
-    if (!vtkWrapHierarchy_WriteHierarchyFile(output_file, lines))
+    if (!results || k < npending || m != nresults)
     {
-      fclose(output_file);
-      fprintf(stderr, "vtkWrapHierarchy: error writing file %s\n",
-              file_name);
-      exit(1);
+      fprintf(stderr, "vtkWrapHierarchy: error reading worker output\n");
+      failed = 1;
     }
-    fclose(output_file);
+    vtkWrapHierarchy_FreeRecords(results, nresults);
   }
 
-  return 0;
+  for (w = 0; w < njobs; w++)
+  {
+    fclose(outputs[w]);
+  }
+  free(outputs);
+  free(pids);
+
+  if (failed)
+  {
+    exit(1);
+  }
 }
+#endif
 
 static int string_compare(const void *vp1, const void *vp2)
 {
@@ -914,11 +995,27 @@ int main(int argc, char *argv[])
 {
   OptionInfo *options;
   int i;
-  size_t j, n;
+  size_t j, k, m, n;
   char **lines = 0;
   char **files = 0;
-  char *flags;
-  char *module_name;
+  char **output;
+  char **flags;
+  char **module_names;
+  char *cache_name;
+  char tool_key[64];
+  int have_tool_key;
+  HierarchyRecord *cached;
+  HierarchyRecord *records;
+  HierarchyRecord *record;
+  HierarchyRecord *found;
+  HierarchyRecord swap;
+  HierarchySignatureTable table;
+  size_t ncached, nrecords, npending;
+  size_t *pending;
+  HierarchyDBInfo *db;
+  int changed;
+  int njobs;
+  int kit;
 
   /* parse command-line options */
   vtkParse_MainMulti(argc, argv);
@@ -935,36 +1032,200 @@ int main(int argc, char *argv[])
   files = vtkWrapHierarchy_TryReadHierarchyFile(
     options->InputFileName, files);
 
-  /* read in all the prior files */
+  /* read in all the prior files, use the database if it has them */
+  vtkParse_StartPhase(VTK_PARSE_PHASE_HIERARCHY);
+  db = NULL;
+  if (options->DatabaseFileName)
+  {
+    db = vtkParseHierarchyDB_ReadFile(options->DatabaseFileName);
+  }
   for (i = 1; i < options->NumberOfFiles; i++)
   {
-    lines = vtkWrapHierarchy_TryReadHierarchyFile(
-      options->Files[i], lines);
+    kit = (db ? vtkParseHierarchyDB_FindKit(db, options->Files[i]) : -1);
+    if (kit >= 0 && vtkParseHierarchyDB_CheckKit(db, kit))
+    {
+      lines = vtkWrapHierarchy_ReadDatabaseKit(db, kit, lines);
+    }
+    else
+    {
+      lines = vtkWrapHierarchy_TryReadHierarchyFile(
+        options->Files[i], lines);
+    }
+  }
+  if (db)
+  {
+    vtkParseHierarchyDB_Free(db);
   }
+  vtkParse_StopPhase(VTK_PARSE_PHASE_HIERARCHY);
+
+  /* read the lines that were saved from the previous run */
+  cache_name = (char *)malloc(strlen(options->OutputFileName) + 7);
+  sprintf(cache_name, "%s.cache", options->OutputFileName);
+  cached = NULL;
+  ncached = 0;
+  have_tool_key = vtkWrapHierarchy_GetToolKey(argv[0], tool_key);
+  if (have_tool_key)
+  {
+    cached = vtkWrapHierarchy_ReadCacheFile(cache_name, tool_key, &ncached);
+  }
+  changed = (cached == NULL);
+  table.NumberOfSlots = 0;
+  table.NumberOfSignatures = 0;
+  table.Slots = NULL;
+
+  /* sort the entries of the data file, and remove duplicates */
+  for (m = 0; files[m] != NULL; m++) { ; }
+  qsort(files, m, sizeof(char *), &string_compare);
+  for (nrecords = 0, k = 0; k < m; k++)
+  {
+    if (nrecords == 0 || strcmp(files[nrecords-1], files[k]) != 0)
+    {
+      files[nrecords++] = files[k];
+    }
+    else
+    {
+      free(files[k]);
+    }
+  }
+  files[nrecords] = NULL;
+  records = (HierarchyRecord *)calloc(nrecords + 1, sizeof(HierarchyRecord));
+  module_names = (char **)malloc((nrecords + 1)*sizeof(char *));
+  flags = (char **)malloc((nrecords + 1)*sizeof(char *));
+  pending = (size_t *)malloc((nrecords + 1)*sizeof(size_t));
+  npending = 0;
 
   /* merge the files listed in the data file */
-  for (i = 0; files[i] != NULL; i++)
+  for (j = 0; j < nrecords; j++)
   {
+    record = &records[j];
+    record->Entry = (char *)malloc(strlen(files[j]) + 1);
+    strcpy(record->Entry, files[j]);
+
     /* look for semicolon that marks the module name */
-    module_name = files[i];
-    while(*module_name != ';' && *module_name != '\0') { module_name++; };
-    if (*module_name == ';') { *module_name++ = '\0'; }
+    module_names[j] = files[j];
+    while(*module_names[j] != ';' && *module_names[j] != '\0')
+    {
+      module_names[j]++;
+    }
+    if (*module_names[j] == ';') { *module_names[j]++ = '\0'; }
 
     /* look for semicolon that marks start of flags */
-    flags = module_name;
-    while(*flags != ';' && *flags != '\0') { flags++; };
-    if (*flags == ';') { *flags++ = '\0'; }
+    flags[j] = module_names[j];
+    while(*flags[j] != ';' && *flags[j] != '\0') { flags[j]++; };
+    if (*flags[j] == ';') { *flags[j]++ = '\0'; }
+
+    /* use the cached lines if the header and its dependencies have
+     * not changed, and swap them with the empty new record, so that
+     * the cached records stay sorted by entry */
+    found = vtkWrapHierarchy_FindRecord(cached, ncached, record->Entry);
+    if (found && vtkWrapHierarchy_CheckRecord(found, &table, files[j]))
+    {
+      swap = *record;
+      *record = *found;
+      *found = swap;
+    }
+    else
+    {
+      pending[npending++] = j;
+    }
+  }
+
+  /* parse the headers that were not in the cache */
+  njobs = options->NumberOfJobs;
+  if ((size_t)njobs > npending)
+  {
+    njobs = (int)npending;
+  }
+#ifndef _WIN32
+  if (njobs > 1)
+  {
+    vtkWrapHierarchy_ParseInWorkers(
+      njobs, pending, npending, files, module_names, flags,
+      records, &table);
+  }
+  else
+#endif
+  {
+    for (k = 0; k < npending; k++)
+    {
+      j = pending[k];
+      if (!vtkWrapHierarchy_ParseRecord(
+            &records[j], &table, files[j], module_names[j], flags[j]))
+      {
+        exit(1);
+      }
+    }
+  }
+
+  /* headers that were parsed, or removed from the data file */
+  if (npending > 0 || ncached != nrecords)
+  {
+    changed = 1;
+  }
 
-    lines = vtkWrapHierarchy_TryParseHeaderFile(
-      files[i], module_name, flags, lines);
+  /* merge the prior lines and the lines from each header, the result
+   * does not depend on the order in which the headers were parsed */
+  for (n = 0; lines && lines[n]; n++) { ; };
+  m = n;
+  for (j = 0; j < nrecords; j++)
+  {
+    m += records[j].NumberOfLines;
+  }
+  output = (char **)malloc((m + 1)*sizeof(char *));
+  m = 0;
+  for (k = 0; k < n; k++)
+  {
+    output[m++] = lines[k];
+  }
+  for (j = 0; j < nrecords; j++)
+  {
+    for (k = 0; k < records[j].NumberOfLines; k++)
+    {
+      output[m++] = records[j].Lines[k];
+    }
   }
 
-  /* sort the lines to ease lookups in the file */
-  for (n = 0; lines[n]; n++) { ; };
-  qsort(lines, n, sizeof(char *), &string_compare);
+  /* sort the lines to ease lookups in the file, and remove duplicates */
+  qsort(output, m, sizeof(char *), &string_compare);
+  for (j = 0, k = 0; k < m; k++)
+  {
+    if (j == 0 || strcmp(output[j-1], output[k]) != 0)
+    {
+      output[j++] = output[k];
+    }
+  }
+  output[j] = NULL;
 
   /* write the file, if it has changed */
-  vtkWrapHierarchy_TryWriteHierarchyFile(options->OutputFileName, lines);
+  vtkParse_StartPhase(VTK_PARSE_PHASE_OUTPUT);
+  vtkParse_BeginSpan("output", options->OutputFileName);
+  vtkWrapHierarchy_TryWriteHierarchyFile(options->OutputFileName, output);
+
+  /* add this kit to the database, if this fails then the other tools
+   * will simply read the hierarchy file instead */
+  if (options->DatabaseFileName)
+  {
+    vtkParseHierarchyDB_WriteKit(
+      options->DatabaseFileName, options->OutputFileName, output,
+      options->NumberOfFiles - 1, &options->Files[1]);
+  }
+  vtkParse_EndSpan("output");
+  vtkParse_StopPhase(VTK_PARSE_PHASE_OUTPUT);
+
+  /* save the lines for each header for the next run */
+  if (changed && have_tool_key)
+  {
+    vtkWrapHierarchy_WriteCacheFile(cache_name, tool_key, records, nrecords);
+  }
+
+  vtkWrapHierarchy_FreeRecords(records, nrecords);
+  vtkWrapHierarchy_FreeRecords(cached, ncached);
+  vtkWrapHierarchy_FreeSignatures(&table);
+  free(cache_name);
+  free(module_names);
+  free(flags);
+  free(pending);
+  free(output);
 
   for (j = 0; j < n; j++)
   {
@@ -0,0 +1,55 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkWrapHierarchyWriter.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+/**
+ vtkWrapHierarchyWriter.h provides the functions that vtkWrapHierarchy
+ uses to build the lines of a hierarchy file from a parsed header, and
+ to write the hierarchy file.  See vtkWrapHierarchy.c for the format
+ of the lines.
+
+ The "lines" are an array of strings that is terminated by NULL.  The
+ array and the strings are allocated with malloc().
+*/
+
+#ifndef VTK_WRAP_HIERARCHY_WRITER_H
+#define VTK_WRAP_HIERARCHY_WRITER_H
+
+#include "vtkParseData.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Add the lines for the classes, enums, and typedefs in a parsed
+ * header.  Lines that are already present are not added again.  If
+ * "lines" is NULL, a new array is created.  The new array is returned.
+ */
+char **vtkWrapHierarchy_AddFileContents(
+  char **lines, FileInfo *data, const char *module_name, const char *flags);
+
+/**
+ * Write the lines to a hierarchy file, unless the file already holds
+ * the same lines.  The file is replaced atomically.  Prints an error
+ * and exits if the file cannot be written.
+ */
+int vtkWrapHierarchy_TryWriteHierarchyFile(
+  const char *file_name, char *lines[]);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapJSON.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ The vtkWrapJSON program will read VTK header files and produce a JSON
+ representation of the interface to the VTK classes.  It uses the
+ writer in vtkWrapXMLWriter.c, so it writes exactly the same content
+ as vtkWrapXML, and it takes the same command-line options.  The output
+ is written in one pass, without building a tree in memory.
+*/
+
+#include "vtkWrapXMLWriter.h"
+
+int main(int argc, char *argv[])
+{
+  return vtkWrapXML_Run(argc, argv, VTKXML_FORMAT_JSON);
+}
@@ -0,0 +1,725 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapXMLBundle.c
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+#include "vtkWrapXMLBundle.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* the sizes of the parts of the bundle */
+#define BUNDLE_HEADER_SIZE 32
+#define BUNDLE_SLOT_SIZE 4
+#define BUNDLE_ENTRY_SIZE 24
+
+/* the LZ compression uses 3-byte matches within an 8k window */
+#define BUNDLE_LZ_HASH_BITS 14
+#define BUNDLE_LZ_MAX_OFFSET 8192
+#define BUNDLE_LZ_MAX_LENGTH 264
+#define BUNDLE_LZ_MAX_LITERALS 32
+
+/* a document that has been added to a writer */
+typedef struct _XMLBundleEntry
+{
+  char          *Name;
+  unsigned char *Data;
+  size_t         StoredSize;
+  size_t         Size;
+  int            Compression;
+  unsigned long  Order;        /* for replacing duplicates */
+} XMLBundleEntry;
+
+struct _XMLBundleWriter
+{
+  int             Compress;
+  unsigned long   NumberOfEntries;
+  XMLBundleEntry *Entries;
+  size_t         *HashTable;   /* for the compressor */
+};
+
+/* The FNV-1a hash of a class name */
+static unsigned long bundle_hash(const char *name, size_t n)
+{
+  unsigned long h = 2166136261ul;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    h ^= (unsigned char)name[i];
+    h = (h * 16777619ul) & 0xfffffffful;
+  }
+
+  return h;
+}
+
+/* Read a 32-bit little-endian integer */
+static unsigned long bundle_get32(const unsigned char *cp)
+{
+  return ((unsigned long)cp[0] |
+          ((unsigned long)cp[1] << 8) |
+          ((unsigned long)cp[2] << 16) |
+          ((unsigned long)cp[3] << 24));
+}
+
+/* Write a 32-bit little-endian integer */
+static void bundle_put32(unsigned char *cp, size_t v)
+{
+  cp[0] = (unsigned char)(v & 0xff);
+  cp[1] = (unsigned char)((v >> 8) & 0xff);
+  cp[2] = (unsigned char)((v >> 16) & 0xff);
+  cp[3] = (unsigned char)((v >> 24) & 0xff);
+}
+
+/* Compress "n" bytes.  Each run starts with a control byte "c":
+ * if c < 32, then c+1 literal bytes follow, otherwise the top three
+ * bits give a length (if 7, then add the next byte), and the low five
+ * bits and the next byte give the offset of an earlier copy.  Returns
+ * zero if the output would be larger than "maxout". */
+static size_t bundle_compress(
+  const unsigned char *in, size_t n, unsigned char *out, size_t maxout,
+  size_t *htab)
+{
+  size_t ip = 0;
+  size_t op = 0;
+  size_t litpos;
+  size_t lit = 0;
+  size_t len, maxlen, ref, off;
+  unsigned long h;
+
+  if (maxout == 0)
+  {
+    return 0;
+  }
+
+  memset(htab, 0, (1 << BUNDLE_LZ_HASH_BITS)*sizeof(size_t));
+
+  /* reserve a control byte for the first literal run */
+  litpos = op++;
+
+  while (ip < n)
+  {
+    len = 0;
+    if (ip + 2 < n)
+    {
+      h = ((unsigned long)in[ip] << 16) | ((unsigned long)in[ip+1] << 8) |
+        in[ip+2];
+      h = ((h * 2654435761ul) & 0xfffffffful) >> (32 - BUNDLE_LZ_HASH_BITS);
+      ref = htab[h];
+      htab[h] = ip + 1;
+
+      if (ref != 0 && ip - ref < BUNDLE_LZ_MAX_OFFSET &&
+          memcmp(&in[ref - 1], &in[ip], 3) == 0)
+      {
+        /* extend the match */
+        ref--;
+        maxlen = n - ip;
+        if (maxlen > BUNDLE_LZ_MAX_LENGTH)
+        {
+          maxlen = BUNDLE_LZ_MAX_LENGTH;
+        }
+        len = 3;
+        while (len < maxlen && in[ref + len] == in[ip + len])
+        {
+          len++;
+        }
+      }
+    }
+
+    if (len == 0)
+    {
+      /* add a literal */
+      if (op >= maxout)
+      {
+        return 0;
+      }
+      out[op++] = in[ip++];
+      if (++lit == BUNDLE_LZ_MAX_LITERALS)
+      {
+        out[litpos] = (unsigned char)(lit - 1);
+        lit = 0;
+        if (op >= maxout)
+        {
+          return 0;
+        }
+        litpos = op++;
+      }
+      continue;
+    }
+
+    /* close the literal run, or remove its unused control byte */
+    if (lit > 0)
+    {
+      out[litpos] = (unsigned char)(lit - 1);
+    }
+    else
+    {
+      op--;
+    }
+
+    /* add the copy, and the control byte for the next literal run */
+    if (op + 4 > maxout)
+    {
+      return 0;
+    }
+    off = ip - ref - 1;
+    if (len - 2 < 7)
+    {
+      out[op++] = (unsigned char)(((len - 2) << 5) | (off >> 8));
+    }
+    else
+    {
+      out[op++] = (unsigned char)((7 << 5) | (off >> 8));
+      out[op++] = (unsigned char)(len - 2 - 7);
+    }
+    out[op++] = (unsigned char)(off & 0xff);
+    ip += len;
+    lit = 0;
+    litpos = op++;
+  }
+
+  if (lit > 0)
+  {
+    out[litpos] = (unsigned char)(lit - 1);
+  }
+  else
+  {
+    op--;
+  }
+
+  return op;
+}
+
+/* Decompress into a buffer of exactly "outn" bytes, return zero if
+ * the compressed data is corrupt */
+static int bundle_decompress(
+  const unsigned char *in, size_t n, unsigned char *out, size_t outn)
+{
+  size_t ip = 0;
+  size_t op = 0;
+  size_t len, off;
+  unsigned int c;
+
+  while (ip < n)
+  {
+    c = in[ip++];
+    if (c < BUNDLE_LZ_MAX_LITERALS)
+    {
+      len = c + 1;
+      if (len > n - ip || len > outn - op)
+      {
+        return 0;
+      }
+      memcpy(&out[op], &in[ip], len);
+      ip += len;
+      op += len;
+    }
+    else
+    {
+      len = c >> 5;
+      if (len == 7)
+      {
+        if (ip >= n)
+        {
+          return 0;
+        }
+        len += in[ip++];
+      }
+      if (ip >= n)
+      {
+        return 0;
+      }
+      len += 2;
+      off = (((size_t)(c & 0x1f)) << 8) + in[ip++] + 1;
+      if (off > op || len > outn - op)
+      {
+        return 0;
+      }
+      /* the copy can overlap, so do it byte-by-byte */
+      for (; len > 0; len--, op++)
+      {
+        out[op] = out[op - off];
+      }
+    }
+  }
+
+  return (op == outn);
+}
+
+/* Create a writer */
+XMLBundleWriter *vtkWrapXMLBundle_NewWriter(int compress)
+{
+  XMLBundleWriter *writer;
+
+  writer = (XMLBundleWriter *)malloc(sizeof(XMLBundleWriter));
+  writer->Compress = compress;
+  writer->NumberOfEntries = 0;
+  writer->Entries = NULL;
+  writer->HashTable = NULL;
+  if (compress)
+  {
+    writer->HashTable = (size_t *)malloc(
+      (1 << BUNDLE_LZ_HASH_BITS)*sizeof(size_t));
+  }
+
+  return writer;
+}
+
+/* Add a document */
+void vtkWrapXMLBundle_AddDocument(
+  XMLBundleWriter *writer, const char *name, const char *text, size_t n)
+{
+  XMLBundleEntry *entry;
+  unsigned long m = writer->NumberOfEntries;
+  size_t l;
+
+  /* grow the array when its size is a power of two */
+  if (m == 0)
+  {
+    writer->Entries = (XMLBundleEntry *)malloc(sizeof(XMLBundleEntry));
+  }
+  else if ((m & (m - 1)) == 0)
+  {
+    writer->Entries = (XMLBundleEntry *)realloc(
+      writer->Entries, 2*m*sizeof(XMLBundleEntry));
+  }
+
+  entry = &writer->Entries[m];
+  l = strlen(name);
+  entry->Name = (char *)malloc(l + 1);
+  memcpy(entry->Name, name, l + 1);
+  entry->Size = n;
+  entry->Order = m;
+  entry->Data = (unsigned char *)malloc(n > 0 ? n : 1);
+  entry->StoredSize = 0;
+  entry->Compression = VTK_XML_BUNDLE_STORED;
+
+  /* keep the compressed document only if it is smaller */
+  if (writer->Compress)
+  {
+    entry->StoredSize = bundle_compress(
+      (const unsigned char *)text, n, entry->Data, n, writer->HashTable);
+  }
+  if (entry->StoredSize > 0 && entry->StoredSize < n)
+  {
+    entry->Compression = VTK_XML_BUNDLE_LZ;
+    entry->Data = (unsigned char *)realloc(entry->Data, entry->StoredSize);
+  }
+  else
+  {
+    memcpy(entry->Data, text, n);
+    entry->StoredSize = n;
+  }
+
+  writer->NumberOfEntries++;
+}
+
+/* Sort the entries by name, and then by the order they were added */
+static int bundle_compare_entries(const void *a, const void *b)
+{
+  const XMLBundleEntry *entry1 = (const XMLBundleEntry *)a;
+  const XMLBundleEntry *entry2 = (const XMLBundleEntry *)b;
+  int r = strcmp(entry1->Name, entry2->Name);
+
+  if (r == 0)
+  {
+    r = (entry1->Order < entry2->Order ? -1 : 1);
+  }
+
+  return r;
+}
+
+/* Build the bundle, and free the writer */
+char *vtkWrapXMLBundle_FinishWriter(XMLBundleWriter *writer, size_t *size)
+{
+  XMLBundleEntry *entries = writer->Entries;
+  unsigned long n = writer->NumberOfEntries;
+  unsigned long m = 0;
+  unsigned long nslots = 1;
+  unsigned long i, h;
+  size_t names_offset, data_offset, total, l;
+  size_t name_pos, data_pos;
+  unsigned char *bundle;
+  unsigned char *cp;
+
+  /* sort, and keep only the last document added for each name */
+  if (n > 0)
+  {
+    qsort(entries, n, sizeof(XMLBundleEntry), bundle_compare_entries);
+  }
+  for (i = 0; i < n; i++)
+  {
+    if (i + 1 < n && strcmp(entries[i].Name, entries[i+1].Name) == 0)
+    {
+      free(entries[i].Name);
+      free(entries[i].Data);
+      continue;
+    }
+    entries[m++] = entries[i];
+  }
+  n = m;
+
+  /* keep the hash table at most half full */
+  while (nslots < 2*n)
+  {
+    nslots <<= 1;
+  }
+
+  /* compute the layout */
+  names_offset = BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*nslots +
+    BUNDLE_ENTRY_SIZE*n;
+  data_offset = names_offset;
+  for (i = 0; i < n; i++)
+  {
+    data_offset += strlen(entries[i].Name) + 1;
+  }
+  total = data_offset;
+  for (i = 0; i < n; i++)
+  {
+    total += entries[i].StoredSize;
+  }
+
+  bundle = (unsigned char *)calloc(total, 1);
+
+  /* the header */
+  memcpy(bundle, "VTKXMLB", 8);
+  bundle_put32(&bundle[8], VTK_XML_BUNDLE_VERSION);
+  bundle_put32(&bundle[12], 0);
+  bundle_put32(&bundle[16], n);
+  bundle_put32(&bundle[20], nslots);
+  bundle_put32(&bundle[24], names_offset);
+  bundle_put32(&bundle[28], data_offset);
+
+  /* the entries, names, and data */
+  name_pos = names_offset;
+  data_pos = data_offset;
+  for (i = 0; i < n; i++)
+  {
+    l = strlen(entries[i].Name);
+    cp = &bundle[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*nslots +
+                 BUNDLE_ENTRY_SIZE*i];
+    bundle_put32(&cp[0], name_pos);
+    bundle_put32(&cp[4], l);
+    bundle_put32(&cp[8], data_pos);
+    bundle_put32(&cp[12], entries[i].StoredSize);
+    bundle_put32(&cp[16], entries[i].Size);
+    bundle_put32(&cp[20], entries[i].Compression);
+
+    memcpy(&bundle[name_pos], entries[i].Name, l + 1);
+    name_pos += l + 1;
+    if (entries[i].StoredSize > 0)
+    {
+      memcpy(&bundle[data_pos], entries[i].Data, entries[i].StoredSize);
+    }
+    data_pos += entries[i].StoredSize;
+
+    /* add the entry to the hash table */
+    h = bundle_hash(entries[i].Name, l) & (nslots - 1);
+    while (bundle_get32(&bundle[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*h]))
+    {
+      h = (h + 1) & (nslots - 1);
+    }
+    bundle_put32(&bundle[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*h], i + 1);
+
+    free(entries[i].Name);
+    free(entries[i].Data);
+  }
+
+  free(writer->Entries);
+  free(writer->HashTable);
+  free(writer);
+
+  *size = total;
+  return (char *)bundle;
+}
+
+/* Map a file into memory, return NULL on failure */
+static const unsigned char *bundle_map_file(
+  const char *filename, size_t *size)
+{
+  const unsigned char *data = NULL;
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE file;
+  HANDLE mapping;
+  LARGE_INTEGER filesize;
+
+  file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return NULL;
+  }
+  if (GetFileSizeEx(file, &filesize) && filesize.QuadPart > 0 &&
+      filesize.HighPart == 0)
+  {
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+    {
+      data = (const unsigned char *)MapViewOfFile(
+        mapping, FILE_MAP_READ, 0, 0, 0);
+      *size = (size_t)filesize.LowPart;
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  struct stat fs;
+  void *map;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    return NULL;
+  }
+  if (fstat(fd, &fs) == 0 && fs.st_size > 0)
+  {
+    map = mmap(NULL, (size_t)fs.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED)
+    {
+      data = (const unsigned char *)map;
+      *size = (size_t)fs.st_size;
+    }
+  }
+  close(fd);
+#endif
+
+  return data;
+}
+
+/* Unmap a file */
+static void bundle_unmap_file(const unsigned char *data, size_t size)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  (void)size;
+  UnmapViewOfFile(data);
+#else
+  munmap((void *)data, size);
+#endif
+}
+
+/* Check that the bundle is valid, so that the lookups can be fast */
+static int bundle_check(const unsigned char *data, size_t size)
+{
+  unsigned long n, nslots, i;
+  size_t names_offset, data_offset;
+  size_t name_pos, name_len, data_pos, stored, docsize;
+  const unsigned char *cp;
+
+  if (size < BUNDLE_HEADER_SIZE || memcmp(data, "VTKXMLB", 8) != 0 ||
+      bundle_get32(&data[8]) != VTK_XML_BUNDLE_VERSION)
+  {
+    return 0;
+  }
+
+  n = bundle_get32(&data[16]);
+  nslots = bundle_get32(&data[20]);
+  names_offset = bundle_get32(&data[24]);
+  data_offset = bundle_get32(&data[28]);
+
+  /* there must be at least one empty slot */
+  if (nslots <= n || (nslots & (nslots - 1)) != 0 ||
+      nslots > size/BUNDLE_SLOT_SIZE || n > size/BUNDLE_ENTRY_SIZE ||
+      names_offset != (BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*nslots +
+                       BUNDLE_ENTRY_SIZE*n) ||
+      names_offset > data_offset || data_offset > size)
+  {
+    return 0;
+  }
+
+  for (i = 0; i < nslots; i++)
+  {
+    if (bundle_get32(&data[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*i]) > n)
+    {
+      return 0;
+    }
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    cp = &data[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*nslots +
+               BUNDLE_ENTRY_SIZE*i];
+    name_pos = bundle_get32(&cp[0]);
+    name_len = bundle_get32(&cp[4]);
+    data_pos = bundle_get32(&cp[8]);
+    stored = bundle_get32(&cp[12]);
+    docsize = bundle_get32(&cp[16]);
+    if (name_pos < names_offset || name_pos >= data_offset ||
+        name_len >= data_offset - name_pos || data[name_pos + name_len] != 0 ||
+        data_pos < data_offset || data_pos > size || stored > size - data_pos)
+    {
+      return 0;
+    }
+    switch (bundle_get32(&cp[20]))
+    {
+      case VTK_XML_BUNDLE_STORED:
+        if (stored != docsize)
+        {
+          return 0;
+        }
+        break;
+      case VTK_XML_BUNDLE_LZ:
+        break;
+      default:
+        return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* Open a bundle */
+XMLBundleInfo *vtkWrapXMLBundle_ReadFile(const char *filename)
+{
+  XMLBundleInfo *info;
+  const unsigned char *data;
+  size_t size = 0;
+
+  data = bundle_map_file(filename, &size);
+  if (data == NULL)
+  {
+    return NULL;
+  }
+
+  if (!bundle_check(data, size))
+  {
+    bundle_unmap_file(data, size);
+    return NULL;
+  }
+
+  info = (XMLBundleInfo *)malloc(sizeof(XMLBundleInfo));
+  info->Data = data;
+  info->Size = size;
+  info->NumberOfEntries = bundle_get32(&data[16]);
+  info->NumberOfSlots = bundle_get32(&data[20]);
+  info->Documents = NULL;
+
+  return info;
+}
+
+/* Close a bundle */
+void vtkWrapXMLBundle_Free(XMLBundleInfo *info)
+{
+  unsigned long i;
+
+  if (info->Documents)
+  {
+    for (i = 0; i < info->NumberOfEntries; i++)
+    {
+      free(info->Documents[i]);
+    }
+    free(info->Documents);
+  }
+
+  bundle_unmap_file(info->Data, info->Size);
+  free(info);
+}
+
+/* Get the entry data for entry "i" */
+static const unsigned char *bundle_entry(const XMLBundleInfo *info, int i)
+{
+  return &info->Data[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*info->NumberOfSlots +
+                     BUNDLE_ENTRY_SIZE*i];
+}
+
+/* Find an entry by name */
+int vtkWrapXMLBundle_FindEntry(const XMLBundleInfo *info, const char *name)
+{
+  const unsigned char *cp;
+  unsigned long mask = info->NumberOfSlots - 1;
+  unsigned long h, s, i;
+  size_t l = strlen(name);
+
+  h = bundle_hash(name, l) & mask;
+  for (i = 0; i < info->NumberOfSlots; i++)
+  {
+    s = bundle_get32(&info->Data[BUNDLE_HEADER_SIZE + BUNDLE_SLOT_SIZE*h]);
+    if (s == 0)
+    {
+      break;
+    }
+    cp = bundle_entry(info, (int)(s - 1));
+    if (bundle_get32(&cp[4]) == l &&
+        memcmp(&info->Data[bundle_get32(&cp[0])], name, l) == 0)
+    {
+      return (int)(s - 1);
+    }
+    h = (h + 1) & mask;
+  }
+
+  return -1;
+}
+
+/* Get the class name for an entry */
+const char *vtkWrapXMLBundle_GetName(const XMLBundleInfo *info, int i)
+{
+  if (i < 0 || (unsigned long)i >= info->NumberOfEntries)
+  {
+    return NULL;
+  }
+
+  return (const char *)&info->Data[bundle_get32(bundle_entry(info, i))];
+}
+
+/* Get the document for an entry, inflate it if necessary */
+const char *vtkWrapXMLBundle_GetDocument(
+  XMLBundleInfo *info, int i, size_t *length)
+{
+  const unsigned char *cp;
+  const unsigned char *data;
+  size_t stored, size;
+  char *text;
+
+  if (i < 0 || (unsigned long)i >= info->NumberOfEntries)
+  {
+    return NULL;
+  }
+
+  cp = bundle_entry(info, i);
+  data = &info->Data[bundle_get32(&cp[8])];
+  stored = bundle_get32(&cp[12]);
+  size = bundle_get32(&cp[16]);
+  *length = size;
+
+  if (bundle_get32(&cp[20]) == VTK_XML_BUNDLE_STORED)
+  {
+    return (const char *)data;
+  }
+
+  /* inflate the document only once */
+  if (info->Documents == NULL)
+  {
+    info->Documents = (char **)calloc(info->NumberOfEntries, sizeof(char *));
+  }
+  if (info->Documents[i] == NULL)
+  {
+    text = (char *)malloc(size > 0 ? size : 1);
+    if (!bundle_decompress(data, stored, (unsigned char *)text, size))
+    {
+      free(text);
+      return NULL;
+    }
+    info->Documents[i] = text;
+  }
+
+  return info->Documents[i];
+}
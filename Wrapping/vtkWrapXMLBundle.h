@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapXMLBundle.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file provides a writer and a reader for XML bundles.
+
+ A bundle holds the XML documents for all the classes in a kit, so
+ that the wrappers do not have to write (and the consumers do not have
+ to read) thousands of small files.  All integers in the bundle are
+ 32-bit little-endian, and all offsets are from the start of the file:
+
+ header:   "VTKXMLB\0", version, flags, number of entries,
+           number of slots, offset of names, offset of data
+ slots:    a hash table of the class names, each slot holds an entry
+           index plus one, or zero if the slot is empty
+ entries:  name offset, name length, data offset, stored size,
+           document size, compression (one set per entry)
+ names:    the class names, each followed by a nul
+ data:     the documents, which are not nul-terminated
+
+ The entries are sorted by name, so the same documents always give the
+ same bundle.  A document is stored compressed if "compress" was set
+ for the writer and if compression made it smaller.  The compression
+ is a simple LZ77 scheme that is built into this file.
+
+ The reader maps the bundle into memory, and a document can be found
+ with a single hash lookup.  Uncompressed documents are returned
+ directly from the mapped memory.  This file does not depend on the
+ parser, so consumers can build it on its own.
+*/
+
+#ifndef VTK_WRAP_XML_BUNDLE_H
+#define VTK_WRAP_XML_BUNDLE_H
+
+#include <stddef.h>
+
+/**
+ * The bundle version, change this when the layout changes
+ */
+#define VTK_XML_BUNDLE_VERSION 1
+
+/**
+ * The compression methods for the entries
+ */
+#define VTK_XML_BUNDLE_STORED 0
+#define VTK_XML_BUNDLE_LZ 1
+
+/**
+ * A bundle writer, the documents are kept in memory until the end
+ */
+typedef struct _XMLBundleWriter XMLBundleWriter;
+
+/**
+ * A bundle that has been opened for reading
+ */
+typedef struct _XMLBundleInfo
+{
+  const unsigned char *Data;   /* the contents of the bundle file */
+  size_t               Size;   /* the size of the bundle file */
+  unsigned long        NumberOfEntries;
+  unsigned long        NumberOfSlots;
+  char               **Documents; /* the documents that were inflated */
+} XMLBundleInfo;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Create a writer.  If "compress" is set, the documents are compressed.
+ */
+XMLBundleWriter *vtkWrapXMLBundle_NewWriter(int compress);
+
+/**
+ * Add a document to the bundle, the text is copied.  If a document
+ * with the same name was already added, then it is replaced.
+ */
+void vtkWrapXMLBundle_AddDocument(
+  XMLBundleWriter *writer, const char *name, const char *text, size_t n);
+
+/**
+ * Get the contents of the bundle file, and free the writer.  The
+ * contents must be freed with free().
+ */
+char *vtkWrapXMLBundle_FinishWriter(XMLBundleWriter *writer, size_t *size);
+
+/**
+ * Open a bundle file.  Returns NULL if the file could not be read, or
+ * if it is not a valid bundle.
+ */
+XMLBundleInfo *vtkWrapXMLBundle_ReadFile(const char *filename);
+
+/**
+ * Close a bundle, and free any documents that were inflated.
+ */
+void vtkWrapXMLBundle_Free(XMLBundleInfo *info);
+
+/**
+ * Find the entry for a class.  Returns -1 if not found.
+ */
+int vtkWrapXMLBundle_FindEntry(const XMLBundleInfo *info, const char *name);
+
+/**
+ * Get the class name for an entry.
+ */
+const char *vtkWrapXMLBundle_GetName(const XMLBundleInfo *info, int i);
+
+/**
+ * Get the XML document for an entry, and set "length" to its size.
+ * The document is not nul-terminated.  The pointer is valid until the
+ * bundle is freed.  Returns NULL if the document is corrupt.
+ */
+const char *vtkWrapXMLBundle_GetDocument(
+  XMLBundleInfo *info, int i, size_t *length);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,2356 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapXMLWriter.c
+
+  Copyright (c) 2010 David Gobbi
+  All rights reserved.
+
+  Copyright (c) 2008, Queen's University, Kingston, Ontario, Canada
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ This file holds the XML writer that is shared by vtkWrapXML and
+ vtkWrapJSON.  The main entry point is vtkWrapXML_Run(), which parses
+ the headers given on the command line and writes the output.  The
+ vtkWrapXML_Body() function and the others that are declared in
+ vtkWrapXMLWriter.h can be used to write the FileInfo that
+ vtkParse.tab.c creates from a header.
+
+ Only the element, attribute, and text functions look at the format,
+ so the two programs always write the same content.  In JSON, each
+ element is an object with a "tag", its attributes, a "text" string
+ for any text content, and a "children" array for any sub-elements.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "vtkWrapXMLWriter.h"
+#include "vtkParse.h"
+#include "vtkParseExtras.h"
+#include "vtkParseProperties.h"
+#include "vtkParseHierarchy.h"
+#include "vtkWrapXMLBundle.h"
+#include "vtkParseMerge.h"
+#include "vtkParseMain.h"
+#include "vtkParseTiming.h"
+#include "vtkConfigure.h"
+
+/* Use SSE2 to find the chars that need escaping, 16 bytes at a time,
+ * if it is available.  There is no path for wider vectors. */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTKXML_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* ----- XML utility functions ----- */
+
+/* The indentation string, default is two spaces */
+#define VTKXML_INDENT "  "
+
+/* indent to the specified indentation level */
+static const char *indent(int indentation)
+{
+  static const char *indentString[6] = {
+    "",
+    VTKXML_INDENT,
+    VTKXML_INDENT VTKXML_INDENT,
+    VTKXML_INDENT VTKXML_INDENT VTKXML_INDENT,
+    VTKXML_INDENT VTKXML_INDENT VTKXML_INDENT VTKXML_INDENT,
+    VTKXML_INDENT VTKXML_INDENT VTKXML_INDENT VTKXML_INDENT VTKXML_INDENT,
+  };
+
+  /* after 6 indentation levels, go back to zero */
+  return indentString[indentation % 6];
+}
+
+/* The output is written to the file in blocks of this size */
+#define VTKXML_BUFFER_SIZE 65536
+
+/**
+ * Write the buffered output to the file, if there is a file
+ */
+static void vtkWrapXML_Flush(wrapxml_state_t *w)
+{
+  if (w->file && w->length > 0)
+  {
+    fwrite(w->buffer, 1, w->length, w->file);
+    w->length = 0;
+  }
+}
+
+/**
+ * Make room for at least n more chars in the buffer, and return a
+ * pointer to the end of the buffered output
+ */
+static char *vtkWrapXML_Reserve(wrapxml_state_t *w, size_t n)
+{
+  if (w->length + n > w->size)
+  {
+    vtkWrapXML_Flush(w);
+    if (w->length + n > w->size)
+    {
+      /* if there is no file, then all output is kept in the buffer */
+      w->size *= 2;
+      if (w->length + n > w->size)
+      {
+        w->size = w->length + n;
+      }
+      w->buffer = (char *)realloc(w->buffer, w->size);
+    }
+  }
+
+  return &w->buffer[w->length];
+}
+
+/**
+ * Append n chars to the output
+ */
+static void vtkWrapXML_Write(wrapxml_state_t *w, const char *text, size_t n)
+{
+  memcpy(vtkWrapXML_Reserve(w, n), text, n);
+  w->length += n;
+}
+
+/**
+ * Append a string to the output
+ */
+static void vtkWrapXML_Puts(wrapxml_state_t *w, const char *text)
+{
+  vtkWrapXML_Write(w, text, strlen(text));
+}
+
+/**
+ * Append a single char to the output
+ */
+static void vtkWrapXML_Putc(wrapxml_state_t *w, char c)
+{
+  *vtkWrapXML_Reserve(w, 1) = c;
+  w->length++;
+}
+
+/**
+ * Append the indentation for the current level to the output
+ */
+static void vtkWrapXML_Indent(wrapxml_state_t *w)
+{
+  vtkWrapXML_Puts(w, indent(w->indentation));
+}
+
+/**
+ * Initialize the state, the output will be written to the file, or
+ * kept in the buffer if the file is NULL
+ */
+void vtkWrapXML_InitState(
+  wrapxml_state_t *w, FileInfo *data, FILE *fp, int format)
+{
+  w->data = data;
+  w->file = fp;
+  w->format = format;
+  w->indentation = 0;
+  w->unclosed = 0;
+  w->depth = 0;
+  w->textopen = 0;
+  w->children = NULL;
+  w->size = VTKXML_BUFFER_SIZE;
+  w->buffer = (char *)malloc(w->size);
+  w->length = 0;
+}
+
+/**
+ * Write any remaining output to the file, and free the buffer
+ */
+void vtkWrapXML_FinishState(wrapxml_state_t *w)
+{
+  vtkWrapXML_Flush(w);
+  free(w->buffer);
+  free(w->children);
+  w->buffer = NULL;
+  w->children = NULL;
+  w->size = 0;
+}
+
+/**
+ * How each char is handled when quoting: 0 for chars that are copied,
+ * 1 for chars that are dropped, and 2 for chars that become entities.
+ * Only printable ASCII and whitespace are kept, as in the "C" locale.
+ */
+static const unsigned char vtkWrapXML_CharType[256] = {
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 2, 0, 0, 0, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 2, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+/**
+ * Get the length of the leading run of chars that can be copied as-is
+ */
+static size_t vtkWrapXML_PlainLength(const char *text, size_t n)
+{
+  size_t i = 0;
+
+#ifdef VTKXML_USE_SSE2
+  /* skip blocks of 16 chars that are printable and need no escaping,
+   * the block that holds the first special char is done bytewise */
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i del = _mm_set1_epi8(0x7f);
+  const __m128i lt = _mm_set1_epi8('<');
+  const __m128i gt = _mm_set1_epi8('>');
+  const __m128i amp = _mm_set1_epi8('&');
+  const __m128i quot = _mm_set1_epi8('\"');
+  const __m128i apos = _mm_set1_epi8('\'');
+  __m128i b, m;
+
+  while (i + 16 <= n)
+  {
+    b = _mm_loadu_si128((const __m128i *)&text[i]);
+    /* signed compare, so this finds controls and non-ASCII */
+    m = _mm_cmplt_epi8(b, space);
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(b, del));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(b, lt));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(b, gt));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(b, amp));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(b, quot));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(b, apos));
+    if (_mm_movemask_epi8(m) != 0)
+    {
+      break;
+    }
+    i += 16;
+  }
+#endif
+
+  while (i < n && vtkWrapXML_CharType[(unsigned char)text[i]] == 0)
+  {
+    i++;
+  }
+
+  return i;
+}
+
+/**
+ * Convert special characters in a string into their escape codes,
+ * so that the string can be quoted in an xml file, and append the
+ * result to the output (the specified maxlen must be at least 32 chars).
+ * If the result would reach maxlen-5 chars, it is cut off there and
+ * an ellipsis is added.
+ */
+static void vtkWrapXML_Quote(
+  wrapxml_state_t *w, const char *comment, size_t maxlen)
+{
+  char *result;
+  const char *entity;
+  size_t limit = maxlen - 5;
+  size_t i, j, k, l, n;
+
+  if (comment == NULL)
+  {
+    return;
+  }
+
+  /* the longest result is maxlen plus an ellipsis */
+  result = vtkWrapXML_Reserve(w, maxlen + 8);
+  n = strlen(comment);
+  i = 0;
+  j = 0;
+
+  while (i < n)
+  {
+    /* copy the chars that need no escaping as a block */
+    k = vtkWrapXML_PlainLength(&comment[i], n - i);
+    if (j + k >= limit)
+    {
+      memcpy(&result[j], &comment[i], limit - j);
+      j = limit;
+      break;
+    }
+    memcpy(&result[j], &comment[i], k);
+    i += k;
+    j += k;
+
+    if (i == n)
+    {
+      break;
+    }
+
+    /* expand or drop the char that stopped the block */
+    if (vtkWrapXML_CharType[(unsigned char)comment[i]] == 2)
+    {
+      switch (comment[i])
+      {
+        case '<':
+          entity = "&lt;";
+          break;
+        case '>':
+          entity = "&gt;";
+          break;
+        case '&':
+          entity = "&amp;";
+          break;
+        case '\"':
+          entity = "&quot;";
+          break;
+        default:
+          entity = "&apos;";
+          break;
+      }
+      l = strlen(entity);
+      memcpy(&result[j], entity, l);
+      j += l;
+      if (j >= limit)
+      {
+        break;
+      }
+    }
+    i++;
+  }
+
+  /* add trailing ellipsis if too long */
+  if (j >= limit)
+  {
+    memcpy(&result[j], " ...", 4);
+    j += 4;
+  }
+
+  w->length += j;
+}
+
+/**
+ * Escape a string for a JSON string literal, and append the result
+ * to the output.  The chars that vtkWrapXML_Quote() drops are dropped
+ * here, too, and the result is cut off at the same place, so "k" counts
+ * the chars that vtkWrapXML_Quote() would have written.
+ */
+static void vtkWrapXML_QuoteJSON(
+  wrapxml_state_t *w, const char *comment, size_t maxlen)
+{
+  char *result;
+  size_t limit = maxlen - 5;
+  size_t i, j, k, n;
+  unsigned char c;
+
+  if (comment == NULL)
+  {
+    return;
+  }
+
+  /* each char becomes at most six chars, plus four for the ellipsis */
+  n = strlen(comment);
+  result = vtkWrapXML_Reserve(w, 6*(n < maxlen ? n : maxlen) + 8);
+  j = 0;
+  k = 0;
+
+  for (i = 0; i < n && k < limit; i++)
+  {
+    c = (unsigned char)comment[i];
+    if (vtkWrapXML_CharType[c] == 1)
+    {
+      continue;
+    }
+
+    /* the length of the xml entity for the char */
+    switch (c)
+    {
+      case '<':
+      case '>':
+        k += 4;
+        break;
+      case '&':
+        k += 5;
+        break;
+      case '\"':
+      case '\'':
+        k += 6;
+        break;
+      default:
+        k++;
+        break;
+    }
+
+    if (c == '\"' || c == '\\')
+    {
+      result[j++] = '\\';
+      result[j++] = (char)c;
+    }
+    else if (c < 0x20)
+    {
+      result[j++] = '\\';
+      switch (c)
+      {
+        case '\t':
+          result[j++] = 't';
+          break;
+        case '\n':
+          result[j++] = 'n';
+          break;
+        case '\r':
+          result[j++] = 'r';
+          break;
+        case '\f':
+          result[j++] = 'f';
+          break;
+        default:
+          memcpy(&result[j], "u000b", 5);
+          j += 5;
+          break;
+      }
+    }
+    else
+    {
+      result[j++] = (char)c;
+    }
+  }
+
+  /* add trailing ellipsis if too long */
+  if (k >= limit)
+  {
+    memcpy(&result[j], " ...", 4);
+    j += 4;
+  }
+
+  w->length += j;
+}
+
+/**
+ * Escape a string for a JSON string literal, and append the result to
+ * the output.  Unlike vtkWrapXML_QuoteJSON(), nothing is dropped and
+ * there is no length limit, because this is for attribute text that
+ * vtkWrapXML writes as-is: only quotes, backslashes, and control chars
+ * are escaped, and non-ASCII bytes are passed through unchanged.
+ */
+static void vtkWrapXML_EscapeJSON(wrapxml_state_t *w, const char *text)
+{
+  static const char hexdigits[] = "0123456789abcdef";
+  char *result;
+  size_t i, j, n;
+  unsigned char c;
+
+  /* each char becomes at most six chars */
+  n = strlen(text);
+  result = vtkWrapXML_Reserve(w, 6*n);
+  j = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    c = (unsigned char)text[i];
+    if (c == '\"' || c == '\\')
+    {
+      result[j++] = '\\';
+      result[j++] = (char)c;
+    }
+    else if (c < 0x20)
+    {
+      result[j++] = '\\';
+      switch (c)
+      {
+        case '\t':
+          result[j++] = 't';
+          break;
+        case '\n':
+          result[j++] = 'n';
+          break;
+        case '\r':
+          result[j++] = 'r';
+          break;
+        case '\f':
+          result[j++] = 'f';
+          break;
+        default:
+          memcpy(&result[j], "u00", 3);
+          result[j + 3] = hexdigits[c >> 4];
+          result[j + 4] = hexdigits[c & 0xf];
+          j += 5;
+          break;
+      }
+    }
+    else
+    {
+      result[j++] = (char)c;
+    }
+  }
+
+  w->length += j;
+}
+
+/**
+ * Close the "text" string of the current JSON element, if it is open
+ */
+static void vtkWrapXML_CloseText(wrapxml_state_t *w)
+{
+  if (w->textopen)
+  {
+    vtkWrapXML_Putc(w, '\"');
+    w->textopen = 0;
+  }
+}
+
+/**
+ * Print one line of element text, made of a prefix that needs no
+ * escaping followed by the quoted text, either of which can be NULL.
+ */
+static void vtkWrapXML_TextLine(
+  wrapxml_state_t *w, const char *prefix, const char *text)
+{
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    if (!w->textopen)
+    {
+      vtkWrapXML_Write(w, ",\"text\":\"", 9);
+      w->textopen = 1;
+    }
+    if (prefix)
+    {
+      vtkWrapXML_Puts(w, prefix);
+    }
+    vtkWrapXML_QuoteJSON(w, text, 500);
+    vtkWrapXML_Write(w, "\\n", 2);
+    return;
+  }
+
+  if ((prefix && prefix[0] != '\0') || (text && text[0] != '\0'))
+  {
+    vtkWrapXML_Indent(w);
+    if (prefix)
+    {
+      vtkWrapXML_Puts(w, prefix);
+    }
+    vtkWrapXML_Quote(w, text, 500);
+  }
+  vtkWrapXML_Putc(w, '\n');
+}
+
+/**
+ * Print a blank line between elements, which is only done for XML
+ */
+static void vtkWrapXML_BlankLine(wrapxml_state_t *w)
+{
+  if (w->format == VTKXML_FORMAT_XML)
+  {
+    vtkWrapXML_Putc(w, '\n');
+  }
+}
+
+/**
+ * Print multi-line text at the specified indentation level.
+ */
+static void vtkWrapXML_MultiLineText(wrapxml_state_t *w, const char *cp)
+{
+  size_t i = 0;
+  size_t j;
+  char temp[512];
+
+  while (cp && cp[i] != '\0')
+  {
+    for (j = 0; j < 200 && cp[i] != '\0' && cp[i] != '\n'; j++)
+    {
+      temp[j] = cp[i++];
+    }
+
+    while (j > 0 &&
+           (temp[j-1] == ' ' || temp[j-1] == '\t' || temp[j-1] == '\r'))
+    {
+      j--;
+    }
+
+    temp[j] = '\0';
+
+    vtkWrapXML_TextLine(w, NULL, temp);
+    if (cp[i] == '\n')
+    {
+      i++;
+    }
+  }
+}
+
+/**
+ * Mark the beginning of the element body
+ */
+void vtkWrapXML_ElementBody(wrapxml_state_t *w)
+{
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    return;
+  }
+
+  if (w->unclosed)
+  {
+    vtkWrapXML_Write(w, ">\n", 2);
+  }
+  w->unclosed = 0;
+}
+
+/**
+ * Print an element start tag
+ */
+void vtkWrapXML_ElementStart(wrapxml_state_t *w, const char *name)
+{
+  int n;
+
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    /* the first sub-element opens the parent's "children" array */
+    vtkWrapXML_CloseText(w);
+    n = w->depth;
+    if (n > 0)
+    {
+      if (w->children[n-1])
+      {
+        vtkWrapXML_Putc(w, ',');
+      }
+      else
+      {
+        vtkWrapXML_Write(w, ",\"children\":[", 13);
+        w->children[n-1] = 1;
+      }
+      vtkWrapXML_Putc(w, '\n');
+    }
+    if (n == 0 || (n & (n - 1)) == 0)
+    {
+      w->children = (char *)realloc(w->children, (n == 0 ? 1 : 2*n));
+    }
+    w->children[w->depth++] = 0;
+    vtkWrapXML_Puts(w, indent(n));
+    vtkWrapXML_Write(w, "{\"tag\":\"", 8);
+    vtkWrapXML_Puts(w, name);
+    vtkWrapXML_Putc(w, '\"');
+    return;
+  }
+
+  vtkWrapXML_ElementBody(w);
+  vtkWrapXML_Indent(w);
+  vtkWrapXML_Putc(w, '<');
+  vtkWrapXML_Puts(w, name);
+  w->unclosed = 1;
+  w->indentation++;
+}
+
+/**
+ * Print an element end tag
+ */
+void vtkWrapXML_ElementEnd(wrapxml_state_t *w, const char *name)
+{
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    vtkWrapXML_CloseText(w);
+    if (w->children[--w->depth])
+    {
+      vtkWrapXML_Putc(w, ']');
+    }
+    vtkWrapXML_Putc(w, '}');
+    if (w->depth == 0)
+    {
+      vtkWrapXML_Putc(w, '\n');
+    }
+    return;
+  }
+
+  w->indentation--;
+  if (w->unclosed)
+  {
+    vtkWrapXML_Write(w, " />\n", 4);
+  }
+  else
+  {
+    vtkWrapXML_Indent(w);
+    vtkWrapXML_Write(w, "</", 2);
+    vtkWrapXML_Puts(w, name);
+    vtkWrapXML_Write(w, ">\n", 2);
+  }
+  w->unclosed = 0;
+}
+
+/**
+ * Print the name of an attribute and open its value
+ */
+static void vtkWrapXML_AttributeStart(wrapxml_state_t *w, const char *name)
+{
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    vtkWrapXML_Write(w, ",\"", 2);
+    vtkWrapXML_Puts(w, name);
+    vtkWrapXML_Write(w, "\":\"", 3);
+  }
+  else
+  {
+    vtkWrapXML_Putc(w, ' ');
+    vtkWrapXML_Puts(w, name);
+    vtkWrapXML_Write(w, "=\"", 2);
+  }
+}
+
+/**
+ * Append text to an attribute value, only JSON needs it to be escaped
+ */
+static void vtkWrapXML_AttributeText(wrapxml_state_t *w, const char *text)
+{
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    vtkWrapXML_EscapeJSON(w, text);
+  }
+  else
+  {
+    vtkWrapXML_Puts(w, text);
+  }
+}
+
+/**
+ * Close an attribute value
+ */
+static void vtkWrapXML_AttributeEnd(wrapxml_state_t *w)
+{
+  vtkWrapXML_Putc(w, '\"');
+}
+
+/**
+ * Append quoted text to an attribute value
+ */
+static void vtkWrapXML_AttributeQuote(wrapxml_state_t *w, const char *value)
+{
+  if (w->format == VTKXML_FORMAT_JSON)
+  {
+    vtkWrapXML_QuoteJSON(w, value, 500);
+  }
+  else
+  {
+    vtkWrapXML_Quote(w, value, 500);
+  }
+}
+
+/**
+ * Print an attribute
+ */
+void vtkWrapXML_Attribute(
+  wrapxml_state_t *w, const char *name, const char *value)
+{
+  vtkWrapXML_AttributeStart(w, name);
+  vtkWrapXML_AttributeQuote(w, value);
+  vtkWrapXML_AttributeEnd(w);
+}
+
+/**
+ * Print an attribute with a prefixed value
+ */
+void vtkWrapXML_AttributeWithPrefix(
+  wrapxml_state_t *w, const char *name, const char *prefix, const char *value)
+{
+  vtkWrapXML_AttributeStart(w, name);
+  vtkWrapXML_AttributeText(w, prefix);
+  vtkWrapXML_AttributeQuote(w, value);
+  vtkWrapXML_AttributeEnd(w);
+}
+
+/**
+ * Print a size attribute
+ */
+void vtkWrapXML_Size(wrapxml_state_t *w, ValueInfo *val)
+{
+  unsigned long ndims = val->NumberOfDimensions;
+  unsigned long j;
+
+  if (ndims > 0)
+  {
+    vtkWrapXML_AttributeStart(w, "size");
+    if (ndims > 1)
+    {
+      vtkWrapXML_Putc(w, '{');
+    }
+    for (j = 0; j < ndims; j++)
+    {
+      if (j > 0)
+      {
+        vtkWrapXML_Putc(w, ',');
+      }
+      vtkWrapXML_AttributeText(w,
+        ((val->Dimensions[j][0] == '\0') ? ":" : val->Dimensions[j]));
+    }
+    if (ndims > 1)
+    {
+      vtkWrapXML_Putc(w, '}');
+    }
+    vtkWrapXML_AttributeEnd(w);
+  }
+}
+
+void vtkWrapXML_Pointer(wrapxml_state_t *w, ValueInfo *val)
+{
+  unsigned long ndims = val->NumberOfDimensions;
+  unsigned int type = val->Type;
+  unsigned int bits;
+  char text[128];
+  int i = 0;
+
+  if ((type & VTK_PARSE_INDIRECT) == VTK_PARSE_BAD_INDIRECT)
+  {
+    vtkWrapXML_Attribute(w, "pointer", "unknown");
+    return;
+  }
+
+  type = (type & VTK_PARSE_POINTER_MASK);
+
+  if (ndims > 0)
+  {
+    type = ((type >> 2) & VTK_PARSE_POINTER_MASK);
+  }
+
+  while (type)
+  {
+    bits = (type & VTK_PARSE_POINTER_LOWMASK);
+    type = ((type >> 2) & VTK_PARSE_POINTER_MASK);
+
+    if (bits == VTK_PARSE_ARRAY)
+    {
+      strncpy(&text[i], "*array", 6);
+      i += 6;
+    }
+    else if (bits == VTK_PARSE_CONST_POINTER)
+    {
+      strncpy(&text[i], "*const", 6);
+      i += 6;
+    }
+    else
+    {
+      text[i++] = '*';
+    }
+  }
+
+  if (i > 0)
+  {
+    text[i++] = '\0';
+    vtkWrapXML_Attribute(w, "pointer", text);
+  }
+}
+
+/**
+ * Print the comment as multi-line text
+ */
+void vtkWrapXML_Comment(wrapxml_state_t *w, const char *comment)
+{
+  const char *elementName = "comment";
+
+  if (comment)
+  {
+    vtkWrapXML_ElementStart(w, elementName);
+    vtkWrapXML_ElementBody(w);
+    vtkWrapXML_MultiLineText(w, comment);
+    vtkWrapXML_ElementEnd(w, elementName);
+  }
+}
+
+/**
+ * Print the access level
+ */
+void vtkWrapXML_Access(wrapxml_state_t *w, parse_access_t access)
+{
+  const char *cp = "public";
+
+  switch (access)
+  {
+    case VTK_ACCESS_PUBLIC:
+      cp = "public";
+      break;
+    case VTK_ACCESS_PROTECTED:
+      cp = "protected";
+      break;
+    case VTK_ACCESS_PRIVATE:
+      cp = "private";
+      break;
+  }
+
+  vtkWrapXML_Attribute(w, "access", cp);
+}
+
+/**
+ * Print a boolean attribute
+ */
+void vtkWrapXML_Flag(wrapxml_state_t *w, const char *name, int value)
+{
+  if (value && w->format == VTKXML_FORMAT_JSON)
+  {
+    vtkWrapXML_Write(w, ",\"", 2);
+    vtkWrapXML_Puts(w, name);
+    vtkWrapXML_Write(w, "\":true", 6);
+  }
+  else if (value)
+  {
+    vtkWrapXML_Putc(w, ' ');
+    vtkWrapXML_Puts(w, name);
+    vtkWrapXML_Write(w, "=\"1\"", 4);
+  }
+}
+
+/**
+ * Print the name attribute
+ */
+void vtkWrapXML_Name(wrapxml_state_t *w, const char *name)
+{
+  vtkWrapXML_Attribute(w, "name", name);
+}
+
+/**
+ * Print the value attribute
+ */
+void vtkWrapXML_Value(wrapxml_state_t *w, const char *value)
+{
+  vtkWrapXML_Attribute(w, "value", value);
+}
+
+/**
+ * Write the file header
+ */
+void vtkWrapXML_FileHeader(wrapxml_state_t *w, const FileInfo *data)
+{
+  const char *elementName = "file";
+  const char *cp = data->FileName;
+  size_t i;
+
+  vtkWrapXML_ElementStart(w, elementName);
+  if (cp)
+  {
+    i = strlen(cp);
+    while (i > 0 && cp[i-1] != '/' && cp[i-1] != '\\' && cp[i-1] != ':')
+    {
+      i--;
+    }
+    vtkWrapXML_Name(w, &cp[i]);
+  }
+  vtkWrapXML_ElementBody(w);
+  w->indentation--;
+}
+
+/**
+ * Write the file footer
+ */
+void vtkWrapXML_FileFooter(wrapxml_state_t *w, const FileInfo *data)
+{
+  const char *elementName = "file";
+  /* avoid warning */
+  (void)data;
+
+  w->indentation++;
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Check for strings that are NULL, empty, or whitespace
+ */
+int vtkWrapXML_EmptyString(const char *cp)
+{
+  if (cp)
+  {
+    while (*cp != '\0')
+    {
+      if (!isspace(*cp++))
+      {
+        return 0;
+      }
+    }
+  }
+
+  return 1;
+}
+
+/**
+ * Write out the VTK-style documentation for the file
+ */
+void vtkWrapXML_FileDoc(wrapxml_state_t *w, FileInfo *data)
+{
+  size_t n;
+  char temp[500];
+  const char *cp;
+
+  if (vtkWrapXML_EmptyString(data->NameComment) &&
+      vtkWrapXML_EmptyString(data->Description) &&
+      vtkWrapXML_EmptyString(data->Caveats) &&
+      vtkWrapXML_EmptyString(data->SeeAlso))
+  {
+    return;
+  }
+
+  vtkWrapXML_ElementStart(w, "comment");
+  vtkWrapXML_ElementBody(w);
+
+  if (data->NameComment)
+  {
+    cp = data->NameComment;
+    while (*cp == ' ')
+    {
+      cp++;
+    }
+    strncpy(temp, " .NAME ", 7);
+    n = strlen(cp) + 7;
+    n = (n >= 500 ? 500-1 : n);
+    strncpy(&temp[7], cp, n-7);
+    temp[n] = '\0';
+    vtkWrapXML_MultiLineText(w, temp);
+  }
+
+  if (data->Description)
+  {
+    vtkWrapXML_TextLine(w, NULL, NULL);
+    vtkWrapXML_TextLine(w, " .SECTION Description", NULL);
+    vtkWrapXML_MultiLineText(w, data->Description);
+  }
+
+  if (data->Caveats && data->Caveats[0] != '\0')
+  {
+    vtkWrapXML_TextLine(w, NULL, NULL);
+    vtkWrapXML_TextLine(w, " .SECTION Caveats", NULL);
+    vtkWrapXML_MultiLineText(w, data->Caveats);
+  }
+
+  if (data->SeeAlso && data->SeeAlso[0] != '\0')
+  {
+    vtkWrapXML_TextLine(w, NULL, NULL);
+    vtkWrapXML_TextLine(w, " .SECTION See also", NULL);
+
+    cp = data->SeeAlso;
+    while(isspace(*cp))
+    {
+      cp++;
+    }
+    while(*cp)
+    {
+      n = 0;
+      while(cp[n] && !isspace(cp[n]))
+      {
+        n++;
+      }
+      /* There might be another section in the See also */
+      if (strncmp(cp, ".SECTION", 8) == 0)
+      {
+        vtkWrapXML_TextLine(w, NULL, NULL);
+
+        while(cp > data->SeeAlso && isspace(*(cp - 1)) && *(cp - 1) != '\n')
+        {
+          cp--;
+        }
+        vtkWrapXML_MultiLineText(w, cp);
+        break;
+      }
+
+      if (n > 0 && n < 400)
+      {
+        strncpy(temp, cp, n);
+        temp[n] = '\0';
+        vtkWrapXML_TextLine(w, " ", temp);
+      }
+      cp += n;
+      while(isspace(*cp))
+      {
+        cp++;
+      }
+    }
+  }
+
+  vtkWrapXML_ElementEnd(w, "comment");
+}
+
+/**
+ * Write the inheritance section
+ */
+void vtkWrapXML_ClassInheritance(
+  wrapxml_state_t *w, MergeInfo *merge)
+{
+  const char *elementName = "inheritance";
+  const char *subElementName = "context";
+  unsigned long i, n;
+
+  /* show the geneology */
+  n = merge->NumberOfClasses;
+
+  vtkWrapXML_ElementStart(w, elementName);
+  vtkWrapXML_ElementBody(w);
+  for (i = 1; i < n; i++)
+  {
+    vtkWrapXML_ElementStart(w, subElementName);
+    vtkWrapXML_Name(w, merge->ClassNames[i]);
+    vtkWrapXML_Attribute(w, "access", "public");
+    vtkWrapXML_ElementEnd(w, subElementName);
+  }
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/* needed for type */
+void vtkWrapXML_FunctionCommon(
+  wrapxml_state_t *w, FunctionInfo *func, int doReturn);
+
+/**
+ * Print out a type in XML format
+ */
+void vtkWrapXML_TypeAttributes(wrapxml_state_t *w, ValueInfo *val)
+{
+  unsigned int type = val->Type;
+
+  if ((type & VTK_PARSE_CONST) != 0)
+  {
+    vtkWrapXML_AttributeWithPrefix(w, "type", "const ", val->TypeName);
+  }
+  else
+  {
+    vtkWrapXML_Attribute(w, "type", val->TypeName);
+  }
+
+  if ((type & VTK_PARSE_RVALUE) != 0)
+  {
+    vtkWrapXML_Flag(w, "rvalue_reference", 1);
+  }
+  else if ((type & VTK_PARSE_REF) != 0)
+  {
+    vtkWrapXML_Flag(w, "reference", 1);
+  }
+
+  if ((type & VTK_PARSE_NEWINSTANCE) != 0)
+  {
+    vtkWrapXML_Flag(w, "newinstance", 1);
+  }
+
+  vtkWrapXML_Pointer(w, val);
+  vtkWrapXML_Size(w, val);
+}
+
+/**
+ * Print out a type in XML format
+ */
+void vtkWrapXML_TypeElements(wrapxml_state_t *w, ValueInfo *val)
+{
+  if (val->Function)
+  {
+    if (val->Function->Class)
+    {
+      vtkWrapXML_ElementStart(w, "method");
+      vtkWrapXML_Attribute(w, "context", val->Function->Class);
+      vtkWrapXML_FunctionCommon(w, val->Function, 1);
+      vtkWrapXML_ElementEnd(w, "method");
+    }
+    else
+    {
+      vtkWrapXML_ElementStart(w, "function");
+      vtkWrapXML_FunctionCommon(w, val->Function, 1);
+      vtkWrapXML_ElementEnd(w, "function");
+    }
+  }
+}
+
+
+/**
+ * Print out a simple type types
+ */
+void vtkWrapXML_TypeSimple(
+  wrapxml_state_t *w, unsigned int type, const char *classname, unsigned long size)
+{
+  char temp[256];
+  char temp2[512];
+  const char *sizes[2];
+  ValueInfo val;
+
+  memset(&val, 0, sizeof(ValueInfo));
+  val.ItemType = VTK_VARIABLE_INFO;
+  val.Type = type;
+
+  if (classname)
+  {
+    strcpy(temp2, classname);
+    val.TypeName = temp2;
+  }
+
+  sizes[0] = 0;
+  sizes[1] = 0;
+  if (size > 0)
+  {
+    sprintf(temp, "%lu", size);
+    sizes[0] = temp;
+    val.Dimensions = sizes;
+    val.NumberOfDimensions = 1;
+  }
+
+  vtkWrapXML_TypeAttributes(w, &val);
+  vtkWrapXML_TypeElements(w, &val);
+}
+
+/**
+ * Print a template
+ */
+void vtkWrapXML_Template(
+  wrapxml_state_t *w, TemplateInfo *info)
+{
+  const char *elementName = "tparam";
+  ValueInfo *param;
+  unsigned long i;
+
+  for (i = 0; i < info->NumberOfParameters; i++)
+  {
+    vtkWrapXML_ElementStart(w, elementName);
+
+    param = info->Parameters[i];
+
+    if (param->Name)
+    {
+      vtkWrapXML_Name(w, param->Name);
+    }
+
+    if (param->Template)
+    {
+      vtkWrapXML_Attribute(w, "type", "template");
+    }
+    else if (param->Type)
+    {
+      vtkWrapXML_Attribute(w, "type", param->TypeName);
+    }
+    else
+    {
+      vtkWrapXML_Attribute(w, "type", "typename");
+    }
+
+    if (param->Value)
+    {
+      vtkWrapXML_Value(w, param->Value);
+    }
+
+    if (param->NumberOfDimensions)
+    {
+      ValueInfo val;
+      val.NumberOfDimensions = param->NumberOfDimensions;
+      val.Dimensions = param->Dimensions;
+      vtkWrapXML_Size(w, &val);
+    }
+
+    if (param->IsPack)
+    {
+      vtkWrapXML_Flag(w, "pack", 1);
+    }
+
+    if (param->Template)
+    {
+      vtkWrapXML_Flag(w, "template", 1);
+      vtkWrapXML_Template(w, param->Template);
+    }
+
+    if (param->Function)
+    {
+      if (param->Function->Class)
+      {
+        vtkWrapXML_ElementStart(w, "method");
+        vtkWrapXML_Attribute(w, "context", param->Function->Class);
+        vtkWrapXML_FunctionCommon(w, param->Function, 1);
+        vtkWrapXML_ElementEnd(w, "method");
+      }
+      else
+      {
+        vtkWrapXML_ElementStart(w, "function");
+        vtkWrapXML_FunctionCommon(w, param->Function, 1);
+        vtkWrapXML_ElementEnd(w, "function");
+      }
+    }
+
+    vtkWrapXML_ElementEnd(w, elementName);
+  }
+}
+
+/* Declare prototype for use in vtkWrapXML_Enum() */
+void vtkWrapXML_Constant(
+  wrapxml_state_t *w, ValueInfo *con, int inClass);
+
+/**
+ * Print an enum
+ */
+void vtkWrapXML_Enum(
+  wrapxml_state_t *w, EnumInfo *item, int inClass)
+{
+  unsigned long i;
+  const char *elementName = "enum";
+
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+
+  if (inClass)
+  {
+    vtkWrapXML_Access(w, item->Access);
+  }
+
+  vtkWrapXML_Name(w, item->Name);
+
+  vtkWrapXML_Comment(w, item->Comment);
+
+  /* print all members of the class */
+  for (i = 0; i < item->NumberOfConstants; i++)
+  {
+    vtkWrapXML_Constant(w, item->Constants[i], 2);
+  }
+
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Print a constant
+ */
+void vtkWrapXML_Constant(
+  wrapxml_state_t *w, ValueInfo *con, int inClass)
+{
+  const char *elementName = "constant";
+
+  /* inClass will be 2 for enum class */
+  if (inClass < 2)
+  {
+    vtkWrapXML_BlankLine(w);
+  }
+
+  vtkWrapXML_ElementStart(w, elementName);
+
+  if (inClass)
+  {
+    vtkWrapXML_Access(w, con->Access);
+  }
+
+  if (con->IsEnum)
+  {
+    vtkWrapXML_Flag(w, "enum", 1);
+  }
+  if (con->Type && con->TypeName && con->TypeName[0] != '\0')
+  {
+    vtkWrapXML_TypeAttributes(w, con);
+  }
+  vtkWrapXML_Name(w, con->Name);
+
+  if (con->Value)
+  {
+    vtkWrapXML_Value(w, con->Value);
+  }
+
+  vtkWrapXML_Comment(w, con->Comment);
+  vtkWrapXML_TypeElements(w, con);
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+
+/**
+ * Print a variable
+ */
+void vtkWrapXML_Variable(
+  wrapxml_state_t *w, ValueInfo *var, int inClass)
+{
+  const char *elementName = "variable";
+
+  if (inClass)
+  {
+    elementName = "member";
+  }
+
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+
+  vtkWrapXML_Name(w, var->Name);
+
+  if (inClass)
+  {
+    vtkWrapXML_Access(w, var->Access);
+  }
+
+  vtkWrapXML_TypeAttributes(w, var);
+
+  if (var->Value)
+  {
+    vtkWrapXML_Value(w, var->Value);
+  }
+
+  if (var->Template)
+  {
+    vtkWrapXML_Flag(w, "template", 1);
+    vtkWrapXML_Template(w, var->Template);
+  }
+
+  vtkWrapXML_Comment(w, var->Comment);
+  vtkWrapXML_TypeElements(w, var);
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+
+/**
+ * Print a typedef
+ */
+void vtkWrapXML_Typedef(
+  wrapxml_state_t *w, ValueInfo *type, int inClass)
+{
+  const char *elementName = "typedef";
+
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+
+  vtkWrapXML_Name(w, type->Name);
+
+  if (inClass)
+  {
+    vtkWrapXML_Access(w, type->Access);
+  }
+
+  if (type->Type)
+  {
+    vtkWrapXML_TypeAttributes(w, type);
+  }
+
+  if (type->Template)
+  {
+    vtkWrapXML_Flag(w, "template", 1);
+    vtkWrapXML_Template(w, type->Template);
+  }
+
+  vtkWrapXML_Comment(w, type->Comment);
+  if (type->Type)
+  {
+    vtkWrapXML_TypeElements(w, type);
+  }
+
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Print a using declaration
+ */
+void vtkWrapXML_Using(
+  wrapxml_state_t *w, UsingInfo *data)
+{
+  const char *elementName = "using";
+  const char *name = "namespace";
+
+  if (data && data->Scope)
+  {
+    if (data->Name)
+    {
+      name = data->Name;
+    }
+
+    vtkWrapXML_BlankLine(w);
+    vtkWrapXML_ElementStart(w, elementName);
+    vtkWrapXML_Name(w, name);
+    vtkWrapXML_Attribute(w, "context", data->Scope);
+    vtkWrapXML_Comment(w, data->Comment);
+    vtkWrapXML_ElementEnd(w, elementName);
+  }
+}
+
+/**
+ * Print out items that are common to functions and methods
+ */
+void vtkWrapXML_FunctionCommon(
+  wrapxml_state_t *w, FunctionInfo *func, int printReturn)
+{
+  ValueInfo *arg;
+  unsigned long i, n;
+  char temp[500];
+  char *cp = 0;
+  size_t l;
+
+  if (func->IsStatic)
+  {
+    vtkWrapXML_Flag(w, "static", 1);
+  }
+
+  if (func->IsVariadic)
+  {
+    vtkWrapXML_Flag(w, "variadic", 1);
+  }
+
+  if (func->IsLegacy)
+  {
+    vtkWrapXML_Flag(w, "legacy", 1);
+  }
+
+  /* the template parameters are the first sub-elements */
+  if (func->Template)
+  {
+    vtkWrapXML_Flag(w, "template", 1);
+    vtkWrapXML_Template(w, func->Template);
+  }
+
+  if (func->Signature)
+  {
+    vtkWrapXML_ElementStart(w, "signature");
+    vtkWrapXML_ElementBody(w);
+
+    l = vtkParse_FunctionInfoToString(func, NULL, VTK_PARSE_EVERYTHING);
+    cp = temp;
+    if (l+1 > sizeof(temp))
+    {
+      cp = (char *)malloc(l+1);
+    }
+    vtkParse_FunctionInfoToString(func, cp, VTK_PARSE_EVERYTHING);
+    vtkWrapXML_TextLine(w, " ", cp);
+    if (cp != temp)
+    {
+      free(cp);
+    }
+    vtkWrapXML_ElementEnd(w, "signature");
+  }
+
+  n = func->NumberOfPreconds;
+  for (i = 0; i < n; i++)
+  {
+    vtkWrapXML_ElementStart(w, "expects");
+    vtkWrapXML_ElementBody(w);
+    vtkParse_FunctionInfoToString(func, cp, VTK_PARSE_EVERYTHING);
+    vtkWrapXML_TextLine(w, " ", func->Preconds[i]);
+    vtkWrapXML_ElementEnd(w, "expects");
+  }
+
+  vtkWrapXML_Comment(w, func->Comment);
+
+  n = func->NumberOfParameters;
+  for (i = 0; i < n; i++)
+  {
+    vtkWrapXML_ElementStart(w, "param");
+    arg = func->Parameters[i];
+
+    if (arg->Name)
+    {
+      vtkWrapXML_Name(w, arg->Name);
+    }
+
+    if (arg->Value)
+    {
+      vtkWrapXML_Value(w, arg->Value);
+    }
+
+    vtkWrapXML_TypeAttributes(w, arg);
+
+    if (arg->IsPack)
+    {
+      vtkWrapXML_Flag(w, "pack", 1);
+    }
+
+    vtkWrapXML_TypeElements(w, arg);
+    vtkWrapXML_ElementEnd(w, "param");
+  }
+
+  if (printReturn)
+  {
+    vtkWrapXML_ElementStart(w, "return");
+    vtkWrapXML_TypeAttributes(w, func->ReturnValue);
+    vtkWrapXML_TypeElements(w, func->ReturnValue);
+    vtkWrapXML_ElementEnd(w, "return");
+  }
+}
+
+/**
+ * Print out a function in XML format
+ */
+void vtkWrapXML_Function(
+  wrapxml_state_t *w, FunctionInfo *func)
+{
+  const char *elementName = "function";
+  const char *name = func->Name;
+
+  if (func->IsOperator)
+  {
+    elementName = "operator";
+    if (strncmp(name, "operator", 8) == 0)
+    {
+      name = &name[8];
+      while (isspace(name[0]))
+      {
+        name++;
+      }
+    }
+  }
+
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+  vtkWrapXML_Name(w, name);
+  vtkWrapXML_FunctionCommon(w, func, 1);
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Print a bitfield of class property access methods
+ */
+void vtkWrapXML_ClassPropertyMethods(
+  wrapxml_state_t *w, unsigned int methodBitfield)
+{
+  unsigned int i;
+  unsigned int methodType;
+  int first = 1;
+
+  vtkWrapXML_AttributeStart(w, "bitfield");
+
+  for (i = 0; i < 32; i++)
+  {
+    methodType = methodBitfield & (1U << i);
+    if (methodType)
+    {
+      if ((methodType & VTK_METHOD_SET_CLAMP) != 0 &&
+          (methodBitfield & VTK_METHOD_SET_CLAMP) == VTK_METHOD_SET_CLAMP)
+      {
+        methodType = VTK_METHOD_SET_CLAMP;
+        methodBitfield &= ~VTK_METHOD_SET_CLAMP;
+      }
+      else if ((methodType & VTK_METHOD_SET_BOOL) != 0 &&
+          (methodBitfield & VTK_METHOD_SET_BOOL) == VTK_METHOD_SET_BOOL)
+      {
+        methodType = VTK_METHOD_SET_BOOL;
+        methodBitfield &= ~VTK_METHOD_SET_BOOL;
+      }
+
+      if (first == 0)
+      {
+        vtkWrapXML_Putc(w, '|');
+      }
+      vtkWrapXML_Puts(w, vtkParseProperties_MethodTypeAsString(methodType));
+      first = 0;
+    }
+  }
+  vtkWrapXML_AttributeEnd(w);
+}
+
+/**
+ * Print out a method in XML format
+ */
+void vtkWrapXML_ClassMethod(
+  wrapxml_state_t *w, ClassInfo *data, FunctionInfo *func, const char *classname,
+  const char *propname)
+{
+  const char *elementName = "method";
+  const char *name = func->Name;
+  int isCtrOrDtr = 0;
+
+  if (func->IsDeleted)
+  {
+    return;
+  }
+
+  if (data && strcmp(data->Name, func->Name) == 0)
+  {
+    elementName = "constructor";
+    isCtrOrDtr = 1;
+  }
+  else if (data && func->Name[0] == '~' &&
+           strcmp(data->Name, &func->Name[1]) == 0)
+  {
+    elementName = "destructor";
+    isCtrOrDtr = 1;
+  }
+  else if (func->IsOperator)
+  {
+    elementName = "operator";
+    if (strncmp(name, "operator", 8) == 0)
+    {
+      name = &name[8];
+      while (isspace(name[0]))
+      {
+        name++;
+      }
+    }
+  }
+
+  /* eliminate macros masquerading as class methods */
+  if (!func->ReturnValue && !isCtrOrDtr)
+  {
+    return;
+  }
+
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+  if (!isCtrOrDtr)
+  {
+    vtkWrapXML_Name(w, name);
+  }
+
+  if (classname && strcmp(classname, data->Name) != 0)
+  {
+    vtkWrapXML_Attribute(w, "context", classname);
+  }
+
+  if (propname)
+  {
+    vtkWrapXML_Attribute(w, "property", propname);
+  }
+
+  vtkWrapXML_Access(w, func->Access);
+
+  if (func->IsConst)
+  {
+    vtkWrapXML_Flag(w, "const", 1);
+  }
+
+  if (func->IsVirtual)
+  {
+    vtkWrapXML_Flag(w, "virtual", 1);
+  }
+
+  if (func->IsPureVirtual)
+  {
+    vtkWrapXML_Flag(w, "pure", 1);
+  }
+
+  if (func->IsFinal)
+  {
+    vtkWrapXML_Flag(w, "final", 1);
+  }
+
+  if (func->IsExplicit)
+  {
+    vtkWrapXML_Flag(w, "explicit", 1);
+  }
+
+  vtkWrapXML_FunctionCommon(w, func, !isCtrOrDtr);
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Print out a property in XML format
+ */
+void vtkWrapXML_ClassProperty(
+  wrapxml_state_t *w, PropertyInfo *property, const char *classname)
+{
+  const char *elementName = "property";
+  const char *access = 0;
+  unsigned long i;
+
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+  vtkWrapXML_Name(w, property->Name);
+
+  if (classname)
+  {
+    vtkWrapXML_Attribute(w, "context", classname);
+  }
+
+  if (property->PublicMethods)
+  {
+    access = "public";
+  }
+  else if (property->ProtectedMethods)
+  {
+    access = "protected";
+  }
+  else if (property->PrivateMethods)
+  {
+    access = "private";
+  }
+
+  if (access)
+  {
+    vtkWrapXML_Attribute(w, "access", access);
+  }
+
+  if (property->IsStatic)
+  {
+    vtkWrapXML_Flag(w, "static", 1);
+  }
+
+  if (((property->PublicMethods | property->ProtectedMethods |
+        property->PrivateMethods) & ~property->LegacyMethods) == 0)
+  {
+    vtkWrapXML_Flag(w, "legacy", 1);
+  }
+
+  vtkWrapXML_TypeSimple(w, property->Type, property->ClassName,
+                        property->Count);
+
+  vtkWrapXML_Comment(w, property->Comment);
+
+  if (property->PublicMethods)
+  {
+    vtkWrapXML_ElementStart(w, "methods");
+    vtkWrapXML_ClassPropertyMethods(w, property->PublicMethods);
+    vtkWrapXML_Attribute(w, "access", "public");
+    vtkWrapXML_ElementEnd(w, "methods");
+  }
+
+  if (property->ProtectedMethods)
+  {
+    vtkWrapXML_ElementStart(w, "methods");
+    vtkWrapXML_ClassPropertyMethods(w, property->ProtectedMethods);
+    vtkWrapXML_Attribute(w, "access", "protected");
+    vtkWrapXML_ElementEnd(w, "methods");
+  }
+
+  if (property->PrivateMethods)
+  {
+    vtkWrapXML_ElementStart(w, "methods");
+    vtkWrapXML_ClassPropertyMethods(w, property->PrivateMethods);
+    vtkWrapXML_Attribute(w, "access", "private");
+    vtkWrapXML_ElementEnd(w, "methods");
+  }
+
+  if (property->LegacyMethods)
+  {
+    vtkWrapXML_ElementStart(w, "methods");
+    vtkWrapXML_ClassPropertyMethods(w, property->LegacyMethods);
+    vtkWrapXML_Flag(w, "legacy", 1);
+    vtkWrapXML_ElementEnd(w, "methods");
+  }
+
+  if (property->EnumConstantNames)
+  {
+    for (i = 0; property->EnumConstantNames[i] != 0; i++)
+    {
+      vtkWrapXML_ElementStart(w, "valname");
+      vtkWrapXML_Attribute(w, "name", property->EnumConstantNames[i]);
+      vtkWrapXML_ElementEnd(w, "valname");
+    }
+  }
+
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Synthesize additional information before printing a method
+ */
+void vtkWrapXML_MethodHelper(
+  wrapxml_state_t *w, MergeInfo *merge, ClassProperties *properties,
+  ClassInfo *classInfo, FunctionInfo *funcInfo)
+{
+  const char *classname = 0;
+  const char *propname = 0;
+  PropertyInfo *property = NULL;
+  unsigned long i, j, n;
+
+  n = classInfo->NumberOfFunctions;
+
+  for (i = 0; i < n; i++)
+  {
+    if (classInfo->Functions[i] == funcInfo)
+    {
+      break;
+    }
+  }
+
+  if (i < n)
+  {
+    if (merge && merge->NumberOfOverrides[i])
+    {
+      classname = merge->ClassNames[merge->OverrideClasses[i][0]];
+      if (strcmp(classname, classInfo->Name) == 0)
+      {
+        classname = 0;
+      }
+    }
+    if (properties && properties->MethodHasProperty[i])
+    {
+      property = properties->Properties[properties->MethodProperties[i]];
+      propname = property->Name;
+      for (j = 0; j < i; j++)
+      {
+        /* only print property if this is the first occurrence */
+        if (properties->MethodHasProperty[j] &&
+            property ==
+            properties->Properties[properties->MethodProperties[j]])
+        {
+          property = NULL;
+          break;
+        }
+      }
+    }
+  }
+
+  if (property)
+  {
+    vtkWrapXML_ClassProperty(w, property, classname);
+  }
+
+  vtkWrapXML_ClassMethod(w, classInfo, funcInfo,
+                         classname, propname);
+}
+
+/**
+ * Print a class as xml
+ */
+void vtkWrapXML_Class(
+  wrapxml_state_t *w, NamespaceInfo *data, ClassInfo *classInfo, int inClass)
+{
+  const char *elementName = "class";
+  ClassProperties *properties;
+  MergeInfo *merge = NULL;
+  unsigned long i, j, n;
+
+  /* start new XML section for class */
+  vtkWrapXML_BlankLine(w);
+  if (classInfo->ItemType == VTK_STRUCT_INFO)
+  {
+    elementName = "struct";
+  }
+  else if (classInfo->ItemType == VTK_UNION_INFO)
+  {
+    elementName = "union";
+  }
+
+  vtkWrapXML_ElementStart(w, elementName);
+
+  vtkWrapXML_Name(w, classInfo->Name);
+
+  if (inClass)
+  {
+    vtkWrapXML_Access(w, classInfo->Access);
+  }
+
+  if (classInfo->IsAbstract)
+  {
+    vtkWrapXML_Flag(w, "abstract", 1);
+  }
+
+  if (classInfo->IsFinal)
+  {
+    vtkWrapXML_Flag(w, "final", 1);
+  }
+
+  if (classInfo->Template)
+  {
+    vtkWrapXML_Flag(w, "template", 1);
+    vtkWrapXML_Template(w, classInfo->Template);
+  }
+  else
+  {
+    vtkWrapXML_ElementBody(w);
+  }
+
+  vtkWrapXML_Comment(w, classInfo->Comment);
+
+  /* actually, vtk classes never have more than one superclass */
+  n = classInfo->NumberOfSuperClasses;
+  for (i = 0; i < n; i++)
+  {
+    vtkWrapXML_ElementStart(w, "base");
+    vtkWrapXML_Name(w, classInfo->SuperClasses[i]);
+    vtkWrapXML_Attribute(w, "access", "public");
+    vtkWrapXML_ElementEnd(w, "base");
+  }
+
+  /* merge all the superclass information */
+  if (classInfo->NumberOfSuperClasses)
+  {
+    //merge = vtkParseMerge_MergeSuperClasses(w->data, data, classInfo);
+    vtkParseMerge_ApplyUsingDeclarations(w->data, data, classInfo);
+  }
+
+  if (merge && merge->NumberOfClasses > 1)
+  {
+    vtkWrapXML_BlankLine(w);
+    vtkWrapXML_ClassInheritance(w, merge);
+  }
+
+  /* get information about the properties */
+  properties = vtkParseProperties_Create(classInfo);
+
+  /* print all members of the class */
+  for (i = 0; i < classInfo->NumberOfItems; i++)
+  {
+    j = classInfo->Items[i].Index;
+    switch (classInfo->Items[i].Type)
+    {
+      case VTK_VARIABLE_INFO:
+      {
+        vtkWrapXML_Variable(w, classInfo->Variables[j], 1);
+        break;
+      }
+      case VTK_CONSTANT_INFO:
+      {
+        vtkWrapXML_Constant(w, classInfo->Constants[j], 1);
+        break;
+      }
+      case VTK_ENUM_INFO:
+      {
+        vtkWrapXML_Enum(w, classInfo->Enums[j], 1);
+        break;
+      }
+      case VTK_FUNCTION_INFO:
+      {
+        vtkWrapXML_MethodHelper(w, merge, properties, classInfo,
+                                classInfo->Functions[j]);
+        break;
+      }
+      case VTK_TYPEDEF_INFO:
+      {
+        vtkWrapXML_Typedef(w, classInfo->Typedefs[j], 1);
+        break;
+      }
+      case VTK_USING_INFO:
+      {
+        vtkWrapXML_Using(w, classInfo->Usings[j]);
+        break;
+      }
+      case VTK_CLASS_INFO:
+      case VTK_STRUCT_INFO:
+      case VTK_UNION_INFO:
+      {
+        vtkWrapXML_Class(w, data, classInfo->Classes[j], 1);
+        break;
+      }
+      case VTK_NAMESPACE_INFO:
+        break;
+    }
+  }
+
+  /* release the information about the properties */
+  vtkParseProperties_Free(properties);
+
+  /* release the info about what was merged from superclasses */
+  if (merge)
+  {
+    vtkParseMerge_FreeMergeInfo(merge);
+  }
+
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/* needed for vtkWrapXML_Body */
+void vtkWrapXML_Namespace(wrapxml_state_t *w, NamespaceInfo *data);
+
+/**
+ * Print the body of a file or namespace
+ */
+void vtkWrapXML_Body(wrapxml_state_t *w, NamespaceInfo *data)
+{
+  unsigned long i, j;
+
+  /* print all constants for the file or namespace */
+  for (i = 0; i < data->NumberOfItems; i++)
+  {
+    j = data->Items[i].Index;
+    switch (data->Items[i].Type)
+    {
+      case VTK_VARIABLE_INFO:
+      {
+        vtkWrapXML_Variable(w, data->Variables[j], 0);
+        break;
+      }
+      case VTK_CONSTANT_INFO:
+      {
+        vtkWrapXML_Constant(w, data->Constants[j], 0);
+        break;
+      }
+      case VTK_TYPEDEF_INFO:
+      {
+        vtkWrapXML_Typedef(w, data->Typedefs[j], 0);
+        break;
+      }
+      case VTK_USING_INFO:
+      {
+        vtkWrapXML_Using(w, data->Usings[j]);
+        break;
+      }
+      case VTK_ENUM_INFO:
+      {
+        vtkWrapXML_Enum(w, data->Enums[j], 0);
+        break;
+      }
+      case VTK_CLASS_INFO:
+      case VTK_STRUCT_INFO:
+      case VTK_UNION_INFO:
+      {
+        vtkWrapXML_Class(w, data, data->Classes[j], 0);
+        break;
+      }
+      case VTK_FUNCTION_INFO:
+      {
+        vtkWrapXML_Function(w, data->Functions[j]);
+        break;
+      }
+      case VTK_NAMESPACE_INFO:
+      {
+        vtkWrapXML_Namespace(w, data->Namespaces[j]);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * Print a namespace as xml
+ */
+void vtkWrapXML_Namespace(wrapxml_state_t *w, NamespaceInfo *data)
+{
+  const char *elementName = "namespace";
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementStart(w, elementName);
+  vtkWrapXML_Name(w, data->Name);
+  vtkWrapXML_ElementBody(w);
+  vtkWrapXML_Body(w, data);
+  vtkWrapXML_BlankLine(w);
+  vtkWrapXML_ElementEnd(w, elementName);
+}
+
+/**
+ * Check whether a file already holds exactly the given text
+ */
+static int vtkWrapXML_FileMatches(
+  const char *filename, const char *text, size_t n, int binary)
+{
+  FILE *fp;
+  char block[8192];
+  size_t i, m;
+  int matched = 1;
+  struct stat fs;
+
+  /* compare the size first (on Windows, text files have CRs) */
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  if (binary)
+#else
+  (void)binary;
+#endif
+  {
+    if (stat(filename, &fs) != 0 || (size_t)fs.st_size != n)
+    {
+      return 0;
+    }
+  }
+
+  fp = fopen(filename, (binary ? "rb" : "r"));
+  if (!fp)
+  {
+    return 0;
+  }
+
+  for (i = 0; matched; i += m)
+  {
+    m = fread(block, 1, sizeof(block), fp);
+    if (m == 0)
+    {
+      matched = (i == n);
+      break;
+    }
+    matched = (m <= n - i && memcmp(block, &text[i], m) == 0);
+  }
+
+  fclose(fp);
+  return matched;
+}
+
+/**
+ * Write the text to the file, unless the file already holds the same
+ * text.  The text is written to a temporary file that is then renamed,
+ * so that the file is replaced atomically.  Returns zero on error.
+ */
+int vtkWrapXML_WriteFileIfChanged(
+  const char *filename, const char *text, size_t n, int binary)
+{
+  FILE *fp;
+  char *tempname;
+  unsigned long pid;
+  int success;
+
+  if (vtkWrapXML_FileMatches(filename, text, n, binary))
+  {
+    return 1;
+  }
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  pid = (unsigned long)_getpid();
+#else
+  pid = (unsigned long)getpid();
+#endif
+
+  /* the temp file must be in the same directory, for the rename */
+  tempname = (char *)malloc(strlen(filename) + 32);
+  sprintf(tempname, "%s.%lu.tmp", filename, pid);
+
+  fp = fopen(tempname, (binary ? "wb" : "w"));
+  if (!fp)
+  {
+    free(tempname);
+    return 0;
+  }
+
+  success = (fwrite(text, 1, n, fp) == n);
+  success &= (fclose(fp) == 0);
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  success = (success &&
+             MoveFileEx(tempname, filename, MOVEFILE_REPLACE_EXISTING));
+#else
+  success = (success && rename(tempname, filename) == 0);
+#endif
+
+  if (!success)
+  {
+    remove(tempname);
+  }
+
+  free(tempname);
+  return success;
+}
+
+/**
+ * Get the file name without the path or the suffix, as a new string
+ */
+static char *vtkWrapXML_ClassNameFromFile(const char *filename)
+{
+  const char *cp = filename + strlen(filename);
+  const char *dot = cp;
+  char *name;
+
+  while (cp > filename && cp[-1] != '/' && cp[-1] != '\\' && cp[-1] != ':')
+  {
+    cp--;
+    if (*cp == '.' && *dot == '\0')
+    {
+      dot = cp;
+    }
+  }
+
+  name = (char *)malloc(dot - cp + 1);
+  memcpy(name, cp, dot - cp);
+  name[dot - cp] = '\0';
+
+  return name;
+}
+
+/**
+ * Write all of the input files to one bundle, named by class
+ */
+static void vtkWrapXML_WriteBundle(OptionInfo *options, int format)
+{
+  XMLBundleWriter *writer;
+  FileInfo *data;
+  wrapxml_state_t ws;
+  const char *filename;
+  char *name;
+  char *bundle;
+  size_t size;
+  int i;
+
+  writer = vtkWrapXMLBundle_NewWriter((options->Bundle & 2) != 0);
+
+  for (i = 0; i < options->NumberOfFiles; i++)
+  {
+    filename = options->Files[i];
+    data = vtkParse_ParseInputFile(i);
+    if (!data)
+    {
+      exit(1);
+    }
+
+    vtkParse_StartPhase(VTK_PARSE_PHASE_OUTPUT);
+    vtkParse_BeginSpan("output", filename);
+
+    vtkWrapXML_InitState(&ws, data, NULL, format);
+    vtkWrapXML_FileHeader(&ws, data);
+    vtkWrapXML_FileDoc(&ws, data);
+    vtkWrapXML_Body(&ws, data->Contents);
+    vtkWrapXML_FileFooter(&ws, data);
+
+    name = vtkWrapXML_ClassNameFromFile(filename);
+    vtkWrapXMLBundle_AddDocument(writer, name, ws.buffer, ws.length);
+    free(name);
+
+    vtkWrapXML_FinishState(&ws);
+    vtkParse_EndSpan("output");
+    vtkParse_StopPhase(VTK_PARSE_PHASE_OUTPUT);
+
+    vtkParse_Free(data);
+  }
+
+  vtkParse_StartPhase(VTK_PARSE_PHASE_OUTPUT);
+  vtkParse_BeginSpan("output", options->OutputFileName);
+  bundle = vtkWrapXMLBundle_FinishWriter(writer, &size);
+  if (!vtkWrapXML_WriteFileIfChanged(
+         options->OutputFileName, bundle, size, 1))
+  {
+    fprintf(stderr, "Error writing output file %s\n", options->OutputFileName);
+    exit(1);
+  }
+  free(bundle);
+  vtkParse_EndSpan("output");
+  vtkParse_StopPhase(VTK_PARSE_PHASE_OUTPUT);
+}
+
+/**
+ * Write a parsed header to a file
+ */
+int vtkWrapXML_WriteFile(FileInfo *data, const char *filename, int format)
+{
+  wrapxml_state_t ws;
+  int success;
+
+  /* the output is kept in memory until it is complete */
+  vtkParse_StartPhase(VTK_PARSE_PHASE_OUTPUT);
+  vtkParse_BeginSpan("output", filename);
+
+  /* a struct to keep track of things */
+  vtkWrapXML_InitState(&ws, data, NULL, format);
+
+  /* print the lead-in */
+  vtkWrapXML_FileHeader(&ws, data);
+
+  /* print the documentation */
+  vtkWrapXML_FileDoc(&ws, data);
+
+  /* print the main body */
+  vtkWrapXML_Body(&ws, data->Contents);
+
+  /* print the closing tag */
+  vtkWrapXML_FileFooter(&ws, data);
+
+  /* write the file, if it has changed */
+  success = vtkWrapXML_WriteFileIfChanged(filename, ws.buffer, ws.length, 0);
+
+  vtkWrapXML_FinishState(&ws);
+  vtkParse_EndSpan("output");
+  vtkParse_StopPhase(VTK_PARSE_PHASE_OUTPUT);
+
+  return success;
+}
+
+/**
+ * Run the wrapper with the given output format
+ */
+int vtkWrapXML_Run(int argc, char *argv[], int format)
+{
+  FileInfo *data;
+  OptionInfo *options;
+
+  /* recurse through included headers (off for now) */
+  vtkParse_SetRecursive(0);
+
+  /* pre-define a macro to identify the language (the same macro is
+   * used for JSON, so that the headers are parsed the same way) */
+  vtkParse_DefineMacro("__VTK_WRAP_XML__", 0);
+
+  /* handle args, parse header, get output file handle */
+  data = vtkParse_Main(argc, argv);
+
+  /* get the command-line options */
+  options = vtkParse_GetCommandLineOptions();
+
+  /* with "--bundle", the files are parsed one at a time */
+  if (options->Bundle)
+  {
+    vtkWrapXML_WriteBundle(options, format);
+    return 0;
+  }
+
+  if (!vtkWrapXML_WriteFile(data, options->OutputFileName, format))
+  {
+    fprintf(stderr, "Error writing output file %s\n", options->OutputFileName);
+    exit(1);
+  }
+
+  vtkParse_Free(data);
+
+  return 0;
+}
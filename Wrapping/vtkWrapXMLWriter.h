@@ -0,0 +1,116 @@
+/*=========================================================================
+
+  Program:   WrapVTK
+  Module:    vtkWrapXMLWriter.h
+
+  Copyright (c) David Gobbi
+  All rights reserved.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  Please see Copyright.txt for more details.
+
+=========================================================================*/
+
+/**
+ vtkWrapXMLWriter.h provides the writer that is shared by vtkWrapXML
+ and vtkWrapJSON.
+
+ A document is written by calling vtkWrapXML_InitState(), then
+ vtkWrapXML_FileHeader(), vtkWrapXML_FileDoc(), vtkWrapXML_Body() and
+ vtkWrapXML_FileFooter(), and finally vtkWrapXML_FinishState().  If no
+ file was given to vtkWrapXML_InitState(), then the whole document is
+ kept in the "buffer" of the state until vtkWrapXML_FinishState().
+*/
+
+#ifndef VTK_WRAP_XML_WRITER_H
+#define VTK_WRAP_XML_WRITER_H
+
+#include "vtkParseData.h"
+#include <stdio.h>
+
+/**
+ * The output formats
+ */
+#define VTKXML_FORMAT_XML 0
+#define VTKXML_FORMAT_JSON 1
+
+/**
+ * The state of the writer
+ */
+typedef struct _wrapxml_state
+{
+  FileInfo *data; /* the data that was parsed */
+  FILE *file; /* the file being written to, or NULL */
+  int format; /* VTKXML_FORMAT_XML or VTKXML_FORMAT_JSON */
+  int indentation; /* current indentation level */
+  int unclosed; /* true if current tag is not closed */
+  int depth; /* JSON: number of open elements */
+  int textopen; /* JSON: true if a "text" string is open */
+  char *children; /* JSON: true if an element has a "children" array */
+  char *buffer; /* output that has not yet been written to the file */
+  size_t length; /* number of chars in the buffer */
+  size_t size; /* allocated size of the buffer */
+} wrapxml_state_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize the state, the output will be written to the file, or
+ * kept in the buffer if the file is NULL
+ */
+void vtkWrapXML_InitState(
+  wrapxml_state_t *w, FileInfo *data, FILE *fp, int format);
+
+/**
+ * Write any remaining output to the file, and free the buffer
+ */
+void vtkWrapXML_FinishState(wrapxml_state_t *w);
+
+/**
+ * Write the start of the document
+ */
+void vtkWrapXML_FileHeader(wrapxml_state_t *w, const FileInfo *data);
+
+/**
+ * Write the documentation for the file
+ */
+void vtkWrapXML_FileDoc(wrapxml_state_t *w, FileInfo *data);
+
+/**
+ * Write the contents of a namespace (or of the file)
+ */
+void vtkWrapXML_Body(wrapxml_state_t *w, NamespaceInfo *data);
+
+/**
+ * Write the end of the document
+ */
+void vtkWrapXML_FileFooter(wrapxml_state_t *w, const FileInfo *data);
+
+/**
+ * Write the text to the file, unless the file already holds the same
+ * text.  The file is replaced atomically.  Returns zero on error.
+ */
+int vtkWrapXML_WriteFileIfChanged(
+  const char *filename, const char *text, size_t n, int binary);
+
+/**
+ * Write a parsed header to the file in the given format, in the same
+ * way as vtkWrapXML_Run().  The file is only replaced if it changed.
+ * Returns zero on error.
+ */
+int vtkWrapXML_WriteFile(FileInfo *data, const char *filename, int format);
+
+/**
+ * The main() of vtkWrapXML and vtkWrapJSON, it parses the headers
+ * given on the command line and writes them in the given format
+ */
+int vtkWrapXML_Run(int argc, char *argv[], int format);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif